@@ -1817,7 +1817,11 @@ void YBEndOperationsBuffering() {
 	// on starting new query and postgres calls standard_ExecutorFinish on non finished executor
 	// from previous failed query.
 	if (buffering_nesting_level && !--buffering_nesting_level) {
-		HandleYBStatus(YBCPgStopOperationsBuffering());
+		/*
+		 * Outside of a transaction block, statement is executed in its own
+		 * transaction, so pggate may keep buffered writes till commit.
+		 */
+		HandleYBStatus(YBCPgStopOperationsBuffering(!IsTransactionBlock()));
 	}
 }
 
@@ -335,11 +335,11 @@ Result<size_t> PopulatePackedRows(
     const SchemaPackingStorage& schema_packing_storage, const Schema& schema,
     const std::shared_ptr<tablet::TabletPeer>& tablet_peer,
     const EnumOidLabelMap& enum_oid_label_map, const CompositeAttsMap& composite_atts_map,
-    Slice* value_slice, RowMessage* row_message) {
+    dockv::PackedRowVersion packed_row_version, Slice* value_slice, RowMessage* row_message) {
   const dockv::SchemaPacking& packing =
       VERIFY_RESULT(schema_packing_storage.GetPacking(value_slice));
   for (size_t i = 0; i != packing.columns(); ++i) {
-    auto slice = packing.GetValue(i, *value_slice);
+    auto slice = packing.GetValue(packed_row_version, i, *value_slice);
     const auto& column_data = packing.column_packing_data(i);
 
     PrimitiveValue pv;
@@ -646,7 +646,7 @@ Status PopulateCDCSDKIntentRecord(
         if (!FLAGS_enable_single_record_update) {
           col_count = schema.num_columns();
         }
-      } else if (value_type == dockv::ValueEntryType::kPackedRow) {
+      } else if (dockv::GetPackedRowVersion(value_type)) {
         SetOperation(row_message, OpType::INSERT, schema);
         col_count = schema.num_key_columns();
       } else {
@@ -712,10 +712,10 @@ Status PopulateCDCSDKIntentRecord(
     prev_key = primary_key;
     prev_intent_phy_time = intent.intent_ht.hybrid_time().GetPhysicalValueMicros();
     if (IsInsertOrUpdate(*row_message)) {
-      if (value_type == dockv::ValueEntryType::kPackedRow) {
+      if (auto packed_row_version = dockv::GetPackedRowVersion(value_type)) {
         col_count += VERIFY_RESULT(PopulatePackedRows(
             schema_packing_storage, schema, tablet_peer, enum_oid_label_map, composite_atts_map,
-            &value_slice, row_message));
+            *packed_row_version, &value_slice, row_message));
       } else {
         if (FLAGS_enable_single_record_update) {
           ++col_count;
@@ -1018,7 +1018,7 @@ Status PopulateCDCSDKWriteRecord(
       // Check whether operation is WRITE or DELETE.
       if (value_type == dockv::ValueEntryType::kTombstone && decoded_key.num_subkeys() == 0) {
         SetOperation(row_message, OpType::DELETE, schema);
-      } else if (value_type == dockv::ValueEntryType::kPackedRow) {
+      } else if (dockv::GetPackedRowVersion(value_type)) {
         SetOperation(row_message, OpType::INSERT, schema);
       } else {
         dockv::KeyEntryValue column_id;
@@ -1079,10 +1079,10 @@ Status PopulateCDCSDKWriteRecord(
     DCHECK(proto_record);
 
     if (IsInsertOrUpdate(*row_message)) {
-      if (value_type == dockv::ValueEntryType::kPackedRow) {
+      if (auto packed_row_version = dockv::GetPackedRowVersion(value_type)) {
         RETURN_NOT_OK(PopulatePackedRows(
             schema_packing_storage, schema, tablet_peer, enum_oid_label_map, composite_atts_map,
-            &value_slice, row_message));
+            *packed_row_version, &value_slice, row_message));
       } else {
         dockv::KeyEntryValue column_id;
         Slice key_column = key.WithoutPrefix(key_size);
@@ -1314,7 +1314,7 @@ Status ProcessIntents(
     Slice value_slice = keyValue.value_buf;
     RETURN_NOT_OK(dockv::ValueControlFields::Decode(&value_slice));
     auto value_type = dockv::DecodeValueEntryType(value_slice);
-    if (value_type != dockv::ValueEntryType::kPackedRow) {
+    if (!dockv::GetPackedRowVersion(value_type)) {
       dockv::Value decoded_value;
       RETURN_NOT_OK(decoded_value.Decode(Slice(keyValue.value_buf)));
     }
@@ -61,6 +61,10 @@ class ConsensusFrontier : public rocksdb::UserFrontier {
   void FromOpIdPBDeprecated(const OpIdPB& pb) override;
   Slice Filter() const override;
 
+  uint64_t PhysicalTimeMicros() const override {
+    return hybrid_time_.is_valid() ? hybrid_time_.GetPhysicalValueMicros() : 0;
+  }
+
   void ResetFilter() override {
     hybrid_time_filter_ = HybridTime::kInvalid;
   }
@@ -13,20 +13,26 @@
 
 #include "yb/docdb/deadlock_detector.h"
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 
 #include "yb/client/transaction_rpc.h"
 
 #include "yb/common/transaction.h"
 #include "yb/common/wire_protocol.h"
 
+#include "yb/docdb/local_wait_for_graph.h"
+
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/thread_annotations.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/strand.h"
 
 #include "yb/tserver/tserver_service.pb.h"
 
@@ -53,6 +59,12 @@ DEFINE_UNKNOWN_int32(
 TAG_FLAG(clear_active_probes_older_than_seconds, hidden);
 TAG_FLAG(clear_active_probes_older_than_seconds, advanced);
 
+DEFINE_RUNTIME_bool(enable_local_deadlock_cycle_detection, true,
+    "Whether the deadlock detector searches for cycles among the waiting transactions it tracks "
+    "in memory, instead of sending probes along wait-for edges between transactions that are "
+    "coordinated by the same status tablet.");
+TAG_FLAG(enable_local_deadlock_cycle_detection, advanced);
+
 METRIC_DEFINE_coarse_histogram(
     tablet, deadlock_size, "Deadlock size", yb::MetricUnit::kTransactions,
     "The number of transactions involved in detected deadlocks");
@@ -62,6 +74,14 @@ METRIC_DEFINE_coarse_histogram(
 METRIC_DEFINE_gauge_uint64(
     tablet, deadlock_detector_waiters, "Num Waiting Txns", yb::MetricUnit::kTransactions,
     "The total number of waiting transactions tracked by one deadlock detector.");
+METRIC_DEFINE_counter(
+    tablet, deadlock_probes_sent, "Deadlock probes sent", yb::MetricUnit::kProbes,
+    "The number of probe requests sent by one deadlock detector, both originated and forwarded.");
+METRIC_DEFINE_coarse_histogram(
+    tablet, deadlock_local_detection_latency, "Local deadlock detection latency",
+    yb::MetricUnit::kMicroseconds,
+    "The time from a change of the waiting transactions tracked by one deadlock detector until "
+    "the search for cycles among them completes.");
 
 DEFINE_test_flag(int32, sleep_amidst_iterating_blockers_ms, 0,
     "Time for which the thread sleeps in each iteration while looping over the computed wait-for "
@@ -76,8 +96,15 @@ YB_STRONGLY_TYPED_UUID(DetectorId);
 
 using LocalProbeProcessorCallback = std::function<void(
     const Status&, const tserver::ProbeTransactionDeadlockResponsePB&)>;
-using WaiterTxnTuple = std::tuple<
-    const TransactionId, const std::string, std::shared_ptr<const WaiterData>>;
+
+// Blockers of a waiting transaction to be probed, merged across all tablet servers that reported
+// the transaction as waiting.
+struct WaiterBlockers {
+  TransactionId waiter_id;
+  // Keeps blocker data referenced from blockers alive after the detector's mutex is released.
+  std::vector<std::shared_ptr<const BlockerData>> blocker_data;
+  std::vector<const BlockerTransactionInfo*> blockers;
+};
 
 // Container class which supports efficiently fetching items uniquely indexed by probe_num as well
 // as efficiently removing items which were added before a threshold time or which are associated
@@ -201,10 +228,12 @@ class LocalProbeProcessor : public std::enable_shared_from_this<LocalProbeProces
   LocalProbeProcessor(
       const std::string& detector_log_prefix, const DetectorId& origin_detector_id,
       uint32_t probe_num, uint32_t min_probe_num, const TransactionId& waiter_id, rpc::Rpcs* rpcs,
-      client::YBClient* client, scoped_refptr<Histogram> probe_latency)
+      client::YBClient* client, scoped_refptr<Histogram> probe_latency,
+      scoped_refptr<Counter> probes_sent)
       : detector_log_prefix_(detector_log_prefix), origin_detector_id_(origin_detector_id),
         waiter_(waiter_id), probe_num_(probe_num), min_probe_num_(min_probe_num), rpcs_(rpcs),
-        client_(client), probe_latency_(std::move(probe_latency)) {
+        client_(client), probe_latency_(std::move(probe_latency)),
+        probes_sent_(std::move(probes_sent)) {
           DCHECK_GE(probe_num_, min_probe_num_);
         }
 
@@ -264,6 +293,7 @@ class LocalProbeProcessor : public std::enable_shared_from_this<LocalProbeProces
     VLOG_WITH_PREFIX(4) << "Sending " << handles_.size() << " probes";
 
     remaining_requests_ = handles_.size();
+    probes_sent_->IncrementBy(handles_.size());
     if (probe_latency_) {
       sent_at_ = CoarseMonoClock::Now();
     }
@@ -331,12 +361,13 @@ class LocalProbeProcessor : public std::enable_shared_from_this<LocalProbeProces
  private:
   const std::string& detector_log_prefix_;
   const DetectorId& origin_detector_id_;
-  const TransactionId& waiter_;
+  const TransactionId waiter_;
   uint32_t probe_num_;
   uint32_t min_probe_num_;
   rpc::Rpcs* rpcs_;
   client::YBClient* client_;
   scoped_refptr<Histogram> probe_latency_;
+  scoped_refptr<Counter> probes_sent_;
 
   CoarseTimePoint sent_at_;
 
@@ -365,11 +396,13 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
       TransactionAbortController* controller, const TabletId& status_tablet_id,
       const MetricEntityPtr& metrics)
       : client_future_(client_future), controller_(controller),
-        detector_id_(DetectorId::GenerateRandom()),
+        status_tablet_id_(status_tablet_id), detector_id_(DetectorId::GenerateRandom()),
         log_prefix_(Format("T $0 D $1 ", status_tablet_id, detector_id_)),
         deadlock_size_(METRIC_deadlock_size.Instantiate(metrics)),
         probe_latency_(METRIC_deadlock_probe_latency.Instantiate(metrics)),
-        deadlock_detector_waiters_(METRIC_deadlock_detector_waiters.Instantiate(metrics, 0)) {
+        deadlock_detector_waiters_(METRIC_deadlock_detector_waiters.Instantiate(metrics, 0)),
+        probes_sent_(METRIC_deadlock_probes_sent.Instantiate(metrics)),
+        local_detection_latency_(METRIC_deadlock_local_detection_latency.Instantiate(metrics)) {
     VLOG_WITH_PREFIX(4) << "Deadlock detector started with instance id: " << detector_id_;
   }
 
@@ -377,7 +410,18 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
     Shutdown();
   }
 
-  void Shutdown() {
+  void Shutdown() EXCLUDES(mutex_) {
+    rpc::Strand* strand = nullptr;
+    {
+      UniqueLock<decltype(mutex_)> l(mutex_);
+      if (!shutdown_) {
+        shutdown_ = true;
+        strand = local_detection_strand_.get();
+      }
+    }
+    if (strand) {
+      strand->Shutdown();
+    }
     rpcs_.Shutdown();
   }
 
@@ -435,9 +479,11 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
       const tserver::UpdateTransactionWaitingForStatusRequestPB& req,
       tserver::UpdateTransactionWaitingForStatusResponsePB* resp,
       DeadlockDetectorRpcCallback&& callback) {
-    std::vector<WaiterTxnTuple> waiters_to_probe;
-    auto status = [this, &waiters_to_probe](const auto& req) -> Status {
+    std::vector<WaiterBlockers> waiters_to_probe;
+    rpc::Strand* local_detection_strand = nullptr;
+    auto status = [this, &waiters_to_probe, &local_detection_strand](const auto& req) -> Status {
       UniqueLock<decltype(mutex_)> l(mutex_);
+      std::vector<TransactionId> updated_waiters;
       auto tserver_uuid = req.tserver_uuid();
       RSTATUS_DCHECK(
           !tserver_uuid.empty(), InvalidArgument,
@@ -447,7 +493,9 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
       if (req.is_full_update()) {
         VLOG_WITH_PREFIX(1) << "Full Update received. Erasing exisiting wait-for dependencies from "
             << "TS: " << tserver_uuid;
-        waiters_.get<TserverUuidTag>().erase(tserver_uuid);
+        if (waiters_.get<TserverUuidTag>().erase(tserver_uuid)) {
+          WaitersChangedUnlocked();
+        }
       }
 
       for (const auto& waiter : req.waiting_transactions()) {
@@ -527,12 +575,21 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
               << "received from TS: " << tserver_uuid << " "
               << "start time: " << wait_start_time;
         }
-        // TODO(wait-queues): Tracking tserver uuid here is unnecessary as it isn't required in
-        // GetProbesToSend. We adhere to this format so that GetProbesToSend function can be re-used
-        // for both 'waiters_'  as well as 'waiters_to_probe'.
-        waiters_to_probe.push_back(
-            {waiter_it->txn_id(), "" /* tserver uuid */, waiter_it->waiter_data()});
+        updated_waiters.push_back(waiter_txn_id);
+      }
+
+      if (updated_waiters.empty()) {
+        return Status::OK();
+      }
+      WaitersChangedUnlocked();
+      auto skip_local_blockers = IsLocalDetectionEnabledUnlocked();
+      auto& waiters_by_txn_id = waiters_.get<TransactionIdTag>();
+      for (const auto& waiter_txn_id : updated_waiters) {
+        AddWaiterToProbeUnlocked(
+            waiter_txn_id, boost::make_iterator_range(waiters_by_txn_id.equal_range(waiter_txn_id)),
+            skip_local_blockers, &waiters_to_probe);
       }
+      local_detection_strand = PrepareLocalDetectionUnlocked();
       return Status::OK();
     }(req);
 
@@ -542,7 +599,8 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
     }
 
     callback(Status::OK());
-    for (const auto& probe : GetProbesToSend(waiters_to_probe)) {
+    ScheduleLocalDetection(local_detection_strand);
+    for (const auto& probe : GetProbesToSend(waiters_to_probe, /* is_probe_scan= */ false)) {
       probe->Send();
     }
   }
@@ -550,21 +608,45 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
   void TriggerProbes() EXCLUDES(mutex_) {
     // We should be able to trigger probes only once per unique waiting transaction, but we still
     // trigger all active probes on a fixed interval for safetey/simplicity.
-    std::vector<LocalProbeProcessorPtr> probes_to_send;
+    auto* messenger = client().messenger();
+    std::vector<WaiterBlockers> waiters_to_probe;
+    rpc::Strand* local_detection_strand = nullptr;
+    bool is_probe_scan_active;
     {
       UniqueLock<decltype(mutex_)> l(mutex_);
+      auto num_waiters = waiters_.size();
       controller_->RemoveInactiveTransactions(&waiters_);
+      if (waiters_.size() != num_waiters) {
+        WaitersChangedUnlocked();
+      }
       deadlock_detector_waiters_->set_value(waiters_.size());
-      if (is_probe_scan_active_) {
-        return;
+      if (!local_detection_strand_ && !shutdown_) {
+        local_detection_strand_ = std::make_unique<rpc::Strand>(&messenger->ThreadPool());
+      }
+      local_detection_strand = PrepareLocalDetectionUnlocked();
+      is_probe_scan_active = is_probe_scan_active_;
+      if (!is_probe_scan_active) {
+        // TODO(wait-queues): Trigger probes only for waiters which which have
+        // wait_start_time > Now() - N seconds
+        auto skip_local_blockers = IsLocalDetectionEnabledUnlocked();
+        auto& waiters_by_txn_id = waiters_.get<TransactionIdTag>();
+        for (auto it = waiters_by_txn_id.begin(); it != waiters_by_txn_id.end();) {
+          auto range_end = waiters_by_txn_id.upper_bound(it->txn_id());
+          AddWaiterToProbeUnlocked(
+              it->txn_id(), boost::make_iterator_range(it, range_end), skip_local_blockers,
+              &waiters_to_probe);
+          it = range_end;
+        }
+        is_probe_scan_active_ = !waiters_to_probe.empty();
       }
-      is_probe_scan_active_ = true;
-      // TODO(wait-queues): Trigger probes only for waiters which which have
-      // wait_start_time > Now() - N seconds
-      probes_to_send = GetProbesToSend(waiters_);
     }
 
-    for (auto& processor : probes_to_send) {
+    ScheduleLocalDetection(local_detection_strand);
+    if (is_probe_scan_active) {
+      return;
+    }
+
+    for (auto& processor : GetProbesToSend(waiters_to_probe, /* is_probe_scan= */ true)) {
       processor->Send();
     }
 
@@ -582,23 +664,67 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
   }
 
  private:
-  template <class T>
-  std::vector<LocalProbeProcessorPtr> GetProbesToSend(const T& waiters) {
-    std::vector<LocalProbeProcessorPtr> probes_to_send;
-    std::shared_ptr<std::atomic<uint64>> outstanding_probes =
-        std::make_shared<std::atomic<uint64>>(waiters.size());
+  bool IsLocalDetectionEnabledUnlocked() const REQUIRES_SHARED(mutex_) {
+    return local_detection_strand_ && !shutdown_ &&
+           GetAtomicFlag(&FLAGS_enable_local_deadlock_cycle_detection);
+  }
+
+  // Returns whether the blocker is a waiter tracked by this detector. Wait-for edges to such
+  // blockers are covered by local cycle detection and by probes forwarded from this detector, so
+  // probes are not originated for them when local cycle detection is enabled.
+  bool IsLocalWaiterUnlocked(const BlockerTransactionInfo& blocker) const REQUIRES_SHARED(mutex_) {
+    if (blocker.status_tablet != status_tablet_id_) {
+      return false;
+    }
+    const auto& waiters_by_txn_id = waiters_.get<TransactionIdTag>();
+    return waiters_by_txn_id.find(blocker.id) != waiters_by_txn_id.end();
+  }
 
-    // A waiter_txn_id might be encountered multiple times in the below iterations depending
-    // on the number of Tablet Servers the wait-for dependencies for the waiter arrived from.
-    //
-    // TODO(wait-queues): Coalesce multiple entries in waiters with the same waiter_txn_id into a
-    // single LocalProbeProcessor.
-    for (const auto& [waiter_txn_id, _, waiter_data] : waiters) {
-      if (waiter_data->blockers->empty()) {
+  // Merges blockers of all entries of the waiter, i.e. reported by different tablet servers, so
+  // that a single probe is originated per waiting transaction.
+  template <class Entries>
+  void AddWaiterToProbeUnlocked(
+      const TransactionId& waiter_txn_id, const Entries& entries, bool skip_local_blockers,
+      std::vector<WaiterBlockers>* out) REQUIRES_SHARED(mutex_) {
+    WaiterBlockers waiter { .waiter_id = waiter_txn_id };
+    for (const auto& entry : entries) {
+      const auto& blockers = entry.waiter_data()->blockers;
+      if (blockers->empty()) {
         LOG_WITH_PREFIX(WARNING) << "Tried getting probes for waiter with no blockers "
                                  << waiter_txn_id;
         continue;
       }
+      auto num_blockers = waiter.blockers.size();
+      for (const auto& blocker : *blockers) {
+        if (skip_local_blockers && IsLocalWaiterUnlocked(blocker)) {
+          continue;
+        }
+        auto same_blocker = [&blocker](const BlockerTransactionInfo* existing) {
+          return existing->id == blocker.id &&
+                 existing->blocking_subtxn_info->set() == blocker.blocking_subtxn_info->set();
+        };
+        if (std::find_if(waiter.blockers.begin(), waiter.blockers.end(), same_blocker) ==
+                waiter.blockers.end()) {
+          waiter.blockers.push_back(&blocker);
+        }
+      }
+      if (waiter.blockers.size() != num_blockers) {
+        waiter.blocker_data.push_back(blockers);
+      }
+    }
+    if (!waiter.blockers.empty()) {
+      out->push_back(std::move(waiter));
+    }
+  }
+
+  std::vector<LocalProbeProcessorPtr> GetProbesToSend(
+      const std::vector<WaiterBlockers>& waiters, bool is_probe_scan) {
+    std::vector<LocalProbeProcessorPtr> probes_to_send;
+    probes_to_send.reserve(waiters.size());
+    std::shared_ptr<std::atomic<uint64>> outstanding_probes =
+        std::make_shared<std::atomic<uint64>>(waiters.size());
+
+    for (const auto& [waiter_txn_id, _, blockers] : waiters) {
       // We need to call created_probes_.GetSmallestProbeNo() before seq_no_.fetch_add(1) to avoid a
       // race condition wherein one thread grabs a lower probe_num from seq_no but calls
       // GetSmallestProbeNo after another thread which grabbed a higher probe_num from seq_no. If we
@@ -608,18 +734,19 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
       auto probe_num = seq_no_.fetch_add(1);
       auto processor = std::make_shared<LocalProbeProcessor>(
           log_prefix_, detector_id_, probe_num, min_probe_num,
-          waiter_txn_id, &rpcs_, &client(), probe_latency_);
-      for (const auto& blocker : *waiter_data->blockers) {
+          waiter_txn_id, &rpcs_, &client(), probe_latency_, probes_sent_);
+      for (const auto* blocker : blockers) {
         AtomicFlagSleepMs(&FLAGS_TEST_sleep_amidst_iterating_blockers_ms);
-        DCHECK(!blocker.status_tablet.empty());
-        processor->AddBlocker(blocker);
+        DCHECK(!blocker->status_tablet.empty());
+        processor->AddBlocker(*blocker);
       }
-      processor->SetCallback([detector = shared_from_this(), outstanding_probes, probe_num]
+      processor->SetCallback(
+          [detector = shared_from_this(), outstanding_probes, probe_num, is_probe_scan]
           (const auto& status, const auto& resp) {
         VLOG(4) << "Got callback for probe "
                 << Format("($0, $1)", probe_num, detector->detector_id_);
         detector->created_probes_.Remove(probe_num);
-        if (outstanding_probes->fetch_sub(1) == 1) {
+        if (outstanding_probes->fetch_sub(1) == 1 && is_probe_scan) {
           UniqueLock<decltype(mutex_)> l(detector->mutex_);
           detector->is_probe_scan_active_ = false;
         }
@@ -757,7 +884,7 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
 
     auto local_processor = std::make_shared<LocalProbeProcessor>(
         log_prefix_, detector_id, probe_num, req.min_probe_num(), waiting_txn_id, &rpcs_,
-        &client(), nullptr /* probe_latency */);
+        &client(), nullptr /* probe_latency */, probes_sent_);
 
     for (const auto& blockers : blockers_per_ts) {
       for (const auto& blocker : *blockers) {
@@ -768,11 +895,91 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
     return local_processor;
   }
 
-  void TxnAbortCallback(Result<TransactionStatusResult> res, const TransactionId txn_id) {
+  void WaitersChangedUnlocked() REQUIRES(mutex_) {
+    if (waiters_version_ == checked_waiters_version_) {
+      waiters_changed_at_ = CoarseMonoClock::Now();
+    }
+    ++waiters_version_;
+  }
+
+  // Returns the strand to run local cycle detection on, when it should be scheduled.
+  rpc::Strand* PrepareLocalDetectionUnlocked() REQUIRES(mutex_) {
+    // The wait-for graph does not change while a deadlock whose victim failed to abort persists,
+    // so it is treated as changed to search for the deadlock again.
+    if (retry_local_detection_.exchange(false, std::memory_order_acq_rel)) {
+      WaitersChangedUnlocked();
+    }
+    if (!IsLocalDetectionEnabledUnlocked() || is_local_detection_scheduled_ ||
+        waiters_version_ == checked_waiters_version_) {
+      return nullptr;
+    }
+    is_local_detection_scheduled_ = true;
+    return local_detection_strand_.get();
+  }
+
+  void ScheduleLocalDetection(rpc::Strand* strand) {
+    if (!strand) {
+      return;
+    }
+    strand->EnqueueFunctor([detector = shared_from_this()] {
+      detector->DetectLocalDeadlocks();
+    });
+  }
+
+  // Searches for cycles among the waiters tracked by this detector and aborts a transaction from
+  // each found cycle. Runs on local_detection_strand_, so the wait-for graph is traversed outside
+  // of mutex_ and without blocking the scheduler thread which triggers probes.
+  void DetectLocalDeadlocks() EXCLUDES(mutex_) {
+    LocalWaitForGraph graph;
+    CoarseTimePoint changed_at;
+    {
+      UniqueLock<decltype(mutex_)> l(mutex_);
+      is_local_detection_scheduled_ = false;
+      if (waiters_version_ == checked_waiters_version_) {
+        return;
+      }
+      checked_waiters_version_ = waiters_version_;
+      changed_at = waiters_changed_at_;
+      for (const auto& entry : waiters_) {
+        const auto& waiter_data = *entry.waiter_data();
+        for (const auto& blocker : *waiter_data.blockers) {
+          if (IsLocalWaiterUnlocked(blocker)) {
+            graph.AddEdge(
+                entry.txn_id(), waiter_data.wait_start_time, blocker.id,
+                blocker.blocking_subtxn_info);
+          }
+        }
+      }
+    }
+
+    VLOG_WITH_PREFIX(4) << "Searching for deadlocks among " << graph.size() << " local waiters";
+    graph.FindCycles(
+        [this](const TransactionId& blocker_id, const SubtxnSet& blocking_subtxn_set) {
+          return controller_->IsAnySubtxnActive(blocker_id, blocking_subtxn_set);
+        },
+        [this](const TransactionId& victim, size_t deadlock_size) {
+          LOG_WITH_PREFIX(INFO) << "Found local deadlock of " << deadlock_size
+                                << " transactions, aborting " << victim;
+          deadlock_size_->Increment(deadlock_size);
+          controller_->Abort(
+              victim, [detector = shared_from_this(), victim](const auto& result) {
+            // The callback could be invoked under the coordinator's lock, so mutex_ is not
+            // acquired here.
+            if (!detector->TxnAbortCallback(result, victim)) {
+              detector->retry_local_detection_.store(true, std::memory_order_release);
+            }
+          });
+        });
+    local_detection_latency_->Increment(
+        MonoDelta(CoarseMonoClock::Now() - changed_at).ToMicroseconds());
+  }
+
+  // Returns whether the transaction was aborted.
+  bool TxnAbortCallback(Result<TransactionStatusResult> res, const TransactionId txn_id) {
     if (res.ok()) {
       if (res->status == TransactionStatus::ABORTED && res->status_time.is_valid()) {
         LOG_WITH_FUNC(INFO) << "Aborting deadlocked transaction " << txn_id << " succeeded.";
-        return;
+        return true;
       }
       LOG_WITH_FUNC(INFO) << "Aborting deadlocked transaction " << txn_id
                           << " failed -- status: " << res->status << ", time: " << res->status_time;
@@ -780,6 +987,7 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
       LOG_WITH_FUNC(INFO) << "Aborting deadlocked transaction " << txn_id
                           << " failed -- " << res.status();
     }
+    return false;
   }
 
   const std::string& LogPrefix() const {
@@ -790,12 +998,15 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
 
   const std::shared_future<client::YBClient*>& client_future_;
   TransactionAbortController* const controller_;
+  const TabletId status_tablet_id_;
   const DetectorId detector_id_;
   const std::string log_prefix_;
 
   scoped_refptr<Histogram> deadlock_size_;
   scoped_refptr<Histogram> probe_latency_;
   scoped_refptr<AtomicGauge<uint64_t>> deadlock_detector_waiters_;
+  scoped_refptr<Counter> probes_sent_;
+  scoped_refptr<Histogram> local_detection_latency_;
 
   mutable rw_spinlock mutex_;
 
@@ -811,6 +1022,19 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
 
   Waiters waiters_ GUARDED_BY(mutex_);
 
+  // Incremented on each change of waiters_, so local cycle detection is performed only when the
+  // wait-for graph has changed since the previous search.
+  uint64_t waiters_version_ GUARDED_BY(mutex_) = 0;
+  uint64_t checked_waiters_version_ GUARDED_BY(mutex_) = 0;
+  // Time of the first change of waiters_ after the previous search.
+  CoarseTimePoint waiters_changed_at_ GUARDED_BY(mutex_);
+  bool is_local_detection_scheduled_ GUARDED_BY(mutex_) = false;
+  std::atomic<bool> retry_local_detection_{false};
+
+  // Created on the first TriggerProbes call, since the client is not available at construction.
+  std::unique_ptr<rpc::Strand> local_detection_strand_ GUARDED_BY(mutex_);
+  bool shutdown_ GUARDED_BY(mutex_) = false;
+
   std::atomic<uint32_t> seq_no_ = 0;
 };
 
@@ -821,7 +1045,10 @@ DeadlockDetector::DeadlockDetector(
     const MetricEntityPtr& metrics):
   impl_(new Impl(client_future, controller, status_tablet_id, metrics)) {}
 
-DeadlockDetector::~DeadlockDetector() {}
+DeadlockDetector::~DeadlockDetector() {
+  // Waits for the scheduled local cycle detection, which holds a reference to impl_.
+  impl_->Shutdown();
+}
 
 void DeadlockDetector::ProcessProbe(
     const tserver::ProbeTransactionDeadlockRequestPB& req,
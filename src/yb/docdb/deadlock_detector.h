@@ -147,6 +147,15 @@ using DeadlockDetectorRpcCallback = std::function<void(const Status&)>;
 // 1. for each blocker:
 // 2.    probe_id = (probe_no++,detector_id)
 // 3.    send probe{probe_id, waiter_id, blocker_id} to blocker's coordinator
+// Blockers of a waiter reported by different tservers are merged, so a single probe_id is used per
+// waiting transaction.
+//
+// When FLAGS_enable_local_deadlock_cycle_detection is set, probes are not originated for blockers
+// which are themselves waiters tracked by this deadlock detector. Instead, each time the tracked
+// waiters change, the deadlock detector searches for cycles among them on a strand of the
+// messenger's thread pool, and aborts the transaction of each found cycle that started waiting
+// last. Deadlocks involving transactions of other coordinators are still detected by the probes
+// originated for the remaining blockers, since probes are forwarded to all blockers.
 //
 // Upon receiving a ProbeTransactionDeadlockRequestPB, a coordinator forwards it directly to the
 // deadlock detector which does the following:
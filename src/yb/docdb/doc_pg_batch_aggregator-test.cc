@@ -0,0 +1,277 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_expr.h"
+#include "yb/docdb/doc_pg_batch_aggregator.h"
+
+#include "yb/dockv/pg_row.h"
+#include "yb/dockv/reader_projection.h"
+
+#include "yb/qlexpr/ql_expr.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/random_util.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb::docdb {
+
+namespace {
+
+Schema BuildSchema() {
+  SchemaBuilder builder;
+  CHECK_OK(builder.AddHashKeyColumn("h", DataType::INT32));
+  CHECK_OK(builder.AddNullableColumn("v_int8", DataType::INT8));
+  CHECK_OK(builder.AddColumn("v_int16", DataType::INT16));
+  CHECK_OK(builder.AddNullableColumn("v_int32", DataType::INT32));
+  CHECK_OK(builder.AddColumn("v_int64", DataType::INT64));
+  CHECK_OK(builder.AddNullableColumn("v_float", DataType::FLOAT));
+  CHECK_OK(builder.AddNullableColumn("v_double", DataType::DOUBLE));
+  CHECK_OK(builder.AddNullableColumn("v_string", DataType::STRING));
+  return builder.Build();
+}
+
+QLValuePB RandomColumnValue(const ColumnSchema& column) {
+  QLValuePB result;
+  if (column.is_nullable() && RandomUniformInt(0, 4) == 0) {
+    return result;
+  }
+  switch (column.type_info()->type) {
+    case DataType::INT8:
+      result.set_int8_value(RandomUniformInt<int32_t>(-128, 127));
+      break;
+    case DataType::INT16:
+      result.set_int16_value(RandomUniformInt<int16_t>());
+      break;
+    case DataType::INT32:
+      result.set_int32_value(RandomUniformInt<int32_t>());
+      break;
+    case DataType::INT64:
+      result.set_int64_value(RandomUniformInt<int64_t>());
+      break;
+    case DataType::FLOAT:
+      result.set_float_value(RandomUniformReal<float>(-1e6, 1e6));
+      break;
+    case DataType::DOUBLE:
+      if (RandomUniformInt(0, 16) == 0) {
+        result.set_double_value(std::numeric_limits<double>::quiet_NaN());
+      } else {
+        result.set_double_value(RandomUniformReal<double>(-1e6, 1e6));
+      }
+      break;
+    case DataType::STRING:
+      result.set_string_value(RandomHumanReadableString(RandomUniformInt(0, 16)));
+      break;
+    default:
+      CHECK(false) << "Not supported data type: " << column.type_info()->type;
+  }
+  return result;
+}
+
+PgsqlExpressionPB MakeAggregate(bfpg::TSOpcode opcode, ColumnId column_id) {
+  PgsqlExpressionPB result;
+  auto& tscall = *result.mutable_tscall();
+  tscall.set_opcode(to_underlying(opcode));
+  tscall.add_operands()->set_column_id(column_id);
+  return result;
+}
+
+PgsqlExpressionPB MakeCountAll() {
+  PgsqlExpressionPB result;
+  auto& tscall = *result.mutable_tscall();
+  tscall.set_opcode(to_underlying(bfpg::TSOpcode::kCount));
+  tscall.add_operands()->mutable_value()->set_int64_value(0);
+  return result;
+}
+
+bfpg::TSOpcode SumOpcode(DataType data_type) {
+  switch (data_type) {
+    case DataType::INT8: return bfpg::TSOpcode::kSumInt8;
+    case DataType::INT16: return bfpg::TSOpcode::kSumInt16;
+    case DataType::INT32: return bfpg::TSOpcode::kSumInt32;
+    case DataType::INT64: return bfpg::TSOpcode::kSumInt64;
+    case DataType::FLOAT: return bfpg::TSOpcode::kSumFloat;
+    case DataType::DOUBLE: return bfpg::TSOpcode::kSumDouble;
+    default: return bfpg::TSOpcode::kNoOp;
+  }
+}
+
+class DocPgBatchAggregatorTest : public YBTest {
+ protected:
+  DocPgBatchAggregatorTest() : schema_(BuildSchema()), projection_(schema_) {}
+
+  void GenerateRows(size_t num_rows) {
+    rows_.reserve(num_rows);
+    while (rows_.size() != num_rows) {
+      auto& row = rows_.emplace_back(projection_);
+      for (size_t idx = 0; idx != schema_.num_columns(); ++idx) {
+        ASSERT_OK(row.SetValue(schema_.column_id(idx), RandomColumnValue(schema_.column(idx))));
+      }
+    }
+  }
+
+  // COUNT(*) and COUNT, SUM, MIN, MAX of all value columns, where applicable.
+  std::vector<PgsqlExpressionPB> AllTargets() {
+    std::vector<PgsqlExpressionPB> result;
+    result.push_back(MakeCountAll());
+    for (size_t idx = schema_.num_key_columns(); idx != schema_.num_columns(); ++idx) {
+      const auto column_id = schema_.column_id(idx);
+      result.push_back(MakeAggregate(bfpg::TSOpcode::kCount, column_id));
+      auto sum_opcode = SumOpcode(schema_.column(idx).type_info()->type);
+      if (sum_opcode == bfpg::TSOpcode::kNoOp) {
+        continue;
+      }
+      result.push_back(MakeAggregate(sum_opcode, column_id));
+      result.push_back(MakeAggregate(bfpg::TSOpcode::kMin, column_id));
+      result.push_back(MakeAggregate(bfpg::TSOpcode::kMax, column_id));
+    }
+    return result;
+  }
+
+  const Schema schema_;
+  const dockv::ReaderProjection projection_;
+  std::vector<dockv::PgTableRow> rows_;
+};
+
+} // namespace
+
+TEST_F(DocPgBatchAggregatorTest, Random) {
+  constexpr size_t kNumRows = 5000;
+  constexpr size_t kMaxBatchSize = 300;
+
+  ASSERT_NO_FATALS(GenerateRows(kNumRows));
+  auto targets = AllTargets();
+
+  DocPgBatchAggregator aggregator(projection_);
+  for (const auto& target : targets) {
+    ASSERT_TRUE(aggregator.TryAdd(target)) << target.ShortDebugString();
+  }
+
+  DocExprExecutor executor;
+  std::vector<qlexpr::QLExprResult> expected(targets.size());
+  dockv::PgTableRowBatch batch(projection_, kMaxBatchSize);
+  std::vector<uint8_t> selection;
+  size_t row_idx = 0;
+  while (row_idx != kNumRows) {
+    auto batch_size = std::min<size_t>(RandomUniformInt<size_t>(1, kMaxBatchSize),
+                                       kNumRows - row_idx);
+    auto use_selection = RandomUniformBool();
+    batch.Reset();
+    selection.clear();
+    for (; batch_size-- > 0; ++row_idx) {
+      const auto& row = rows_[row_idx];
+      batch.AppendRow(row);
+      auto selected = !use_selection || RandomUniformBool();
+      selection.push_back(selected);
+      if (!selected) {
+        continue;
+      }
+      for (size_t i = 0; i != targets.size(); ++i) {
+        ASSERT_OK(executor.EvalExpr(targets[i], row, expected[i].Writer()));
+      }
+    }
+    aggregator.Apply(batch, use_selection ? selection.data() : nullptr);
+  }
+
+  auto results = aggregator.Results();
+  ASSERT_EQ(results.size(), targets.size());
+  for (size_t i = 0; i != targets.size(); ++i) {
+    ASSERT_EQ(results[i].ShortDebugString(), expected[i].Value().ShortDebugString())
+        << "Target: " << targets[i].ShortDebugString();
+  }
+}
+
+TEST_F(DocPgBatchAggregatorTest, NotSupported) {
+  DocPgBatchAggregator aggregator(projection_);
+
+  // SUM with opcode that does not match column type.
+  ASSERT_FALSE(aggregator.TryAdd(MakeAggregate(bfpg::TSOpcode::kSumInt64, schema_.column_id(3))));
+  // MIN of string column.
+  ASSERT_FALSE(aggregator.TryAdd(MakeAggregate(bfpg::TSOpcode::kMin, schema_.column_id(7))));
+  // COUNT(NULL).
+  PgsqlExpressionPB count_null;
+  auto& tscall = *count_null.mutable_tscall();
+  tscall.set_opcode(to_underlying(bfpg::TSOpcode::kCount));
+  tscall.add_operands()->mutable_value();
+  ASSERT_FALSE(aggregator.TryAdd(count_null));
+
+  ASSERT_TRUE(aggregator.empty());
+}
+
+// Compares rows/sec of the batch aggregator with row by row evaluation by DocExprExecutor,
+// which is used for aggregate pushdown when batching is not enabled.
+TEST_F(DocPgBatchAggregatorTest, Benchmark) {
+  constexpr size_t kBatchSize = 1024;
+  const int kNumRuns = AllowSlowTests() ? 5000 : 100;
+
+  ASSERT_NO_FATALS(GenerateRows(kBatchSize));
+  dockv::PgTableRowBatch batch(projection_, kBatchSize);
+  for (const auto& row : rows_) {
+    batch.AppendRow(row);
+  }
+
+  // SELECT count(*), sum(v_int64), max(v_double)
+  std::vector<PgsqlExpressionPB> targets = {
+    MakeCountAll(),
+    MakeAggregate(bfpg::TSOpcode::kSumInt64, schema_.column_id(4)),
+    MakeAggregate(bfpg::TSOpcode::kMax, schema_.column_id(6)),
+  };
+
+  const auto num_rows = kNumRuns * kBatchSize;
+
+  DocExprExecutor executor;
+  std::vector<qlexpr::QLExprResult> expected(targets.size());
+  Stopwatch row_sw;
+  row_sw.start();
+  for (int run = 0; run != kNumRuns; ++run) {
+    for (const auto& row : rows_) {
+      for (size_t i = 0; i != targets.size(); ++i) {
+        ASSERT_OK(executor.EvalExpr(targets[i], row, expected[i].Writer()));
+      }
+    }
+  }
+  row_sw.stop();
+  auto row_time = row_sw.elapsed().wall_seconds();
+
+  DocPgBatchAggregator aggregator(projection_);
+  for (const auto& target : targets) {
+    ASSERT_TRUE(aggregator.TryAdd(target));
+  }
+  Stopwatch batch_sw;
+  batch_sw.start();
+  for (int run = 0; run != kNumRuns; ++run) {
+    aggregator.Apply(batch);
+  }
+  batch_sw.stop();
+  auto batch_time = batch_sw.elapsed().wall_seconds();
+
+  auto results = aggregator.Results();
+  for (size_t i = 0; i != targets.size(); ++i) {
+    ASSERT_EQ(results[i].ShortDebugString(), expected[i].Value().ShortDebugString());
+  }
+  LOG(INFO) << "Row by row: " << num_rows / row_time << " rows/sec, "
+            << "batch aggregator: " << num_rows / batch_time << " rows/sec";
+}
+
+} // namespace yb::docdb
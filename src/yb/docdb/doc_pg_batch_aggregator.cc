@@ -0,0 +1,370 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_pg_batch_aggregator.h"
+
+#include <cmath>
+#include <type_traits>
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/ql_datatype.h"
+#include "yb/common/ql_value.h"
+
+#include "yb/dockv/pg_row.h"
+#include "yb/dockv/reader_projection.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/logging.h"
+
+namespace yb::docdb {
+
+namespace {
+
+YB_DEFINE_ENUM(AggregateKind, (kCountAll)(kCount)(kSum)(kMin)(kMax));
+
+template <class T>
+T Load(dockv::PgValueDatum datum) {
+  if constexpr (std::is_same_v<T, float>) {
+    return bit_cast<float>(static_cast<uint32_t>(datum));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return bit_cast<double>(static_cast<uint64_t>(datum));
+  } else {
+    return static_cast<T>(datum);
+  }
+}
+
+// Ordering used by QLValuePB, where NaN is greater than any other value.
+template <class T>
+bool Less(T lhs, T rhs) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return !std::isnan(lhs) && (std::isnan(rhs) || lhs < rhs);
+  } else {
+    return lhs < rhs;
+  }
+}
+
+size_t CountMask(const uint8_t* mask, size_t size) {
+  size_t result = 0;
+  for (size_t i = 0; i != size; ++i) {
+    result += mask[i];
+  }
+  return result;
+}
+
+// Integer sum is accumulated as unsigned to have well defined wraparound, the same as int64_t
+// addition in DocExprExecutor produces in practice.
+template <class T>
+uint64_t SumInts(const dockv::PgValueDatum* values, const uint8_t* mask, size_t size) {
+  uint64_t result = 0;
+  for (size_t i = 0; i != size; ++i) {
+    result += static_cast<uint64_t>(static_cast<int64_t>(Load<T>(values[i]))) &
+              -static_cast<uint64_t>(mask[i]);
+  }
+  return result;
+}
+
+// Floating point values are added in row order, so result does not depend on batch size.
+// The first value is taken as is, the same as DocExprExecutor does.
+template <class T>
+T SumReals(
+    const dockv::PgValueDatum* values, const uint8_t* mask, size_t size, bool has_sum, T sum) {
+  for (size_t i = 0; i != size; ++i) {
+    if (!mask[i]) {
+      continue;
+    }
+    if (has_sum) {
+      sum += Load<T>(values[i]);
+    } else {
+      sum = Load<T>(values[i]);
+      has_sum = true;
+    }
+  }
+  return sum;
+}
+
+// Finds index of the masked value that should replace current MIN or MAX value. The current value
+// is replaced only by strictly better one, so the first of equal values is kept.
+// Returns size if current value should be kept.
+template <class T, bool kMax>
+size_t FindExtreme(
+    const dockv::PgValueDatum* values, const uint8_t* mask, size_t size, bool has_current,
+    dockv::PgValueDatum current) {
+  auto best = Load<T>(current);
+  size_t result = size;
+  for (size_t i = 0; i != size; ++i) {
+    if (!mask[i]) {
+      continue;
+    }
+    auto value = Load<T>(values[i]);
+    if ((!has_current && result == size) || (kMax ? Less(best, value) : Less(value, best))) {
+      best = value;
+      result = i;
+    }
+  }
+  return result;
+}
+
+template <bool kMax>
+size_t FindExtreme(
+    DataType data_type, const dockv::PgValueDatum* values, const uint8_t* mask, size_t size,
+    bool has_current, dockv::PgValueDatum current) {
+  switch (data_type) {
+    case DataType::INT8:
+      return FindExtreme<int8_t, kMax>(values, mask, size, has_current, current);
+    case DataType::INT16:
+      return FindExtreme<int16_t, kMax>(values, mask, size, has_current, current);
+    case DataType::INT32:
+      return FindExtreme<int32_t, kMax>(values, mask, size, has_current, current);
+    case DataType::INT64:
+      return FindExtreme<int64_t, kMax>(values, mask, size, has_current, current);
+    case DataType::FLOAT:
+      return FindExtreme<float, kMax>(values, mask, size, has_current, current);
+    case DataType::DOUBLE:
+      return FindExtreme<double, kMax>(values, mask, size, has_current, current);
+    default:
+      break;
+  }
+  LOG(DFATAL) << "Unexpected data type: " << data_type;
+  return size;
+}
+
+bool IsSupportedNumericType(DataType data_type) {
+  switch (data_type) {
+    case DataType::INT8: [[fallthrough]];
+    case DataType::INT16: [[fallthrough]];
+    case DataType::INT32: [[fallthrough]];
+    case DataType::INT64: [[fallthrough]];
+    case DataType::FLOAT: [[fallthrough]];
+    case DataType::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns data type of the column that could be summed using specified opcode.
+DataType SumDataType(bfpg::TSOpcode opcode) {
+  switch (opcode) {
+    case bfpg::TSOpcode::kSumInt8:
+      return DataType::INT8;
+    case bfpg::TSOpcode::kSumInt16:
+      return DataType::INT16;
+    case bfpg::TSOpcode::kSumInt32:
+      return DataType::INT32;
+    case bfpg::TSOpcode::kSumInt64:
+      return DataType::INT64;
+    case bfpg::TSOpcode::kSumFloat:
+      return DataType::FLOAT;
+    case bfpg::TSOpcode::kSumDouble:
+      return DataType::DOUBLE;
+    default:
+      return DataType::UNKNOWN_DATA;
+  }
+}
+
+} // namespace
+
+struct DocPgBatchAggregator::Aggregate {
+  AggregateKind kind;
+  size_t column_idx = 0;
+  DataType data_type = DataType::UNKNOWN_DATA;
+  // Number of accumulated values.
+  int64_t count = 0;
+  uint64_t int_sum = 0;
+  float float_sum = 0;
+  double double_sum = 0;
+  // Current MIN/MAX value.
+  dockv::PgValueDatum extreme = 0;
+
+  void Apply(const dockv::PgValueDatum* values, const uint8_t* mask, size_t size);
+  QLValuePB Result() const;
+};
+
+void DocPgBatchAggregator::Aggregate::Apply(
+    const dockv::PgValueDatum* values, const uint8_t* mask, size_t size) {
+  const auto num_values = CountMask(mask, size);
+  if (num_values == 0) {
+    return;
+  }
+  switch (kind) {
+    case AggregateKind::kCountAll: [[fallthrough]];
+    case AggregateKind::kCount:
+      break;
+    case AggregateKind::kSum:
+      switch (data_type) {
+        case DataType::INT8:
+          int_sum += SumInts<int8_t>(values, mask, size);
+          break;
+        case DataType::INT16:
+          int_sum += SumInts<int16_t>(values, mask, size);
+          break;
+        case DataType::INT32:
+          int_sum += SumInts<int32_t>(values, mask, size);
+          break;
+        case DataType::INT64:
+          int_sum += SumInts<int64_t>(values, mask, size);
+          break;
+        case DataType::FLOAT:
+          float_sum = SumReals(values, mask, size, count != 0, float_sum);
+          break;
+        case DataType::DOUBLE:
+          double_sum = SumReals(values, mask, size, count != 0, double_sum);
+          break;
+        default:
+          LOG(DFATAL) << "Unexpected data type: " << data_type;
+          break;
+      }
+      break;
+    case AggregateKind::kMin: [[fallthrough]];
+    case AggregateKind::kMax: {
+      const auto idx = kind == AggregateKind::kMax
+          ? FindExtreme<true>(data_type, values, mask, size, count != 0, extreme)
+          : FindExtreme<false>(data_type, values, mask, size, count != 0, extreme);
+      if (idx < size) {
+        extreme = values[idx];
+      }
+      break;
+    }
+  }
+  count += num_values;
+}
+
+QLValuePB DocPgBatchAggregator::Aggregate::Result() const {
+  QLValuePB result;
+  if (count == 0) {
+    return result;
+  }
+  switch (kind) {
+    case AggregateKind::kCountAll: [[fallthrough]];
+    case AggregateKind::kCount:
+      result.set_int64_value(count);
+      return result;
+    case AggregateKind::kSum:
+      if (data_type == DataType::FLOAT) {
+        result.set_float_value(float_sum);
+      } else if (data_type == DataType::DOUBLE) {
+        result.set_double_value(double_sum);
+      } else {
+        result.set_int64_value(static_cast<int64_t>(int_sum));
+      }
+      return result;
+    case AggregateKind::kMin: [[fallthrough]];
+    case AggregateKind::kMax:
+      return dockv::PgValue(extreme).ToQLValuePB(data_type);
+  }
+  FATAL_INVALID_ENUM_VALUE(AggregateKind, kind);
+}
+
+DocPgBatchAggregator::DocPgBatchAggregator(
+    std::reference_wrapper<const dockv::ReaderProjection> projection)
+    : projection_(&projection.get()) {
+}
+
+DocPgBatchAggregator::~DocPgBatchAggregator() = default;
+
+DocPgBatchAggregator::DocPgBatchAggregator(DocPgBatchAggregator&&) = default;
+DocPgBatchAggregator& DocPgBatchAggregator::operator=(DocPgBatchAggregator&&) = default;
+
+bool DocPgBatchAggregator::TryAdd(const PgsqlExpressionPB& target) {
+  if (!target.has_tscall() || target.tscall().operands().size() != 1) {
+    return false;
+  }
+  const auto opcode = static_cast<bfpg::TSOpcode>(target.tscall().opcode());
+  const auto& operand = target.tscall().operands(0);
+  if (opcode == bfpg::TSOpcode::kCount && operand.has_value()) {
+    // COUNT(NULL) is rare, so it is left to DocExprExecutor.
+    if (IsNull(operand.value())) {
+      return false;
+    }
+    aggregates_.push_back(Aggregate { .kind = AggregateKind::kCountAll });
+    return true;
+  }
+  if (!operand.has_column_id()) {
+    return false;
+  }
+  const auto column_idx = projection_->ColumnIdxById(ColumnId(operand.column_id()));
+  if (column_idx == dockv::ReaderProjection::kNotFoundIndex) {
+    return false;
+  }
+  const auto data_type = projection_->columns[column_idx].data_type;
+  AggregateKind kind;
+  switch (opcode) {
+    case bfpg::TSOpcode::kCount:
+      kind = AggregateKind::kCount;
+      break;
+    case bfpg::TSOpcode::kSumInt8: [[fallthrough]];
+    case bfpg::TSOpcode::kSumInt16: [[fallthrough]];
+    case bfpg::TSOpcode::kSumInt32: [[fallthrough]];
+    case bfpg::TSOpcode::kSumInt64: [[fallthrough]];
+    case bfpg::TSOpcode::kSumFloat: [[fallthrough]];
+    case bfpg::TSOpcode::kSumDouble:
+      if (SumDataType(opcode) != data_type) {
+        return false;
+      }
+      kind = AggregateKind::kSum;
+      break;
+    case bfpg::TSOpcode::kMin: [[fallthrough]];
+    case bfpg::TSOpcode::kMax:
+      if (!IsSupportedNumericType(data_type)) {
+        return false;
+      }
+      kind = opcode == bfpg::TSOpcode::kMin ? AggregateKind::kMin : AggregateKind::kMax;
+      break;
+    default:
+      return false;
+  }
+  aggregates_.push_back(Aggregate {
+    .kind = kind,
+    .column_idx = column_idx,
+    .data_type = data_type,
+  });
+  return true;
+}
+
+void DocPgBatchAggregator::Apply(const dockv::PgTableRowBatch& batch, const uint8_t* selection) {
+  const auto size = batch.size();
+  for (auto& aggregate : aggregates_) {
+    if (aggregate.kind == AggregateKind::kCountAll) {
+      aggregate.count += selection ? CountMask(selection, size) : size;
+      continue;
+    }
+    // Mask of the rows that should be accumulated, i.e. selected and not NULL.
+    mask_.resize(size);
+    const auto* nulls = batch.NullFlags(aggregate.column_idx);
+    if (selection) {
+      for (size_t i = 0; i != size; ++i) {
+        mask_[i] = selection[i] & (nulls[i] ^ 1);
+      }
+    } else {
+      for (size_t i = 0; i != size; ++i) {
+        mask_[i] = nulls[i] ^ 1;
+      }
+    }
+    aggregate.Apply(batch.FixedValues(aggregate.column_idx), mask_.data(), size);
+  }
+}
+
+std::vector<QLValuePB> DocPgBatchAggregator::Results() const {
+  std::vector<QLValuePB> result;
+  result.reserve(aggregates_.size());
+  for (const auto& aggregate : aggregates_) {
+    result.push_back(aggregate.Result());
+  }
+  return result;
+}
+
+} // namespace yb::docdb
@@ -0,0 +1,70 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "yb/common/pgsql_protocol.fwd.h"
+#include "yb/common/value.pb.h"
+
+#include "yb/dockv/dockv_fwd.h"
+
+namespace yb::docdb {
+
+// DocPgBatchAggregator accumulates pushed down aggregates over dockv::PgTableRowBatch.
+//
+// Supported aggregates are COUNT of constant or column, SUM of integer and floating point columns
+// and MIN/MAX of integer and floating point columns. Values are accumulated directly from the
+// column arrays of the batch, w/o converting each of them to QLValuePB.
+//
+// Results are the same as produced by DocExprExecutor for the same targets. In particular floating
+// point sums are accumulated in the row order with the precision of the column type.
+class DocPgBatchAggregator {
+ public:
+  explicit DocPgBatchAggregator(std::reference_wrapper<const dockv::ReaderProjection> projection);
+  ~DocPgBatchAggregator();
+
+  DocPgBatchAggregator(DocPgBatchAggregator&&);
+  DocPgBatchAggregator& operator=(DocPgBatchAggregator&&);
+
+  // Adds target to the aggregator. Returns false if target is not supported, in this case
+  // aggregator is not changed.
+  bool TryAdd(const PgsqlExpressionPB& target);
+
+  bool empty() const {
+    return aggregates_.empty();
+  }
+
+  void Clear() {
+    aggregates_.clear();
+  }
+
+  // Accumulates rows of the batch. When selection is specified, only rows with non zero selection
+  // byte are accumulated.
+  void Apply(const dockv::PgTableRowBatch& batch, const uint8_t* selection = nullptr);
+
+  // Returns accumulated values, one per added target. Aggregate that did not accumulate any value
+  // is returned as NULL.
+  std::vector<QLValuePB> Results() const;
+
+ private:
+  struct Aggregate;
+
+  const dockv::ReaderProjection* projection_;
+  std::vector<Aggregate> aggregates_;
+  std::vector<uint8_t> mask_;
+};
+
+} // namespace yb::docdb
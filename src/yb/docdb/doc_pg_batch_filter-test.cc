@@ -0,0 +1,375 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_pg_batch_filter.h"
+#include "yb/docdb/doc_pg_expr.h"
+#include "yb/docdb/docdb_pgapi.h"
+
+#include "yb/dockv/pg_row.h"
+#include "yb/dockv/reader_projection.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/format.h"
+#include "yb/util/random_util.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb::docdb {
+
+namespace {
+
+constexpr int kMaxValue = 10;
+
+// Type and operator OIDs from pg_type.dat and pg_operator.dat.
+constexpr int kBoolOid = 16;
+constexpr int kInt2Oid = 21;
+constexpr int kInt4Oid = 23;
+constexpr int kInt8Oid = 20;
+constexpr int kFloat4Oid = 700;
+constexpr int kFloat8Oid = 701;
+constexpr int kInt4GeOperator = 525;
+constexpr int kInt4GeFunction = 150;
+constexpr int kFloat8LtOperator = 672;
+constexpr int kFloat8LtFunction = 295;
+
+// Helpers to build serialized Postgres expression, in the format produced by nodeToString.
+std::string PgVar(int attno, int type) {
+  return Format(
+      "{VAR :varno 1 :varattno $0 :vartype $1 :vartypmod -1 :varcollid 0 :varlevelsup 0 "
+      ":varnoold 1 :varoattno $0 :location -1}", attno, type);
+}
+
+std::string PgByValConst(int type, int len, uint64_t value) {
+  std::string bytes;
+  for (size_t i = 0; i != sizeof(value); ++i) {
+    bytes += Format("$0 ", static_cast<int>(static_cast<int8_t>(value >> (i * 8))));
+  }
+  return Format(
+      "{CONST :consttype $0 :consttypmod -1 :constcollid 0 :constlen $1 :constbyval true "
+      ":constisnull false :location -1 :constvalue $1 [ $2]}", type, len, bytes);
+}
+
+std::string PgOpExpr(int opno, int opfuncid, const std::string& lhs, const std::string& rhs) {
+  return Format(
+      "{OPEXPR :opno $0 :opfuncid $1 :opresulttype $2 :opretset false :opcollid 0 "
+      ":inputcollid 0 :args ($3 $4) :location -1}", opno, opfuncid, kBoolOid, lhs, rhs);
+}
+
+Schema BuildSchema() {
+  SchemaBuilder builder;
+  CHECK_OK(builder.AddHashKeyColumn("h", DataType::INT32));
+  CHECK_OK(builder.AddColumn("v_int16", DataType::INT16));
+  CHECK_OK(builder.AddNullableColumn("v_int32", DataType::INT32));
+  CHECK_OK(builder.AddNullableColumn("v_int64", DataType::INT64));
+  CHECK_OK(builder.AddColumn("v_float", DataType::FLOAT));
+  CHECK_OK(builder.AddNullableColumn("v_double", DataType::DOUBLE));
+  return builder.Build();
+}
+
+QLValuePB RandomValue(DataType data_type) {
+  QLValuePB result;
+  auto value = RandomUniformInt(-kMaxValue, kMaxValue);
+  switch (data_type) {
+    case DataType::INT16:
+      result.set_int16_value(value);
+      break;
+    case DataType::INT32:
+      result.set_int32_value(value);
+      break;
+    case DataType::INT64:
+      result.set_int64_value(value);
+      break;
+    case DataType::FLOAT:
+      result.set_float_value(value / 2.0f);
+      break;
+    case DataType::DOUBLE:
+      result.set_double_value(value / 2.0);
+      break;
+    default:
+      CHECK(false) << "Not supported data type: " << data_type;
+  }
+  return result;
+}
+
+QLValuePB RandomColumnValue(const ColumnSchema& column) {
+  if (column.is_nullable() && RandomUniformInt(0, 4) == 0) {
+    return QLValuePB();
+  }
+  if (column.type_info()->type == DataType::DOUBLE && RandomUniformInt(0, 8) == 0) {
+    QLValuePB result;
+    result.set_double_value(std::numeric_limits<double>::quiet_NaN());
+    return result;
+  }
+  return RandomValue(column.type_info()->type);
+}
+
+class DocPgBatchFilterTest : public YBTest {
+ protected:
+  DocPgBatchFilterTest() : schema_(BuildSchema()), projection_(schema_) {
+    static const std::vector<int> kTypeOids = {
+        kInt4Oid, kInt2Oid, kInt4Oid, kInt8Oid, kFloat4Oid, kFloat8Oid};
+    for (size_t idx = 0; idx != schema_.num_columns(); ++idx) {
+      auto& col_ref = *col_refs_.Add();
+      col_ref.set_column_id(schema_.column_id(idx));
+      col_ref.set_attno(narrow_cast<int32_t>(idx + 1));
+      col_ref.set_typid(kTypeOids[idx]);
+      col_ref.set_typmod(-1);
+    }
+  }
+
+  // Converts rows of the batch to PgTableRow, to be evaluated by DocPgExprExecutor.
+  void BatchToRows(const dockv::PgTableRowBatch& batch, std::vector<dockv::PgTableRow>* rows) {
+    for (size_t row_idx = 0; row_idx != batch.size(); ++row_idx) {
+      auto& row = rows->emplace_back(projection_);
+      for (size_t column_idx = 0; column_idx != projection_.size(); ++column_idx) {
+        auto value = batch.GetValue(row_idx, column_idx);
+        if (value) {
+          ASSERT_OK(row.SetValue(
+              projection_.columns[column_idx].id,
+              value->ToQLValuePB(projection_.columns[column_idx].data_type)));
+        }
+      }
+    }
+  }
+
+  // Serialized Postgres expression: v_int32 >= 0 AND v_double < 2.5
+  PgsqlExpressionPB PgExprWhereClause() {
+    auto expr = Format(
+        "{BOOLEXPR :boolop and :args ($0 $1) :location -1}",
+        PgOpExpr(kInt4GeOperator, kInt4GeFunction, PgVar(3, kInt4Oid),
+                 PgByValConst(kInt4Oid, 4, 0)),
+        PgOpExpr(kFloat8LtOperator, kFloat8LtFunction, PgVar(6, kFloat8Oid),
+                 PgByValConst(kFloat8Oid, 8, bit_cast<uint64_t>(2.5))));
+    PgsqlExpressionPB result;
+    auto& tscall = *result.mutable_tscall();
+    tscall.set_opcode(to_underlying(bfpg::TSOpcode::kPgEvalExprCall));
+    tscall.add_operands()->mutable_value()->set_string_value(expr);
+    return result;
+  }
+
+  void FillBatch(dockv::PgTableRowBatch* batch) {
+    dockv::PgTableRow row(projection_);
+    while (!batch->Full()) {
+      row.Reset();
+      for (size_t idx = 0; idx != schema_.num_columns(); ++idx) {
+        ASSERT_OK(row.SetValue(schema_.column_id(idx), RandomColumnValue(schema_.column(idx))));
+      }
+      batch->AppendRow(row);
+    }
+  }
+
+  // Generates random condition over value columns.
+  PgsqlExpressionPB RandomCondition() {
+    static const std::vector<QLOperator> kOps = {
+      QL_OP_EQUAL, QL_OP_NOT_EQUAL, QL_OP_LESS_THAN, QL_OP_LESS_THAN_EQUAL, QL_OP_GREATER_THAN,
+      QL_OP_GREATER_THAN_EQUAL, QL_OP_IN, QL_OP_NOT_IN, QL_OP_IS_NULL, QL_OP_IS_NOT_NULL,
+      QL_OP_AND,
+    };
+    PgsqlExpressionPB result;
+    auto& condition = *result.mutable_condition();
+    auto op = RandomElement(kOps);
+    condition.set_op(op);
+    if (op == QL_OP_AND) {
+      for (int i = 0; i != 2; ++i) {
+        *condition.add_operands() = RandomCondition();
+      }
+      return result;
+    }
+    auto column_idx = RandomUniformInt<size_t>(1, schema_.num_columns() - 1);
+    auto data_type = schema_.column(column_idx).type_info()->type;
+    auto& column = *condition.add_operands();
+    column.set_column_id(schema_.column_id(column_idx));
+    if (op == QL_OP_IS_NULL || op == QL_OP_IS_NOT_NULL) {
+      return result;
+    }
+    auto& value = *condition.add_operands()->mutable_value();
+    if (op == QL_OP_IN || op == QL_OP_NOT_IN) {
+      for (int i = RandomUniformInt(1, 4); i-- > 0;) {
+        *value.mutable_list_value()->add_elems() = RandomValue(data_type);
+      }
+      return result;
+    }
+    value = RandomValue(data_type);
+    if (RandomUniformBool()) {
+      // Put constant first.
+      condition.mutable_operands()->SwapElements(0, 1);
+    }
+    return result;
+  }
+
+  const Schema schema_;
+  const dockv::ReaderProjection projection_;
+  google::protobuf::RepeatedPtrField<PgsqlColRefPB> col_refs_;
+};
+
+} // namespace
+
+TEST_F(DocPgBatchFilterTest, Random) {
+  constexpr size_t kBatchSize = 253;
+  constexpr int kNumIterations = 200;
+
+  dockv::PgTableRowBatch batch(projection_, kBatchSize);
+  std::vector<uint8_t> selection;
+  for (int iteration = 0; iteration != kNumIterations; ++iteration) {
+    batch.Reset();
+    ASSERT_NO_FATALS(FillBatch(&batch));
+
+    std::vector<PgsqlExpressionPB> where_clauses(RandomUniformInt(1, 3));
+    DocPgBatchFilter filter(projection_);
+    DocPgExprExecutorBuilder builder(schema_, projection_);
+    for (auto& where_clause : where_clauses) {
+      where_clause = RandomCondition();
+      ASSERT_TRUE(filter.TryAdd(where_clause, col_refs_)) << where_clause.ShortDebugString();
+      ASSERT_OK(builder.AddWhere(where_clause));
+    }
+    auto executor = ASSERT_RESULT(builder.Build(std::vector<PgsqlColRefPB>()));
+
+    auto selected = filter.Eval(batch, &selection);
+    ASSERT_EQ(selection.size(), batch.size());
+    size_t expected_selected = 0;
+    dockv::PgTableRow row(projection_);
+    for (size_t row_idx = 0; row_idx != batch.size(); ++row_idx) {
+      row.Reset();
+      for (size_t column_idx = 0; column_idx != projection_.size(); ++column_idx) {
+        auto value = batch.GetValue(row_idx, column_idx);
+        if (value) {
+          ASSERT_OK(row.SetValue(
+              projection_.columns[column_idx].id,
+              value->ToQLValuePB(projection_.columns[column_idx].data_type)));
+        }
+      }
+      auto expected = ASSERT_RESULT(executor.Exec(row));
+      expected_selected += expected;
+      ASSERT_EQ(selection[row_idx] != 0, expected)
+          << "Row: " << row.ToString() << ", where: " << AsString(where_clauses);
+    }
+    ASSERT_EQ(selected, expected_selected);
+  }
+}
+
+TEST_F(DocPgBatchFilterTest, NotSupported) {
+  DocPgBatchFilter filter(projection_);
+
+  // Comparison of two columns.
+  PgsqlExpressionPB where_clause;
+  auto& condition = *where_clause.mutable_condition();
+  condition.set_op(QL_OP_EQUAL);
+  condition.add_operands()->set_column_id(schema_.column_id(1));
+  condition.add_operands()->set_column_id(schema_.column_id(1));
+  ASSERT_FALSE(filter.TryAdd(where_clause, col_refs_));
+
+  // Constant of different type.
+  condition.mutable_operands(1)->mutable_value()->set_int64_value(1);
+  ASSERT_FALSE(filter.TryAdd(where_clause, col_refs_));
+
+  // NaN constant.
+  condition.mutable_operands(0)->set_column_id(schema_.column_id(5));
+  condition.mutable_operands(1)->mutable_value()->set_double_value(
+      std::numeric_limits<double>::quiet_NaN());
+  ASSERT_FALSE(filter.TryAdd(where_clause, col_refs_));
+
+  // Serialized Postgres expression that could not be converted to condition.
+  where_clause.mutable_tscall()->set_opcode(to_underlying(bfpg::TSOpcode::kPgEvalExprCall));
+  ASSERT_FALSE(filter.TryAdd(where_clause, col_refs_));
+
+  ASSERT_TRUE(filter.empty());
+}
+
+// Serialized Postgres expression converted to condition should select the same rows as evaluated
+// by Postgres.
+TEST_F(DocPgBatchFilterTest, PgExpression) {
+  constexpr size_t kBatchSize = 253;
+  ASSERT_OK(DocPgInit());
+
+  dockv::PgTableRowBatch batch(projection_, kBatchSize);
+  ASSERT_NO_FATALS(FillBatch(&batch));
+  std::vector<dockv::PgTableRow> rows;
+  ASSERT_NO_FATALS(BatchToRows(batch, &rows));
+
+  auto where_clause = PgExprWhereClause();
+  DocPgBatchFilter filter(projection_);
+  ASSERT_TRUE(filter.TryAdd(where_clause, col_refs_));
+  DocPgExprExecutorBuilder builder(schema_, projection_);
+  ASSERT_OK(builder.AddWhere(where_clause));
+  auto executor = ASSERT_RESULT(builder.Build(col_refs_));
+
+  std::vector<uint8_t> selection;
+  filter.Eval(batch, &selection);
+  for (size_t row_idx = 0; row_idx != rows.size(); ++row_idx) {
+    ASSERT_EQ(selection[row_idx] != 0, ASSERT_RESULT(executor.Exec(rows[row_idx])))
+        << "Row: " << rows[row_idx].ToString();
+  }
+}
+
+// Compares batch filter with row by row evaluation of the same serialized Postgres expression by
+// DocPgExprExecutor, i.e. the way such expressions are evaluated w/o batch filter.
+TEST_F(DocPgBatchFilterTest, Benchmark) {
+  constexpr size_t kBatchSize = 1024;
+  const int kNumRuns = AllowSlowTests() ? 10000 : 200;
+  ASSERT_OK(DocPgInit());
+
+  dockv::PgTableRowBatch batch(projection_, kBatchSize);
+  ASSERT_NO_FATALS(FillBatch(&batch));
+
+  auto where_clause = PgExprWhereClause();
+  DocPgBatchFilter filter(projection_);
+  ASSERT_TRUE(filter.TryAdd(where_clause, col_refs_));
+  DocPgExprExecutorBuilder builder(schema_, projection_);
+  ASSERT_OK(builder.AddWhere(where_clause));
+  auto executor = ASSERT_RESULT(builder.Build(col_refs_));
+
+  std::vector<dockv::PgTableRow> rows;
+  ASSERT_NO_FATALS(BatchToRows(batch, &rows));
+
+  const auto num_rows = kNumRuns * kBatchSize;
+  size_t batch_selected = 0;
+  std::vector<uint8_t> selection;
+  Stopwatch batch_sw;
+  batch_sw.start();
+  for (int run = 0; run != kNumRuns; ++run) {
+    batch_selected += filter.Eval(batch, &selection);
+  }
+  batch_sw.stop();
+  auto batch_time = batch_sw.elapsed().wall_seconds();
+
+  size_t row_selected = 0;
+  Stopwatch row_sw;
+  row_sw.start();
+  for (int run = 0; run != kNumRuns; ++run) {
+    for (const auto& row : rows) {
+      row_selected += ASSERT_RESULT(executor.Exec(row));
+    }
+  }
+  row_sw.stop();
+  auto row_time = row_sw.elapsed().wall_seconds();
+
+  ASSERT_EQ(batch_selected, row_selected);
+  LOG(INFO) << "Batch filter: " << num_rows / batch_time << " rows/sec, "
+            << "row by row: " << num_rows / row_time << " rows/sec";
+}
+
+} // namespace yb::docdb
@@ -0,0 +1,592 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_pg_batch_filter.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <cmath>
+#include <optional>
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/ql_datatype.h"
+
+#include "yb/docdb/doc_pg_expr_condition.h"
+
+#include "yb/dockv/pg_row.h"
+#include "yb/dockv/reader_projection.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/cpu.h"
+
+#include "yb/util/cast.h"
+#include "yb/util/enums.h"
+#include "yb/util/logging.h"
+
+namespace yb::docdb {
+
+namespace {
+
+YB_DEFINE_ENUM(PredicateKind, (kCompare)(kIn)(kNotIn)(kIsNull)(kIsNotNull));
+YB_DEFINE_ENUM(CompareOp, (kEqual)(kNotEqual)(kLess)(kLessEqual)(kGreater)(kGreaterEqual));
+YB_DEFINE_ENUM(ValueDomain, (kInt)(kFloat)(kDouble));
+
+// How values of column with particular data type are compared.
+struct ColumnDomain {
+  ValueDomain domain;
+  // Integer values are stored in the low bits of PgValueDatum, possibly w/o sign extension.
+  // So they are shifted left by this amount before comparison, which preserves the order of
+  // signed values.
+  int shift;
+  // Type of the constant that could be compared with this column.
+  InternalType value_case;
+};
+
+std::optional<ColumnDomain> GetColumnDomain(DataType data_type) {
+  switch (data_type) {
+    case DataType::INT8:
+      return ColumnDomain{ValueDomain::kInt, 56, InternalType::kInt8Value};
+    case DataType::INT16:
+      return ColumnDomain{ValueDomain::kInt, 48, InternalType::kInt16Value};
+    case DataType::INT32:
+      return ColumnDomain{ValueDomain::kInt, 32, InternalType::kInt32Value};
+    case DataType::INT64:
+      return ColumnDomain{ValueDomain::kInt, 0, InternalType::kInt64Value};
+    case DataType::UINT32:
+      return ColumnDomain{ValueDomain::kInt, 0, InternalType::kUint32Value};
+    case DataType::BOOL:
+      return ColumnDomain{ValueDomain::kInt, 0, InternalType::kBoolValue};
+    case DataType::FLOAT:
+      return ColumnDomain{ValueDomain::kFloat, 0, InternalType::kFloatValue};
+    case DataType::DOUBLE:
+      return ColumnDomain{ValueDomain::kDouble, 0, InternalType::kDoubleValue};
+    default:
+      return std::nullopt;
+  }
+}
+
+int64_t IntConstant(const QLValuePB& value) {
+  switch (value.value_case()) {
+    case InternalType::kInt8Value:
+      return value.int8_value();
+    case InternalType::kInt16Value:
+      return value.int16_value();
+    case InternalType::kInt32Value:
+      return value.int32_value();
+    case InternalType::kInt64Value:
+      return value.int64_value();
+    case InternalType::kUint32Value:
+      return value.uint32_value();
+    case InternalType::kBoolValue:
+      return value.bool_value();
+    default:
+      break;
+  }
+  LOG(DFATAL) << "Unexpected constant: " << value.ShortDebugString();
+  return 0;
+}
+
+std::optional<double> DoubleConstant(const QLValuePB& value) {
+  double result = value.value_case() == InternalType::kFloatValue ? value.float_value()
+                                                                  : value.double_value();
+  if (std::isnan(result)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+std::optional<CompareOp> ToCompareOp(QLOperator op) {
+  switch (op) {
+    case QL_OP_EQUAL:
+      return CompareOp::kEqual;
+    case QL_OP_NOT_EQUAL:
+      return CompareOp::kNotEqual;
+    case QL_OP_LESS_THAN:
+      return CompareOp::kLess;
+    case QL_OP_LESS_THAN_EQUAL:
+      return CompareOp::kLessEqual;
+    case QL_OP_GREATER_THAN:
+      return CompareOp::kGreater;
+    case QL_OP_GREATER_THAN_EQUAL:
+      return CompareOp::kGreaterEqual;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Returns op, such that (a op b) == (b result a).
+CompareOp Mirror(CompareOp op) {
+  switch (op) {
+    case CompareOp::kEqual: [[fallthrough]];
+    case CompareOp::kNotEqual:
+      return op;
+    case CompareOp::kLess:
+      return CompareOp::kGreater;
+    case CompareOp::kLessEqual:
+      return CompareOp::kGreaterEqual;
+    case CompareOp::kGreater:
+      return CompareOp::kLess;
+    case CompareOp::kGreaterEqual:
+      return CompareOp::kLessEqual;
+  }
+  FATAL_INVALID_ENUM_VALUE(CompareOp, op);
+}
+
+// QLValuePB considers NaN to be greater than any other value. Since constant could not be NaN,
+// NaN column value satisfies only kNotEqual, kGreater and kGreaterEqual. So the last two are
+// expressed via negation of ordered comparison.
+template <CompareOp kOp, class T>
+inline bool Compare(T lhs, T rhs) {
+  if constexpr (kOp == CompareOp::kEqual) {
+    return lhs == rhs;
+  } else if constexpr (kOp == CompareOp::kNotEqual) {
+    return lhs != rhs;
+  } else if constexpr (kOp == CompareOp::kLess) {
+    return lhs < rhs;
+  } else if constexpr (kOp == CompareOp::kLessEqual) {
+    return lhs <= rhs;
+  } else if constexpr (kOp == CompareOp::kGreater) {
+    return !(lhs <= rhs);
+  } else {
+    return !(lhs < rhs);
+  }
+}
+
+inline int64_t LoadInt(dockv::PgValueDatum datum, int shift) {
+  return static_cast<int64_t>(datum << shift);
+}
+
+inline double LoadFloat(dockv::PgValueDatum datum) {
+  return bit_cast<float>(static_cast<uint32_t>(datum));
+}
+
+inline double LoadDouble(dockv::PgValueDatum datum) {
+  return bit_cast<double>(static_cast<uint64_t>(datum));
+}
+
+template <CompareOp kOp>
+void CompareIntsScalar(
+    const dockv::PgValueDatum* values, size_t begin, size_t end, int shift, int64_t arg,
+    uint8_t* out) {
+  for (auto i = begin; i != end; ++i) {
+    out[i] = Compare<kOp>(LoadInt(values[i], shift), arg);
+  }
+}
+
+template <CompareOp kOp>
+void CompareDoublesScalar(
+    const dockv::PgValueDatum* values, size_t begin, size_t end, bool is_float, double arg,
+    uint8_t* out) {
+  if (is_float) {
+    for (auto i = begin; i != end; ++i) {
+      out[i] = Compare<kOp>(LoadFloat(values[i]), arg);
+    }
+  } else {
+    for (auto i = begin; i != end; ++i) {
+      out[i] = Compare<kOp>(LoadDouble(values[i]), arg);
+    }
+  }
+}
+
+#if defined(__x86_64__)
+
+bool CpuHasAvx2() {
+  static const bool result = base::CPU().has_avx2();
+  return result;
+}
+
+inline void StoreMask4(int bits, uint8_t* out) {
+  out[0] = bits & 1;
+  out[1] = (bits >> 1) & 1;
+  out[2] = (bits >> 2) & 1;
+  out[3] = (bits >> 3) & 1;
+}
+
+template <CompareOp kOp>
+__attribute__((target("avx2"))) size_t CompareIntsAvx2(
+    const dockv::PgValueDatum* values, size_t size, int shift, int64_t arg, uint8_t* out) {
+  const auto arg_vec = _mm256_set1_epi64x(arg);
+  const auto shift_vec = _mm_cvtsi32_si128(shift);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    auto value = _mm256_sll_epi64(
+        _mm256_loadu_si256(pointer_cast<const __m256i*>(values + i)), shift_vec);
+    __m256i mask;
+    bool invert = false;
+    if constexpr (kOp == CompareOp::kEqual || kOp == CompareOp::kNotEqual) {
+      mask = _mm256_cmpeq_epi64(value, arg_vec);
+      invert = kOp == CompareOp::kNotEqual;
+    } else if constexpr (kOp == CompareOp::kGreater || kOp == CompareOp::kLessEqual) {
+      mask = _mm256_cmpgt_epi64(value, arg_vec);
+      invert = kOp == CompareOp::kLessEqual;
+    } else {
+      mask = _mm256_cmpgt_epi64(arg_vec, value);
+      invert = kOp == CompareOp::kGreaterEqual;
+    }
+    auto bits = _mm256_movemask_pd(_mm256_castsi256_pd(mask));
+    StoreMask4(invert ? ~bits : bits, out + i);
+  }
+  return i;
+}
+
+template <CompareOp kOp>
+constexpr int DoublePredicate() {
+  if constexpr (kOp == CompareOp::kEqual) {
+    return _CMP_EQ_OQ;
+  } else if constexpr (kOp == CompareOp::kNotEqual) {
+    return _CMP_NEQ_UQ;
+  } else if constexpr (kOp == CompareOp::kLess) {
+    return _CMP_LT_OQ;
+  } else if constexpr (kOp == CompareOp::kLessEqual) {
+    return _CMP_LE_OQ;
+  } else if constexpr (kOp == CompareOp::kGreater) {
+    return _CMP_NLE_UQ;
+  } else {
+    return _CMP_NLT_UQ;
+  }
+}
+
+template <CompareOp kOp>
+__attribute__((target("avx2"))) size_t CompareDoublesAvx2(
+    const dockv::PgValueDatum* values, size_t size, double arg, uint8_t* out) {
+  const auto arg_vec = _mm256_set1_pd(arg);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    auto value = _mm256_loadu_pd(pointer_cast<const double*>(values + i));
+    auto mask = _mm256_cmp_pd(value, arg_vec, DoublePredicate<kOp>());
+    StoreMask4(_mm256_movemask_pd(mask), out + i);
+  }
+  return i;
+}
+
+#endif
+
+template <CompareOp kOp>
+void CompareInts(
+    const dockv::PgValueDatum* values, size_t size, int shift, int64_t arg, uint8_t* out) {
+  size_t processed = 0;
+#if defined(__x86_64__)
+  if (CpuHasAvx2()) {
+    processed = CompareIntsAvx2<kOp>(values, size, shift, arg, out);
+  }
+#endif
+  CompareIntsScalar<kOp>(values, processed, size, shift, arg, out);
+}
+
+template <CompareOp kOp>
+void CompareDoubles(
+    const dockv::PgValueDatum* values, size_t size, bool is_float, double arg, uint8_t* out) {
+  size_t processed = 0;
+#if defined(__x86_64__)
+  if (!is_float && CpuHasAvx2()) {
+    processed = CompareDoublesAvx2<kOp>(values, size, arg, out);
+  }
+#endif
+  CompareDoublesScalar<kOp>(values, processed, size, is_float, arg, out);
+}
+
+template <CompareOp kOp>
+void CompareValues(
+    const dockv::PgValueDatum* values, size_t size, ValueDomain domain, int shift,
+    int64_t int_arg, double double_arg, uint8_t* out) {
+  if (domain == ValueDomain::kInt) {
+    CompareInts<kOp>(values, size, shift, int_arg, out);
+  } else {
+    CompareDoubles<kOp>(values, size, domain == ValueDomain::kFloat, double_arg, out);
+  }
+}
+
+void CompareValues(
+    CompareOp op, const dockv::PgValueDatum* values, size_t size, ValueDomain domain, int shift,
+    int64_t int_arg, double double_arg, uint8_t* out) {
+  switch (op) {
+    case CompareOp::kEqual:
+      CompareValues<CompareOp::kEqual>(values, size, domain, shift, int_arg, double_arg, out);
+      return;
+    case CompareOp::kNotEqual:
+      CompareValues<CompareOp::kNotEqual>(values, size, domain, shift, int_arg, double_arg, out);
+      return;
+    case CompareOp::kLess:
+      CompareValues<CompareOp::kLess>(values, size, domain, shift, int_arg, double_arg, out);
+      return;
+    case CompareOp::kLessEqual:
+      CompareValues<CompareOp::kLessEqual>(values, size, domain, shift, int_arg, double_arg, out);
+      return;
+    case CompareOp::kGreater:
+      CompareValues<CompareOp::kGreater>(values, size, domain, shift, int_arg, double_arg, out);
+      return;
+    case CompareOp::kGreaterEqual:
+      CompareValues<CompareOp::kGreaterEqual>(
+          values, size, domain, shift, int_arg, double_arg, out);
+      return;
+  }
+  FATAL_INVALID_ENUM_VALUE(CompareOp, op);
+}
+
+} // namespace
+
+struct DocPgBatchFilter::Predicate {
+  PredicateKind kind;
+  size_t column_idx;
+  ValueDomain domain = ValueDomain::kInt;
+  int shift = 0;
+  CompareOp op = CompareOp::kEqual;
+  // Arguments of comparison or IN list. Integer arguments are already shifted.
+  std::vector<int64_t> int_args;
+  std::vector<double> double_args;
+
+  size_t num_args() const {
+    return domain == ValueDomain::kInt ? int_args.size() : double_args.size();
+  }
+
+  int64_t int_arg(size_t idx) const {
+    return domain == ValueDomain::kInt ? int_args[idx] : 0;
+  }
+
+  double double_arg(size_t idx) const {
+    return domain == ValueDomain::kInt ? 0 : double_args[idx];
+  }
+};
+
+DocPgBatchFilter::DocPgBatchFilter(
+    std::reference_wrapper<const dockv::ReaderProjection> projection)
+    : projection_(&projection.get()) {
+}
+
+DocPgBatchFilter::~DocPgBatchFilter() = default;
+
+DocPgBatchFilter::DocPgBatchFilter(DocPgBatchFilter&&) = default;
+DocPgBatchFilter& DocPgBatchFilter::operator=(DocPgBatchFilter&&) = default;
+
+bool DocPgBatchFilter::TryAdd(
+    const PgsqlExpressionPB& where_clause,
+    const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs) {
+  const PgsqlConditionPB* condition = nullptr;
+  PgsqlConditionPB converted_condition;
+  if (where_clause.has_condition()) {
+    condition = &where_clause.condition();
+  } else if (ConvertPgExprToCondition(where_clause, col_refs, &converted_condition)) {
+    condition = &converted_condition;
+  } else {
+    VLOG_WITH_FUNC(4) << "Not supported: " << where_clause.ShortDebugString();
+    return false;
+  }
+  std::vector<Predicate> predicates;
+  if (!Compile(*condition, &predicates)) {
+    VLOG_WITH_FUNC(4) << "Not supported: " << where_clause.ShortDebugString();
+    return false;
+  }
+  for (auto& predicate : predicates) {
+    predicates_.push_back(std::move(predicate));
+  }
+  return true;
+}
+
+bool DocPgBatchFilter::Compile(
+    const PgsqlConditionPB& condition, std::vector<Predicate>* out) const {
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_AND:
+      for (const auto& operand : operands) {
+        if (!operand.has_condition() || !Compile(operand.condition(), out)) {
+          return false;
+        }
+      }
+      return !operands.empty();
+
+    case QL_OP_IS_NULL: [[fallthrough]];
+    case QL_OP_IS_NOT_NULL: {
+      if (operands.size() != 1 || !operands.Get(0).has_column_id()) {
+        return false;
+      }
+      auto column_idx = projection_->ColumnIdxById(ColumnId(operands.Get(0).column_id()));
+      if (column_idx == dockv::ReaderProjection::kNotFoundIndex) {
+        return false;
+      }
+      out->push_back(Predicate {
+        .kind = condition.op() == QL_OP_IS_NULL ? PredicateKind::kIsNull
+                                                : PredicateKind::kIsNotNull,
+        .column_idx = column_idx,
+      });
+      return true;
+    }
+
+    case QL_OP_EQUAL: [[fallthrough]];
+    case QL_OP_NOT_EQUAL: [[fallthrough]];
+    case QL_OP_LESS_THAN: [[fallthrough]];
+    case QL_OP_LESS_THAN_EQUAL: [[fallthrough]];
+    case QL_OP_GREATER_THAN: [[fallthrough]];
+    case QL_OP_GREATER_THAN_EQUAL:
+      return operands.size() == 2 &&
+             CompileComparison(condition.op(), operands.Get(0), operands.Get(1), out);
+
+    case QL_OP_IN: [[fallthrough]];
+    case QL_OP_NOT_IN: {
+      if (operands.size() != 2 || !operands.Get(0).has_column_id() ||
+          !operands.Get(1).has_value() || !operands.Get(1).value().has_list_value()) {
+        return false;
+      }
+      auto column_idx = projection_->ColumnIdxById(ColumnId(operands.Get(0).column_id()));
+      if (column_idx == dockv::ReaderProjection::kNotFoundIndex) {
+        return false;
+      }
+      auto column_domain = GetColumnDomain(projection_->columns[column_idx].data_type);
+      if (!column_domain) {
+        return false;
+      }
+      Predicate predicate {
+        .kind = condition.op() == QL_OP_IN ? PredicateKind::kIn : PredicateKind::kNotIn,
+        .column_idx = column_idx,
+        .domain = column_domain->domain,
+        .shift = column_domain->shift,
+      };
+      for (const auto& elem : operands.Get(1).value().list_value().elems()) {
+        if (elem.value_case() != column_domain->value_case) {
+          return false;
+        }
+        if (predicate.domain == ValueDomain::kInt) {
+          predicate.int_args.push_back(
+              static_cast<int64_t>(static_cast<uint64_t>(IntConstant(elem)) << predicate.shift));
+        } else {
+          auto arg = DoubleConstant(elem);
+          if (!arg) {
+            return false;
+          }
+          predicate.double_args.push_back(*arg);
+        }
+      }
+      out->push_back(std::move(predicate));
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+bool DocPgBatchFilter::CompileComparison(
+    QLOperator ql_op, const PgsqlExpressionPB& lhs, const PgsqlExpressionPB& rhs,
+    std::vector<Predicate>* out) const {
+  auto op = ToCompareOp(ql_op);
+  if (!op) {
+    return false;
+  }
+  const PgsqlExpressionPB* column = &lhs;
+  const PgsqlExpressionPB* constant = &rhs;
+  if (!column->has_column_id()) {
+    std::swap(column, constant);
+    *op = Mirror(*op);
+  }
+  if (!column->has_column_id() || !constant->has_value()) {
+    return false;
+  }
+  auto column_idx = projection_->ColumnIdxById(ColumnId(column->column_id()));
+  if (column_idx == dockv::ReaderProjection::kNotFoundIndex) {
+    return false;
+  }
+  auto column_domain = GetColumnDomain(projection_->columns[column_idx].data_type);
+  const auto& value = constant->value();
+  if (!column_domain || value.value_case() != column_domain->value_case) {
+    return false;
+  }
+  Predicate predicate {
+    .kind = PredicateKind::kCompare,
+    .column_idx = column_idx,
+    .domain = column_domain->domain,
+    .shift = column_domain->shift,
+    .op = *op,
+  };
+  if (predicate.domain == ValueDomain::kInt) {
+    predicate.int_args.push_back(
+        static_cast<int64_t>(static_cast<uint64_t>(IntConstant(value)) << predicate.shift));
+  } else {
+    auto arg = DoubleConstant(value);
+    if (!arg) {
+      return false;
+    }
+    predicate.double_args.push_back(*arg);
+  }
+  out->push_back(std::move(predicate));
+  return true;
+}
+
+size_t DocPgBatchFilter::Eval(
+    const dockv::PgTableRowBatch& batch, std::vector<uint8_t>* selection) const {
+  const auto size = batch.size();
+  selection->assign(size, 1);
+  for (const auto& predicate : predicates_) {
+    Eval(predicate, batch, selection->data());
+  }
+  size_t result = 0;
+  for (auto selected : *selection) {
+    result += selected;
+  }
+  return result;
+}
+
+void DocPgBatchFilter::Eval(
+    const Predicate& predicate, const dockv::PgTableRowBatch& batch, uint8_t* selection) const {
+  const auto size = batch.size();
+  const auto* nulls = batch.NullFlags(predicate.column_idx);
+  switch (predicate.kind) {
+    case PredicateKind::kIsNull:
+      for (size_t i = 0; i != size; ++i) {
+        selection[i] &= nulls[i];
+      }
+      return;
+    case PredicateKind::kIsNotNull:
+      for (size_t i = 0; i != size; ++i) {
+        selection[i] &= nulls[i] ^ 1;
+      }
+      return;
+    case PredicateKind::kCompare: {
+      temp_.resize(size);
+      auto* matches = temp_.data();
+      CompareValues(
+          predicate.op, batch.FixedValues(predicate.column_idx), size, predicate.domain,
+          predicate.shift, predicate.int_arg(0), predicate.double_arg(0), matches);
+      // NULL satisfies only NOT EQUAL, the same as in QLValuePB comparison.
+      const uint8_t null_matches = predicate.op == CompareOp::kNotEqual;
+      for (size_t i = 0; i != size; ++i) {
+        selection[i] &= nulls[i] ? null_matches : matches[i];
+      }
+      return;
+    }
+    case PredicateKind::kIn: [[fallthrough]];
+    case PredicateKind::kNotIn: {
+      temp_.assign(size * 2, 0);
+      auto* any_match = temp_.data();
+      auto* matches = any_match + size;
+      const auto* values = batch.FixedValues(predicate.column_idx);
+      for (size_t arg_idx = 0; arg_idx != predicate.num_args(); ++arg_idx) {
+        CompareValues(
+            CompareOp::kEqual, values, size, predicate.domain, predicate.shift,
+            predicate.int_arg(arg_idx), predicate.double_arg(arg_idx), matches);
+        for (size_t i = 0; i != size; ++i) {
+          any_match[i] |= matches[i];
+        }
+      }
+      // NULL does not match any list element, so it satisfies NOT IN.
+      const uint8_t invert = predicate.kind == PredicateKind::kNotIn;
+      for (size_t i = 0; i != size; ++i) {
+        selection[i] &= nulls[i] ? invert : any_match[i] ^ invert;
+      }
+      return;
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(PredicateKind, predicate.kind);
+}
+
+} // namespace yb::docdb
@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <google/protobuf/repeated_field.h>
+
+#include "yb/common/pgsql_protocol.fwd.h"
+#include "yb/common/value.pb.h"
+
+#include "yb/dockv/dockv_fwd.h"
+
+namespace yb::docdb {
+
+// DocPgBatchFilter evaluates simple pushed down conditions over dockv::PgTableRowBatch.
+//
+// Supported conditions are:
+// - comparison of fixed size numeric column with a constant of the same type,
+// - IN/NOT IN list of such constants,
+// - IS NULL/IS NOT NULL on any column,
+// - AND of supported conditions.
+// Results are the same as produced by QLExprExecutor, in particular NULL column value satisfies
+// only NOT EQUAL and NOT IN conditions, and NaN is greater than any other value.
+//
+// Serialized Postgres expressions are accepted when ConvertPgExprToCondition converts them to
+// the equivalent condition.
+//
+// Conditions are evaluated column by column for all rows of the batch and produce selection
+// mask with one byte per row. Comparison kernels use AVX2 when it is supported by the CPU,
+// with scalar fallback otherwise.
+//
+// Conditions that are not supported should be evaluated by DocPgExprExecutor.
+class DocPgBatchFilter {
+ public:
+  explicit DocPgBatchFilter(std::reference_wrapper<const dockv::ReaderProjection> projection);
+  ~DocPgBatchFilter();
+
+  DocPgBatchFilter(DocPgBatchFilter&&);
+  DocPgBatchFilter& operator=(DocPgBatchFilter&&);
+
+  // Adds where clause to the filter, col_refs are used to resolve columns of serialized Postgres
+  // expression. Returns false if where clause is not supported, in this case filter is not
+  // changed.
+  bool TryAdd(
+      const PgsqlExpressionPB& where_clause,
+      const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs);
+
+  bool empty() const {
+    return predicates_.empty();
+  }
+
+  void Clear() {
+    predicates_.clear();
+  }
+
+  // Fills selection with one byte per row of the batch. The byte is 1 if row satisfies all added
+  // conditions and 0 otherwise.
+  // Returns number of selected rows.
+  size_t Eval(const dockv::PgTableRowBatch& batch, std::vector<uint8_t>* selection) const;
+
+ private:
+  struct Predicate;
+
+  bool Compile(const PgsqlConditionPB& condition, std::vector<Predicate>* out) const;
+  bool CompileComparison(
+      QLOperator op, const PgsqlExpressionPB& lhs, const PgsqlExpressionPB& rhs,
+      std::vector<Predicate>* out) const;
+
+  void Eval(
+      const Predicate& predicate, const dockv::PgTableRowBatch& batch, uint8_t* selection) const;
+
+  const dockv::ReaderProjection* projection_;
+  std::vector<Predicate> predicates_;
+  mutable std::vector<uint8_t> temp_;
+};
+
+} // namespace yb::docdb
@@ -0,0 +1,213 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/pgsql_protocol.pb.h"
+
+#include "yb/docdb/doc_pg_expr_condition.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/endian.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/format.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb::docdb {
+
+namespace {
+
+constexpr int kInt4Oid = 23;
+constexpr int kInt8Oid = 20;
+constexpr int kFloat8Oid = 701;
+constexpr int kTextOid = 25;
+
+// Operator OIDs from pg_operator.dat.
+constexpr int kInt4Eq = 96;
+constexpr int kInt4Lt = 97;
+constexpr int kInt4Ne = 518;
+constexpr int kInt8Eq = 410;
+constexpr int kInt8Ne = 411;
+constexpr int kFloat8Ge = 675;
+
+std::string Var(int attno, int type) {
+  return Format(
+      "{VAR :varno 1 :varattno $0 :vartype $1 :vartypmod -1 :varcollid 0 :varlevelsup 0 "
+      ":varnoold 1 :varoattno $0 :location -1}", attno, type);
+}
+
+std::string Datum(const std::string& bytes) {
+  std::string result = Format("$0 [ ", bytes.size());
+  for (auto ch : bytes) {
+    result += Format("$0 ", static_cast<int>(ch));
+  }
+  return result + "]";
+}
+
+std::string ByValConst(int type, uint64_t value) {
+  std::string bytes(sizeof(uint64_t), 0);
+  LittleEndian::Store64(bytes.data(), value);
+  return Format(
+      "{CONST :consttype $0 :consttypmod -1 :constcollid 0 :constlen 8 :constbyval true "
+      ":constisnull false :location -1 :constvalue $1}", type, Datum(bytes));
+}
+
+std::string Int8ArrayConst(const std::vector<int64_t>& values) {
+  std::string bytes(24 + values.size() * sizeof(int64_t), 0);
+  LittleEndian::Store32(bytes.data(), static_cast<uint32_t>(bytes.size() << 2));
+  LittleEndian::Store32(bytes.data() + 4, 1);
+  LittleEndian::Store32(bytes.data() + 8, 0);
+  LittleEndian::Store32(bytes.data() + 12, kInt8Oid);
+  LittleEndian::Store32(bytes.data() + 16, static_cast<uint32_t>(values.size()));
+  LittleEndian::Store32(bytes.data() + 20, 1);
+  for (size_t i = 0; i != values.size(); ++i) {
+    LittleEndian::Store64(bytes.data() + 24 + i * sizeof(int64_t), values[i]);
+  }
+  return Format(
+      "{CONST :consttype 1016 :consttypmod -1 :constcollid 0 :constlen -1 :constbyval false "
+      ":constisnull false :location -1 :constvalue $0}", Datum(bytes));
+}
+
+std::string OpExpr(int opno, const std::string& lhs, const std::string& rhs) {
+  return Format(
+      "{OPEXPR :opno $0 :opfuncid 0 :opresulttype 16 :opretset false :opcollid 0 "
+      ":inputcollid 0 :args ($1 $2) :location -1}", opno, lhs, rhs);
+}
+
+std::string ScalarArrayOpExpr(int opno, bool use_or, const std::string& array) {
+  return Format(
+      "{SCALARARRAYOPEXPR :opno $0 :opfuncid 0 :useOr $1 :inputcollid 0 :args ($2 $3) "
+      ":location -1}", opno, use_or ? "true" : "false", Var(3, kInt8Oid), array);
+}
+
+std::string NullTest(int attno, int null_test_type) {
+  return Format(
+      "{NULLTEST :arg $0 :nulltesttype $1 :argisrow false :location -1}",
+      Var(attno, kInt4Oid), null_test_type);
+}
+
+std::string BoolExpr(const std::string& op, const std::string& lhs, const std::string& rhs) {
+  return Format("{BOOLEXPR :boolop $0 :args ($1 $2) :location -1}", op, lhs, rhs);
+}
+
+class DocPgExprConditionTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    // attno 2 - column 11, attno 3 - column 12, attno 4 - column 13.
+    for (int attno = 2; attno != 5; ++attno) {
+      auto& col_ref = *col_refs_.Add();
+      col_ref.set_attno(attno);
+      col_ref.set_column_id(attno + 9);
+    }
+  }
+
+  // Returns condition in the text format, or empty string when expression is not supported.
+  std::string Convert(const std::string& expr) {
+    PgsqlExpressionPB where_clause;
+    auto& tscall = *where_clause.mutable_tscall();
+    tscall.set_opcode(to_underlying(bfpg::TSOpcode::kPgEvalExprCall));
+    tscall.add_operands()->mutable_value()->set_string_value(expr);
+    PgsqlConditionPB condition;
+    if (!ConvertPgExprToCondition(where_clause, col_refs_, &condition)) {
+      return std::string();
+    }
+    return condition.ShortDebugString();
+  }
+
+  google::protobuf::RepeatedPtrField<PgsqlColRefPB> col_refs_;
+};
+
+} // namespace
+
+TEST_F(DocPgExprConditionTest, Comparison) {
+  ASSERT_EQ(
+      Convert(OpExpr(kInt4Lt, Var(2, kInt4Oid), ByValConst(kInt4Oid, 5))),
+      "op: QL_OP_LESS_THAN operands { column_id: 11 } operands { value { int32_value: 5 } }");
+  // Negative value and constant before column.
+  ASSERT_EQ(
+      Convert(OpExpr(kInt4Eq, ByValConst(kInt4Oid, static_cast<uint32_t>(-7)), Var(2, kInt4Oid))),
+      "op: QL_OP_EQUAL operands { value { int32_value: -7 } } operands { column_id: 11 }");
+  ASSERT_EQ(
+      Convert(OpExpr(kFloat8Ge, Var(4, kFloat8Oid), ByValConst(kFloat8Oid, bit_cast<uint64_t>(
+          2.5)))),
+      "op: QL_OP_GREATER_THAN_EQUAL operands { column_id: 13 } "
+      "operands { value { double_value: 2.5 } }");
+  // Postgres does not select NULL for <>, while PgsqlConditionPB does.
+  ASSERT_EQ(
+      Convert(OpExpr(kInt4Ne, Var(2, kInt4Oid), ByValConst(kInt4Oid, 5))),
+      "op: QL_OP_AND "
+      "operands { condition { op: QL_OP_IS_NOT_NULL operands { column_id: 11 } } } "
+      "operands { condition { op: QL_OP_NOT_EQUAL operands { column_id: 11 } "
+      "operands { value { int32_value: 5 } } } }");
+}
+
+TEST_F(DocPgExprConditionTest, ScalarArrayOp) {
+  ASSERT_EQ(
+      Convert(ScalarArrayOpExpr(kInt8Eq, true, Int8ArrayConst({1, -2}))),
+      "op: QL_OP_IN operands { column_id: 12 } operands { value { list_value { "
+      "elems { int64_value: 1 } elems { int64_value: -2 } } } }");
+  ASSERT_EQ(
+      Convert(ScalarArrayOpExpr(kInt8Ne, false, Int8ArrayConst({3}))),
+      "op: QL_OP_AND "
+      "operands { condition { op: QL_OP_IS_NOT_NULL operands { column_id: 12 } } } "
+      "operands { condition { op: QL_OP_NOT_IN operands { column_id: 12 } "
+      "operands { value { list_value { elems { int64_value: 3 } } } } } }");
+  // = ALL and <> ANY are not supported.
+  ASSERT_EQ(Convert(ScalarArrayOpExpr(kInt8Eq, false, Int8ArrayConst({1}))), "");
+  ASSERT_EQ(Convert(ScalarArrayOpExpr(kInt8Ne, true, Int8ArrayConst({1}))), "");
+}
+
+TEST_F(DocPgExprConditionTest, NullTestAndBoolExpr) {
+  ASSERT_EQ(Convert(NullTest(2, 0)), "op: QL_OP_IS_NULL operands { column_id: 11 }");
+  ASSERT_EQ(Convert(NullTest(2, 1)), "op: QL_OP_IS_NOT_NULL operands { column_id: 11 }");
+  ASSERT_EQ(
+      Convert(BoolExpr(
+          "and", NullTest(2, 1), OpExpr(kInt4Lt, Var(2, kInt4Oid), ByValConst(kInt4Oid, 5)))),
+      "op: QL_OP_AND "
+      "operands { condition { op: QL_OP_IS_NOT_NULL operands { column_id: 11 } } } "
+      "operands { condition { op: QL_OP_LESS_THAN operands { column_id: 11 } "
+      "operands { value { int32_value: 5 } } } }");
+  ASSERT_EQ(Convert(BoolExpr("or", NullTest(2, 1), NullTest(2, 0))), "");
+}
+
+TEST_F(DocPgExprConditionTest, NotSupported) {
+  // Unknown column.
+  ASSERT_EQ(Convert(OpExpr(kInt4Lt, Var(7, kInt4Oid), ByValConst(kInt4Oid, 5))), "");
+  // Not supported type.
+  ASSERT_EQ(Convert(OpExpr(kInt4Lt, Var(2, kTextOid), ByValConst(kInt4Oid, 5))), "");
+  // Not supported operator.
+  ASSERT_EQ(Convert(OpExpr(98, Var(2, kInt4Oid), ByValConst(kInt4Oid, 5))), "");
+  // NaN constant.
+  ASSERT_EQ(
+      Convert(OpExpr(kFloat8Ge, Var(4, kFloat8Oid), ByValConst(kFloat8Oid, bit_cast<uint64_t>(
+          std::numeric_limits<double>::quiet_NaN())))), "");
+  // Function call.
+  ASSERT_EQ(
+      Convert(OpExpr(
+          kInt4Lt, "{FUNCEXPR :funcid 1 :args (" + Var(2, kInt4Oid) + ")}",
+          ByValConst(kInt4Oid, 5))), "");
+  // Malformed input.
+  ASSERT_EQ(Convert("{OPEXPR :opno 97 :args ("), "");
+  ASSERT_EQ(Convert(NullTest(2, 0) + " trailing"), "");
+}
+
+} // namespace yb::docdb
@@ -0,0 +1,539 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_pg_expr_condition.h"
+
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/pgsql_protocol.pb.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/endian.h"
+#include "yb/gutil/strings/numbers.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/logging.h"
+#include "yb/util/slice.h"
+
+// Please do not include this file into headers: postgres_build/src/include/catalog is added as
+// a special include path to CMakeLists.txt
+#include "pg_type_d.h" // NOLINT
+
+namespace yb::docdb {
+
+namespace {
+
+// Limits nesting of parsed nodes, so malformed input could not exhaust the stack.
+constexpr int kMaxNodeDepth = 32;
+
+// Offset of array elements in ArrayType with single dimension and without null bitmap, i.e.
+// MAXALIGN of the header: vl_len_, ndim, dataoffset, elemtype, dims[1] and lbound[1].
+constexpr size_t kArrayDataOffset = 24;
+
+// Postgres node in the text form produced by nodeToString. Only fields that are nodes, lists of
+// nodes, scalar tokens and datums are distinguished, since that is enough for expressions
+// supported by the conversion.
+struct PgNode;
+
+struct PgField {
+  Slice name;
+  Slice token;
+  // Single node for node field, elements for list field.
+  std::vector<PgNode> nodes;
+  // Bytes of the datum, for constvalue field.
+  std::string datum;
+};
+
+struct PgNode {
+  Slice type;
+  std::vector<PgField> fields;
+
+  const PgField* Field(Slice name) const {
+    for (const auto& field : fields) {
+      if (field.name == name) {
+        return &field;
+      }
+    }
+    return nullptr;
+  }
+
+  std::optional<int64_t> IntField(Slice name) const {
+    const auto* field = Field(name);
+    if (!field || field->token.empty()) {
+      return std::nullopt;
+    }
+    int64_t result;
+    if (!safe_strto64(field->token.cdata(), narrow_cast<int>(field->token.size()), &result)) {
+      return std::nullopt;
+    }
+    return result;
+  }
+
+  // Returns the only node of the field, i.e. value of node field or the only element of list.
+  const PgNode* NodeField(Slice name) const {
+    const auto* field = Field(name);
+    return field && field->nodes.size() == 1 ? &field->nodes.front() : nullptr;
+  }
+
+  const std::vector<PgNode>* ListField(Slice name) const {
+    const auto* field = Field(name);
+    return field ? &field->nodes : nullptr;
+  }
+};
+
+// Reads nodes in the format of pg_strtok.
+class PgNodeReader {
+ public:
+  explicit PgNodeReader(Slice input) : input_(input) {}
+
+  bool ReadNode(PgNode* node, int depth = 0) {
+    if (depth > kMaxNodeDepth || NextToken() != "{") {
+      return false;
+    }
+    node->type = NextToken();
+    for (;;) {
+      auto token = NextToken();
+      if (token == "}") {
+        return true;
+      }
+      if (!token.starts_with(':')) {
+        return false;
+      }
+      auto& field = node->fields.emplace_back();
+      field.name = token.WithoutPrefix(1);
+      if (!ReadValue(&field, depth)) {
+        return false;
+      }
+    }
+  }
+
+  bool AtEnd() {
+    SkipSpaces();
+    return input_.empty();
+  }
+
+ private:
+  bool ReadValue(PgField* field, int depth) {
+    auto token = PeekToken();
+    if (token == "{") {
+      return ReadNode(&field->nodes.emplace_back(), depth + 1);
+    }
+    if (token == "(") {
+      NextToken();
+      for (;;) {
+        token = PeekToken();
+        if (token == ")") {
+          NextToken();
+          return true;
+        }
+        if (token == "{") {
+          if (!ReadNode(&field->nodes.emplace_back(), depth + 1)) {
+            return false;
+          }
+        } else if (token.empty() || token == "}") {
+          return false;
+        } else {
+          // Elements of integer or OID list, they are not used by supported expressions.
+          NextToken();
+        }
+      }
+    }
+    field->token = NextToken();
+    if (PeekToken() == "[") {
+      // Datum is written as length followed by bytes in brackets.
+      NextToken();
+      for (;;) {
+        token = NextToken();
+        if (token == "]") {
+          return true;
+        }
+        int32_t byte;
+        if (token.empty() || !safe_strto32(token.cdata(), narrow_cast<int>(token.size()), &byte)) {
+          return false;
+        }
+        field->datum.push_back(static_cast<char>(byte));
+      }
+    }
+    return !field->token.empty();
+  }
+
+  void SkipSpaces() {
+    while (!input_.empty() &&
+           (input_[0] == ' ' || input_[0] == '\n' || input_[0] == '\t')) {
+      input_.consume_byte();
+    }
+  }
+
+  Slice PeekToken() {
+    auto saved_input = input_;
+    auto result = NextToken();
+    input_ = saved_input;
+    return result;
+  }
+
+  Slice NextToken() {
+    SkipSpaces();
+    auto* start = input_.cdata();
+    if (input_.empty()) {
+      return Slice(start, start);
+    }
+    if (IsDelimiter(input_[0])) {
+      input_.consume_byte();
+      return Slice(start, 1);
+    }
+    while (!input_.empty() && !IsDelimiter(input_[0]) && input_[0] != ' ' &&
+           input_[0] != '\n' && input_[0] != '\t') {
+      // Backslash escapes the next character.
+      if (input_[0] == '\\' && input_.size() > 1) {
+        input_.consume_byte();
+      }
+      input_.consume_byte();
+    }
+    return Slice(start, input_.cdata());
+  }
+
+  static bool IsDelimiter(char ch) {
+    return ch == '(' || ch == ')' || ch == '{' || ch == '}';
+  }
+
+  Slice input_;
+};
+
+// OIDs of comparison operators on int2, int4, int8, float4 and float8, from pg_operator.dat.
+struct PgComparisonOperator {
+  uint32_t oid;
+  QLOperator op;
+};
+
+constexpr PgComparisonOperator kComparisonOperators[] = {
+  // =
+  {94, QL_OP_EQUAL}, {96, QL_OP_EQUAL}, {410, QL_OP_EQUAL}, {15, QL_OP_EQUAL},
+  {416, QL_OP_EQUAL}, {532, QL_OP_EQUAL}, {533, QL_OP_EQUAL}, {1862, QL_OP_EQUAL},
+  {1868, QL_OP_EQUAL}, {620, QL_OP_EQUAL}, {670, QL_OP_EQUAL}, {1120, QL_OP_EQUAL},
+  {1130, QL_OP_EQUAL},
+  // <>
+  {519, QL_OP_NOT_EQUAL}, {518, QL_OP_NOT_EQUAL}, {411, QL_OP_NOT_EQUAL}, {36, QL_OP_NOT_EQUAL},
+  {417, QL_OP_NOT_EQUAL}, {538, QL_OP_NOT_EQUAL}, {539, QL_OP_NOT_EQUAL},
+  {1863, QL_OP_NOT_EQUAL}, {1869, QL_OP_NOT_EQUAL}, {621, QL_OP_NOT_EQUAL},
+  {671, QL_OP_NOT_EQUAL}, {1121, QL_OP_NOT_EQUAL}, {1131, QL_OP_NOT_EQUAL},
+  // <
+  {95, QL_OP_LESS_THAN}, {97, QL_OP_LESS_THAN}, {412, QL_OP_LESS_THAN}, {37, QL_OP_LESS_THAN},
+  {418, QL_OP_LESS_THAN}, {534, QL_OP_LESS_THAN}, {535, QL_OP_LESS_THAN},
+  {1864, QL_OP_LESS_THAN}, {1870, QL_OP_LESS_THAN}, {622, QL_OP_LESS_THAN},
+  {672, QL_OP_LESS_THAN}, {1122, QL_OP_LESS_THAN}, {1132, QL_OP_LESS_THAN},
+  // <=
+  {522, QL_OP_LESS_THAN_EQUAL}, {523, QL_OP_LESS_THAN_EQUAL}, {414, QL_OP_LESS_THAN_EQUAL},
+  {80, QL_OP_LESS_THAN_EQUAL}, {420, QL_OP_LESS_THAN_EQUAL}, {540, QL_OP_LESS_THAN_EQUAL},
+  {541, QL_OP_LESS_THAN_EQUAL}, {1866, QL_OP_LESS_THAN_EQUAL}, {1872, QL_OP_LESS_THAN_EQUAL},
+  {624, QL_OP_LESS_THAN_EQUAL}, {673, QL_OP_LESS_THAN_EQUAL}, {1124, QL_OP_LESS_THAN_EQUAL},
+  {1134, QL_OP_LESS_THAN_EQUAL},
+  // >
+  {520, QL_OP_GREATER_THAN}, {521, QL_OP_GREATER_THAN}, {413, QL_OP_GREATER_THAN},
+  {76, QL_OP_GREATER_THAN}, {419, QL_OP_GREATER_THAN}, {536, QL_OP_GREATER_THAN},
+  {537, QL_OP_GREATER_THAN}, {1865, QL_OP_GREATER_THAN}, {1871, QL_OP_GREATER_THAN},
+  {623, QL_OP_GREATER_THAN}, {674, QL_OP_GREATER_THAN}, {1123, QL_OP_GREATER_THAN},
+  {1133, QL_OP_GREATER_THAN},
+  // >=
+  {524, QL_OP_GREATER_THAN_EQUAL}, {525, QL_OP_GREATER_THAN_EQUAL},
+  {415, QL_OP_GREATER_THAN_EQUAL}, {82, QL_OP_GREATER_THAN_EQUAL},
+  {430, QL_OP_GREATER_THAN_EQUAL}, {542, QL_OP_GREATER_THAN_EQUAL},
+  {543, QL_OP_GREATER_THAN_EQUAL}, {1867, QL_OP_GREATER_THAN_EQUAL},
+  {1873, QL_OP_GREATER_THAN_EQUAL}, {625, QL_OP_GREATER_THAN_EQUAL},
+  {675, QL_OP_GREATER_THAN_EQUAL}, {1125, QL_OP_GREATER_THAN_EQUAL},
+  {1135, QL_OP_GREATER_THAN_EQUAL},
+};
+
+std::optional<QLOperator> ComparisonOperator(std::optional<int64_t> opno) {
+  if (!opno) {
+    return std::nullopt;
+  }
+  for (const auto& entry : kComparisonOperators) {
+    if (entry.oid == *opno) {
+      return entry.op;
+    }
+  }
+  return std::nullopt;
+}
+
+bool IsSupportedType(std::optional<int64_t> type_oid) {
+  if (!type_oid) {
+    return false;
+  }
+  switch (*type_oid) {
+    case INT2OID: [[fallthrough]];
+    case INT4OID: [[fallthrough]];
+    case INT8OID: [[fallthrough]];
+    case FLOAT4OID: [[fallthrough]];
+    case FLOAT8OID:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Decodes value of the specified type from its in memory representation. NaN is not supported,
+// since PgsqlConditionPB and Postgres compare it differently.
+bool DecodeValue(int64_t type_oid, const char* data, size_t size, QLValuePB* out) {
+  switch (type_oid) {
+    case INT2OID:
+      if (size < sizeof(int16_t)) {
+        return false;
+      }
+      out->set_int16_value(static_cast<int16_t>(LittleEndian::Load16(data)));
+      return true;
+    case INT4OID:
+      if (size < sizeof(int32_t)) {
+        return false;
+      }
+      out->set_int32_value(static_cast<int32_t>(LittleEndian::Load32(data)));
+      return true;
+    case INT8OID:
+      if (size < sizeof(int64_t)) {
+        return false;
+      }
+      out->set_int64_value(static_cast<int64_t>(LittleEndian::Load64(data)));
+      return true;
+    case FLOAT4OID: {
+      if (size < sizeof(float)) {
+        return false;
+      }
+      auto value = bit_cast<float>(LittleEndian::Load32(data));
+      if (std::isnan(value)) {
+        return false;
+      }
+      out->set_float_value(value);
+      return true;
+    }
+    case FLOAT8OID: {
+      if (size < sizeof(double)) {
+        return false;
+      }
+      auto value = bit_cast<double>(LittleEndian::Load64(data));
+      if (std::isnan(value)) {
+        return false;
+      }
+      out->set_double_value(value);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+size_t TypeSize(int64_t type_oid) {
+  switch (type_oid) {
+    case INT2OID:
+      return sizeof(int16_t);
+    case INT4OID: [[fallthrough]];
+    case FLOAT4OID:
+      return sizeof(int32_t);
+    case INT8OID: [[fallthrough]];
+    case FLOAT8OID:
+      return sizeof(int64_t);
+    default:
+      return 0;
+  }
+}
+
+class PgExprConverter {
+ public:
+  explicit PgExprConverter(const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs)
+      : col_refs_(col_refs) {}
+
+  bool Convert(const PgNode& node, PgsqlConditionPB* out) {
+    if (node.type == "BOOLEXPR") {
+      const auto* boolop = node.Field("boolop");
+      const auto* args = node.ListField("args");
+      if (!boolop || boolop->token != "and" || !args || args->empty()) {
+        return false;
+      }
+      out->set_op(QL_OP_AND);
+      for (const auto& arg : *args) {
+        if (!Convert(arg, out->add_operands()->mutable_condition())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (node.type == "NULLTEST") {
+      // NullTestType: IS_NULL = 0, IS_NOT_NULL = 1.
+      auto null_test_type = node.IntField("nulltesttype");
+      const auto* arg = node.NodeField("arg");
+      if (!arg || !null_test_type || *null_test_type > 1) {
+        return false;
+      }
+      out->set_op(*null_test_type == 0 ? QL_OP_IS_NULL : QL_OP_IS_NOT_NULL);
+      return ConvertColumn(*arg, out->add_operands());
+    }
+    if (node.type == "OPEXPR") {
+      return ConvertComparison(node, out);
+    }
+    if (node.type == "SCALARARRAYOPEXPR") {
+      return ConvertScalarArrayOp(node, out);
+    }
+    return false;
+  }
+
+ private:
+  bool ConvertComparison(const PgNode& node, PgsqlConditionPB* out) {
+    auto op = ComparisonOperator(node.IntField("opno"));
+    const auto* args = node.ListField("args");
+    if (!op || !args || args->size() != 2) {
+      return false;
+    }
+    const auto* column = &args->front();
+    const auto* constant = &args->back();
+    if (column->type != "VAR") {
+      std::swap(column, constant);
+    }
+    auto* condition = out;
+    if (*op == QL_OP_NOT_EQUAL) {
+      condition = AddNotNull(*column, out);
+      if (!condition) {
+        return false;
+      }
+    }
+    condition->set_op(*op);
+    // Keep order of operands, PgsqlConditionPB consumers handle constant before column.
+    auto* column_operand = condition->add_operands();
+    auto* constant_operand = condition->add_operands();
+    if (column != &args->front()) {
+      std::swap(column_operand, constant_operand);
+    }
+    return ConvertColumn(*column, column_operand) &&
+           ConvertConstant(*constant, constant_operand->mutable_value());
+  }
+
+  bool ConvertScalarArrayOp(const PgNode& node, PgsqlConditionPB* out) {
+    auto op = ComparisonOperator(node.IntField("opno"));
+    const auto* use_or = node.Field("useOr");
+    const auto* args = node.ListField("args");
+    if (!op || !use_or || !args || args->size() != 2) {
+      return false;
+    }
+    auto* condition = out;
+    if (*op == QL_OP_EQUAL && use_or->token == "true") {
+      condition->set_op(QL_OP_IN);
+    } else if (*op == QL_OP_NOT_EQUAL && use_or->token == "false") {
+      condition = AddNotNull(args->front(), out);
+      if (!condition) {
+        return false;
+      }
+      condition->set_op(QL_OP_NOT_IN);
+    } else {
+      return false;
+    }
+    return ConvertColumn(args->front(), condition->add_operands()) &&
+           ConvertArray(
+               args->back(), condition->add_operands()->mutable_value()->mutable_list_value());
+  }
+
+  // Makes out AND of IS NOT NULL for the column and returns condition to be filled by caller.
+  PgsqlConditionPB* AddNotNull(const PgNode& column, PgsqlConditionPB* out) {
+    out->set_op(QL_OP_AND);
+    auto& not_null = *out->add_operands()->mutable_condition();
+    not_null.set_op(QL_OP_IS_NOT_NULL);
+    if (!ConvertColumn(column, not_null.add_operands())) {
+      return nullptr;
+    }
+    return out->add_operands()->mutable_condition();
+  }
+
+  bool ConvertColumn(const PgNode& node, PgsqlExpressionPB* out) {
+    auto levels_up = node.IntField("varlevelsup");
+    auto attno = node.IntField("varattno");
+    if (node.type != "VAR" || !levels_up || *levels_up != 0 || !attno ||
+        !IsSupportedType(node.IntField("vartype"))) {
+      return false;
+    }
+    for (const auto& col_ref : col_refs_) {
+      if (col_ref.attno() == *attno) {
+        out->set_column_id(col_ref.column_id());
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ConvertConstant(const PgNode& node, QLValuePB* out) {
+    auto type_oid = node.IntField("consttype");
+    const auto* value = node.Field("constvalue");
+    if (node.type != "CONST" || !IsSupportedType(type_oid) || !value) {
+      return false;
+    }
+    // NULL constant is written as <>, comparison with it does not select any row, so it is left
+    // to the Postgres expression.
+    return DecodeValue(*type_oid, value->datum.data(), value->datum.size(), out);
+  }
+
+  bool ConvertArray(const PgNode& node, QLSeqValuePB* out) {
+    const auto* value = node.Field("constvalue");
+    if (node.type != "CONST" || !value) {
+      return false;
+    }
+    const auto& datum = value->datum;
+    // Only 4 byte varlena header, single dimension and absence of nulls are supported.
+    if (datum.size() < kArrayDataOffset || (datum[0] & 0x03) != 0) {
+      return false;
+    }
+    auto ndim = LittleEndian::Load32(datum.data() + 4);
+    auto data_offset = LittleEndian::Load32(datum.data() + 8);
+    int64_t elem_type = LittleEndian::Load32(datum.data() + 12);
+    auto num_elems = LittleEndian::Load32(datum.data() + 16);
+    auto elem_size = TypeSize(elem_type);
+    if (ndim != 1 || data_offset != 0 || elem_size == 0 || num_elems == 0 ||
+        datum.size() != kArrayDataOffset + num_elems * elem_size) {
+      return false;
+    }
+    for (size_t i = 0; i != num_elems; ++i) {
+      if (!DecodeValue(
+              elem_type, datum.data() + kArrayDataOffset + i * elem_size, elem_size,
+              out->add_elems())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs_;
+};
+
+} // namespace
+
+bool ConvertPgExprToCondition(
+    const PgsqlExpressionPB& expr,
+    const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs,
+    PgsqlConditionPB* condition) {
+  if (!expr.has_tscall()) {
+    return false;
+  }
+  const auto& tscall = expr.tscall();
+  if (tscall.opcode() != to_underlying(bfpg::TSOpcode::kPgEvalExprCall) ||
+      tscall.operands().empty() || !tscall.operands(0).value().has_string_value()) {
+    return false;
+  }
+  PgNodeReader reader(tscall.operands(0).value().string_value());
+  PgNode node;
+  if (!reader.ReadNode(&node) || !reader.AtEnd()) {
+    VLOG_WITH_FUNC(4) << "Failed to parse: " << tscall.operands(0).value().string_value();
+    return false;
+  }
+  return PgExprConverter(col_refs).Convert(node, condition);
+}
+
+} // namespace yb::docdb
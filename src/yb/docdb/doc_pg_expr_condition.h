@@ -0,0 +1,42 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <google/protobuf/repeated_field.h>
+
+#include "yb/common/pgsql_protocol.fwd.h"
+
+namespace yb::docdb {
+
+// Converts where clause in the form of serialized Postgres expression to the equivalent
+// PgsqlConditionPB, so it could be checked without Postgres expression evaluation.
+//
+// Supported expressions are:
+// - comparison (OpExpr) of int2, int4, int8, float4 or float8 column with a constant,
+// - col = ANY (array constant) and col <> ALL (array constant) (ScalarArrayOpExpr),
+// - col IS [NOT] NULL (NullTest),
+// - AND of supported expressions.
+// Columns are resolved to column ids by col_refs of the request.
+//
+// PgsqlConditionPB treats NULL as not equal to any value, while Postgres does not select row with
+// NULL for <> comparison. So <> and <> ALL are converted to AND with IS NOT NULL.
+//
+// Returns false when expression is not supported, in this case condition is left in unspecified
+// state.
+bool ConvertPgExprToCondition(
+    const PgsqlExpressionPB& expr,
+    const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs,
+    PgsqlConditionPB* condition);
+
+} // namespace yb::docdb
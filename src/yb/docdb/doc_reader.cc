@@ -250,10 +250,13 @@ class DocDBTableReader::PackedRowData {
     return *DCHECK_NOTNULL(doc_ht_);
   }
 
-  template <class ColumnDecoder>
+  // When fixed_column_decoder is specified, it is used for fixed size columns with fixed offset
+  // in the packed row. Such columns are gathered directly from packed row bytes, w/o going through
+  // the generic value decoding.
+  template <class ColumnDecoder, class FixedColumnDecoder = std::nullptr_t>
   Status Decode(
       Slice value, const LazyDocHybridTime* doc_ht, const ValueControlFields& control_fields,
-      ColumnDecoder column_decoder) {
+      ColumnDecoder column_decoder, FixedColumnDecoder fixed_column_decoder = nullptr) {
     DVLOG_WITH_FUNC(4)
         << "value: " << value.ToDebugHexString() << ", control fields: "
         << control_fields.ToString() << ", doc_ht: " << doc_ht->ToString();
@@ -271,14 +274,31 @@ class DocDBTableReader::PackedRowData {
     const auto& projection = *DCHECK_NOTNULL(reader_.projection_);
     auto projection_index = projection.num_key_columns;
     auto num_value_columns = projection.num_value_columns();
+    [[maybe_unused]] const uint8_t* columns_data = nullptr;
+    if constexpr (!std::is_same_v<FixedColumnDecoder, std::nullptr_t>) {
+      columns_data = value.data() + schema_packing_->PrefixLen(packed_row_version_, value);
+    }
     for (size_t index = 0; index != num_value_columns; ++index, ++projection_index) {
-      auto packed_index = packed_index_[index];
+      const auto& packed_column = packed_columns_[index];
+      auto packed_index = packed_column.index;
       if (packed_index == dockv::SchemaPacking::kSkippedColumnIdx) {
         DVLOG_WITH_FUNC(4) << "no packed index for: " << index;
         column_decoder(projection_index, std::nullopt);
         continue;
       }
-      auto column_value = schema_packing_->GetValue(packed_index, value);
+      if constexpr (!std::is_same_v<FixedColumnDecoder, std::nullptr_t>) {
+        if (packed_column.fixed_size) {
+          const auto* data = columns_data + packed_column.fixed_offset;
+          if (*data == packed_column.fixed_value_type) {
+            fixed_column_decoder(
+                projection_index,
+                packed_column.fixed_size == sizeof(uint32_t)
+                    ? BigEndian::Load32(data + 1) : BigEndian::Load64(data + 1));
+            continue;
+          }
+        }
+      }
+      auto column_value = schema_packing_->GetValue(packed_row_version_, packed_index, value);
       DVLOG_WITH_FUNC(4) << "packed index: " << packed_index << ", value: " << column_value;
       // Remove buggy intent_doc_ht from start of the column. See #16650 for details.
       if (column_value.TryConsumeByte(dockv::KeyEntryTypeAsChar::kHybridTime)) {
@@ -295,14 +315,31 @@ class DocDBTableReader::PackedRowData {
 
   Status UpdateSchemaPacking(Slice* value) {
     const auto* start = value->cdata();
-    value->consume_byte();
+    auto packed_row_version = dockv::ConsumePackedRowVersion(value);
+    RSTATUS_DCHECK(
+        packed_row_version, Corruption, "Packed row expected: $0", value->ToDebugHexString());
+    packed_row_version_ = *packed_row_version;
     schema_packing_ = &VERIFY_RESULT(schema_packing_storage_.GetPacking(value)).get();
     schema_packing_version_.Assign(start, value->cdata());
 
-    packed_index_.clear();
-    packed_index_.reserve(reader_.projection_->num_value_columns());
+    packed_columns_.clear();
+    packed_columns_.reserve(reader_.projection_->num_value_columns());
     for (const auto& column : reader_.projection_->value_columns()) {
-      packed_index_.push_back(schema_packing_->GetIndex(column.id));
+      auto& packed_column = packed_columns_.emplace_back(PackedColumn {
+        .index = schema_packing_->GetIndex(column.id),
+      });
+      if (packed_column.index == dockv::SchemaPacking::kSkippedColumnIdx) {
+        continue;
+      }
+      auto fixed_offset = schema_packing_->FixedOffset(packed_column.index);
+      auto value_type = dockv::PackedFixedValueType(column.data_type);
+      auto fixed_size = dockv::PackedFixedValueSize(value_type);
+      if (fixed_offset && fixed_size &&
+          schema_packing_->column_packing_data(packed_column.index).size == fixed_size + 1) {
+        packed_column.fixed_offset = *fixed_offset;
+        packed_column.fixed_size = fixed_size;
+        packed_column.fixed_value_type = static_cast<uint8_t>(value_type);
+      }
     }
     return Status::OK();
   }
@@ -311,9 +348,22 @@ class DocDBTableReader::PackedRowData {
   DocDBTableReader& reader_;
   const dockv::SchemaPackingStorage& schema_packing_storage_;
 
+  // Information about projected value column in the current schema packing.
+  struct PackedColumn {
+    int64_t index;
+    // Offset (from the end of packed row prefix) and size of fixed size column value that could
+    // be gathered directly.
+    // fixed_size is 0 when column should be decoded using generic path.
+    size_t fixed_offset = 0;
+    size_t fixed_size = 0;
+    uint8_t fixed_value_type = 0;
+  };
+
   const dockv::SchemaPacking* schema_packing_ = nullptr;
+  dockv::PackedRowVersion packed_row_version_ = dockv::PackedRowVersion::kV1;
+  // Packed row value type and schema version of the last decoded row.
   ByteBuffer<0x10> schema_packing_version_;
-  boost::container::small_vector<int64_t, 0x10> packed_index_;
+  boost::container::small_vector<PackedColumn, 0x10> packed_columns_;
 
   const LazyDocHybridTime* doc_ht_;
   ValueControlFields control_fields_;
@@ -998,7 +1048,7 @@ class DocDBTableReader::GetHelper : public BaseOfGetHelper<ResultType> {
       Slice row_value, LazyDocHybridTime* root_write_time,
       const ValueControlFields& control_fields) override {
     auto value_type = dockv::DecodeValueEntryType(row_value);
-    if (value_type == ValueEntryType::kPackedRow) {
+    if (dockv::GetPackedRowVersion(value_type)) {
       RETURN_NOT_OK(reader_.packed_row_->Decode(
           row_value, root_write_time, control_fields, [this](size_t index, auto value){
             return DecodePackedColumn(value, &reader_.projection_->columns[index]);
@@ -1168,7 +1218,7 @@ class DocDBTableReader::FlatGetHelper : public BaseOfFlatGetHelper<ResultType> {
       const ValueControlFields& control_fields) override {
     DCHECK_ONLY_NOTNULL(reader_.projection_);
     auto value_type = dockv::DecodeValueEntryType(row_value);
-    if (value_type != ValueEntryType::kPackedRow) {
+    if (!dockv::GetPackedRowVersion(value_type)) {
       SetNullResult(*reader_.projection_, result_);
       return Status::OK();
     }
@@ -1176,11 +1226,19 @@ class DocDBTableReader::FlatGetHelper : public BaseOfFlatGetHelper<ResultType> {
     if (Base::kCheckExistOnly) {
       return Status::OK();
     }
-    return reader_.packed_row_->Decode(
-        row_value, root_write_time, control_fields,
-        [this](size_t index, auto value) {
+    auto column_decoder = [this](size_t index, auto value) {
       return DecodePackedColumn(result_, index, value, *reader_.projection_);
-    });
+    };
+    if constexpr (std::is_same_v<ResultType, dockv::PgTableRow*>) {
+      return reader_.packed_row_->Decode(
+          row_value, root_write_time, control_fields, column_decoder,
+          [this](size_t index, dockv::PgValueDatum value) {
+        result_->SetFixedValue(index, value);
+      });
+    } else {
+      return reader_.packed_row_->Decode(
+          row_value, root_write_time, control_fields, column_decoder);
+    }
   }
 
  private:
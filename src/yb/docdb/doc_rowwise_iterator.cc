@@ -104,7 +104,8 @@ void DocRowwiseIterator::InitIterator(
       read_operation_data_,
       file_filter,
       nullptr /* iterate_upper_bound */,
-      statistics_);
+      statistics_,
+      std::move(isolated_file_filter_));
   InitResult();
 
   if (is_forward_scan_ && has_bound_key_) {
@@ -94,6 +94,12 @@ class DocRowwiseIterator final : public DocRowwiseIteratorBase {
     doc_mode_ = DocMode::kAny;
   }
 
+  // Sets filter that is used as rocksdb::ReadOptions::isolated_file_filter to skip SST files of
+  // regular DB. Should be called before Init.
+  void SetIsolatedFileFilter(std::shared_ptr<rocksdb::TableAwareReadFileFilter> filter) {
+    isolated_file_filter_ = std::move(filter);
+  }
+
  private:
   void InitIterator(
       BloomFilterMode bloom_filter_mode = BloomFilterMode::DONT_USE_BLOOM_FILTER,
@@ -152,6 +158,8 @@ class DocRowwiseIterator final : public DocRowwiseIteratorBase {
   DocReaderResult prev_doc_found_ = DocReaderResult::kNotFound;
 
   const DocDBStatistics* statistics_;
+
+  std::shared_ptr<rocksdb::TableAwareReadFileFilter> isolated_file_filter_;
 };
 
 }  // namespace docdb
@@ -285,6 +285,18 @@ Result<Slice> DocRowwiseIteratorBase::GetTupleId() const {
   return tuple_id;
 }
 
+void AppendTupleIdPrefix(const Schema& schema, dockv::KeyBytes* out) {
+  if (schema.has_cotable_id()) {
+    std::string bytes;
+    schema.cotable_id().EncodeToComparable(&bytes);
+    out->AppendKeyEntryType(dockv::KeyEntryType::kTableId);
+    out->AppendRawBytes(bytes);
+  } else if (schema.has_colocation_id()) {
+    out->AppendKeyEntryType(dockv::KeyEntryType::kColocationId);
+    out->AppendUInt32(schema.colocation_id());
+  }
+}
+
 void DocRowwiseIteratorBase::SeekTuple(Slice tuple_id) {
   // If cotable id / colocation id is present in the table schema, then
   // we need to prepend it in the tuple key to seek.
@@ -293,16 +305,7 @@ void DocRowwiseIteratorBase::SeekTuple(Slice tuple_id) {
     if (!tuple_key_) {
       tuple_key_.emplace();
       tuple_key_->Reserve(1 + size + tuple_id.size());
-
-      if (schema_->has_cotable_id()) {
-        std::string bytes;
-        schema_->cotable_id().EncodeToComparable(&bytes);
-        tuple_key_->AppendKeyEntryType(dockv::KeyEntryType::kTableId);
-        tuple_key_->AppendRawBytes(bytes);
-      } else {
-        tuple_key_->AppendKeyEntryType(dockv::KeyEntryType::kColocationId);
-        tuple_key_->AppendUInt32(schema_->colocation_id());
-      }
+      AppendTupleIdPrefix(*schema_, &*tuple_key_);
     } else {
       tuple_key_->Truncate(1 + size);
     }
@@ -197,4 +197,8 @@ class DocRowwiseIteratorBase : public YQLRowwiseIteratorIf {
   size_t obsolete_keys_found_past_cutoff_ = 0;
 };
 
+// Appends cotable id / colocation id of the table to the key, so tuple id could be appended to get
+// the key of the row. Does nothing if the table does not have them.
+void AppendTupleIdPrefix(const Schema& schema, dockv::KeyBytes* out);
+
 }  // namespace yb::docdb
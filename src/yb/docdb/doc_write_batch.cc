@@ -132,7 +132,7 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, HasAncestor
           key_data.write_time = packed_row_write_time_;
           key_data.key = key_prefix_.AsSlice();
           auto value_opt = packed_row_packing_->GetValue(
-              column_id_ref, packed_row_value_.AsSlice());
+              packed_row_version_, column_id_ref, packed_row_value_.AsSlice());
           if (value_opt) {
             recent_value = *value_opt;
             use_packed_row = true;
@@ -159,8 +159,11 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, HasAncestor
     control_fields = VERIFY_RESULT(ValueControlFields::Decode(&value_copy));
     current_entry_.user_timestamp = control_fields.timestamp;
     current_entry_.value_type = dockv::DecodeValueEntryType(value_copy);
-    if (doc_read_context_ && value_copy.TryConsumeByte(dockv::ValueEntryTypeAsChar::kPackedRow)) {
+    auto packed_row_version = doc_read_context_
+        ? dockv::ConsumePackedRowVersion(&value_copy) : std::nullopt;
+    if (packed_row_version) {
       packed_row_key_.Assign(key_data.key);
+      packed_row_version_ = *packed_row_version;
       packed_row_packing_ = &VERIFY_RESULT_REF(
           doc_read_context_->schema_packing_storage.GetPacking(&value_copy));
       packed_row_value_.Assign(value_copy);
@@ -360,6 +360,7 @@ class DocWriteBatch {
 
   KeyBuffer packed_row_key_;
   const dockv::SchemaPacking* packed_row_packing_;
+  dockv::PackedRowVersion packed_row_version_ = dockv::PackedRowVersion::kV1;
   ValueBuffer packed_row_value_;
   EncodedDocHybridTime packed_row_write_time_;
 
@@ -0,0 +1,326 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_zone_map.h"
+#include "yb/docdb/docdb_compaction_context.h"
+
+#include "yb/dockv/doc_key.h"
+#include "yb/dockv/packed_row.h"
+#include "yb/dockv/schema_packing.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/format.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_bool(docdb_collect_zone_maps);
+
+namespace yb::docdb {
+
+namespace {
+
+constexpr SchemaVersion kVersion = 1;
+
+Schema BuildSchema() {
+  SchemaBuilder builder;
+  CHECK_OK(builder.AddKeyColumn("k", DataType::INT32));
+  CHECK_OK(builder.AddColumn("v_int32", DataType::INT32));
+  CHECK_OK(builder.AddNullableColumn("v_int64", DataType::INT64));
+  CHECK_OK(builder.AddColumn("v_double", DataType::DOUBLE));
+  CHECK_OK(builder.AddNullableColumn("v_string", DataType::STRING));
+  return builder.Build();
+}
+
+class TestSchemaPackingProvider : public SchemaPackingProvider {
+ public:
+  void AddSchema(SchemaVersion version, const Schema& schema) {
+    packings_[version] = std::make_shared<dockv::SchemaPacking>(
+        TableType::PGSQL_TABLE_TYPE, schema);
+  }
+
+  Result<CompactionSchemaInfo> CotablePacking(
+      const Uuid& cotable_id, uint32_t schema_version, HybridTime history_cutoff) override {
+    auto it = packings_.find(schema_version);
+    if (!cotable_id.IsNil() || it == packings_.end()) {
+      return STATUS_FORMAT(NotFound, "Unknown packing: $0, $1", cotable_id, schema_version);
+    }
+    return CompactionSchemaInfo {
+      .table_type = TableType::PGSQL_TABLE_TYPE,
+      .schema_version = schema_version,
+      .schema_packing = it->second,
+      .cotable_id = cotable_id,
+      .deleted_cols = {},
+      .enabled = true,
+    };
+  }
+
+  Result<CompactionSchemaInfo> ColocationPacking(
+      ColocationId colocation_id, uint32_t schema_version, HybridTime history_cutoff) override {
+    return STATUS_FORMAT(NotFound, "Unknown colocation: $0", colocation_id);
+  }
+
+ private:
+  std::unordered_map<SchemaVersion, std::shared_ptr<const dockv::SchemaPacking>> packings_;
+};
+
+QLValuePB Int32Value(int32_t value) {
+  QLValuePB result;
+  result.set_int32_value(value);
+  return result;
+}
+
+QLValuePB Int64Value(std::optional<int64_t> value) {
+  QLValuePB result;
+  if (value) {
+    result.set_int64_value(*value);
+  }
+  return result;
+}
+
+QLValuePB DoubleValue(double value) {
+  QLValuePB result;
+  result.set_double_value(value);
+  return result;
+}
+
+PgsqlExpressionPB Compare(QLOperator op, ColumnId column_id, const QLValuePB& value) {
+  PgsqlExpressionPB result;
+  auto& condition = *result.mutable_condition();
+  condition.set_op(op);
+  condition.add_operands()->set_column_id(column_id.rep());
+  *condition.add_operands()->mutable_value() = value;
+  return result;
+}
+
+PgsqlExpressionPB IsNull(QLOperator op, ColumnId column_id) {
+  PgsqlExpressionPB result;
+  auto& condition = *result.mutable_condition();
+  condition.set_op(op);
+  condition.add_operands()->set_column_id(column_id.rep());
+  return result;
+}
+
+class DocZoneMapTest : public YBTest {
+ protected:
+  DocZoneMapTest() : schema_(BuildSchema()) {}
+
+  void SetUp() override {
+    YBTest::SetUp();
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_docdb_collect_zone_maps) = true;
+    provider_.AddSchema(kVersion, schema_);
+    packing_ = std::make_unique<dockv::SchemaPacking>(TableType::PGSQL_TABLE_TYPE, schema_);
+    collector_.reset(CreateZoneMapCollectorFactory(&provider_)->CreateTablePropertiesCollector(
+        rocksdb::TablePropertiesCollectorFactory::Context()));
+  }
+
+  void AddRow(
+      int32_t key, int32_t v_int32, std::optional<int64_t> v_int64, double v_double,
+      std::optional<ColocationId> colocation_id = std::nullopt) {
+    dockv::RowPacker packer(
+        kVersion, *packing_, /* packed_size_limit= */ std::numeric_limits<int64_t>::max(),
+        /* control_fields= */ Slice());
+    ASSERT_OK(packer.AddValue(schema_.column_id(1), Int32Value(v_int32)));
+    ASSERT_OK(packer.AddValue(schema_.column_id(2), Int64Value(v_int64)));
+    ASSERT_OK(packer.AddValue(schema_.column_id(3), DoubleValue(v_double)));
+    QLValuePB v_string;
+    v_string.set_string_value("value");
+    ASSERT_OK(packer.AddValue(schema_.column_id(4), v_string));
+    auto packed = ASSERT_RESULT(packer.Complete());
+
+    dockv::DocKey doc_key(schema_, dockv::KeyEntryValues{dockv::KeyEntryValue::Int32(key)});
+    if (colocation_id) {
+      doc_key.set_colocation_id(*colocation_id);
+    }
+    ASSERT_OK(collector_->AddUserKey(
+        doc_key.Encode().AsSlice(), packed, rocksdb::kEntryPut, /* seq= */ 0,
+        /* file_size= */ 0));
+  }
+
+  rocksdb::UserCollectedProperties Finish() {
+    rocksdb::UserCollectedProperties result;
+    CHECK_OK(collector_->Finish(&result));
+    return result;
+  }
+
+  bool MayMatch(
+      const rocksdb::UserCollectedProperties& properties,
+      std::initializer_list<PgsqlExpressionPB> where_clauses) {
+    ZoneMapFileFilter filter;
+    for (const auto& where_clause : where_clauses) {
+      filter.Add(where_clause);
+    }
+    return filter.MayMatch(properties);
+  }
+
+  const Schema schema_;
+  TestSchemaPackingProvider provider_;
+  std::unique_ptr<dockv::SchemaPacking> packing_;
+  std::unique_ptr<rocksdb::TablePropertiesCollector> collector_;
+};
+
+} // namespace
+
+TEST_F(DocZoneMapTest, Filter) {
+  for (int i = 0; i != 11; ++i) {
+    ASSERT_NO_FATALS(AddRow(
+        i, 10 + i, i % 2 ? std::optional<int64_t>(i * 100) : std::nullopt, i * 0.5));
+  }
+  auto properties = Finish();
+  ASSERT_EQ(properties.count(kZoneMapPropertyName), 1);
+
+  const auto v_int32 = schema_.column_id(1);
+  const auto v_int64 = schema_.column_id(2);
+  const auto v_double = schema_.column_id(3);
+  const auto v_string = schema_.column_id(4);
+
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_EQUAL, v_int32, Int32Value(15))}));
+  ASSERT_FALSE(MayMatch(properties, {Compare(QL_OP_EQUAL, v_int32, Int32Value(21))}));
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_GREATER_THAN_EQUAL, v_int32, Int32Value(20))}));
+  ASSERT_FALSE(MayMatch(properties, {Compare(QL_OP_GREATER_THAN, v_int32, Int32Value(20))}));
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_LESS_THAN_EQUAL, v_int32, Int32Value(10))}));
+  ASSERT_FALSE(MayMatch(properties, {Compare(QL_OP_LESS_THAN, v_int32, Int32Value(10))}));
+  ASSERT_FALSE(MayMatch(properties, {Compare(QL_OP_GREATER_THAN, v_int64, Int64Value(900))}));
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_LESS_THAN, v_int64, Int64Value(101))}));
+  ASSERT_FALSE(MayMatch(properties, {Compare(QL_OP_LESS_THAN, v_double, DoubleValue(0))}));
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_LESS_THAN_EQUAL, v_double, DoubleValue(0))}));
+
+  // Constant before column.
+  auto mirrored = Compare(QL_OP_LESS_THAN, v_int32, Int32Value(20));
+  mirrored.mutable_condition()->mutable_operands()->SwapElements(0, 1);
+  ASSERT_FALSE(MayMatch(properties, {mirrored}));
+
+  // IN.
+  PgsqlExpressionPB in_clause;
+  auto& in_condition = *in_clause.mutable_condition();
+  in_condition.set_op(QL_OP_IN);
+  in_condition.add_operands()->set_column_id(v_int32.rep());
+  auto& elems = *in_condition.add_operands()->mutable_value()->mutable_list_value();
+  *elems.add_elems() = Int32Value(5);
+  *elems.add_elems() = Int32Value(25);
+  ASSERT_FALSE(MayMatch(properties, {in_clause}));
+  *elems.add_elems() = Int32Value(12);
+  ASSERT_TRUE(MayMatch(properties, {in_clause}));
+
+  // IS [NOT] NULL.
+  ASSERT_TRUE(MayMatch(properties, {IsNull(QL_OP_IS_NULL, v_int64)}));
+  ASSERT_FALSE(MayMatch(properties, {IsNull(QL_OP_IS_NULL, v_int32)}));
+  ASSERT_TRUE(MayMatch(properties, {IsNull(QL_OP_IS_NOT_NULL, v_int32)}));
+
+  // AND, and several where clauses, skip file when any of conditions could not be satisfied.
+  PgsqlExpressionPB and_clause;
+  auto& and_condition = *and_clause.mutable_condition();
+  and_condition.set_op(QL_OP_AND);
+  *and_condition.add_operands() = Compare(QL_OP_GREATER_THAN, v_int32, Int32Value(15));
+  *and_condition.add_operands() = Compare(QL_OP_GREATER_THAN, v_double, DoubleValue(10));
+  ASSERT_FALSE(MayMatch(properties, {and_clause}));
+  ASSERT_FALSE(MayMatch(properties, {
+      Compare(QL_OP_GREATER_THAN, v_int32, Int32Value(15)),
+      Compare(QL_OP_GREATER_THAN, v_double, DoubleValue(10))}));
+
+  // Not supported conditions do not skip the file.
+  QLValuePB string_value;
+  string_value.set_string_value("zzz");
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_GREATER_THAN, v_string, string_value)}));
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_NOT_EQUAL, v_int32, Int32Value(15))}));
+  // Constant of floating point type for integer column.
+  ASSERT_TRUE(MayMatch(properties, {Compare(QL_OP_GREATER_THAN, v_int32, DoubleValue(100))}));
+}
+
+TEST_F(DocZoneMapTest, PgExpression) {
+  for (int i = 0; i != 11; ++i) {
+    ASSERT_NO_FATALS(AddRow(i, 10 + i, i * 100, i * 0.5));
+  }
+  auto properties = Finish();
+
+  google::protobuf::RepeatedPtrField<PgsqlColRefPB> col_refs;
+  auto& col_ref = *col_refs.Add();
+  col_ref.set_column_id(schema_.column_id(1).rep());
+  col_ref.set_attno(2);
+
+  // v_int32 > value, serialized as OpExpr with int4gt operator.
+  auto greater_than = [&col_refs, &properties](int value) {
+    PgsqlExpressionPB where_clause;
+    auto& tscall = *where_clause.mutable_tscall();
+    tscall.set_opcode(to_underlying(bfpg::TSOpcode::kPgEvalExprCall));
+    tscall.add_operands()->mutable_value()->set_string_value(Format(
+        "{OPEXPR :opno 521 :opfuncid 147 :opresulttype 16 :opretset false :opcollid 0 "
+        ":inputcollid 0 :args ({VAR :varno 1 :varattno 2 :vartype 23 :vartypmod -1 "
+        ":varcollid 0 :varlevelsup 0 :varnoold 1 :varoattno 2 :location -1} "
+        "{CONST :consttype 23 :consttypmod -1 :constcollid 0 :constlen 4 :constbyval true "
+        ":constisnull false :location -1 :constvalue 4 [ $0 0 0 0 0 0 0 0 ]}) :location -1}",
+        value));
+    ZoneMapFileFilter filter;
+    filter.Add(where_clause, col_refs);
+    return filter.MayMatch(properties);
+  };
+  ASSERT_TRUE(greater_than(19));
+  ASSERT_FALSE(greater_than(20));
+}
+
+TEST_F(DocZoneMapTest, NullOnlyColumn) {
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_NO_FATALS(AddRow(i, i, std::nullopt, i));
+  }
+  auto properties = Finish();
+  const auto v_int64 = schema_.column_id(2);
+  ASSERT_FALSE(MayMatch(properties, {Compare(QL_OP_EQUAL, v_int64, Int64Value(0))}));
+  ASSERT_FALSE(MayMatch(properties, {IsNull(QL_OP_IS_NOT_NULL, v_int64)}));
+  ASSERT_TRUE(MayMatch(properties, {IsNull(QL_OP_IS_NULL, v_int64)}));
+}
+
+TEST_F(DocZoneMapTest, NaN) {
+  ASSERT_NO_FATALS(AddRow(1, 1, 1, 1.0));
+  ASSERT_NO_FATALS(AddRow(2, 2, 2, std::numeric_limits<double>::quiet_NaN()));
+  auto properties = Finish();
+  // NaN is greater than any other value, so column with NaN is not present in zone map.
+  ASSERT_TRUE(MayMatch(
+      properties, {Compare(QL_OP_GREATER_THAN, schema_.column_id(3), DoubleValue(100))}));
+  ASSERT_FALSE(MayMatch(
+      properties, {Compare(QL_OP_GREATER_THAN, schema_.column_id(1), Int32Value(100))}));
+}
+
+TEST_F(DocZoneMapTest, NotPackedEntry) {
+  ASSERT_NO_FATALS(AddRow(1, 1, 1, 1.0));
+  dockv::DocKey doc_key(schema_, dockv::KeyEntryValues{dockv::KeyEntryValue::Int32(2)});
+  ASSERT_OK(collector_->AddUserKey(
+      doc_key.Encode().AsSlice(), Slice(), rocksdb::kEntryDelete, /* seq= */ 0,
+      /* file_size= */ 0));
+  ASSERT_EQ(Finish().count(kZoneMapPropertyName), 0);
+}
+
+TEST_F(DocZoneMapTest, Colocated) {
+  ASSERT_NO_FATALS(AddRow(1, 1, 1, 1.0, /* colocation_id= */ 16384));
+  ASSERT_EQ(Finish().count(kZoneMapPropertyName), 0);
+}
+
+TEST_F(DocZoneMapTest, Disabled) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_docdb_collect_zone_maps) = false;
+  collector_.reset(CreateZoneMapCollectorFactory(&provider_)->CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context()));
+  ASSERT_NO_FATALS(AddRow(1, 1, 1, 1.0));
+  ASSERT_EQ(Finish().count(kZoneMapPropertyName), 0);
+}
+
+} // namespace yb::docdb
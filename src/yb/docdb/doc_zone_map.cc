@@ -0,0 +1,559 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_zone_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/common/hybrid_time.h"
+#include "yb/common/pgsql_protocol.pb.h"
+
+#include "yb/docdb/doc_pg_expr_condition.h"
+#include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/docdb_compaction_context.h"
+#include "yb/docdb/key_bounds.h"
+
+#include "yb/dockv/schema_packing.h"
+#include "yb/dockv/value.h"
+#include "yb/dockv/value_type.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/endian.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/table/table_reader.h"
+
+#include "yb/util/fast_varint.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/uuid.h"
+
+DEFINE_RUNTIME_bool(docdb_collect_zone_maps, false,
+    "Whether to collect zone map, i.e. min/max and null count of fixed size numeric columns, "
+    "while writing SST files of YSQL tables. Zone map is stored as SST file property.");
+
+DEFINE_RUNTIME_bool(ysql_use_zone_map_file_filter, false,
+    "Skip SST files whose zone map shows that no row in the file satisfies where clause of "
+    "YSQL scan. File is skipped only when its key range does not overlap key ranges of files "
+    "and memtables that are read, unless they are skipped as well, and tablet does not have "
+    "intents. So it is mostly useful for append only tables whose primary key increases with "
+    "insertion time, e.g. range sharded time series.");
+
+namespace yb::docdb {
+
+const char kZoneMapPropertyName[] = "yb.docdb.zone_map";
+
+namespace {
+
+struct ColumnStats {
+  // Number of rows whose packing contains this column.
+  uint64_t num_rows = 0;
+  uint64_t null_count = 0;
+  // Reset when column contains value that could not be tracked, e.g. string or NaN.
+  bool valid = true;
+  bool has_value = false;
+  bool is_real = false;
+  int64_t min_int = 0;
+  int64_t max_int = 0;
+  double min_real = 0;
+  double max_real = 0;
+
+  void Update(Slice value) {
+    auto value_type = static_cast<dockv::ValueEntryType>(value.consume_byte());
+    switch (value_type) {
+      case dockv::ValueEntryType::kInt32:
+        if (value.size() == sizeof(uint32_t)) {
+          UpdateInt(static_cast<int32_t>(BigEndian::Load32(value.data())));
+          return;
+        }
+        break;
+      case dockv::ValueEntryType::kInt64:
+        if (value.size() == sizeof(uint64_t)) {
+          UpdateInt(static_cast<int64_t>(BigEndian::Load64(value.data())));
+          return;
+        }
+        break;
+      case dockv::ValueEntryType::kFloat:
+        if (value.size() == sizeof(uint32_t)) {
+          UpdateReal(bit_cast<float>(BigEndian::Load32(value.data())));
+          return;
+        }
+        break;
+      case dockv::ValueEntryType::kDouble:
+        if (value.size() == sizeof(uint64_t)) {
+          UpdateReal(bit_cast<double>(BigEndian::Load64(value.data())));
+          return;
+        }
+        break;
+      default:
+        break;
+    }
+    valid = false;
+  }
+
+  void UpdateInt(int64_t value) {
+    if (!has_value) {
+      has_value = true;
+      min_int = max_int = value;
+      return;
+    }
+    if (is_real) {
+      valid = false;
+      return;
+    }
+    min_int = std::min(min_int, value);
+    max_int = std::max(max_int, value);
+  }
+
+  void UpdateReal(double value) {
+    // NaN is greater than any other value in QL, so it could not be represented by max.
+    if (std::isnan(value)) {
+      valid = false;
+      return;
+    }
+    if (!has_value) {
+      has_value = true;
+      is_real = true;
+      min_real = max_real = value;
+      return;
+    }
+    if (!is_real) {
+      valid = false;
+      return;
+    }
+    min_real = std::min(min_real, value);
+    max_real = std::max(max_real, value);
+  }
+};
+
+class ZoneMapCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  explicit ZoneMapCollector(SchemaPackingProvider* schema_packing_provider)
+      : schema_packing_provider_(schema_packing_provider),
+        valid_(FLAGS_docdb_collect_zone_maps) {}
+
+  Status AddUserKey(
+      const Slice& key, const Slice& value, rocksdb::EntryType type,
+      rocksdb::SequenceNumber /* seq */, uint64_t /* file_size */) override {
+    if (!valid_) {
+      return Status::OK();
+    }
+    // Zone map is optional, so failure to build it should not fail the flush or compaction.
+    auto result = ProcessEntry(key, value, type);
+    if (!result.ok() || !*result) {
+      VLOG_WITH_FUNC(2)
+          << "Zone map is not collected because of " << key.ToDebugHexString() << ": "
+          << (result.ok() ? Status::OK() : result.status());
+      valid_ = false;
+    }
+    return Status::OK();
+  }
+
+  Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    if (!valid_ || num_rows_ == 0) {
+      return Status::OK();
+    }
+    ZoneMapPB zone_map;
+    zone_map.set_num_rows(num_rows_);
+    for (const auto& [column_id, stats] : columns_) {
+      // Column that is missing from the packing of some rows, could have default value in them.
+      if (!stats.valid || stats.num_rows != num_rows_) {
+        continue;
+      }
+      auto& column = *zone_map.add_columns();
+      column.set_column_id(column_id.rep());
+      column.set_null_count(stats.null_count);
+      if (!stats.has_value) {
+        continue;
+      }
+      if (stats.is_real) {
+        column.set_min_real(stats.min_real);
+        column.set_max_real(stats.max_real);
+      } else {
+        column.set_min_int(stats.min_int);
+        column.set_max_int(stats.max_int);
+      }
+    }
+    if (!zone_map.columns().empty()) {
+      (*properties)[kZoneMapPropertyName] = zone_map.SerializeAsString();
+    }
+    return Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return rocksdb::UserCollectedProperties();
+  }
+
+  const char* Name() const override {
+    return "ZoneMapCollector";
+  }
+
+ private:
+  struct PackingInfo {
+    std::shared_ptr<const dockv::SchemaPacking> packing;
+    // Stats of packed columns, in the order of packing.
+    std::vector<ColumnStats*> columns;
+  };
+
+  // Returns false when entry prevents building of zone map for the file.
+  Result<bool> ProcessEntry(Slice key, Slice value, rocksdb::EntryType type) {
+    if (type != rocksdb::kEntryPut || key.empty() ||
+        key[0] == dockv::KeyEntryTypeAsChar::kColocationId ||
+        key[0] == dockv::KeyEntryTypeAsChar::kTableId) {
+      return false;
+    }
+    RETURN_NOT_OK(dockv::ValueControlFields::Decode(&value));
+    auto packed_row_version = dockv::ConsumePackedRowVersion(&value);
+    if (!packed_row_version) {
+      return false;
+    }
+    auto schema_version = narrow_cast<SchemaVersion>(
+        VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&value)));
+    const auto& packing_info = *VERIFY_RESULT(GetPacking(schema_version));
+    const auto& packing = *packing_info.packing;
+    ++num_rows_;
+    for (size_t idx = 0; idx != packing_info.columns.size(); ++idx) {
+      auto& stats = *packing_info.columns[idx];
+      ++stats.num_rows;
+      if (!stats.valid) {
+        continue;
+      }
+      auto column_value = packing.GetValue(*packed_row_version, idx, value);
+      // Remove buggy intent_doc_ht from start of the column. See #16650 for details.
+      if (column_value.TryConsumeByte(dockv::KeyEntryTypeAsChar::kHybridTime)) {
+        RETURN_NOT_OK(DocHybridTime::EncodedFromStart(&column_value));
+      }
+      if (column_value.empty()) {
+        ++stats.null_count;
+        continue;
+      }
+      stats.Update(column_value);
+    }
+    return true;
+  }
+
+  Result<const PackingInfo*> GetPacking(SchemaVersion schema_version) {
+    auto it = packings_.find(schema_version);
+    if (it != packings_.end()) {
+      return &it->second;
+    }
+    auto schema_info = VERIFY_RESULT(schema_packing_provider_->CotablePacking(
+        Uuid::Nil(), schema_version, HybridTime::kMax));
+    auto& packing_info = packings_[schema_version];
+    packing_info.packing = std::move(schema_info.schema_packing);
+    const auto& packing = *packing_info.packing;
+    packing_info.columns.reserve(packing.columns());
+    for (size_t idx = 0; idx != packing.columns(); ++idx) {
+      packing_info.columns.push_back(&columns_[packing.column_packing_data(idx).id]);
+    }
+    return &packing_info;
+  }
+
+  SchemaPackingProvider* const schema_packing_provider_;
+  bool valid_;
+  uint64_t num_rows_ = 0;
+  std::map<ColumnId, ColumnStats> columns_;
+  std::unordered_map<SchemaVersion, PackingInfo> packings_;
+};
+
+class ZoneMapCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  explicit ZoneMapCollectorFactory(SchemaPackingProvider* schema_packing_provider)
+      : schema_packing_provider_(schema_packing_provider) {}
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context /* context */) override {
+    return new ZoneMapCollector(schema_packing_provider_);
+  }
+
+  const char* Name() const override {
+    return "ZoneMapCollectorFactory";
+  }
+
+ private:
+  SchemaPackingProvider* const schema_packing_provider_;
+};
+
+QLOperator Mirror(QLOperator op) {
+  switch (op) {
+    case QL_OP_LESS_THAN:
+      return QL_OP_GREATER_THAN;
+    case QL_OP_LESS_THAN_EQUAL:
+      return QL_OP_GREATER_THAN_EQUAL;
+    case QL_OP_GREATER_THAN:
+      return QL_OP_LESS_THAN;
+    case QL_OP_GREATER_THAN_EQUAL:
+      return QL_OP_LESS_THAN_EQUAL;
+    default:
+      return op;
+  }
+}
+
+template <class T>
+bool RangeMayMatch(QLOperator op, T min, T max, const std::vector<T>& values) {
+  switch (op) {
+    case QL_OP_EQUAL: [[fallthrough]];
+    case QL_OP_IN:
+      return std::any_of(values.begin(), values.end(), [min, max](T value) {
+        return min <= value && value <= max;
+      });
+    case QL_OP_LESS_THAN:
+      return min < values.front();
+    case QL_OP_LESS_THAN_EQUAL:
+      return min <= values.front();
+    case QL_OP_GREATER_THAN:
+      return max > values.front();
+    case QL_OP_GREATER_THAN_EQUAL:
+      return max >= values.front();
+    default:
+      return true;
+  }
+}
+
+// Returns true when intents DB has intents of any transaction. Entries that do not belong to doc
+// keys, i.e. transaction metadata and reverse index, are ignored.
+// Since intents are checked before the iterator over regular DB is created, the value of the
+// applied transaction would be present either in intents or in regular DB that is read.
+Result<bool> HasIntents(const DocDB& doc_db) {
+  if (!doc_db.intents) {
+    return false;
+  }
+  rocksdb::ReadOptions read_options;
+  read_options.fill_cache = false;
+  std::unique_ptr<rocksdb::Iterator> iter(doc_db.intents->NewIterator(read_options));
+  for (auto* entry = &iter->SeekToFirst(); entry->Valid();) {
+    auto first_byte = static_cast<dockv::KeyEntryType>(entry->key[0]);
+    if (first_byte != dockv::KeyEntryType::kTransactionApplyState &&
+        first_byte != dockv::KeyEntryType::kExternalTransactionId &&
+        first_byte != dockv::KeyEntryType::kTransactionId) {
+      return true;
+    }
+    // Skip all entries with the same first byte.
+    char next_prefix = entry->key[0] + 1;
+    entry = &iter->Seek(Slice(&next_prefix, 1));
+  }
+  RETURN_NOT_OK(iter->status());
+  return false;
+}
+
+} // namespace
+
+std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> CreateZoneMapCollectorFactory(
+    SchemaPackingProvider* schema_packing_provider) {
+  return std::make_shared<ZoneMapCollectorFactory>(schema_packing_provider);
+}
+
+struct ZoneMapFileFilter::Condition {
+  ColumnId column_id;
+  QLOperator op;
+  bool is_real = false;
+  // Constants converted to the type of zone map bounds. Only IN could have several of them.
+  std::vector<int64_t> int_values;
+  std::vector<double> real_values;
+
+  // Converts constant to the type of zone map bounds. Returns false for NULL, NaN and not
+  // supported types.
+  bool AddValue(const QLValuePB& value) {
+    std::optional<int64_t> int_value;
+    std::optional<double> real_value;
+    switch (value.value_case()) {
+      case QLValuePB::kInt8Value:
+        int_value = value.int8_value();
+        break;
+      case QLValuePB::kInt16Value:
+        int_value = value.int16_value();
+        break;
+      case QLValuePB::kInt32Value:
+        int_value = value.int32_value();
+        break;
+      case QLValuePB::kInt64Value:
+        int_value = value.int64_value();
+        break;
+      case QLValuePB::kFloatValue:
+        real_value = value.float_value();
+        break;
+      case QLValuePB::kDoubleValue:
+        real_value = value.double_value();
+        break;
+      default:
+        return false;
+    }
+    if (int_values.empty() && real_values.empty()) {
+      is_real = real_value.has_value();
+    }
+    if (int_value && !is_real) {
+      int_values.push_back(*int_value);
+      return true;
+    }
+    if (real_value && is_real && !std::isnan(*real_value)) {
+      real_values.push_back(*real_value);
+      return true;
+    }
+    return false;
+  }
+
+  bool MayMatch(uint64_t num_rows, const ColumnZoneMapPB& column) const {
+    switch (op) {
+      case QL_OP_IS_NULL:
+        return column.null_count() != 0;
+      case QL_OP_IS_NOT_NULL:
+        return column.null_count() != num_rows;
+      default:
+        break;
+    }
+    // NULL does not satisfy comparison, so file with NULL only values could be skipped.
+    if (!column.has_min_int() && !column.has_min_real()) {
+      return false;
+    }
+    if (is_real != column.has_min_real()) {
+      return true;
+    }
+    return is_real ? RangeMayMatch(op, column.min_real(), column.max_real(), real_values)
+                   : RangeMayMatch(op, column.min_int(), column.max_int(), int_values);
+  }
+};
+
+ZoneMapFileFilter::ZoneMapFileFilter() = default;
+ZoneMapFileFilter::~ZoneMapFileFilter() = default;
+
+void ZoneMapFileFilter::Add(
+    const PgsqlExpressionPB& where_clause,
+    const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs) {
+  if (where_clause.has_condition()) {
+    Add(where_clause.condition());
+    return;
+  }
+  PgsqlConditionPB condition;
+  if (ConvertPgExprToCondition(where_clause, col_refs, &condition)) {
+    Add(condition);
+  }
+}
+
+void ZoneMapFileFilter::Add(const PgsqlConditionPB& condition) {
+  const auto& operands = condition.operands();
+  auto op = condition.op();
+  switch (op) {
+    case QL_OP_AND:
+      for (const auto& operand : operands) {
+        Add(operand);
+      }
+      return;
+    case QL_OP_IS_NULL: [[fallthrough]];
+    case QL_OP_IS_NOT_NULL:
+      if (operands.size() == 1 && operands.Get(0).has_column_id()) {
+        conditions_.push_back(Condition {
+          .column_id = ColumnId(operands.Get(0).column_id()),
+          .op = op,
+        });
+      }
+      return;
+    case QL_OP_IN: {
+      if (operands.size() != 2 || !operands.Get(0).has_column_id() ||
+          !operands.Get(1).has_value() || !operands.Get(1).value().has_list_value()) {
+        return;
+      }
+      Condition result {
+        .column_id = ColumnId(operands.Get(0).column_id()),
+        .op = op,
+      };
+      for (const auto& elem : operands.Get(1).value().list_value().elems()) {
+        if (!result.AddValue(elem)) {
+          return;
+        }
+      }
+      if (!result.int_values.empty() || !result.real_values.empty()) {
+        conditions_.push_back(std::move(result));
+      }
+      return;
+    }
+    case QL_OP_EQUAL: [[fallthrough]];
+    case QL_OP_LESS_THAN: [[fallthrough]];
+    case QL_OP_LESS_THAN_EQUAL: [[fallthrough]];
+    case QL_OP_GREATER_THAN: [[fallthrough]];
+    case QL_OP_GREATER_THAN_EQUAL: {
+      if (operands.size() != 2) {
+        return;
+      }
+      const auto* column = &operands.Get(0);
+      const auto* constant = &operands.Get(1);
+      if (!column->has_column_id()) {
+        std::swap(column, constant);
+        op = Mirror(op);
+      }
+      if (!column->has_column_id() || !constant->has_value()) {
+        return;
+      }
+      Condition result {
+        .column_id = ColumnId(column->column_id()),
+        .op = op,
+      };
+      if (result.AddValue(constant->value())) {
+        conditions_.push_back(std::move(result));
+      }
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+bool ZoneMapFileFilter::Filter(rocksdb::TableReader* reader) const {
+  auto properties = reader->GetTableProperties();
+  return !properties || MayMatch(properties->user_collected_properties);
+}
+
+bool ZoneMapFileFilter::MayMatch(const rocksdb::UserCollectedProperties& properties) const {
+  auto it = properties.find(kZoneMapPropertyName);
+  if (it == properties.end()) {
+    return true;
+  }
+  ZoneMapPB zone_map;
+  if (!zone_map.ParseFromString(it->second)) {
+    LOG(DFATAL) << "Failed to parse zone map: " << Slice(it->second).ToDebugHexString();
+    return true;
+  }
+  for (const auto& condition : conditions_) {
+    for (const auto& column : zone_map.columns()) {
+      if (column.column_id() == condition.column_id.rep() &&
+          !condition.MayMatch(zone_map.num_rows(), column)) {
+        VLOG_WITH_FUNC(4) << "Skip file with zone map: " << zone_map.ShortDebugString();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+Result<std::shared_ptr<ZoneMapFileFilter>> CreateZoneMapFileFilter(
+    const PgsqlReadRequestPB& request, const DocDB& doc_db) {
+  // Rows of the request with index request are fetched by ybctid found in the index.
+  if (!FLAGS_ysql_use_zone_map_file_filter || request.where_clauses().empty() ||
+      request.has_index_request() || request.is_for_backfill()) {
+    return nullptr;
+  }
+  auto result = std::make_shared<ZoneMapFileFilter>();
+  for (const auto& where_clause : request.where_clauses()) {
+    result->Add(where_clause, request.col_refs());
+  }
+  if (result->empty() || VERIFY_RESULT(HasIntents(doc_db))) {
+    return nullptr;
+  }
+  return result;
+}
+
+} // namespace yb::docdb
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <google/protobuf/repeated_field.h>
+
+#include "yb/common/pgsql_protocol.fwd.h"
+
+#include "yb/docdb/docdb_fwd.h"
+
+#include "yb/rocksdb/options.h"
+#include "yb/rocksdb/table_properties.h"
+
+#include "yb/util/result.h"
+
+namespace yb::docdb {
+
+// Name of the user collected SST file property that contains serialized ZoneMapPB.
+extern const char kZoneMapPropertyName[];
+
+// Creates factory of collectors that build zone map of SST file, i.e. min/max and null count of
+// fixed size numeric columns over all rows in the file.
+// Zone map is built only for files that contain just packed rows of the primary table, since
+// otherwise values of the row could be spread across several entries.
+std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> CreateZoneMapCollectorFactory(
+    SchemaPackingProvider* schema_packing_provider);
+
+// Skips SST files whose zone map shows that no row in the file satisfies the conditions.
+// Supported conditions are comparisons of integer or floating point column with a constant,
+// IN with a list of constants, IS [NOT] NULL and AND of them.
+//
+// Should be used as rocksdb::ReadOptions::isolated_file_filter, since a file could hold an
+// older version of a row whose latest version is stored in another file or memtable.
+class ZoneMapFileFilter : public rocksdb::TableAwareReadFileFilter {
+ public:
+  ZoneMapFileFilter();
+  ~ZoneMapFileFilter();
+
+  // Adds supported parts of the where clause to the filter. Unsupported parts are ignored, since
+  // a file is skipped only when one of the conditions cannot be satisfied by any of its rows.
+  // Serialized Postgres expressions are converted using col_refs, see ConvertPgExprToCondition.
+  void Add(
+      const PgsqlExpressionPB& where_clause,
+      const google::protobuf::RepeatedPtrField<PgsqlColRefPB>& col_refs = {});
+
+  void Add(const PgsqlConditionPB& condition);
+
+  bool empty() const {
+    return conditions_.empty();
+  }
+
+  bool Filter(rocksdb::TableReader* reader) const override;
+
+  // Returns false when zone map in properties shows that no row satisfies the conditions.
+  bool MayMatch(const rocksdb::UserCollectedProperties& properties) const;
+
+ private:
+  struct Condition;
+
+  std::vector<Condition> conditions_;
+};
+
+// Creates filter for where clauses of the YSQL read request. Returns nullptr when zone map
+// filtering is disabled, none of the where clauses could be checked against zone map, or intents
+// DB has intents. Intents are not covered by zone maps, and could be resolved to a newer version
+// of a row stored in the skipped file.
+Result<std::shared_ptr<ZoneMapFileFilter>> CreateZoneMapFileFilter(
+    const PgsqlReadRequestPB& request, const DocDB& doc_db);
+
+} // namespace yb::docdb
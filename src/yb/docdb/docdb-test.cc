@@ -52,6 +52,7 @@
 #include "yb/util/size_literals.h"
 #include "yb/util/status_log.h"
 #include "yb/util/string_trim.h"
+#include "yb/util/sync_point.h"
 #include "yb/util/strongly_typed_bool.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
@@ -70,6 +71,8 @@ using namespace std::literals;
 DECLARE_bool(TEST_docdb_sort_weak_intents);
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_int32(rocksdb_max_subcompactions);
+DECLARE_int64(db_block_size_bytes);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
 
@@ -4365,6 +4368,59 @@ TEST_P(DocDBTestWrapper, ScanForwardWithDuplicateKeys) {
   )#");
 }
 
+// Sync points are not available in release builds.
+#ifndef NDEBUG
+TEST_P(DocDBTestWrapper, SubcompactionBoundaries) {
+  // Small blocks produce a lot of index separators. Separators are shortened, so most of them are
+  // not valid DocDB keys and could not be used as subcompaction boundaries directly.
+  ASSERT_OK(SET_FLAG(db_block_size_bytes, 256));
+  ASSERT_OK(SET_FLAG(rocksdb_max_subcompactions, 4));
+  ASSERT_OK(ReinitDBOptions());
+  regular_db_options_.target_file_size_base = 8_KB;
+  ASSERT_OK(ReopenRocksDB());
+
+  // Both files cover the whole key range, so all boundaries inside it come from key anchors.
+  constexpr int kNumKeys = 2000;
+  for (int flush = 0; flush != 2; ++flush) {
+    for (int i = 1; i <= kNumKeys; ++i) {
+      ASSERT_OK(WriteSimple(i));
+    }
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  std::vector<std::string> boundaries;
+  yb::SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::GenSubcompactionBoundaries:End", [&boundaries](void* arg) {
+    for (const auto& boundary : *static_cast<std::vector<Slice>*>(arg)) {
+      boundaries.push_back(boundary.ToBuffer());
+    }
+  });
+  yb::SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(ForceRocksDBCompact(rocksdb(), rocksdb::CompactRangeOptions()));
+  yb::SyncPoint::GetInstance()->DisableProcessing();
+  yb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  LOG(INFO) << "Boundaries: " << AsString(boundaries);
+  ASSERT_FALSE(boundaries.empty());
+  for (const auto& boundary : boundaries) {
+    // Each boundary should be a whole encoded DocKey, so a document is not split.
+    ASSERT_EQ(
+        ASSERT_RESULT(dockv::DocKey::EncodedSize(boundary, dockv::DocKeyPart::kWholeDocKey)),
+        boundary.size()) << Slice(boundary).ToDebugHexString();
+  }
+
+  rocksdb::ReadOptions read_opts;
+  read_opts.query_id = rocksdb::kDefaultQueryId;
+  unique_ptr<rocksdb::Iterator> iter(rocksdb()->NewIterator(read_opts));
+  int num_keys = 0;
+  for (iter->SeekToFirst(); ASSERT_RESULT(iter->CheckedValid()); iter->Next()) {
+    ++num_keys;
+  }
+  // Duplicates from the second file are removed by the compaction.
+  ASSERT_EQ(num_keys, kNumKeys);
+}
+#endif // NDEBUG
+
 class DocDBPerfTest : public DocDBTest {
  public:
   // Size of block cache for RocksDB, 0 means don't use block cache.
@@ -28,6 +28,7 @@
 #include "yb/dockv/value_type.h"
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/util/statistics.h"
 
 #include "yb/util/memory/arena.h"
 #include "yb/util/fast_varint.h"
@@ -62,8 +63,14 @@ struct OverwriteData {
   }
 };
 
-Result<SchemaVersion> ParseValueHeader(Slice* value) {
-  value->consume_byte(); // TODO(packed_row) control_fields
+Result<SchemaVersion> ParseValueHeader(
+    Slice* value, dockv::PackedRowVersion* packed_row_version = nullptr) {
+  // TODO(packed_row) control_fields
+  auto version = dockv::ConsumePackedRowVersion(value);
+  RSTATUS_DCHECK(version, Corruption, "Packed row expected: $0", value->ToDebugHexString());
+  if (packed_row_version) {
+    *packed_row_version = *version;
+  }
   return narrow_cast<SchemaVersion>(VERIFY_RESULT(util::FastDecodeUnsignedVarInt(value)));
 }
 
@@ -119,6 +126,10 @@ class PackedRowData {
     return can_start_packing_;
   }
 
+  size_t num_repacked_rows() const {
+    return num_repacked_rows_;
+  }
+
   bool ColumnDeleted(ColumnId column_id) const {
     return new_packing_.deleted_cols.count(column_id) != 0;
   }
@@ -165,8 +176,11 @@ class PackedRowData {
 
     old_value_.Assign(full_value);
     old_value_slice_ = old_value_.AsSlice().WithoutPrefix(control_fields_size);
-    old_schema_version_ = VERIFY_RESULT(ParseValueHeader(&old_value_slice_));
+    old_schema_version_ = VERIFY_RESULT(ParseValueHeader(
+        &old_value_slice_, &old_packed_row_version_));
     if (old_schema_version_ != new_packing_.schema_version) {
+      // Row is repacked to the latest schema version, dropping values of deleted columns.
+      ++num_repacked_rows_;
       return StartRepacking();
     }
     packing_started_ = false;
@@ -223,7 +237,8 @@ class PackedRowData {
 
     size_t tail_size = 0; // As usual, when not specified size is in bytes.
     if (!old_value_slice_.empty()) {
-      auto old_value = old_packing_.schema_packing->GetValue(column_id, old_value_slice_);
+      auto old_value = old_packing_.schema_packing->GetValue(
+          old_packed_row_version_, column_id, old_value_slice_);
       if (old_value) {
         tail_size = old_value_slice_.end() - old_value->end();
       }
@@ -303,7 +318,8 @@ class PackedRowData {
   Status PackOldValue(ColumnId column_id) {
     auto column_value = old_value_slice_.empty()
         ? std::optional<Slice>()
-        : old_packing_.schema_packing->GetValue(column_id, old_value_slice_);
+        : old_packing_.schema_packing->GetValue(
+              old_packed_row_version_, column_id, old_value_slice_);
     if (!column_value) {
       const auto& column_data = VERIFY_RESULT_REF(packer_->NextColumnData());
       RSTATUS_DCHECK(column_data.varlen(), Corruption, Format(
@@ -396,11 +412,15 @@ class PackedRowData {
   ValueBuffer old_value_;
   ValueBuffer control_fields_buffer_;
   Slice old_value_slice_;
+  dockv::PackedRowVersion old_packed_row_version_ = dockv::PackedRowVersion::kV1;
   SchemaVersion old_schema_version_;
   CompactionSchemaInfo old_packing_;
 
   bool packing_started_ = false; // Whether we have started packing the row.
 
+  // Number of packed rows with old schema version, that were repacked to the new one.
+  size_t num_repacked_rows_ = 0;
+
   // Use fake coprefix as default value.
   // So we will trigger table change on the first record.
   ByteBuffer<1 + kUuidSize> active_coprefix_{"FAKE_PREFIX"s};
@@ -436,7 +456,8 @@ class DocDBCompactionFeed : public rocksdb::CompactionFeed, public PackedRowFeed
       HybridTime min_other_data_ht,
       rocksdb::BoundaryValuesExtractor* boundary_extractor,
       const KeyBounds* key_bounds,
-      SchemaPackingProvider* schema_packing_provider)
+      SchemaPackingProvider* schema_packing_provider,
+      rocksdb::Statistics* statistics)
       : next_feed_(*next_feed),
         retention_(retention),
         // Use max write id, to be sure that entries with hybrid time equals to history cutoff
@@ -452,6 +473,7 @@ class DocDBCompactionFeed : public rocksdb::CompactionFeed, public PackedRowFeed
         could_change_key_range_(
             !CanHaveOtherDataBefore(EncodedDocHybridTime(min_input_hybrid_time, kMinWriteId))),
         boundary_extractor_(boundary_extractor),
+        statistics_(statistics),
         packed_row_(this, schema_packing_provider, retention_.history_cutoff) {
   }
 
@@ -510,6 +532,8 @@ class DocDBCompactionFeed : public rocksdb::CompactionFeed, public PackedRowFeed
 
   Status Flush() override {
     RETURN_NOT_OK(packed_row_.Flush());
+    rocksdb::RecordTick(
+        statistics_, rocksdb::COMPACTION_PACKED_ROWS_REPACKED, packed_row_.num_repacked_rows());
     if (first_pending_row_) {
       return STATUS(IllegalState, "Have pending rows after packed row flush");
     }
@@ -585,6 +609,7 @@ class DocDBCompactionFeed : public rocksdb::CompactionFeed, public PackedRowFeed
   const EncodedDocHybridTime encoded_min_other_data_ht_;
   const bool could_change_key_range_;
   rocksdb::BoundaryValuesExtractor* boundary_extractor_;
+  rocksdb::Statistics* statistics_;
   ValueBuffer new_value_buffer_;
 
   std::vector<char> prev_subdoc_key_;
@@ -817,7 +842,7 @@ Status DocDBCompactionFeed::Feed(const Slice& internal_key, const Slice& value)
         << encoded_history_cutoff_.ToString();
     auto value_slice = value;
     RETURN_NOT_OK(ValueControlFields::Decode(&value_slice));
-    if (dockv::DecodeValueEntryType(value_slice) == dockv::ValueEntryType::kPackedRow) {
+    if (dockv::GetPackedRowVersion(dockv::DecodeValueEntryType(value_slice))) {
       // Check packed row version for rows left untouched.
       RETURN_NOT_OK(packed_row_.ProcessForwardedPackedRow(value_slice));
     }
@@ -968,7 +993,7 @@ Status DocDBCompactionFeed::Feed(const Slice& internal_key, const Slice& value)
     new_value_buffer_.Append(value_slice);
     new_value = new_value_buffer_.AsSlice();
     within_merge_block_ = false;
-  } else if (value_type == dockv::ValueEntryType::kPackedRow) {
+  } else if (dockv::GetPackedRowVersion(value_type)) {
     return packed_row_.ProcessPackedRow(
         internal_key, sub_key_ends_.back(), value, value_slice.data() - value.data(),
         encoded_doc_ht, doc_key_serial_);
@@ -1004,7 +1029,8 @@ class DocDBCompactionContext : public rocksdb::CompactionContext {
       HybridTime min_other_data_ht,
       rocksdb::BoundaryValuesExtractor* boundary_extractor,
       const KeyBounds* key_bounds,
-      SchemaPackingProvider* schema_packing_provider);
+      SchemaPackingProvider* schema_packing_provider,
+      rocksdb::Statistics* statistics);
 
   ~DocDBCompactionContext() = default;
 
@@ -1047,12 +1073,13 @@ DocDBCompactionContext::DocDBCompactionContext(
     HybridTime min_other_data_ht,
     rocksdb::BoundaryValuesExtractor* boundary_extractor,
     const KeyBounds* key_bounds,
-    SchemaPackingProvider* schema_packing_provider)
+    SchemaPackingProvider* schema_packing_provider,
+    rocksdb::Statistics* statistics)
     : history_cutoff_(retention.history_cutoff),
       key_bounds_(key_bounds),
       feed_(std::make_unique<DocDBCompactionFeed>(
           next_feed, std::move(retention), min_input_hybrid_time, min_other_data_ht,
-          boundary_extractor, key_bounds, schema_packing_provider)) {
+          boundary_extractor, key_bounds, schema_packing_provider, statistics)) {
 }
 
 rocksdb::UserFrontierPtr DocDBCompactionContext::GetLargestUserFrontier() const {
@@ -1151,7 +1178,8 @@ std::shared_ptr<rocksdb::CompactionContextFactory> CreateCompactionContextFactor
             : HybridTime::kMax,
         options.boundary_extractor,
         key_bounds,
-        schema_packing_provider);
+        schema_packing_provider,
+        options.statistics);
   });
 }
 
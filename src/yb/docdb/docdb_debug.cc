@@ -107,7 +107,7 @@ std::string EntryToString(
   if (value_res.ok()) {
     value_str = *value_res;
   } else if (value_res.status().IsNotFound() &&
-             value_copy.TryConsumeByte(dockv::ValueEntryTypeAsChar::kPackedRow)) {
+             dockv::ConsumePackedRowVersion(&value_copy)) {
     auto version = util::FastDecodeUnsignedVarInt(&value_copy);
     if (!version.ok()) {
       value_str = version.status().ToString();
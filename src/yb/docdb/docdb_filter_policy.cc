@@ -106,6 +106,18 @@ DocDbAwareV2FilterPolicy::GetKeyTransformer() const {
   return &HashedDocKeyUpToHashComponentsExtractor::GetInstance();
 }
 
+const char* DocDbAwareV3FilterPolicy::Name() const {
+  switch (format_) {
+    case rocksdb::FixedSizeFilterFormat::kBloom:
+      return "DocKeyV3Filter";
+    case rocksdb::FixedSizeFilterFormat::kBlockedBloom:
+      return "DocKeyV3BlockedBloomFilter";
+    case rocksdb::FixedSizeFilterFormat::kRibbon:
+      return "DocKeyV3RibbonFilter";
+  }
+  FATAL_INVALID_ENUM_VALUE(rocksdb::FixedSizeFilterFormat, format_);
+}
+
 const rocksdb::FilterPolicy::KeyTransformer*
 DocDbAwareV3FilterPolicy::GetKeyTransformer() const {
   return &DocKeyComponentsExtractor<dockv::DocKeyPart::kUpToHashOrFirstRange>::GetInstance();
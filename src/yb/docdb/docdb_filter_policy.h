@@ -19,9 +19,12 @@ namespace yb::docdb {
 
 class DocDbAwareFilterPolicyBase : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicyBase(size_t filter_block_size_bits, rocksdb::Logger* logger) {
+  explicit DocDbAwareFilterPolicyBase(
+      size_t filter_block_size_bits, rocksdb::Logger* logger,
+      rocksdb::FixedSizeFilterFormat format = rocksdb::FixedSizeFilterFormat::kBloom) {
     builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger,
+        format));
   }
 
   void CreateFilter(const Slice* keys, int n, std::string* dst) const override;
@@ -68,14 +71,21 @@ class DocDbAwareV2FilterPolicy : public DocDbAwareFilterPolicyBase {
 // use all hash components of the doc key.
 // - For hash-based partitioned tables (such tables have >0 hashed components):
 // use first range component of the doc key.
+// Format of filter blocks is part of the name, except for bloom filter format which is used by
+// files written before other formats were introduced.
 class DocDbAwareV3FilterPolicy : public DocDbAwareFilterPolicyBase {
  public:
-  DocDbAwareV3FilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger)
-      : DocDbAwareFilterPolicyBase(filter_block_size_bits, logger) {}
+  DocDbAwareV3FilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger,
+      rocksdb::FixedSizeFilterFormat format = rocksdb::FixedSizeFilterFormat::kBloom)
+      : DocDbAwareFilterPolicyBase(filter_block_size_bits, logger, format), format_(format) {}
 
-  const char* Name() const override { return "DocKeyV3Filter"; }
+  const char* Name() const override;
 
   const KeyTransformer* GetKeyTransformer() const override;
+
+ private:
+  rocksdb::FixedSizeFilterFormat format_;
 };
 
 }  // namespace yb::docdb
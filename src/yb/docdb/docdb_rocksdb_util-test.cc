@@ -13,15 +13,19 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/rocksdb/table.h"
+#include "yb/rocksdb/util/compression.h"
 
+#include "yb/util/flags.h"
 #include "yb/util/result.h"
 #include "yb/util/test_util.h"
 
 DECLARE_int32(num_cpus);
 DECLARE_int32(rocksdb_max_background_flushes);
 DECLARE_bool(rocksdb_disable_compactions);
+DECLARE_bool(enable_zstd_compression);
 DECLARE_int32(rocksdb_base_background_compactions);
 DECLARE_int32(rocksdb_max_background_compactions);
+DECLARE_int32(rocksdb_max_subcompactions);
 DECLARE_int32(priority_thread_pool_size);
 DECLARE_int32(block_restart_interval);
 DECLARE_int32(index_block_restart_interval);
@@ -51,6 +55,19 @@ TEST_F(DocDBRocksDBUtilTest, CaseInsensitiveCompressionType) {
 
   got_compression_type = CHECK_RESULT(TEST_GetConfiguredCompressionType("zLiB"));
   ASSERT_EQ(got_compression_type, rocksdb::kZlibCompression);
+
+  if (rocksdb::ZSTD_Supported()) {
+    ASSERT_OK(SET_FLAG(enable_zstd_compression, true));
+    got_compression_type = CHECK_RESULT(TEST_GetConfiguredCompressionType("Zstd"));
+    ASSERT_EQ(got_compression_type, rocksdb::kZSTD);
+
+    // ZSTD is not used until the AutoFlag is promoted.
+    ASSERT_OK(SET_FLAG(enable_zstd_compression, false));
+    got_compression_type = CHECK_RESULT(TEST_GetConfiguredCompressionType("Zstd"));
+    ASSERT_EQ(got_compression_type, rocksdb::kSnappyCompression);
+  } else {
+    ASSERT_NOK(TEST_GetConfiguredCompressionType("Zstd"));
+  }
 }
 
 TEST_F(DocDBRocksDBUtilTest, MaxBackgroundFlushesDefault) {
@@ -108,6 +125,17 @@ TEST_F(DocDBRocksDBUtilTest, MaxBackgroundCompactionsExplicit) {
   CHECK_EQ(options.max_background_compactions, 23);
 }
 
+TEST_F(DocDBRocksDBUtilTest, MaxSubcompactions) {
+  auto options = TEST_AutoInitFromRocksDBFlags();
+  ASSERT_EQ(options.max_subcompactions, 1U);
+  ASSERT_OK(SET_FLAG(rocksdb_max_subcompactions, 4));
+  options = TEST_AutoInitFromRocksDBFlags();
+  ASSERT_EQ(options.max_subcompactions, 4U);
+  ASSERT_NOK(SET_FLAG(rocksdb_max_subcompactions, 0));
+  ASSERT_NOK(SET_FLAG(rocksdb_max_subcompactions, -1));
+  ASSERT_EQ(FLAGS_rocksdb_max_subcompactions, 4);
+}
+
 TEST_F(DocDBRocksDBUtilTest, PriorityThreadPoolSizeDefaultLowCpus) {
   ANNOTATE_UNPROTECTED_WRITE(FLAGS_num_cpus) = 3;
   CHECK_EQ(GetGlobalRocksDBPriorityThreadPoolSize(), 1);
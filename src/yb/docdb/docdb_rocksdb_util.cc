@@ -13,6 +13,7 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
 #include <memory>
 #include <thread>
 
@@ -78,6 +79,9 @@ DEFINE_UNKNOWN_int32(rocksdb_base_background_compactions, -1,
 DEFINE_UNKNOWN_int32(rocksdb_max_background_compactions, -1,
              "Increased number of threads to do background compactions (used when compactions need "
              "to catch up.) Unless rocksdb_disable_compactions=true, this cannot be set to zero.");
+DEFINE_NON_RUNTIME_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of threads used by a single compaction to process disjoint key ranges "
+             "in parallel. Should be positive, 1 disables subcompactions.");
 DEFINE_UNKNOWN_int32(rocksdb_level0_file_num_compaction_trigger, 5,
              "Number of files to trigger level-0 compaction. -1 if compaction should not be "
              "triggered by number of files at all.");
@@ -125,8 +129,40 @@ DEFINE_UNKNOWN_int32(memstore_size_mb, 128,
 DEFINE_UNKNOWN_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
 
+DEFINE_NON_RUNTIME_string(docdb_bloom_filter_format, "bloom",
+              "Format of filter blocks written by DocDbAwareFilterPolicy: bloom, blocked_bloom or "
+              "ribbon. Files written using any of the formats could be read regardless of this "
+              "flag. Formats other than bloom are used only after "
+              "enable_docdb_bloom_filter_formats is promoted.");
+
+// Using class kExternal as this change affects the format of data in the SST files which are sent
+// to xClusters during bootstrap.
+DEFINE_RUNTIME_AUTO_bool(enable_docdb_bloom_filter_formats, kExternal, false, true,
+    "Whether filter blocks of new SST files could be written in the format specified by "
+    "docdb_bloom_filter_format. When not set, bloom format is used, since other formats could "
+    "not be read by older versions.");
+
 DEFINE_UNKNOWN_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
 
+DEFINE_NON_RUNTIME_bool(cache_bloom_filter_index, false,
+            "Whether to load index of bloom filter blocks on demand through the block cache, "
+            "instead of keeping it in memory for each open SST file.");
+
+// Using class kExternal as this change affects the format of data in the SST files which are sent
+// to xClusters during bootstrap.
+DEFINE_RUNTIME_AUTO_bool(use_data_block_hash_index, kExternal, false, true,
+    "Whether to add hash index to data blocks of new SST files, so point lookup inside data block "
+    "does not need binary search over restart points.");
+
+DEFINE_NON_RUNTIME_uint64(db_auto_readahead_initial_size_bytes, 64_KB,
+            "Size of the first readahead issued by the iterator after it detects sequential reads "
+            "of SST data blocks.");
+
+DEFINE_NON_RUNTIME_uint64(db_auto_readahead_max_size_bytes, 2_MB,
+            "Max size of the readahead issued by the iterator during sequential reads of SST data "
+            "blocks. Readahead size doubles on each request until it reaches this value. "
+            "0 disables readahead.");
+
 // Using class kExternal as this change affects the format of data in the SST files which are sent
 // to xClusters during bootstrap.
 DEFINE_RUNTIME_AUTO_string(regular_tablets_data_block_key_value_encoding, kExternal,
@@ -152,6 +188,22 @@ DEFINE_UNKNOWN_string(compression_type, "Snappy",
               "On-disk compression type to use in RocksDB."
               "By default, Snappy is used if supported.");
 
+// Using class kExternal as this change affects the format of data in the SST files which are sent
+// to xClusters during bootstrap.
+DEFINE_RUNTIME_AUTO_bool(enable_zstd_compression, kExternal, false, true,
+    "Whether new SST files could be compressed with ZSTD, when compression_type is Zstd. When not "
+    "set, Snappy is used instead, since SST files compressed with ZSTD, with or without "
+    "dictionary, could not be read by older versions.");
+
+DEFINE_NON_RUNTIME_uint32(compression_dict_max_bytes, 16_KB,
+              "Maximal size of dictionary trained for ZSTD compression of data blocks in SST files "
+              "produced by compaction. Only used when compression_type is Zstd. 0 disables "
+              "dictionary compression.");
+
+DEFINE_NON_RUNTIME_uint32(compression_dict_max_train_bytes, 1_MB,
+              "Maximal size of data blocks buffered and sampled to train ZSTD compression "
+              "dictionary.");
+
 DEFINE_UNKNOWN_int32(block_restart_interval, kDefaultDataBlockRestartInterval,
              "Controls the number of keys to look at for computing the diff encoding.");
 
@@ -161,6 +213,15 @@ DEFINE_UNKNOWN_int32(index_block_restart_interval, kDefaultIndexBlockRestartInte
 DEFINE_UNKNOWN_bool(prioritize_tasks_by_disk, false,
             "Consider disk load when considering compaction and flush priorities.");
 
+DEFINE_NON_RUNTIME_uint64(memtable_insert_min_entries_per_thread, 4096,
+            "Min number of write batch entries inserted into the memtable by a single thread, "
+            "when memtable insert thread pool is enabled.");
+
+DEFINE_NON_RUNTIME_string(regular_db_memtable_rep, "skiplist",
+            "Memtable representation used by regular RocksDB: skiplist or btree. btree keeps "
+            "entries in a B+-tree, that is faster for lookups of keys with long common prefixes, "
+            "but does not support concurrent memtable inserts.");
+
 namespace yb {
 
 namespace {
@@ -173,11 +234,15 @@ Result<rocksdb::CompressionType> GetConfiguredCompressionType(const std::string&
     rocksdb::kNoCompression,
     rocksdb::kSnappyCompression,
     rocksdb::kZlibCompression,
-    rocksdb::kLZ4Compression
+    rocksdb::kLZ4Compression,
+    rocksdb::kZSTD
   };
   for (const auto& compression_type : kValidRocksDBCompressionTypes) {
     if (boost::iequals(flag_value, rocksdb::CompressionTypeToString(compression_type))) {
       if (rocksdb::CompressionTypeSupported(compression_type)) {
+        if (compression_type == rocksdb::kZSTD && !FLAGS_enable_zstd_compression) {
+          return rocksdb::kSnappyCompression;
+        }
         return compression_type;
       }
       return STATUS_FORMAT(
@@ -188,6 +253,31 @@ Result<rocksdb::CompressionType> GetConfiguredCompressionType(const std::string&
       InvalidArgument, "Configured compression type $0 is not valid.", flag_value);
 }
 
+Result<rocksdb::FixedSizeFilterFormat> GetConfiguredBloomFilterFormat(
+    const std::string& flag_value) {
+  static const std::pair<const char*, rocksdb::FixedSizeFilterFormat> kFormats[] = {
+    {"bloom", rocksdb::FixedSizeFilterFormat::kBloom},
+    {"blocked_bloom", rocksdb::FixedSizeFilterFormat::kBlockedBloom},
+    {"ribbon", rocksdb::FixedSizeFilterFormat::kRibbon},
+  };
+  for (const auto& [name, format] : kFormats) {
+    if (boost::iequals(flag_value, name)) {
+      return format;
+    }
+  }
+  return STATUS_FORMAT(InvalidArgument, "Bloom filter format $0 is not valid.", flag_value);
+}
+
+Result<bool> IsBTreeMemTableRep(const std::string& flag_value) {
+  if (boost::iequals(flag_value, "btree")) {
+    return true;
+  }
+  if (boost::iequals(flag_value, "skiplist")) {
+    return false;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Memtable representation $0 is not valid.", flag_value);
+}
+
 } // namespace
 
 namespace docdb {
@@ -219,6 +309,32 @@ bool CompressionTypeValidator(const char* flagname, const std::string& flag_comp
   return true;
 }
 
+bool BloomFilterFormatValidator(const char* flag_name, const std::string& flag_value) {
+  auto res = yb::GetConfiguredBloomFilterFormat(flag_value);
+  bool ok = res.ok();
+  if (!ok) {
+    LOG(ERROR) << flag_name << ": " << res.status();
+  }
+  return ok;
+}
+
+bool MemTableRepValidator(const char* flag_name, const std::string& flag_value) {
+  auto res = yb::IsBTreeMemTableRep(flag_value);
+  bool ok = res.ok();
+  if (!ok) {
+    LOG(ERROR) << flag_name << ": " << res.status();
+  }
+  return ok;
+}
+
+bool MaxSubcompactionsValidator(const char* flag_name, int32_t flag_value) {
+  if (flag_value >= 1) {
+    return true;
+  }
+  LOG(ERROR) << flag_name << ": should be positive, value " << flag_value << " is invalid";
+  return false;
+}
+
 bool KeyValueEncodingFormatValidator(const char* flag_name, const std::string& flag_value) {
   auto res = yb::docdb::GetConfiguredKeyValueEncodingFormat(flag_value);
   bool ok = res.ok();
@@ -231,7 +347,10 @@ bool KeyValueEncodingFormatValidator(const char* flag_name, const std::string& f
 } // namespace
 
 DEFINE_validator(compression_type, &CompressionTypeValidator);
+DEFINE_validator(docdb_bloom_filter_format, &BloomFilterFormatValidator);
 DEFINE_validator(regular_tablets_data_block_key_value_encoding, &KeyValueEncodingFormatValidator);
+DEFINE_validator(regular_db_memtable_rep, &MemTableRepValidator);
+DEFINE_validator(rocksdb_max_subcompactions, &MaxSubcompactionsValidator);
 
 using std::shared_ptr;
 using std::string;
@@ -261,7 +380,8 @@ rocksdb::ReadOptions PrepareReadOptions(
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
     const Slice* iterate_upper_bound,
-    rocksdb::Statistics* statistics) {
+    rocksdb::Statistics* statistics,
+    std::shared_ptr<rocksdb::TableAwareReadFileFilter> isolated_file_filter = nullptr) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
   if (FLAGS_use_docdb_aware_bloom_filter &&
@@ -270,6 +390,7 @@ rocksdb::ReadOptions PrepareReadOptions(
     read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
         NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
   }
+  read_opts.isolated_file_filter = std::move(isolated_file_filter);
   read_opts.file_filter = std::move(file_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
   read_opts.statistics = statistics;
@@ -301,11 +422,13 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadOperationData& read_operation_data,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
     const Slice* iterate_upper_bound,
-    const DocDBStatistics* statistics) {
+    const DocDBStatistics* statistics,
+    std::shared_ptr<rocksdb::TableAwareReadFileFilter> isolated_file_filter) {
   // TODO(dtxn) do we need separate options for intents db?
   rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
       user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound,
-      statistics ? statistics->RegularDBStatistics() : nullptr);
+      statistics ? statistics->RegularDBStatistics() : nullptr,
+      std::move(isolated_file_filter));
   return std::make_unique<IntentAwareIterator>(
       doc_db, read_opts, read_operation_data, txn_op_context,
       statistics ? statistics->IntentsDBStatistics() : nullptr);
@@ -391,6 +514,7 @@ void AutoInitFromRocksDBFlags(rocksdb::Options* options) {
 
   options->max_background_compactions = GetMaxBackgroundCompactions();
   options->base_background_compactions = GetBaseBackgroundCompactions();
+  options->max_subcompactions = static_cast<uint32_t>(FLAGS_rocksdb_max_subcompactions);
 }
 
 void AutoInitFromBlockBasedTableOptions(rocksdb::BlockBasedTableOptions* table_options) {
@@ -424,6 +548,10 @@ void AutoInitFromBlockBasedTableOptions(rocksdb::BlockBasedTableOptions* table_o
   } else {
     table_options->index_block_restart_interval = FLAGS_index_block_restart_interval;
   }
+
+  table_options->use_data_block_hash_index = FLAGS_use_data_block_hash_index;
+  table_options->auto_readahead_initial_size = FLAGS_db_auto_readahead_initial_size_bytes;
+  table_options->auto_readahead_max_size = FLAGS_db_auto_readahead_max_size_bytes;
 }
 
 class HybridTimeFilteringIterator : public rocksdb::FilteringIterator {
@@ -570,6 +698,8 @@ void InitRocksDBOptions(
   // Since the flag validator for FLAGS_compression_type will fail if the result of this call is not
   // OK, this CHECK_RESULT should never fail and is safe.
   options->compression = CHECK_RESULT(GetConfiguredCompressionType(FLAGS_compression_type));
+  options->compression_opts.max_dict_bytes = FLAGS_compression_dict_max_bytes;
+  options->compression_opts.zstd_max_train_bytes = FLAGS_compression_dict_max_train_bytes;
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -580,6 +710,7 @@ void InitRocksDBOptions(
     table_options.block_cache = tablet_options.block_cache;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.cache_filter_index = FLAGS_cache_bloom_filter_index;
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
@@ -590,14 +721,26 @@ void InitRocksDBOptions(
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     const auto filter_block_size_bits = table_options.filter_block_size * 8;
+    // Since the flag validator for FLAGS_docdb_bloom_filter_format will fail if the result of this
+    // call is not OK, this CHECK_RESULT should never fail and is safe.
+    const auto filter_format = FLAGS_enable_docdb_bloom_filter_formats
+        ? CHECK_RESULT(GetConfiguredBloomFilterFormat(FLAGS_docdb_bloom_filter_format))
+        : rocksdb::FixedSizeFilterFormat::kBloom;
     table_options.filter_policy = std::make_shared<const DocDbAwareV3FilterPolicy>(
-        filter_block_size_bits, options->info_log.get());
+        filter_block_size_bits, options->info_log.get(), filter_format);
     table_options.supported_filter_policies =
         std::make_shared<rocksdb::BlockBasedTableOptions::FilterPoliciesMap>();
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareHashedComponentsFilterPolicy>(
             filter_block_size_bits, options->info_log.get()), &table_options);
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareV2FilterPolicy>(
             filter_block_size_bits, options->info_log.get()), &table_options);
+    // Files could be written with another format before the flag was changed.
+    for (auto format : rocksdb::FixedSizeFilterFormatList()) {
+      if (format != filter_format) {
+        AddSupportedFilterPolicy(std::make_shared<const DocDbAwareV3FilterPolicy>(
+                filter_block_size_bits, options->info_log.get(), format), &table_options);
+      }
+    }
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -617,6 +760,14 @@ void InitRocksDBOptions(
     : rocksdb::CompactionStyle::kCompactionStyleNone;
   // Set the number of levels to 1.
   options->num_levels = 1;
+  // Subcompaction boundaries should not split a document, since compaction feed processes
+  // all records of the document together.
+  options->subcompaction_key_prefix_size = std::make_shared<std::function<size_t(Slice)>>(
+      [](Slice key) -> size_t {
+        auto doc_key_size = dockv::DocKey::EncodedSize(key, dockv::DocKeyPart::kWholeDocKey);
+        // Zero means that key could not be used as a subcompaction boundary.
+        return doc_key_size.ok() ? *doc_key_size : 0;
+      });
 
   AutoInitFromRocksDBFlags(options);
   if (compactions_enabled) {
@@ -657,6 +808,22 @@ void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix) {
   options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
 }
 
+void SetRegularDBMemTableOptions(rocksdb::Options* options, ThreadPool* insert_thread_pool) {
+  if (CHECK_RESULT(IsBTreeMemTableRep(FLAGS_regular_db_memtable_rep))) {
+    options->memtable_factory = std::make_shared<rocksdb::BTreeRepFactory>();
+    return;
+  }
+  if (!insert_thread_pool) {
+    return;
+  }
+  // Single writer memtable does not support concurrent inserts, so it is replaced with the one that
+  // does. Such memtable does not support in memory erase, but it is used by intents DB only.
+  options->memtable_factory = std::make_shared<rocksdb::SkipListFactory>(
+      0 /* lookahead */, rocksdb::ConcurrentWrites::kTrue);
+  options->memtable_insert_thread_pool = insert_thread_pool;
+  options->memtable_insert_min_entries_per_thread = FLAGS_memtable_insert_min_entries_per_thread;
+}
+
 namespace {
 
 // Helper class for RocksDBPatcher.
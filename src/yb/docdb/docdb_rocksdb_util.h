@@ -67,7 +67,8 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadOperationData& read_operation_data,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
     const Slice* iterate_upper_bound = nullptr,
-    const DocDBStatistics* statistics = nullptr);
+    const DocDBStatistics* statistics = nullptr,
+    std::shared_ptr<rocksdb::TableAwareReadFileFilter> isolated_file_filter = nullptr);
 
 std::shared_ptr<rocksdb::RocksDBPriorityThreadPoolMetrics> CreateRocksDBPriorityThreadPoolMetrics(
     scoped_refptr<yb::MetricEntity> entity);
@@ -109,6 +110,13 @@ void InitRocksDBOptions(
 // Sets logs prefix for RocksDB options. This will also reinitialize options->info_log.
 void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix);
 
+// Configures memtable of regular RocksDB. Uses B+-tree memtable when regular_db_memtable_rep is
+// btree. Otherwise, when insert_thread_pool is not nullptr, large write batches are inserted into
+// the memtable concurrently, using threads of insert_thread_pool.
+// Should be used for regular RocksDB only, intents RocksDB relies on in memory erase that is not
+// supported by these memtables.
+void SetRegularDBMemTableOptions(rocksdb::Options* options, ThreadPool* insert_thread_pool);
+
 // Gets the configured size of the node-global RocksDB priority thread pool.
 int32_t GetGlobalRocksDBPriorityThreadPoolSize();
 
@@ -131,6 +131,9 @@ constexpr std::pair<uint32_t, uint32_t> kTickers[] = {
       rocksdb::BLOCK_CACHE_MULTI_TOUCH_BYTES_READ},
   {pggate::YB_ANALYZE_METRIC_ROCKSDB_BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
       rocksdb::BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE},
+  {pggate::YB_ANALYZE_METRIC_ROCKSDB_READAHEAD_REQUESTS, rocksdb::READAHEAD_REQUESTS},
+  {pggate::YB_ANALYZE_METRIC_ROCKSDB_READAHEAD_BYTES, rocksdb::READAHEAD_BYTES},
+  {pggate::YB_ANALYZE_METRIC_ROCKSDB_READAHEAD_RESETS, rocksdb::READAHEAD_RESETS},
 };
 
 } // namespace
@@ -153,7 +153,8 @@ Result<std::string> DocDBValueToDebugStrInternal(
   if (!value_slice.empty() || key_type != KeyType::kIntentKey) {
     dockv::Value v;
     auto control_fields = VERIFY_RESULT(dockv::ValueControlFields::Decode(&value_slice));
-    if (!value_slice.TryConsumeByte(dockv::ValueEntryTypeAsChar::kPackedRow)) {
+    auto packed_row_version = dockv::ConsumePackedRowVersion(&value_slice);
+    if (!packed_row_version) {
       RETURN_NOT_OK_PREPEND(
           v.Decode(value_slice, control_fields),
           Format("Error: failed to decode value $0", prefix));
@@ -162,7 +163,7 @@ Result<std::string> DocDBValueToDebugStrInternal(
       auto packing = VERIFY_RESULT(packed_row_to_packing_info_func(&value_slice));
       prefix += "{";
       for (size_t i = 0; i != packing->columns(); ++i) {
-        auto slice = packing->GetValue(i, value_slice);
+        auto slice = packing->GetValue(*packed_row_version, i, value_slice);
         const auto& column_data = packing->column_packing_data(i);
         prefix += " ";
         prefix += column_data.id.ToString();
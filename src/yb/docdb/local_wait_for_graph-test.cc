@@ -0,0 +1,127 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/docdb/local_wait_for_graph.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb::tablet {
+
+class LocalWaitForGraphTest : public YBTest {
+ protected:
+  // Found deadlocks as pairs of victim index and deadlock size.
+  using Deadlocks = std::vector<std::pair<size_t, size_t>>;
+
+  // Transaction with larger index started waiting later.
+  const TransactionId& Txn(size_t index) {
+    while (txns_.size() <= index) {
+      txns_.push_back(TransactionId::GenerateRandom());
+    }
+    return txns_[index];
+  }
+
+  void AddEdge(
+      size_t waiter, size_t blocker,
+      const std::shared_ptr<const SubtxnSetAndPB>& info = std::make_shared<SubtxnSetAndPB>()) {
+    // Txn could reallocate txns_, so ids are copied.
+    const auto waiter_id = Txn(waiter);
+    const auto blocker_id = Txn(blocker);
+    graph_.AddEdge(waiter_id, HybridTime::FromMicros(waiter + 1), blocker_id, info);
+  }
+
+  Deadlocks FindCycles() {
+    Deadlocks result;
+    graph_.FindCycles(
+        [this](const TransactionId&, const SubtxnSet& set) {
+          return !inactive_sets_.contains(&set);
+        },
+        [this, &result](const TransactionId& victim, size_t deadlock_size) {
+          auto it = std::find(txns_.begin(), txns_.end(), victim);
+          result.emplace_back(static_cast<size_t>(it - txns_.begin()), deadlock_size);
+        });
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  LocalWaitForGraph graph_;
+  std::vector<TransactionId> txns_;
+  std::unordered_set<const SubtxnSet*> inactive_sets_;
+};
+
+TEST_F(LocalWaitForGraphTest, Cycles) {
+  // Cycle 0 -> 1 -> 2 -> 0 with a branch 1 -> 3, and separate cycle 4 <-> 5.
+  AddEdge(0, 1);
+  AddEdge(1, 3);
+  AddEdge(1, 2);
+  AddEdge(2, 0);
+  AddEdge(4, 5);
+  AddEdge(5, 4);
+  ASSERT_EQ(FindCycles(), (Deadlocks{{2, 3}, {5, 2}}));
+}
+
+TEST_F(LocalWaitForGraphTest, NestedCycles) {
+  // Cycles 1 <-> 2 and 0 -> 1 -> 2 -> 0 both pass through the youngest transaction 2, so aborting
+  // it resolves both of them. Whatever the order of the search, 2 should be picked only once.
+  AddEdge(0, 2);
+  AddEdge(2, 1);
+  AddEdge(1, 2);
+  AddEdge(1, 0);
+  ASSERT_EQ(FindCycles(), (Deadlocks{{2, 2}}));
+}
+
+TEST_F(LocalWaitForGraphTest, CyclesSharingVictim) {
+  // Cycles 0 -> 3 -> 0, 1 -> 3 -> 1 and 2 -> 3 -> 2, all of them are resolved by aborting 3.
+  for (size_t i = 0; i != 3; ++i) {
+    AddEdge(i, 3);
+    AddEdge(3, i);
+  }
+  ASSERT_EQ(FindCycles(), (Deadlocks{{3, 2}}));
+}
+
+TEST_F(LocalWaitForGraphTest, DuplicateEdges) {
+  // The same wait-for edge is reported by two tablet servers, with different blocking
+  // subtransactions.
+  auto first_info = std::make_shared<SubtxnSetAndPB>();
+  auto second_info = std::make_shared<SubtxnSetAndPB>();
+  AddEdge(0, 1, first_info);
+  AddEdge(0, 1, second_info);
+  AddEdge(0, 1, second_info);
+  AddEdge(1, 0);
+  AddEdge(1, 0);
+
+  // Edge is active while any of reported subtransaction sets is active.
+  inactive_sets_.insert(&first_info->set());
+  ASSERT_EQ(FindCycles(), (Deadlocks{{1, 2}}));
+}
+
+TEST_F(LocalWaitForGraphTest, InactiveEdges) {
+  auto first_info = std::make_shared<SubtxnSetAndPB>();
+  auto second_info = std::make_shared<SubtxnSetAndPB>();
+  AddEdge(0, 1, first_info);
+  AddEdge(0, 1, second_info);
+  AddEdge(1, 0);
+  inactive_sets_.insert(&first_info->set());
+  inactive_sets_.insert(&second_info->set());
+  ASSERT_EQ(FindCycles(), Deadlocks{});
+}
+
+} // namespace yb::tablet
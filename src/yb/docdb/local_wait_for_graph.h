@@ -0,0 +1,162 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
+
+namespace yb {
+namespace tablet {
+
+// Wait-for graph among the transactions tracked as waiters by a deadlock detector, limited to the
+// edges whose blocker is also such a waiter. Cycles in this graph are deadlocks which could be
+// found without sending any probes.
+class LocalWaitForGraph {
+ public:
+  // Adds edge from the waiter to the blocker. The same edge could be reported by several tablet
+  // servers, in this case a single edge is kept, which is active when any of the reported blocking
+  // subtransaction sets is active.
+  void AddEdge(
+      const TransactionId& waiter_id, HybridTime wait_start_time, const TransactionId& blocker_id,
+      const std::shared_ptr<const SubtxnSetAndPB>& blocking_subtxn_info) {
+    auto& node = nodes_[waiter_id];
+    if (!node.wait_start_time.is_valid() || node.wait_start_time < wait_start_time) {
+      node.wait_start_time = wait_start_time;
+    }
+    auto edge = std::find_if(node.edges.begin(), node.edges.end(), [&blocker_id](const Edge& e) {
+      return e.blocker_id == blocker_id;
+    });
+    if (edge == node.edges.end()) {
+      edge = node.edges.insert(node.edges.end(), Edge {
+        .blocker_id = blocker_id,
+        .blocking_subtxn_infos = {},
+      });
+    }
+    auto& infos = edge->blocking_subtxn_infos;
+    if (std::find(infos.begin(), infos.end(), blocking_subtxn_info) == infos.end()) {
+      infos.push_back(blocking_subtxn_info);
+    }
+  }
+
+  size_t size() const {
+    return nodes_.size();
+  }
+
+  // Searches for cycles using depth first search. An edge is followed only if is_edge_active
+  // returns true for it, since the blocking subtransactions could have been rolled back.
+  // For each found cycle, on_deadlock is invoked with the transaction of the cycle that started
+  // waiting last and the size of the cycle. That transaction is expected to be aborted, so it is
+  // excluded from the rest of the search, and the search is resumed from the transaction that
+  // waits for it. Cycles which were missed because of it are found by the next search, after the
+  // aborted transaction is removed from the waiters.
+  template <class IsEdgeActive, class OnDeadlock>
+  void FindCycles(const IsEdgeActive& is_edge_active, const OnDeadlock& on_deadlock) {
+    struct StackEntry {
+      NodeMap::value_type* node;
+      size_t next_edge;
+    };
+    std::vector<StackEntry> stack;
+    for (auto& root : nodes_) {
+      if (root.second.state != NodeState::kNotVisited) {
+        continue;
+      }
+      root.second.state = NodeState::kOnStack;
+      stack.push_back({&root, 0});
+      while (!stack.empty()) {
+        auto& node = stack.back().node->second;
+        if (stack.back().next_edge == node.edges.size()) {
+          node.state = NodeState::kVisited;
+          stack.pop_back();
+          continue;
+        }
+        const auto& edge = node.edges[stack.back().next_edge++];
+        auto it = nodes_.find(edge.blocker_id);
+        if (it == nodes_.end()) {
+          continue;
+        }
+        auto& blocker = it->second;
+        if (blocker.state == NodeState::kVisited || blocker.state == NodeState::kVictim ||
+            !IsEdgeActiveImpl(edge, is_edge_active)) {
+          continue;
+        }
+        if (blocker.state == NodeState::kNotVisited) {
+          blocker.state = NodeState::kOnStack;
+          stack.push_back({&*it, 0});
+          continue;
+        }
+        // The blocker is on the stack, so the edge closes a cycle.
+        auto cycle_begin = std::find_if(
+            stack.begin(), stack.end(), [blocker_node = &*it](const StackEntry& entry) {
+          return entry.node == blocker_node;
+        });
+        auto victim = cycle_begin;
+        for (auto entry = cycle_begin; entry != stack.end(); ++entry) {
+          if (entry->node->second.wait_start_time > victim->node->second.wait_start_time) {
+            victim = entry;
+          }
+        }
+        victim->node->second.state = NodeState::kVictim;
+        on_deadlock(victim->node->first, static_cast<size_t>(stack.end() - cycle_begin));
+        // Transactions above the victim were reached through it, so their search is not complete
+        // and they could be reached again without passing through the victim.
+        for (auto entry = victim + 1; entry != stack.end(); ++entry) {
+          entry->node->second.state = NodeState::kNotVisited;
+        }
+        stack.erase(victim, stack.end());
+      }
+    }
+  }
+
+ private:
+  struct Edge {
+    TransactionId blocker_id;
+    std::vector<std::shared_ptr<const SubtxnSetAndPB>> blocking_subtxn_infos;
+  };
+
+  template <class IsEdgeActive>
+  static bool IsEdgeActiveImpl(const Edge& edge, const IsEdgeActive& is_edge_active) {
+    for (const auto& info : edge.blocking_subtxn_infos) {
+      if (is_edge_active(edge.blocker_id, info->set())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  enum class NodeState {
+    kNotVisited,
+    kOnStack,
+    kVisited,
+    // Transaction picked to be aborted to resolve a deadlock.
+    kVictim,
+  };
+
+  struct Node {
+    HybridTime wait_start_time;
+    std::vector<Edge> edges;
+    NodeState state = NodeState::kNotVisited;
+  };
+
+  using NodeMap = std::unordered_map<TransactionId, Node, TransactionIdHash>;
+
+  NodeMap nodes_;
+};
+
+} // namespace tablet
+} // namespace yb
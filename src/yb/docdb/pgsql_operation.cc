@@ -13,6 +13,7 @@
 
 #include "yb/docdb/pgsql_operation.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 #include <unordered_set>
@@ -25,6 +26,8 @@
 #include "yb/common/ql_value.h"
 #include "yb/common/row_mark.h"
 
+#include "yb/docdb/doc_pg_batch_aggregator.h"
+#include "yb/docdb/doc_pg_batch_filter.h"
 #include "yb/docdb/doc_pg_expr.h"
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_read_context.h"
@@ -55,6 +58,7 @@
 #include "yb/util/result.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status_format.h"
+#include "yb/util/status_log.h"
 #include "yb/util/trace.h"
 #include "yb/util/yb_pg_errcodes.h"
 
@@ -102,6 +106,19 @@ DEFINE_test_flag(bool, ysql_suppress_ybctid_corruption_details, false,
 DEFINE_RUNTIME_bool(ysql_enable_pack_full_row_update, false,
                     "Whether to enable packed row for full row update.");
 
+DEFINE_RUNTIME_uint64(ysql_scan_batch_rows, 0,
+                      "Number of rows that are collected into columnar batch before being "
+                      "serialized to the response during YSQL scan. Used only when all targets "
+                      "are plain columns. Simple where clauses are evaluated over the whole "
+                      "batch. 0 to serialize rows one by one.");
+
+DEFINE_RUNTIME_uint64(ysql_ybctid_batch_prefetch_min_size, 0,
+                      "Min number of ybctids in a batched read request to load SST data blocks "
+                      "of all requested rows into the block cache before looking them up. "
+                      "Missing blocks of each SST file are read by a single batched read, that "
+                      "is performed in parallel when use_io_uring_for_multi_read is set. "
+                      "0 to disable.");
+
 namespace yb::docdb {
 
 using dockv::DocKey;
@@ -304,8 +321,9 @@ class FilteringIterator {
       const ReadOperationData& read_operation_data,
       bool is_explicit_request_read_time,
       std::reference_wrapper<const ScopedRWOperation> pending_op,
-      const DocDBStatistics* statistics) {
-    RETURN_NOT_OK(InitCommon(request, read_context.get().schema(), projection));
+      const DocDBStatistics* statistics,
+      DocPgBatchFilter* batch_filter = nullptr) {
+    RETURN_NOT_OK(InitCommon(request, read_context.get().schema(), projection, batch_filter));
     iterator_holder_ = VERIFY_RESULT(CreateIterator(
         ql_storage, request, projection, read_context, txn_op_context, read_operation_data,
         is_explicit_request_read_time, pending_op, statistics));
@@ -347,13 +365,26 @@ class FilteringIterator {
   }
 
  private:
+  // When batch_filter is specified and it supports all where clauses, they are added to it
+  // and evaluated by the caller over batch of fetched rows. Otherwise batch_filter is left empty.
   Status InitCommon(
       const PgsqlReadRequestPB& request, const Schema& schema,
-      const dockv::ReaderProjection& projection) {
+      const dockv::ReaderProjection& projection, DocPgBatchFilter* batch_filter = nullptr) {
     const auto& where_clauses = request.where_clauses();
     if (where_clauses.empty()) {
       return Status::OK();
     }
+    if (batch_filter) {
+      auto supported = std::all_of(
+          where_clauses.begin(), where_clauses.end(),
+          [batch_filter, &request](const auto& exp) {
+            return batch_filter->TryAdd(exp, request.col_refs());
+          });
+      if (supported) {
+        return Status::OK();
+      }
+      batch_filter->Clear();
+    }
     DocPgExprExecutorBuilder builder(schema, projection);
     for (const auto& exp : where_clauses) {
       RETURN_NOT_OK(builder.AddWhere(exp));
@@ -1478,10 +1509,41 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(
   // projection only to scan sub-documents. The query schema is used to select only referenced
   // columns and key columns.
   auto doc_projection = CreateProjection(doc_read_context.schema(), request_);
+
+  // Rows are collected to the columnar batch and serialized when batch is full.
+  // All fetched rows should be serialized, since paging state is taken from the iterator position.
+  // When all where clauses are supported by DocPgBatchFilter, they are evaluated over the batch.
+  // For aggregate requests the batch is used only when all targets are supported by
+  // DocPgBatchAggregator.
+  std::optional<dockv::PgTableRowBatch> batch;
+  std::optional<DocPgBatchFilter> batch_filter;
+  std::optional<DocPgBatchAggregator> batch_aggregator;
+  const auto batch_rows = FLAGS_ysql_scan_batch_rows;
+  if (batch_rows > 1 && !index_doc_read_context) {
+    bool use_batch;
+    if (request_.is_aggregate()) {
+      batch_aggregator.emplace(doc_projection);
+      const auto& targets = request_.targets();
+      use_batch = !targets.empty() && std::all_of(
+          targets.begin(), targets.end(),
+          [&batch_aggregator](const auto& target) { return batch_aggregator->TryAdd(target); });
+      if (!use_batch) {
+        batch_aggregator.reset();
+      }
+    } else {
+      use_batch = CanPopulateResultSetFromBatch(doc_projection);
+    }
+    if (use_batch) {
+      batch.emplace(doc_projection, batch_rows);
+      batch_filter.emplace(doc_projection);
+    }
+  }
+
   FilteringIterator table_iter(&table_iter_);
   RETURN_NOT_OK(table_iter.Init(
       ql_storage, request_, doc_projection, doc_read_context, txn_op_context_, read_operation_data,
-      is_explicit_request_read_time, pending_op, statistics));
+      is_explicit_request_read_time, pending_op, statistics,
+      batch_filter ? &*batch_filter : nullptr));
 
   std::optional<IndexState> index_state;
   if (index_doc_read_context) {
@@ -1506,6 +1568,28 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(
   size_t fetched_rows = 0;
   dockv::PgTableRow row(doc_projection);
   const auto& table_id = request_.index_request().table_id();
+  std::vector<uint8_t> selection;
+  auto flush_batch = [&batch, &batch_filter, &batch_aggregator, &selection, &match_count,
+                      &fetched_rows, result_buffer, this] {
+    if (!batch || batch->empty()) {
+      return;
+    }
+    const uint8_t* selected = nullptr;
+    size_t num_selected = batch->size();
+    if (!batch_filter->empty()) {
+      num_selected = batch_filter->Eval(*batch, &selection);
+      selected = selection.data();
+    }
+    match_count += num_selected;
+    if (batch_aggregator) {
+      batch_aggregator->Apply(*batch, selected);
+    } else {
+      PopulateResultSet(*batch, selected, result_buffer);
+      fetched_rows += num_selected;
+    }
+    batch->Reset();
+  };
+
   do {
     const auto fetch_result = VERIFY_RESULT(FetchTableRow(
         table_id, &table_iter, index_state ? &*index_state : nullptr, &row));
@@ -1513,10 +1597,21 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(
       break;
     }
     if (fetch_result == FetchResult::Found) {
-      ++match_count;
-      if (request_.is_aggregate()) {
+      if (batch) {
+        batch->AppendRow(row);
+        // Rows of the batch are not accounted in the result buffer yet, so flush the batch when
+        // it could reach response size limit.
+        if (batch->Full() ||
+            (!batch_aggregator &&
+             (fetched_rows + batch->size() >= row_count_limit ||
+              result_buffer->size() + batch->EncodedSize() >= response_size_limit))) {
+          flush_batch();
+        }
+      } else if (request_.is_aggregate()) {
+        ++match_count;
         RETURN_NOT_OK(EvalAggregate(row));
       } else {
+        ++match_count;
         RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
         ++fetched_rows;
       }
@@ -1527,6 +1622,14 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(
        fetched_rows >= row_count_limit ||
        result_buffer->size() >= response_size_limit);
   } while (!limit_exceeded);
+  flush_batch();
+  if (batch_aggregator) {
+    auto results = batch_aggregator->Results();
+    aggr_result_.resize(results.size());
+    for (size_t i = 0; i != results.size(); ++i) {
+      aggr_result_[i].ForceNewValue() = std::move(results[i]);
+    }
+  }
 
   // Output aggregate values accumulated while looping over rows
   if (request_.is_aggregate() && match_count > 0) {
@@ -1582,6 +1685,20 @@ Result<size_t> PgsqlReadOperation::ExecuteBatchYbctid(
     }
   }
 
+  const auto prefetch_min_size = FLAGS_ysql_ybctid_batch_prefetch_min_size;
+  if (prefetch_min_size && static_cast<size_t>(batch_args.size()) >= prefetch_min_size) {
+    std::vector<Slice> ybctids;
+    ybctids.reserve(batch_args.size());
+    for (const auto& batch_arg : batch_args) {
+      ybctids.emplace_back(batch_arg.ybctid().value().binary_value());
+    }
+    // Prefetch is just an optimization, lookups below will report the failure if any.
+    WARN_NOT_OK(
+        ql_storage.PrefetchYbctids(
+            request_.stmt_id(), doc_read_context.schema(), ybctids, statistics),
+        "Failed to prefetch ybctid batch");
+  }
+
   auto projection = CreateProjection(doc_read_context.schema(), request_);
   dockv::PgTableRow row(projection);
   std::optional<FilteringIterator> iter;
@@ -1659,20 +1776,51 @@ Result<bool> PgsqlReadOperation::SetPagingState(
   return true;
 }
 
+void PgsqlReadOperation::InitTargetIndex(const dockv::ReaderProjection& projection) {
+  if (!target_index_.empty()) {
+    return;
+  }
+  target_index_.reserve(request_.targets().size());
+  for (const auto& expr : request_.targets()) {
+    if (expr.expr_case() == PgsqlExpressionPB::kColumnId &&
+        expr.column_id() != to_underlying(PgSystemAttrNum::kYBTupleId)) {
+      target_index_.push_back(projection.ColumnIdxById(ColumnId(expr.column_id())));
+    } else {
+      target_index_.push_back(dockv::ReaderProjection::kNotFoundIndex);
+    }
+  }
+}
+
+bool PgsqlReadOperation::CanPopulateResultSetFromBatch(
+    const dockv::ReaderProjection& projection) {
+  if (request_.targets().empty()) {
+    return false;
+  }
+  InitTargetIndex(projection);
+  for (auto index : target_index_) {
+    if (index == dockv::ReaderProjection::kNotFoundIndex) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PgsqlReadOperation::PopulateResultSet(
+    const dockv::PgTableRowBatch& batch, const uint8_t* selection, WriteBuffer *result_buffer) {
+  for (size_t row_idx = 0; row_idx != batch.size(); ++row_idx) {
+    if (selection && !selection[row_idx]) {
+      continue;
+    }
+    for (auto index : target_index_) {
+      batch.AppendValue(row_idx, index, result_buffer);
+    }
+  }
+}
+
 Status PgsqlReadOperation::PopulateResultSet(const dockv::PgTableRow& table_row,
                                              WriteBuffer *result_buffer) {
   const auto size = request_.targets().size();
-  if (target_index_.empty()) {
-    target_index_.reserve(request_.targets().size());
-    for (const auto& expr : request_.targets()) {
-      if (expr.expr_case() == PgsqlExpressionPB::kColumnId &&
-          expr.column_id() != to_underlying(PgSystemAttrNum::kYBTupleId)) {
-        target_index_.push_back(table_row.projection().ColumnIdxById(ColumnId(expr.column_id())));
-      } else {
-        target_index_.push_back(dockv::ReaderProjection::kNotFoundIndex);
-      }
-    }
-  }
+  InitTargetIndex(table_row.projection());
   QLExprResult result;
   const char kNullMark = 1;
   for (int i = 0; i != size; ++i) {
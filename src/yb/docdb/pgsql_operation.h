@@ -219,6 +219,17 @@ class PgsqlReadOperation : public DocExprExecutor {
   Status PopulateResultSet(const dockv::PgTableRow& table_row,
                            WriteBuffer *result_buffer);
 
+  // Serializes rows of the batch. Could be used only when all targets are plain columns.
+  // When selection is specified, only rows with non zero selection byte are serialized.
+  void PopulateResultSet(
+      const dockv::PgTableRowBatch& batch, const uint8_t* selection, WriteBuffer *result_buffer);
+
+  void InitTargetIndex(const dockv::ReaderProjection& projection);
+
+  // Whether rows could be serialized directly from columnar batch, i.e. all targets are columns
+  // present in projection.
+  bool CanPopulateResultSetFromBatch(const dockv::ReaderProjection& projection);
+
   Status EvalAggregate(const dockv::PgTableRow& table_row);
 
   Status PopulateAggregate(WriteBuffer *result_buffer);
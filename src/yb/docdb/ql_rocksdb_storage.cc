@@ -24,10 +24,13 @@
 #include "yb/docdb/doc_read_context.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/doc_zone_map.h"
 #include "yb/dockv/primitive_value_util.h"
 
 #include "yb/qlexpr/ql_expr_util.h"
 
+#include "yb/rocksdb/db.h"
+
 #include "yb/util/result.h"
 
 namespace yb::docdb {
@@ -173,6 +176,31 @@ Status QLRocksDBStorage::GetIteratorForYbctid(
   return Status::OK();
 }
 
+Status QLRocksDBStorage::PrefetchYbctids(
+    uint64 stmt_id,
+    const Schema& schema,
+    const std::vector<Slice>& ybctids,
+    const DocDBStatistics* statistics) const {
+  dockv::KeyBytes prefix;
+  AppendTupleIdPrefix(schema, &prefix);
+  std::vector<std::string> keys;
+  std::vector<Slice> key_slices;
+  if (!prefix.empty()) {
+    keys.reserve(ybctids.size());
+    key_slices.reserve(ybctids.size());
+    for (const auto& ybctid : ybctids) {
+      keys.push_back(prefix.ToStringBuffer());
+      keys.back().append(ybctid.cdata(), ybctid.size());
+      key_slices.emplace_back(keys.back());
+    }
+  }
+
+  rocksdb::ReadOptions read_options;
+  read_options.query_id = stmt_id;
+  read_options.statistics = statistics ? statistics->RegularDBStatistics() : nullptr;
+  return doc_db_.regular->PrefetchKeys(read_options, prefix.empty() ? ybctids : key_slices);
+}
+
 Status QLRocksDBStorage::GetIterator(
     const PgsqlReadRequestPB& request,
     const dockv::ReaderProjection& projection,
@@ -194,6 +222,7 @@ Status QLRocksDBStorage::GetIterator(
   auto doc_iter = std::make_unique<DocRowwiseIterator>(
       projection, doc_read_context, txn_op_context, doc_db_, read_operation_data, pending_op,
       statistics);
+  doc_iter->SetIsolatedFileFilter(VERIFY_RESULT(CreateZoneMapFileFilter(request, doc_db_)));
 
   if (range_components.size() == schema.num_range_key_columns() &&
       hashed_components.size() == schema.num_hash_key_columns()) {
@@ -90,6 +90,12 @@ class QLRocksDBStorage : public YQLStorageIf {
       const docdb::DocDBStatistics* statistics = nullptr,
       SkipSeek skip_seek = SkipSeek::kFalse) const override;
 
+  Status PrefetchYbctids(
+      uint64 stmt_id,
+      const Schema& schema,
+      const std::vector<Slice>& ybctids,
+      const DocDBStatistics* statistics = nullptr) const override;
+
  private:
   const DocDB doc_db_;
 };
@@ -16,6 +16,7 @@
 #include <limits>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "yb/common/common_fwd.h"
 #include "yb/common/read_hybrid_time.h"
@@ -109,6 +110,16 @@ class YQLStorageIf {
       std::unique_ptr<YQLRowwiseIteratorIf>* iter,
       const DocDBStatistics* statistics = nullptr,
       SkipSeek skip_seek = SkipSeek::kFalse) const = 0;
+
+  // Loads data blocks of the rows with specified ybctids into the block cache, reading missing
+  // blocks of each SST file in parallel, so following lookups of these rows don't wait for IO.
+  virtual Status PrefetchYbctids(
+      uint64 stmt_id,
+      const Schema& schema,
+      const std::vector<Slice>& ybctids,
+      const DocDBStatistics* statistics = nullptr) const {
+    return Status::OK();
+  }
 };
 
 }  // namespace yb::docdb
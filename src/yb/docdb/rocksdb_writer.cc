@@ -25,15 +25,23 @@
 #include "yb/dockv/doc_key.h"
 #include "yb/dockv/doc_kv_util.h"
 #include "yb/dockv/intent.h"
+#include "yb/dockv/schema_packing.h"
 #include "yb/dockv/value_type.h"
 
 #include "yb/gutil/walltime.h"
 
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/immutable_options.h"
+#include "yb/rocksdb/sst_file_writer.h"
+
 #include "yb/util/bitmap.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/fast_varint.h"
 #include "yb/util/flags.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/scope_exit.h"
 
 DEFINE_UNKNOWN_bool(enable_transaction_sealing, false,
             "Whether transaction sealing is enabled.");
@@ -601,12 +609,95 @@ void ApplyIntentsContext::Complete(rocksdb::DirectWriteHandler* handler) {
   FlushSchemaVersion();
 }
 
+std::pair<Slice, Slice> BufferedApplyWriteHandler::Put(
+    const SliceParts& key, const SliceParts& value) {
+  auto key_size = key.SumSizes();
+  auto* buffer = static_cast<char*>(arena_.AllocateBytes(key_size + value.SumSizes()));
+  auto* value_start = key.CopyAllTo(buffer);
+  auto* value_end = value.CopyAllTo(value_start);
+  Record record(Slice(buffer, value_start), Slice(value_start, value_end));
+  auto& records = record.first.starts_with(KeyEntryTypeAsChar::kTransactionApplyState)
+      ? apply_state_records_ : records_;
+  records.push_back(record);
+  return record;
+}
+
+void BufferedApplyWriteHandler::SingleDelete(const Slice& key) {
+  LOG(DFATAL) << "Single delete is not expected while applying intents: "
+              << key.ToDebugHexString();
+}
+
+Status BufferedApplyWriteHandler::WriteSstFile(
+    rocksdb::DB* regular_db, const std::string& path, rocksdb::ExternalSstFileInfo* file_info) {
+  const auto& options = regular_db->GetOptions();
+  std::sort(records_.begin(), records_.end(), [&options](const Record& lhs, const Record& rhs) {
+    return options.comparator->Compare(lhs.first, rhs.first) < 0;
+  });
+
+  rocksdb::SstFileWriter writer(
+      rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options), options.comparator);
+  RETURN_NOT_OK(writer.Open(path));
+  for (const auto& [key, value] : records_) {
+    RETURN_NOT_OK(writer.Add(key, value));
+  }
+  return writer.Finish(file_info);
+}
+
+Result<bool> BufferedApplyWriteHandler::IngestRecords(
+    rocksdb::DB* regular_db, const std::string& dir, const std::string& file_name,
+    const rocksdb::UserFrontiers& frontiers) {
+  if (records_.empty()) {
+    return false;
+  }
+  auto* env = regular_db->GetEnv();
+  RETURN_NOT_OK(env->CreateDirIfMissing(dir));
+  const auto path = JoinPathSegments(dir, file_name);
+  // The file could be partially written or left in place after a failed attempt. After successful
+  // AddFile it is moved to the DB, so there is nothing to delete.
+  auto se = ScopeExit([env, &path] {
+    for (const auto& file : {path, rocksdb::TableBaseToDataFileName(path)}) {
+      if (env->FileExists(file).ok()) {
+        WARN_NOT_OK(env->DeleteFile(file), "Failed to delete apply SST file");
+      }
+    }
+  });
+
+  rocksdb::ExternalSstFileInfo file_info;
+  auto status = WriteSstFile(regular_db, path, &file_info);
+  if (status.ok()) {
+    file_info.user_frontiers = &frontiers;
+    status = regular_db->AddFile(&file_info, /* move_file= */ true);
+    if (status.ok()) {
+      return true;
+    }
+  }
+
+  if (status.IsNotSupported()) {
+    // Key range of the file overlaps existing keys.
+    VLOG(1) << "Unable to add apply SST file " << path << ": " << status;
+    return false;
+  }
+  return status;
+}
+
+void BufferedApplyWriteHandler::AppendToWriteBatch(
+    bool include_records, rocksdb::WriteBatch* write_batch) const {
+  if (include_records) {
+    for (const auto& [key, value] : records_) {
+      write_batch->Put(key, value);
+    }
+  }
+  for (const auto& [key, value] : apply_state_records_) {
+    write_batch->Put(key, value);
+  }
+}
+
 Status FrontierSchemaVersionUpdater::UpdateSchemaVersion(Slice key, Slice value) {
   if (!frontiers_) {
     return Status::OK();
   }
   RETURN_NOT_OK(dockv::ValueControlFields::Decode(&value));
-  if (!value.TryConsumeByte(ValueEntryTypeAsChar::kPackedRow)) {
+  if (!dockv::ConsumePackedRowVersion(&value)) {
     return Status::OK();
   }
   auto schema_version =
@@ -25,6 +25,8 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include "yb/util/memory/arena.h"
+
 namespace yb {
 namespace docdb {
 
@@ -244,6 +246,42 @@ class RemoveIntentsContext : public IntentsWriterContext {
   uint8_t reason_;
 };
 
+// Buffers records produced by ApplyIntentsContext instead of writing them to the memtable, so
+// records of a large transaction could be added to the regular DB as a single SST file.
+class BufferedApplyWriteHandler : public rocksdb::DirectWriteHandler {
+ public:
+  std::pair<Slice, Slice> Put(const SliceParts& key, const SliceParts& value) override;
+  void SingleDelete(const Slice& key) override;
+
+  // Number of buffered regular records, not counting transaction apply state records.
+  size_t num_records() const {
+    return records_.size();
+  }
+
+  // Writes buffered regular records to an SST file with the specified name in the specified
+  // temporary directory and adds it to the regular DB, the file is assigned the specified
+  // frontiers. The temporary file is removed in any case. Returns false if the file could not be
+  // added, for instance because its key range overlaps keys already present in the DB. In this
+  // case records should be written using AppendToWriteBatch.
+  Result<bool> IngestRecords(
+      rocksdb::DB* regular_db, const std::string& dir, const std::string& file_name,
+      const rocksdb::UserFrontiers& frontiers);
+
+  // Appends buffered transaction apply state records to the write batch. Regular records are
+  // appended only when include_records is true.
+  void AppendToWriteBatch(bool include_records, rocksdb::WriteBatch* write_batch) const;
+
+ private:
+  using Record = std::pair<Slice, Slice>;
+
+  Status WriteSstFile(
+      rocksdb::DB* regular_db, const std::string& path, rocksdb::ExternalSstFileInfo* file_info);
+
+  Arena arena_;
+  std::vector<Record> records_;
+  std::vector<Record> apply_state_records_;
+};
+
 // Usually put_batch contains only records that should be applied to regular DB.
 // So apply_external_transactions will be empty and regular_entry will be true.
 //
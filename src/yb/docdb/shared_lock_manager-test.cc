@@ -164,6 +164,83 @@ TEST_F(SharedLockManagerTest, QuickLockUnlock) {
   }
 }
 
+// Batches with keys from different shards visit shards in different order, so they would
+// deadlock if a shard mutex was held while locking the next one.
+TEST_F(SharedLockManagerTest, ConcurrentMultiShardBatches) {
+  constexpr size_t kNumThreads = 8;
+  constexpr size_t kNumKeys = 64;
+  constexpr size_t kKeysPerBatch = 4;
+  const auto kDuration = 1s * kTimeMultiplier;
+
+  std::atomic<bool> stop_requested{false};
+  std::vector<std::thread> threads;
+  while (threads.size() != kNumThreads) {
+    threads.emplace_back([this, &stop_requested, thread_idx = threads.size()] {
+      size_t i = thread_idx;
+      while (!stop_requested.load(std::memory_order_acquire)) {
+        LockBatchEntries entries;
+        for (size_t j = 0; j != kKeysPerBatch; ++j) {
+          entries.push_back(LockBatchEntry {
+            .key = RefCntPrefix(Format("key_$0", (i * 7 + j * 13) % kNumKeys)),
+            .intent_types = IntentTypeSet({IntentType::kWeakRead}),
+          });
+        }
+        LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+        ASSERT_OK(lb.status());
+        ++i;
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(kDuration);
+  stop_requested.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Measures lock/unlock throughput with different number of threads. Each batch takes weak lock
+// on the key shared by all threads, like table prefix in colocated tablet, and strong lock on the
+// thread specific row key.
+//
+// Performance test, it runs for a short time and only checks that batches are locked unless slow
+// tests are allowed.
+TEST_F(SharedLockManagerTest, YB_DISABLE_TEST_EXCEPT_RELEASE(LockUnlockThroughput)) {
+  const auto kDuration = AllowSlowTests() ? 2s : 100ms;
+  const RefCntPrefix kSharedKey("table"s);
+
+  for (size_t num_threads : {1, 2, 4, 8, 16, 32, 64}) {
+    std::atomic<bool> stop_requested{false};
+    std::atomic<size_t> num_batches{0};
+    std::vector<std::thread> threads;
+    while (threads.size() != num_threads) {
+      size_t thread_idx = threads.size();
+      threads.emplace_back([this, &stop_requested, &num_batches, &kSharedKey, thread_idx] {
+        size_t i = 0;
+        while (!stop_requested.load(std::memory_order_acquire)) {
+          RefCntPrefix key(Format("row_$0_$1", thread_idx, i % 1000));
+          LockBatch lb(&lm_, {
+              {kSharedKey, IntentTypeSet({IntentType::kWeakWrite, IntentType::kWeakRead})},
+              {key, IntentTypeSet({IntentType::kStrongWrite, IntentType::kStrongRead})}},
+              CoarseTimePoint::max());
+          ASSERT_OK(lb.status());
+          ++i;
+        }
+        num_batches.fetch_add(i, std::memory_order_acq_rel);
+      });
+    }
+
+    std::this_thread::sleep_for(kDuration);
+    stop_requested.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    LOG(INFO) << "Threads: " << num_threads << ", lock batches per second: "
+              << num_batches.load(std::memory_order_acquire) * 1s / kDuration;
+    ASSERT_GE(num_batches.load(std::memory_order_acquire), num_threads);
+  }
+}
+
 TEST_F(SharedLockManagerTest, LockConflicts) {
   rpc::ThreadPool tp(rpc::ThreadPoolOptions{
     .name = "test_pool"s,
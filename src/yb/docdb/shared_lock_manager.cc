@@ -24,6 +24,8 @@
 
 #include "yb/docdb/lock_batch.h"
 
+#include "yb/gutil/port.h"
+
 #include "yb/util/enums.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/scope_exit.h"
@@ -133,13 +135,18 @@ bool IntentTypeSetsConflict(IntentTypeSet lhs, IntentTypeSet rhs) {
 }
 
 struct LockedBatchEntry {
+  explicit LockedBatchEntry(size_t shard_idx) : shard(shard_idx) {}
+
   // Taken only for short duration, with no blocking wait.
   mutable std::mutex mutex;
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and covers this field for all LockBatchEntries.
+  // Index of the lock manager shard this entry belongs to.
+  const size_t shard;
+
+  // Refcounting for garbage collection. Can only be used while the shard mutex is locked.
+  // Shard mutex resides in lock manager and covers this field for all entries of the shard.
   size_t ref_count = 0;
 
   // Number of holders for each type
@@ -165,28 +172,46 @@ class SharedLockManager::Impl {
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
   ~Impl() {
-    std::lock_guard lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& shard : shards_) {
+      std::lock_guard lock(shard.mutex);
+      LOG_IF(DFATAL, !shard.locks.empty())
+          << "Locks not empty in dtor: " << yb::ToString(shard.locks);
+    }
   }
 
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
+  // Lock entries are partitioned into shards by key hash, so concurrent batches with different
+  // keys don't contend on a single mutex.
+  struct CACHELINE_ALIGNED Shard {
+    // The shard mutex should be taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  };
+
+  static constexpr size_t kShardBits = 4;
+  static constexpr size_t kNumShards = 1ULL << kShardBits;
+
+  static size_t ShardIndex(const RefCntPrefix& key) {
+    // Use high bits of multiplicative hash, since low bits of the key hash are used by the map
+    // inside the shard.
+    return (static_cast<uint64_t>(RefCntPrefixHash()(key)) * 0x9E3779B97F4A7C15ULL) >>
+           (64 - kShardBits);
+  }
+
+  // Make sure the entries exist in the shard maps and store pointers to them in the batch, so we
+  // can access them without holding the shard locks.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
-
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  std::array<Shard, kNumShards> shards_;
 };
 
 std::string SharedLockManager::ToString(const LockState& state) {
@@ -306,16 +331,29 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
 }
 
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard lock(global_mutex_);
+  // Keep the shard locked while consecutive keys belong to it.
+  std::unique_lock<std::mutex> lock;
+  Shard* locked_shard = nullptr;
   for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
+    auto shard_idx = ShardIndex(key_and_intent_type.key);
+    auto& shard = shards_[shard_idx];
+    if (&shard != locked_shard) {
+      // Release the previous shard before locking the next one, so at most one shard mutex is
+      // held at a time and batches visiting shards in different order cannot deadlock.
+      if (locked_shard) {
+        lock.unlock();
+      }
+      lock = std::unique_lock(shard.mutex);
+      locked_shard = &shard;
+    }
+    auto& value = shard.locks[key_and_intent_type.key];
     if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
+      if (!shard.free_lock_entries.empty()) {
+        value = shard.free_lock_entries.back();
+        shard.free_lock_entries.pop_back();
       } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+        shard.lock_entries.emplace_back(std::make_unique<LockedBatchEntry>(shard_idx));
+        value = shard.lock_entries.back().get();
       }
     }
     value->ref_count++;
@@ -334,11 +372,22 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard lock(global_mutex_);
+  std::unique_lock<std::mutex> lock;
+  Shard* locked_shard = nullptr;
   for (const auto& item : key_to_intent_type) {
+    auto& shard = shards_[item.locked->shard];
+    if (&shard != locked_shard) {
+      // Release the previous shard before locking the next one, so at most one shard mutex is
+      // held at a time and batches visiting shards in different order cannot deadlock.
+      if (locked_shard) {
+        lock.unlock();
+      }
+      lock = std::unique_lock(shard.mutex);
+      locked_shard = &shard;
+    }
     if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+      shard.locks.erase(item.key);
+      shard.free_lock_entries.push_back(item.locked);
     }
   }
 }
@@ -31,6 +31,7 @@ class KeyEntryValue;
 class Partition;
 class PartitionSchema;
 class PgTableRow;
+class PgTableRowBatch;
 class PgValue;
 class PrimitiveValue;
 class RowPacker;
@@ -58,5 +59,6 @@ YB_STRONGLY_TYPED_BOOL(PartialRangeKeyIntents);
 YB_STRONGLY_TYPED_BOOL(UseHash);
 
 YB_DEFINE_ENUM(OperationKind, (kRead)(kWrite));
+YB_DEFINE_ENUM(PackedRowVersion, (kV1)(kV2));
 
 }  // namespace yb::dockv
@@ -22,9 +22,12 @@
 #include "yb/dockv/value_type.h"
 
 #include "yb/util/fast_varint.h"
+#include "yb/util/flags.h"
 #include "yb/util/random_util.h"
 #include "yb/util/test_macros.h"
 
+DECLARE_bool(use_packed_row_v2);
+
 namespace yb::dockv {
 
 QLValuePB RandomQLValue(DataType type) {
@@ -55,11 +58,16 @@ void TestRowPacking(const Schema& schema, const std::vector<QLValuePB>& values)
   }
   auto packed = ASSERT_RESULT(packer.Complete());
   LOG(INFO) << "Packed: " << packed.ToDebugHexString();
-  ASSERT_EQ(static_cast<ValueEntryType>(packed.consume_byte()), ValueEntryType::kPackedRow);
+  auto packed_row_version = ConsumePackedRowVersion(&packed);
+  ASSERT_TRUE(packed_row_version);
+  if (!FLAGS_use_packed_row_v2) {
+    ASSERT_EQ(*packed_row_version, PackedRowVersion::kV1);
+  }
   auto version = ASSERT_RESULT(util::FastDecodeUnsignedVarInt(&packed));
   ASSERT_EQ(version, kVersion);
   for (size_t i = schema.num_key_columns(); i != schema.num_columns(); ++i) {
-    auto value_slice = *schema_packing.GetValue(schema.column_id(i), packed);
+    auto value_slice = *schema_packing.GetValue(
+        *packed_row_version, schema.column_id(i), packed);
     const auto& value = values[i - schema.num_key_columns()];
     PrimitiveValue decoded_value;
     if (IsNull(value)) {
@@ -105,7 +113,7 @@ void TestPacking(const std::vector<DataType>& types) {
   }
 }
 
-TEST(PackedRowTest, Random) {
+void TestRandomPacking() {
   std::vector<DataType> supported_types = {DataType::INT32, DataType::INT64, DataType::STRING};
   for (int i = 1; i != 10; ++i) {
     std::vector<DataType> types;
@@ -116,4 +124,71 @@ TEST(PackedRowTest, Random) {
   }
 }
 
+TEST(PackedRowTest, Random) {
+  google::FlagSaver flag_saver;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_use_packed_row_v2) = false;
+  TestRandomPacking();
+}
+
+TEST(PackedRowTest, RandomV2) {
+  google::FlagSaver flag_saver;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_use_packed_row_v2) = true;
+  TestRandomPacking();
+}
+
+// Checks that packed row V2 is used only when it is smaller than V1, and that it has the same
+// column data.
+TEST(PackedRowTest, V2Size) {
+  google::FlagSaver flag_saver;
+  SchemaBuilder builder;
+  ASSERT_OK(builder.AddHashKeyColumn("h", DataType::INT32));
+  ASSERT_OK(builder.AddColumn("v_int32", DataType::INT32));
+  ASSERT_OK(builder.AddNullableColumn("v_int64", DataType::INT64));
+  ASSERT_OK(builder.AddNullableColumn("v_string", DataType::STRING));
+  auto schema = builder.Build();
+  SchemaPacking schema_packing(TableType::PGSQL_TABLE_TYPE, schema);
+
+  for (auto string_len : {0, 10, 300, 70000}) {
+    std::vector<QLValuePB> values = {
+      QLValue::Primitive(RandomUniformInt<int32_t>()),
+      QLValue::Primitive(RandomUniformInt<int64_t>()),
+      QLValue::Primitive(RandomHumanReadableString(string_len)),
+    };
+    std::vector<std::string> packed_rows;
+    for (auto use_v2 : {false, true}) {
+      ANNOTATE_UNPROTECTED_WRITE(FLAGS_use_packed_row_v2) = use_v2;
+      RowPacker packer(
+          /* version= */ 1, schema_packing,
+          /* packed_size_limit= */ std::numeric_limits<int64_t>::max(),
+          /* value_control_fields= */ Slice());
+      for (size_t i = 0; i != values.size(); ++i) {
+        ASSERT_OK(packer.AddValue(schema.column_id(i + 1), values[i]));
+      }
+      packed_rows.push_back(ASSERT_RESULT(packer.Complete()).ToBuffer());
+    }
+    Slice v1 = packed_rows[0];
+    Slice v2 = packed_rows[1];
+    auto v1_version = ConsumePackedRowVersion(&v1);
+    auto v2_version = ConsumePackedRowVersion(&v2);
+    ASSERT_TRUE(v1_version && v2_version);
+    ASSERT_EQ(*v1_version, PackedRowVersion::kV1);
+    if (string_len > std::numeric_limits<uint16_t>::max()) {
+      ASSERT_EQ(*v2_version, PackedRowVersion::kV1);
+      ASSERT_EQ(v1, v2);
+      continue;
+    }
+    ASSERT_EQ(*v2_version, PackedRowVersion::kV2);
+    // 2 varlen columns, 1 byte width of the ends.
+    size_t expected_saving = string_len < 200 ? 2 * 3 - 1 : 2 * 2 - 1;
+    ASSERT_EQ(v1.size(), v2.size() + expected_saving);
+    ASSERT_OK(util::FastDecodeUnsignedVarInt(&v1));
+    ASSERT_OK(util::FastDecodeUnsignedVarInt(&v2));
+    ASSERT_EQ(schema_packing.PrefixLen(PackedRowVersion::kV1, v1), 2 * sizeof(uint32_t));
+    for (size_t i = 0; i != schema_packing.columns(); ++i) {
+      ASSERT_EQ(schema_packing.GetValue(PackedRowVersion::kV1, i, v1),
+                schema_packing.GetValue(PackedRowVersion::kV2, i, v2));
+    }
+  }
+}
+
 } // namespace yb::dockv
@@ -13,6 +13,8 @@
 
 #include "yb/dockv/packed_row.h"
 
+#include <limits>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
 
@@ -35,6 +37,10 @@ using namespace yb::size_literals;
 
 DEFINE_UNKNOWN_int64(db_block_size_bytes, 32_KB, "Size of RocksDB data block (in bytes).");
 
+DEFINE_RUNTIME_AUTO_bool(use_packed_row_v2, kExternal, false, true,
+                         "Write packed rows using packed row V2 encoding, that stores ends of "
+                         "varlen columns in a more compact way.");
+
 namespace yb::dockv {
 
 namespace {
@@ -141,6 +147,7 @@ RowPacker::RowPacker(
 void RowPacker::Init(SchemaVersion version) {
   size_t prefix_len = packing_.prefix_len();
   result_.Reserve(result_.size() + 1 + kMaxVarint32Length + prefix_len);
+  value_type_pos_ = result_.size();
   result_.PushBack(ValueEntryTypeAsChar::kPackedRow);
   result_.Truncate(
       result_.size() +
@@ -181,6 +188,7 @@ Result<bool> RowPacker::AddValue(
 // Replaces the schema version in packed value with the provided schema version.
 // Note: Value starts with the schema version (does not contain control fields, value type).
 Status ReplaceSchemaVersionInPackedValue(Slice value,
+                                         PackedRowVersion packed_row_version,
                                          const ValueControlFields& control_fields,
                                          const SchemaVersionMapper& schema_versions_mapper,
                                          ValueBuffer *out) {
@@ -193,7 +201,7 @@ Status ReplaceSchemaVersionInPackedValue(Slice value,
   auto mapped_version = VERIFY_RESULT(schema_versions_mapper(schema_version));
 
   out->Reserve(out->size() + 1 + kMaxVarint32Length + value.size());
-  out->PushBack(ValueEntryTypeAsChar::kPackedRow);
+  out->PushBack(PackedRowValueTypeAsChar(packed_row_version));
   util::FastAppendUnsignedVarInt(mapped_version, out);
   out->Append(value);
 
@@ -265,9 +273,44 @@ Result<Slice> RowPacker::Complete() {
   }
   RSTATUS_DCHECK_EQ(
       varlen_write_pos_, prefix_end_, InvalidArgument, "Not all varlen columns packed");
+  if (FLAGS_use_packed_row_v2) {
+    return CompactVarlenEnds();
+  }
   return result_.AsSlice();
 }
 
+Slice RowPacker::CompactVarlenEnds() {
+  const auto num_varlen_columns = packing_.varlen_columns_count();
+  const auto data_size = result_.size() - prefix_end_;
+  if (num_varlen_columns == 0 || data_size > std::numeric_limits<uint16_t>::max()) {
+    return result_.AsSlice();
+  }
+  const size_t width = data_size <= std::numeric_limits<uint8_t>::max() ? 1 : 2;
+  const auto prefix_start = prefix_end_ - packing_.prefix_len();
+  const auto value = result_.AsSlice();
+
+  compact_result_.Clear();
+  compact_result_.Reserve(prefix_start + 1 + num_varlen_columns * width + data_size);
+  compact_result_.Append(value.Prefix(value_type_pos_));
+  compact_result_.PushBack(ValueEntryTypeAsChar::kPackedRowV2);
+  compact_result_.Append(Slice(value.data() + value_type_pos_ + 1, value.data() + prefix_start));
+  compact_result_.PushBack(static_cast<char>(width));
+  auto* out = compact_result_.GrowByAtLeast(num_varlen_columns * width);
+  const auto* end_ptr = value.data() + prefix_start;
+  for (size_t i = 0; i != num_varlen_columns; ++i) {
+    auto end = LittleEndian::Load32(end_ptr);
+    if (width == 1) {
+      *out = static_cast<char>(end);
+    } else {
+      LittleEndian::Store16(out, narrow_cast<uint16_t>(end));
+    }
+    end_ptr += sizeof(uint32_t);
+    out += width;
+  }
+  compact_result_.Append(value.WithoutPrefix(prefix_end_));
+  return compact_result_.AsSlice();
+}
+
 ColumnId RowPacker::NextColumnId() const {
   return idx_ < packing_.columns() ? packing_.column_packing_data(idx_).id : kInvalidColumnId;
 }
@@ -64,12 +64,30 @@ namespace yb::dockv {
 //
 // The rationale for this format is to have ability to extract column value with O(1) complexity.
 // Also it helps us to avoid storing common data for all rows, and put it to a single schema info.
+//
+// The format above is packed row V1, i.e. value type kPackedRow.
+// When use_packed_row_v2 AutoFlag is set, rows are written using packed row V2, i.e. value type
+// kPackedRowV2, that stores varlen column ends using the minimal width enough for the row data:
+// varint: schema_version
+// uint8: width of the end, 1 or 2 bytes
+// width bytes: end_of_column_data for the 1st varlen column
+// ...
+// width bytes: end_of_column_data for the last varlen column
+// bytes: data for the 1st column
+// ...
+// bytes: data for the last column
+//
+// Column data is the same in both versions, so the column value could be extracted w/o copying.
+// Packed row V2 is written only when it is smaller than V1, i.e. row has varlen columns and
+// row data fits into 64KB. For rows with less than 256 bytes of data it saves 3 bytes per varlen
+// column, i.e. per each nullable column in YSQL and per each column in YCQL.
 
 using SchemaVersionMapper = boost::function<Result<SchemaVersion>(SchemaVersion)>;
 
 // Replaces the schema version in packed value with the provided schema version.
 // Note: Value starts with the schema version (does not contain control fields, value type).
 Status ReplaceSchemaVersionInPackedValue(Slice value,
+                                         PackedRowVersion packed_row_version,
                                          const ValueControlFields& control_fields,
                                          const SchemaVersionMapper& schema_versions_mapper,
                                          ValueBuffer *out);
@@ -112,12 +130,17 @@ class RowPacker {
   template <class Value>
   Result<bool> DoAddValue(ColumnId column_id, const Value& value, ssize_t tail_size);
 
+  // Converts packed row from result_ to packed row V2 when it is beneficial.
+  Slice CompactVarlenEnds();
+
   const SchemaPacking& packing_;
   const ssize_t packed_size_limit_;
   size_t idx_ = 0;
+  size_t value_type_pos_;
   size_t prefix_end_;
   ValueBuffer result_;
   size_t varlen_write_pos_;
+  ValueBuffer compact_result_;
 };
 
 } // namespace yb::dockv
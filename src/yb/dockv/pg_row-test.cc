@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/common/ql_value.h"
+#include "yb/common/schema.h"
+
+#include "yb/dockv/pg_row.h"
+#include "yb/dockv/reader_projection.h"
+#include "yb/dockv/schema_packing.h"
+
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/write_buffer.h"
+
+namespace yb::dockv {
+
+namespace {
+
+Schema BuildSchema() {
+  SchemaBuilder builder;
+  CHECK_OK(builder.AddHashKeyColumn("h", DataType::INT32));
+  CHECK_OK(builder.AddColumn("v_int32", DataType::INT32));
+  CHECK_OK(builder.AddColumn("v_int64", DataType::INT64));
+  CHECK_OK(builder.AddNullableColumn("v_string", DataType::STRING));
+  CHECK_OK(builder.AddColumn("v_double", DataType::DOUBLE));
+  return builder.Build();
+}
+
+QLValuePB RandomValue(const ColumnSchema& column) {
+  if (column.is_nullable() && RandomUniformBool()) {
+    return QLValuePB();
+  }
+  switch (column.type_info()->type) {
+    case DataType::INT32:
+      return QLValue::Primitive(RandomUniformInt<int32_t>());
+    case DataType::INT64:
+      return QLValue::Primitive(RandomUniformInt<int64_t>());
+    case DataType::DOUBLE:
+      return QLValue::Primitive(RandomUniformReal<double>());
+    case DataType::STRING:
+      return QLValue::Primitive(RandomHumanReadableString(RandomUniformInt(0, 32)));
+    default:
+      CHECK(false) << "Not supported data type: " << column.type_info()->type;
+  }
+}
+
+} // namespace
+
+TEST(PgRowTest, FixedOffset) {
+  auto schema = BuildSchema();
+  SchemaPacking packing(TableType::PGSQL_TABLE_TYPE, schema);
+  ASSERT_EQ(packing.varlen_columns_count(), 1);
+  // v_int32 and v_int64 are located before the first varlen column, right after the prefix.
+  ASSERT_EQ(*packing.FixedOffset(0), 0U);
+  ASSERT_EQ(*packing.FixedOffset(1), 1 + sizeof(int32_t));
+  // v_string is varlen, and v_double follows varlen column.
+  ASSERT_FALSE(packing.FixedOffset(2));
+  ASSERT_FALSE(packing.FixedOffset(3));
+}
+
+TEST(PgRowTest, Batch) {
+  constexpr size_t kCapacity = 16;
+  auto schema = BuildSchema();
+  ReaderProjection projection(schema);
+  PgTableRowBatch batch(projection, kCapacity);
+  PgTableRow row(projection);
+  std::vector<std::string> expected;
+  for (size_t i = 0; i != kCapacity; ++i) {
+    row.Reset();
+    for (size_t idx = 0; idx != schema.num_columns(); ++idx) {
+      ASSERT_OK(row.SetValue(schema.column_id(idx), RandomValue(schema.column(idx))));
+    }
+    batch.AppendRow(row);
+    WriteBuffer buffer(0x100);
+    for (size_t idx = 0; idx != projection.size(); ++idx) {
+      row.AppendValueByIndex(idx, &buffer);
+    }
+    expected.push_back(buffer.ToBuffer());
+  }
+  ASSERT_TRUE(batch.Full());
+  ASSERT_EQ(batch.size(), kCapacity);
+
+  size_t encoded_size = 0;
+  for (size_t i = 0; i != kCapacity; ++i) {
+    WriteBuffer buffer(0x100);
+    for (size_t idx = 0; idx != projection.size(); ++idx) {
+      batch.AppendValue(i, idx, &buffer);
+    }
+    ASSERT_EQ(buffer.ToBuffer(), expected[i]) << "Row: " << i;
+    encoded_size += buffer.size();
+  }
+  ASSERT_LE(encoded_size, batch.EncodedSize());
+
+  batch.Reset();
+  ASSERT_TRUE(batch.empty());
+}
+
+} // namespace yb::dockv
@@ -289,6 +289,44 @@ Status DoDecodeKey(
 
 } // namespace
 
+ValueEntryType PackedFixedValueType(DataType data_type) {
+  switch (data_type) {
+    case DataType::INT8: [[fallthrough]];
+    case DataType::INT16: [[fallthrough]];
+    case DataType::INT32:
+      return ValueEntryType::kInt32;
+    case DataType::UINT8: [[fallthrough]];
+    case DataType::UINT16: [[fallthrough]];
+    case DataType::UINT32:
+      return ValueEntryType::kUInt32;
+    case DataType::FLOAT:
+      return ValueEntryType::kFloat;
+    case DataType::INT64:
+      return ValueEntryType::kInt64;
+    case DataType::UINT64:
+      return ValueEntryType::kUInt64;
+    case DataType::DOUBLE:
+      return ValueEntryType::kDouble;
+    default:
+      return ValueEntryType::kInvalid;
+  }
+}
+
+size_t PackedFixedValueSize(ValueEntryType value_type) {
+  switch (value_type) {
+    case ValueEntryType::kInt32: [[fallthrough]];
+    case ValueEntryType::kUInt32: [[fallthrough]];
+    case ValueEntryType::kFloat:
+      return sizeof(uint32_t);
+    case ValueEntryType::kInt64: [[fallthrough]];
+    case ValueEntryType::kUInt64: [[fallthrough]];
+    case ValueEntryType::kDouble:
+      return sizeof(uint64_t);
+    default:
+      return 0;
+  }
+}
+
 int8_t PgValue::int8_value() const {
   return static_cast<int8_t>(value_);
 }
@@ -545,4 +583,99 @@ Status PgTableRow::SetValue(ColumnId column_id, const QLValuePB& value) {
   return Status::OK();
 }
 
+PgTableRowBatch::PgTableRowBatch(
+    std::reference_wrapper<const ReaderProjection> projection, size_t capacity)
+    : projection_(&projection.get()), capacity_(capacity),
+      is_null_(projection_->size() * capacity), values_(projection_->size() * capacity) {
+  fixed_sizes_.reserve(projection_->size());
+  for (const auto& column : projection_->columns) {
+    fixed_sizes_.push_back(FixedSize(column.data_type));
+    // Prefix byte followed by the value.
+    max_encoded_fixed_size_ += 1 + fixed_sizes_.back();
+  }
+}
+
+void PgTableRowBatch::Reset() {
+  size_ = 0;
+  buffer_.clear();
+}
+
+void PgTableRowBatch::AppendRow(const PgTableRow& row) {
+  DCHECK_EQ(row.projection_, projection_);
+  DCHECK_LT(size_, capacity_);
+  const auto num_columns = fixed_sizes_.size();
+  for (size_t column_idx = 0, idx = size_; column_idx != num_columns;
+       ++column_idx, idx += capacity_) {
+    const bool is_null = row.is_null_[column_idx];
+    is_null_[idx] = is_null;
+    if (is_null) {
+      continue;
+    }
+    if (fixed_sizes_[column_idx]) {
+      values_[idx] = row.values_[column_idx];
+      continue;
+    }
+    const auto* data = row.buffer_.data() + row.values_[column_idx];
+    const auto len = BigEndian::Load64(data);
+    values_[idx] = buffer_.size();
+    buffer_.Append(Slice(data, len + sizeof(uint64_t)));
+  }
+  ++size_;
+}
+
+std::optional<PgValue> PgTableRowBatch::GetValue(size_t row_idx, size_t column_idx) const {
+  const auto idx = column_idx * capacity_ + row_idx;
+  if (is_null_[idx]) {
+    return std::nullopt;
+  }
+  if (fixed_sizes_[column_idx]) {
+    return PgValue(values_[idx]);
+  }
+  return PgValue(bit_cast<PgValueDatum>(buffer_.data() + values_[idx]));
+}
+
+void PgTableRowBatch::AppendValue(size_t row_idx, size_t column_idx, WriteBuffer* buffer) const {
+  const auto idx = column_idx * capacity_ + row_idx;
+  if (is_null_[idx]) {
+    const char kNullMark = 1;
+    buffer->Append(&kNullMark, 1);
+    return;
+  }
+
+  const auto fixed_size = fixed_sizes_[column_idx];
+  if (fixed_size) {
+    auto big_endian_value = BigEndian::FromHost64(values_[idx]);
+    Slice slice(pointer_cast<const uint8_t*>(&big_endian_value), 8);
+    buffer->AppendWithPrefix(0, slice.Suffix(fixed_size));
+    return;
+  }
+
+  const auto data = pointer_cast<const char*>(buffer_.data()) + values_[idx];
+  const auto len = BigEndian::Load64(data);
+  buffer->AppendWithPrefix(0, data, len + 8);
+}
+
+std::string PgTableRowBatch::ToString() const {
+  std::string result = "[ ";
+  for (size_t row_idx = 0; row_idx != size_; ++row_idx) {
+    result += "{ ";
+    for (size_t column_idx = 0; column_idx != fixed_sizes_.size(); ++column_idx) {
+      result += projection_->columns[column_idx].id.ToString();
+      result += ": ";
+      auto value = GetValue(row_idx, column_idx);
+      if (!value) {
+        result += "<NULL>";
+      } else if (fixed_sizes_[column_idx]) {
+        result += std::to_string(values_[column_idx * capacity_ + row_idx]);
+      } else {
+        result += value->binary_value().ToDebugHexString();
+      }
+      result += " ";
+    }
+    result += "} ";
+  }
+  result += "]";
+  return result;
+}
+
 }  // namespace yb::dockv
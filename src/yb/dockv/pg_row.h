@@ -14,6 +14,7 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include <boost/container/small_vector.hpp>
 
@@ -37,6 +38,14 @@ namespace yb::dockv {
 
 using PgValueDatum = size_t;
 
+// Returns type of the entry that is used to encode not null value of fixed size column with
+// specified data type in packed row. Returns kInvalid when value of such column should be decoded
+// via generic path.
+ValueEntryType PackedFixedValueType(DataType data_type);
+
+// Size of the value encoded with specified type, w/o entry type itself.
+size_t PackedFixedValueSize(ValueEntryType value_type);
+
 class PgValue {
  public:
   PgValue() = default;
@@ -102,6 +111,12 @@ class PgTableRow {
   Status DecodeKey(size_t column_idx, Slice* value);
   Status DecodeValue(size_t column_idx, Slice value);
 
+  // Set value of the fixed size column, that was already decoded by the caller.
+  void SetFixedValue(size_t column_idx, PgValueDatum value) {
+    is_null_[column_idx] = false;
+    values_[column_idx] = value;
+  }
+
   bool IsNull(size_t index) const {
     return is_null_[index];
   }
@@ -117,6 +132,8 @@ class PgTableRow {
   PgValue TrimString(size_t idx, size_t skip_prefix, size_t new_len);
 
  private:
+  friend class PgTableRowBatch;
+
   PgValueDatum GetDatum(size_t idx) const;
 
   const ReaderProjection* projection_;
@@ -125,4 +142,84 @@ class PgTableRow {
   ValueBuffer buffer_;
 };
 
+// Columnar representation of the batch of rows read using the same projection.
+// Values of each column are stored contiguously, so fixed size columns could be processed
+// as plain arrays, w/o per value dispatch.
+// Variable length values are stored in the shared buffer using the same format as PgTableRow does,
+// and column contains offset of the value in this buffer.
+class PgTableRowBatch {
+ public:
+  PgTableRowBatch(std::reference_wrapper<const ReaderProjection> projection, size_t capacity);
+
+  const ReaderProjection& projection() const {
+    return *projection_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  bool Full() const {
+    return size_ == capacity_;
+  }
+
+  // Fixed size of the column values, 0 for variable length columns.
+  size_t fixed_size(size_t column_idx) const {
+    return fixed_sizes_[column_idx];
+  }
+
+  void Reset();
+
+  // Appends row to the batch. Row should use the same projection as the batch.
+  void AppendRow(const PgTableRow& row);
+
+  bool IsNull(size_t row_idx, size_t column_idx) const {
+    return is_null_[column_idx * capacity_ + row_idx];
+  }
+
+  std::optional<PgValue> GetValue(size_t row_idx, size_t column_idx) const;
+
+  // Append encoded value of specified column in specified row to the buffer.
+  // Uses the same format as PgTableRow::AppendValueByIndex.
+  void AppendValue(size_t row_idx, size_t column_idx, WriteBuffer* buffer) const;
+
+  // Upper bound of the number of bytes appended by AppendValue for all columns of all rows.
+  size_t EncodedSize() const {
+    return size_ * max_encoded_fixed_size_ + buffer_.size();
+  }
+
+  // Null flags of the column, one byte per row.
+  const uint8_t* NullFlags(size_t column_idx) const {
+    return is_null_.data() + column_idx * capacity_;
+  }
+
+  // Values of the fixed size column. Value is undefined for NULL rows.
+  const PgValueDatum* FixedValues(size_t column_idx) const {
+    return values_.data() + column_idx * capacity_;
+  }
+
+  std::string ToString() const;
+
+ private:
+  const ReaderProjection* projection_;
+  const size_t capacity_;
+  size_t size_ = 0;
+  std::vector<size_t> fixed_sizes_;
+  // Max number of bytes appended by AppendValue for all columns of a row, excluding variable
+  // length data stored in buffer_.
+  size_t max_encoded_fixed_size_ = 0;
+  // Column major arrays, i.e. value of row r in column c is stored at c * capacity_ + r.
+  std::vector<uint8_t> is_null_;
+  std::vector<PgValueDatum> values_;
+  ValueBuffer buffer_;
+};
+
 }  // namespace yb::dockv
@@ -65,6 +65,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueEntryType::kJsonb: FALLTHROUGH_INTENDED; \
     case ValueEntryType::kObject: FALLTHROUGH_INTENDED; \
     case ValueEntryType::kPackedRow: FALLTHROUGH_INTENDED; \
+    case ValueEntryType::kPackedRowV2: FALLTHROUGH_INTENDED; \
     case ValueEntryType::kRedisList: FALLTHROUGH_INTENDED; \
     case ValueEntryType::kRedisSet: FALLTHROUGH_INTENDED; \
     case ValueEntryType::kRedisSortedSet: FALLTHROUGH_INTENDED;  \
@@ -283,7 +284,8 @@ std::string PrimitiveValue::ValueToString() const {
       return "l";
     case ValueEntryType::kArrayIndex:
       return Substitute("ArrayIndex($0)", int64_val_);
-    case ValueEntryType::kPackedRow:
+    case ValueEntryType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueEntryType::kPackedRowV2:
       return "<PACKED ROW>";
     case ValueEntryType::kObject:
       return "{}";
@@ -1324,6 +1326,7 @@ Status PrimitiveValue::DecodeFromValue(const Slice& rocksdb_slice) {
 
     case ValueEntryType::kInvalid: FALLTHROUGH_INTENDED;
     case ValueEntryType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueEntryType::kPackedRowV2: FALLTHROUGH_INTENDED;
     case ValueEntryType::kMaxByte:
       return STATUS_FORMAT(Corruption, "$0 is not allowed in a RocksDB PrimitiveValue", value_type);
   }
@@ -1546,6 +1549,7 @@ Status PrimitiveValue::DecodeToQLValuePB(
 
     case ValueEntryType::kInvalid: FALLTHROUGH_INTENDED;
     case ValueEntryType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueEntryType::kPackedRowV2: FALLTHROUGH_INTENDED;
     case ValueEntryType::kRowLock: FALLTHROUGH_INTENDED;
     case ValueEntryType::kMaxByte:
       return STATUS_FORMAT(Corruption, "$0 is not allowed in a RocksDB PrimitiveValue", value_type);
@@ -19,6 +19,7 @@
 
 #include "yb/dockv/dockv.pb.h"
 #include "yb/dockv/primitive_value.h"
+#include "yb/dockv/value_type.h"
 
 #include "yb/gutil/casts.h"
 
@@ -46,8 +47,73 @@ size_t EncodedColumnSize(const ColumnSchema& column_schema) {
   return 1 + column_schema.type_info()->size;
 }
 
+// Provides access to varlen column ends stored in prefix of packed row.
+// V1 stores ends as uint32, while V2 stores width of the ends in the first byte of the prefix.
+class VarlenEnds {
+ public:
+  VarlenEnds(PackedRowVersion version, size_t varlen_columns_count, Slice packed) {
+    if (version == PackedRowVersion::kV1) {
+      data_ = packed.data();
+      width_ = sizeof(uint32_t);
+      prefix_len_ = varlen_columns_count * sizeof(uint32_t);
+    } else {
+      data_ = packed.data() + 1;
+      width_ = packed[0];
+      prefix_len_ = 1 + varlen_columns_count * width_;
+    }
+  }
+
+  size_t prefix_len() const {
+    return prefix_len_;
+  }
+
+  size_t Load(size_t idx) const {
+    const auto* ptr = data_ + idx * width_;
+    switch (width_) {
+      case 1:
+        return *ptr;
+      case 2:
+        return LittleEndian::Load16(ptr);
+      default:
+        return LittleEndian::Load32(ptr);
+    }
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t width_;
+  size_t prefix_len_;
+};
+
 } // namespace
 
+std::optional<PackedRowVersion> GetPackedRowVersion(ValueEntryType value_type) {
+  switch (value_type) {
+    case ValueEntryType::kPackedRow:
+      return PackedRowVersion::kV1;
+    case ValueEntryType::kPackedRowV2:
+      return PackedRowVersion::kV2;
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<PackedRowVersion> ConsumePackedRowVersion(Slice* value) {
+  if (value->empty()) {
+    return std::nullopt;
+  }
+  auto result = GetPackedRowVersion(static_cast<ValueEntryType>((*value)[0]));
+  if (result) {
+    value->consume_byte();
+  }
+  return result;
+}
+
+char PackedRowValueTypeAsChar(PackedRowVersion version) {
+  return version == PackedRowVersion::kV1 ? ValueEntryTypeAsChar::kPackedRow
+                                          : ValueEntryTypeAsChar::kPackedRowV2;
+}
+
 ColumnPackingData ColumnPackingData::FromPB(const ColumnPackingPB& pb) {
   return ColumnPackingData {
     .id = ColumnId(pb.id()),
@@ -115,27 +181,28 @@ SchemaPacking::SchemaPacking(const SchemaPackingPB& pb) : varlen_columns_count_(
   }
 }
 
-size_t LoadEnd(size_t idx, const Slice& packed) {
-  return LittleEndian::Load32(packed.data() + idx * sizeof(uint32_t));
-}
-
 bool SchemaPacking::SkippedColumn(ColumnId column_id) const {
   auto it = column_to_idx_.find(column_id);
   return it && *it == kSkippedColumnIdx;
 }
 
+size_t SchemaPacking::PrefixLen(PackedRowVersion version, Slice packed) const {
+  return VarlenEnds(version, varlen_columns_count_, packed).prefix_len();
+}
+
 void SchemaPacking::GetBounds(
-    Slice packed, boost::container::small_vector_base<const uint8_t*>* bounds) const {
+    PackedRowVersion version, Slice packed,
+    boost::container::small_vector_base<const uint8_t*>* bounds) const {
   bounds->clear();
   bounds->reserve(columns_.size() + 1);
-  const auto prefix_len = this->prefix_len();
+  VarlenEnds ends(version, varlen_columns_count_, packed);
+  const auto prefix_len = ends.prefix_len();
   size_t offset = prefix_len;
   bounds->push_back(packed.data() + offset);
-  const auto* end_ptr = packed.data();
+  size_t varlen_idx = 0;
   for (const auto& column_data : columns_) {
     if (column_data.varlen()) {
-      offset = prefix_len + LittleEndian::Load32(end_ptr);
-      end_ptr += sizeof(uint32_t);
+      offset = prefix_len + ends.Load(varlen_idx++);
     } else {
       offset += column_data.size;
     }
@@ -143,23 +210,33 @@ void SchemaPacking::GetBounds(
   }
 }
 
-Slice SchemaPacking::GetValue(size_t idx, Slice packed) const {
+Slice SchemaPacking::GetValue(PackedRowVersion version, size_t idx, Slice packed) const {
   const auto& column_data = columns_[idx];
+  VarlenEnds ends(version, varlen_columns_count_, packed);
   size_t offset = column_data.num_varlen_columns_before
-      ? LoadEnd(column_data.num_varlen_columns_before - 1, packed) : 0;
-  offset += prefix_len() + column_data.offset_after_prev_varlen_column;
+      ? ends.Load(column_data.num_varlen_columns_before - 1) : 0;
+  offset += ends.prefix_len() + column_data.offset_after_prev_varlen_column;
   size_t end = column_data.varlen()
-      ? prefix_len() + LoadEnd(column_data.num_varlen_columns_before, packed)
+      ? ends.prefix_len() + ends.Load(column_data.num_varlen_columns_before)
       : offset + column_data.size;
   return Slice(packed.data() + offset, packed.data() + end);
 }
 
-std::optional<Slice> SchemaPacking::GetValue(ColumnId column_id, Slice packed) const {
+std::optional<Slice> SchemaPacking::GetValue(
+    PackedRowVersion version, ColumnId column_id, Slice packed) const {
   auto index = column_to_idx_.get(column_id.rep());
   if (index == kSkippedColumnIdx) {
     return {};
   }
-  return GetValue(index, packed);
+  return GetValue(version, index, packed);
+}
+
+std::optional<size_t> SchemaPacking::FixedOffset(size_t idx) const {
+  const auto& column_data = columns_[idx];
+  if (column_data.varlen() || column_data.num_varlen_columns_before) {
+    return std::nullopt;
+  }
+  return column_data.offset_after_prev_varlen_column;
 }
 
 int64_t SchemaPacking::GetIndex(ColumnId column_id) const {
@@ -26,6 +26,7 @@
 #include "yb/common/id_mapping.h"
 
 #include "yb/dockv/dockv.fwd.h"
+#include "yb/dockv/dockv_fwd.h"
 
 #include "yb/util/slice.h"
 #include "yb/util/strongly_typed_bool.h"
@@ -34,6 +35,15 @@ namespace yb::dockv {
 
 YB_STRONGLY_TYPED_BOOL(OverwriteSchemaPacking);
 
+// Returns packed row version for value type, or std::nullopt if it is not a packed row value type.
+std::optional<PackedRowVersion> GetPackedRowVersion(ValueEntryType value_type);
+
+// Consumes packed row value type from the start of value.
+// Returns std::nullopt and leaves value as is if value is not a packed row.
+std::optional<PackedRowVersion> ConsumePackedRowVersion(Slice* value);
+
+char PackedRowValueTypeAsChar(PackedRowVersion version);
+
 struct ColumnPackingData {
   ColumnId id;
 
@@ -78,23 +88,35 @@ class SchemaPacking {
     return columns_[idx];
   }
 
-  // Size of prefix before actual data.
+  // Size of prefix before actual data, when varlen column ends are stored as uint32.
+  // I.e. the size of prefix used by RowPacker while packing the row.
   size_t prefix_len() const {
     return varlen_columns_count_ * sizeof(uint32_t);
   }
 
+  // Size of prefix before actual data in packed row of specified version.
+  // packed - packed row data that follows schema version.
+  size_t PrefixLen(PackedRowVersion version, Slice packed) const;
+
   size_t varlen_columns_count() const {
     return varlen_columns_count_;
   }
 
   bool SkippedColumn(ColumnId column_id) const;
   int64_t GetIndex(ColumnId column_id) const;
-  Slice GetValue(size_t idx, Slice packed) const;
-  std::optional<Slice> GetValue(ColumnId column_id, Slice packed) const;
+  Slice GetValue(PackedRowVersion version, size_t idx, Slice packed) const;
+  std::optional<Slice> GetValue(
+      PackedRowVersion version, ColumnId column_id, Slice packed) const;
+
+  // Returns offset of the column data from the end of packed row prefix, when it does not depend
+  // on the row contents. I.e. column is fixed size and there are no varlen columns before it.
+  // So such column could be read w/o loading varlen column ends.
+  std::optional<size_t> FixedOffset(size_t idx) const;
 
   // Fills `bounds` with pointers of all packed columns in row represented by `packed`.
   void GetBounds(
-      Slice packed, boost::container::small_vector_base<const uint8_t*>* bounds) const;
+      PackedRowVersion version, Slice packed,
+      boost::container::small_vector_base<const uint8_t*>* bounds) const;
   void ToPB(SchemaPackingPB* out) const;
 
   bool CouldPack(const google::protobuf::RepeatedPtrField<QLColumnValuePB>& values) const;
@@ -17,6 +17,7 @@
 
 #include "yb/common/table_properties_constants.h"
 
+#include "yb/dockv/schema_packing.h"
 #include "yb/dockv/value_type.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -219,7 +220,7 @@ bool IsFullRowValue(const Slice& value) {
   if (value.empty()) {
     return false;
   }
-  return static_cast<dockv::ValueEntryType>(value[0]) == dockv::ValueEntryType::kPackedRow;
+  return GetPackedRowVersion(static_cast<dockv::ValueEntryType>(value[0])).has_value();
 }
 
 }  // namespace yb::dockv
@@ -184,6 +184,8 @@ namespace yb::dockv {
     /* Indicator for whether an intent is for a row lock. */ \
     ((kRowLock, 'l'))  /* ASCII code 108 */ \
     ((kSubTransactionId, 'n')) /* ASCII code 110 */ \
+    /* Packed row with compact encoding of varlen column ends. See packed_row.h for details. */ \
+    ((kPackedRowV2, 'p')) /* ASCII code 112 */ \
     /* Timestamp value in microseconds */ \
     ((kTimestamp, 's'))  /* ASCII code 115 */ \
     /* TTL value in milliseconds, optionally present at the start of a value. */ \
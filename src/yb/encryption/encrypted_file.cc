@@ -60,6 +60,11 @@ Status EncryptedRandomAccessFile::Read(
                       EncryptionOverflowWorkaround::kFalse);
 }
 
+Status EncryptedRandomAccessFile::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  // Each request should be decrypted separately, so don't forward batch to the underlying file.
+  return RandomAccessFile::MultiRead(requests, num_requests);
+}
+
 Status EncryptedRandomAccessFile::ReadAndValidate(
     uint64_t offset, size_t n, Slice* result, char* scratch, const ReadValidator& validator) {
   if (!FLAGS_encryption_counter_overflow_read_path_workaround ||
@@ -87,6 +92,10 @@ Status EncryptedRandomAccessFile::ReadAndValidate(
   return status_without_workaround;
 }
 
+Status EncryptedRandomAccessFile::Readahead(uint64_t offset, size_t length) {
+  return RandomAccessFileWrapper::Readahead(offset + header_size_, length);
+}
+
 Result<uint64_t> EncryptedRandomAccessFile::Size() const {
   return VERIFY_RESULT(RandomAccessFileWrapper::Size()) - header_size_;
 }
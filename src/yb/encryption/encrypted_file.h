@@ -46,12 +46,16 @@ class EncryptedRandomAccessFile : public RandomAccessFileWrapper {
 
   Status Read(uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const override;
 
+  Status MultiRead(ReadRequest* requests, size_t num_requests) const override;
+
   uint64_t GetEncryptionHeaderSize() const override {
     return header_size_;
   }
 
   Result<uint64_t> Size() const override;
 
+  Status Readahead(uint64_t offset, size_t length) override;
+
   virtual bool IsEncrypted() const override {
     return true;
   }
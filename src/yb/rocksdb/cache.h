@@ -54,6 +54,7 @@ enum SubCacheType {
 };
 
 class Cache;
+class SecondaryCache;
 
 // Create a new cache with a fixed size capacity. The cache is sharded
 // to 2^num_shard_bits shards, by hash of the key. The total capacity
@@ -66,6 +67,30 @@ extern std::shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern std::shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Same as above, but MULTI_TOUCH entries inserted with InsertSpillable are offered to
+// secondary_cache when evicted from the cache.
+extern std::shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
+                                     bool strict_capacity_limit,
+                                     std::shared_ptr<SecondaryCache> secondary_cache);
+
+// Default estimated charge of the clock cache entry. Smaller than the typical data block, since
+// index and filter blocks are also stored in the block cache.
+constexpr size_t kClockCacheDefaultEstimatedEntryCharge = 16 * 1024;
+
+// Create a new cache with the same sharding, capacity and SINGLE_TOUCH/MULTI_TOUCH semantics as
+// NewLRUCache, but using CLOCK (second chance) eviction instead of LRU lists.
+// Lookup and Release do not take any mutex, so this cache scales better on read mostly workloads
+// with high concurrency.
+//
+// Each shard keeps its entries in the fixed size open addressing hash table, sized using
+// estimated_entry_charge. When the table becomes full, entries are evicted even if the usage is
+// below capacity, so estimated_entry_charge should not exceed the typical entry charge.
+// strict_capacity_limit is respected on a best effort basis, i.e. concurrent inserts could
+// temporarily exceed the capacity.
+extern std::shared_ptr<Cache> NewClockCache(
+    size_t capacity, int num_shard_bits, bool strict_capacity_limit = false,
+    size_t estimated_entry_charge = kClockCacheDefaultEstimatedEntryCharge);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -115,6 +140,26 @@ class Cache {
                         Handle** handle = nullptr,
                         Statistics* statistics = nullptr) = 0;
 
+  // Returns the serialized contents of the value, that could be stored in the secondary cache.
+  using ContentsFunction = Slice (*)(void* value);
+
+  // Same as Insert, but when the entry is evicted from the multi touch cache, the contents of its
+  // value returned by contents_function are offered to the secondary cache.
+  // The default implementation does not support secondary cache and just inserts the entry.
+  virtual Status InsertSpillable(const Slice& key, const QueryId query_id,
+                                 void* value, size_t charge,
+                                 void (*deleter)(const Slice& key, void* value),
+                                 ContentsFunction contents_function,
+                                 Handle** handle = nullptr,
+                                 Statistics* statistics = nullptr) {
+    return Insert(key, query_id, value, charge, deleter, handle, statistics);
+  }
+
+  // Returns the secondary cache that receives entries evicted from this cache, nullptr if none.
+  virtual SecondaryCache* secondary_cache() const {
+    return nullptr;
+  }
+
   // If the cache has no mapping for "key", returns nullptr.
   //
   // Else return a handle that corresponds to the mapping.  The caller
@@ -123,6 +168,11 @@ class Cache {
   virtual Handle* Lookup(const Slice& key, const QueryId query_id,
                          Statistics* statistics = nullptr) = 0;
 
+  // Returns true if the cache has a mapping for "key". Unlike Lookup, does not
+  // count as an access: does not affect eviction order and sub cache of the entry,
+  // statistics and metrics, and does not check the secondary cache.
+  virtual bool Contains(const Slice& key) = 0;
+
   // Release a mapping returned by a previous Lookup().
   // REQUIRES: handle must not have been released yet.
   // REQUIRES: handle must have been returned by a method on *this.
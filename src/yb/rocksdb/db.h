@@ -281,6 +281,14 @@ class DB {
                     keys, values);
   }
 
+  // Loads SST data blocks that could contain specified keys of the default column family into the
+  // block cache, so following lookups of these keys don't wait for IO. Blocks of each SST file
+  // missing in the cache are read by a single batched read. Keys don't have to be sorted.
+  // Default implementation does nothing.
+  virtual Status PrefetchKeys(const ReadOptions& options, const std::vector<Slice>& keys) {
+    return Status::OK();
+  }
+
   // If the key definitely does not exist in the database, then this method
   // returns false, else true. If the caller wants to obtain value when the key
   // is found in memory, a bool for 'value_found' must be passed. 'value_found'
@@ -791,6 +799,11 @@ class DB {
   // Returns total number of SST Files.
   virtual uint64_t GetCurrentVersionNumSSTFiles() { return 0; }
 
+  // Returns the largest number of sorted runs in the default column family, that could be
+  // compacted together. Unlike the number of SST files, it does not count files that are never
+  // compacted together, and outputs of the same compaction are counted as a single run.
+  virtual uint64_t GetCurrentVersionNumCompactableSortedRuns() { return 0; }
+
   // Returns the combined size of all the SST Files data blocks for the current version in the
   // rocksdb instance.
   virtual uint64_t GetCurrentVersionDataSstFilesSize() { return 0; }
@@ -858,6 +871,10 @@ class DB {
   // (2) No other writes happen during AddFile call, otherwise
   //     DB may get corrupted.
   // (3) No snapshots are held.
+  //
+  // Unless nothing was written to the DB yet, the file is assigned the next sequence number and
+  // the non-empty memtable is switched and flushed, so the file is ordered as the newest sorted
+  // run of level 0.
   virtual Status AddFile(ColumnFamilyHandle* column_family,
                          const std::string& file_path,
                          bool move_file = false) = 0;
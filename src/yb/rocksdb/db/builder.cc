@@ -147,10 +147,14 @@ Status BuildTable(const std::string& dbname,
     if (!s.ok()) {
       return s;
     }
+    // Compression dictionary is only trained for compaction output, flushed files are usually
+    // compacted soon, so it is not worth to buffer their data blocks.
+    auto build_compression_opts = compression_opts;
+    build_compression_opts.max_dict_bytes = 0;
     std::unique_ptr<TableBuilder> builder(NewTableBuilder(
         ioptions, internal_comparator, int_tbl_prop_collector_factories,
         column_family_id, base_file_writer.get(), data_file_writer.get(), compression,
-        compression_opts));
+        build_compression_opts));
 
     MergeHelper merge(env, internal_comparator->user_comparator(),
                       ioptions.merge_operator, nullptr, ioptions.info_log,
@@ -588,7 +588,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level, outputs of subcompactions cover disjoint key ranges and have the same
+    // sequence number range, so they are treated as a single sorted run by the compaction picker.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
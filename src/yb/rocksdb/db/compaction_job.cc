@@ -52,6 +52,7 @@
 #include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/db/memtable_list.h"
 #include "yb/rocksdb/db/merge_helper.h"
+#include "yb/rocksdb/db/table_cache.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
@@ -62,6 +63,7 @@
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
@@ -357,6 +359,9 @@ void CompactionJob::GenSubcompactionBoundaries() {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
         }
+        // Files usually cover the whole key range in universal compaction with single level, so
+        // their boundaries do not help to split it. Use index keys as additional anchors.
+        AddKeyAnchors(*flevel, &bounds);
       } else {
         // For all other levels add the smallest/largest key in the level to
         // encompass the range covered by that level
@@ -429,7 +434,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        auto boundary = ExtractUserKey(ranges[i].range.limit);
+        if (db_options_.subcompaction_key_prefix_size) {
+          // Keys with the same prefix should be processed by the same subcompaction, so use
+          // the prefix as boundary. All keys with this prefix go to the next subcompaction.
+          boundary = boundary.Prefix((*db_options_.subcompaction_key_prefix_size)(boundary));
+          if (boundary.empty() ||
+              (!boundaries_.empty() && cfd_comparator->Compare(boundaries_.back(), boundary) >= 0)) {
+            continue;
+          }
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -440,6 +455,78 @@ void CompactionJob::GenSubcompactionBoundaries() {
     // Only one range so its size is the total sum of sizes computed above
     sizes_.emplace_back(sum);
   }
+  TEST_SYNC_POINT_CALLBACK("CompactionJob::GenSubcompactionBoundaries:End", &boundaries_);
+}
+
+Result<std::vector<std::string>> CompactionJob::GetKeyAnchors(
+    const ColumnFamilyData& cfd, const FileDescriptor& fd, size_t max_anchors) {
+  auto trwh = VERIFY_RESULT(cfd.table_cache()->GetTableReader(
+      env_options_, cfd.internal_comparator(), fd, kDefaultQueryId, /* no_io = */ false,
+      /* file_read_hist = */ nullptr, /* skip_filters = */ true));
+  auto anchors = VERIFY_RESULT(trwh.table_reader->GetKeyAnchors(max_anchors));
+
+  // Anchors are index separators, which are shortened by FindShortestSeparator and are not
+  // necessarily keys present in the file. Such keys could not be used by
+  // subcompaction_key_prefix_size, so replace each anchor with the first data key at or after it.
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  std::unique_ptr<InternalIterator> iter(trwh.table_reader->NewIterator(
+      read_options, /* arena = */ nullptr, /* skip_filters = */ true));
+  std::vector<std::string> result;
+  result.reserve(anchors.size());
+  for (const auto& anchor : anchors) {
+    if (anchor.size() < kLastInternalComponentSize) {
+      continue;
+    }
+    const auto& entry = iter->Seek(anchor);
+    if (!entry.Valid()) {
+      break;
+    }
+    if (result.empty() || entry.key.compare(result.back()) != 0) {
+      result.push_back(entry.key.ToBuffer());
+    }
+  }
+  RETURN_NOT_OK(iter->status());
+  return result;
+}
+
+void CompactionJob::AddKeyAnchors(const LevelFilesBrief& files, std::vector<Slice>* bounds) {
+  // Number of anchors per subcompaction, so the ranges could be grouped into subcompactions of
+  // roughly the same size.
+  constexpr uint64_t kAnchorsPerSubcompaction = 8;
+
+  auto* cfd = compact_->compaction->column_family_data();
+  uint64_t total_size = 0;
+  for (size_t i = 0; i != files.num_files; ++i) {
+    total_size += files.files[i].fd.GetTotalFileSize();
+  }
+  if (total_size == 0) {
+    return;
+  }
+  const uint64_t total_anchors = kAnchorsPerSubcompaction * db_options_.max_subcompactions;
+  for (size_t i = 0; i != files.num_files; ++i) {
+    const auto& fd = files.files[i].fd;
+    // Distribute anchors proportionally to the file size, small files do not need them.
+    const auto max_anchors = total_anchors * fd.GetTotalFileSize() / total_size;
+    if (max_anchors == 0) {
+      continue;
+    }
+    auto anchors = GetKeyAnchors(*cfd, fd, max_anchors);
+    if (!anchors.ok()) {
+      // Anchors are just an optimization, so proceed with file boundaries only.
+      RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+          "[%s] [JOB %d] Failed to get key anchors for file %" PRIu64 ": %s",
+          cfd->GetName().c_str(), job_id_, fd.GetNumber(), anchors.status().ToString().c_str());
+      continue;
+    }
+    for (auto& anchor : *anchors) {
+      if (anchor.size() < kLastInternalComponentSize) {
+        continue;
+      }
+      key_anchors_.push_back(std::move(anchor));
+      bounds->emplace_back(key_anchors_.back());
+    }
+  }
 }
 
 Result<FileNumbersHolder> CompactionJob::Run() {
@@ -637,6 +724,7 @@ void CompactionJob::ProcessKeyValueCompaction(
     auto context = CompactionContextOptions {
       .level0_inputs = *compact_->compaction->inputs(0),
       .boundary_extractor = sub_compact->boundary_extractor,
+      .statistics = stats_,
     };
     sub_compact->context = (*db_options_.compaction_context_factory)(sub_compact, context);
     sub_compact->feed = sub_compact->context->Feed();
@@ -715,7 +803,11 @@ void CompactionJob::ProcessKeyValueCompaction(
   // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
   // filter.
   if (sub_compact->context) {
-    largest_user_frontier_ = sub_compact->context->GetLargestUserFrontier();
+    auto frontier = sub_compact->context->GetLargestUserFrontier();
+    // Subcompactions are running concurrently, so merge their frontiers.
+    std::lock_guard<std::mutex> lock(largest_user_frontier_mutex_);
+    UpdateUserFrontier(
+        &largest_user_frontier_, std::move(frontier), UpdateUserValueType::kLargest);
   }
 
   sub_compact->num_input_records = c_iter_stats.num_input_records;
@@ -28,6 +28,7 @@
 #include <deque>
 #include <functional>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -103,6 +104,10 @@ class CompactionJob {
 
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
+  // Adds keys from SST indexes of the specified files to the potential subcompaction boundaries.
+  void AddKeyAnchors(const LevelFilesBrief& files, std::vector<Slice>* bounds);
+  Result<std::vector<std::string>> GetKeyAnchors(
+      const ColumnFamilyData& cfd, const FileDescriptor& fd, size_t max_anchors);
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -178,7 +183,11 @@ class CompactionJob {
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
+  // Stores the keys read from SST indexes, that are used as potential subcompaction boundaries.
+  // Deque is used, since boundaries_ refer to the keys stored here.
+  std::deque<std::string> key_anchors_;
 
+  std::mutex largest_user_frontier_mutex_;
   UserFrontierPtr largest_user_frontier_;
 };
 
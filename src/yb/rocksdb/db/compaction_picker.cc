@@ -29,6 +29,7 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <limits>
 #include <queue>
 #include <string>
@@ -163,6 +164,17 @@ CompactionPicker::CompactionPicker(const ImmutableCFOptions& ioptions,
 
 CompactionPicker::~CompactionPicker() {}
 
+size_t CompactionPicker::NumCompactableSortedRuns(
+    const MutableCFOptions& mutable_cf_options, const VersionStorageInfo& vstorage) const {
+  size_t result = vstorage.LevelFiles(0).size();
+  for (int level = 1; level < vstorage.num_levels(); ++level) {
+    if (!vstorage.LevelFiles(level).empty()) {
+      ++result;
+    }
+  }
+  return result;
+}
+
 // Delete this compaction from the list of running compactions.
 void CompactionPicker::ReleaseCompactionFiles(Compaction* c, Status status) {
   if (c->start_level() == 0 ||
@@ -1191,13 +1203,24 @@ struct UniversalCompactionPicker::SortedRun {
   SortedRun(int _level, FileMetaData* _file, uint64_t _size,
             uint64_t _compensated_file_size, bool _being_compacted)
       : level(_level),
-        file(_file),
         size(_size),
         compensated_file_size(_compensated_file_size),
         being_compacted(_being_compacted) {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
-    assert((level != 0) != (file != nullptr));
+    assert((level != 0) != (_file != nullptr));
+    if (_file) {
+      files.push_back(_file);
+    }
+  }
+
+  // Adds level 0 file produced by the same compaction as files of this sorted run.
+  void AddFile(FileMetaData* file) {
+    assert(level == 0);
+    files.push_back(file);
+    size += file->fd.GetTotalFileSize();
+    compensated_file_size += file->compensated_file_size;
+    being_compacted = being_compacted || file->being_compacted;
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1214,13 +1237,16 @@ struct UniversalCompactionPicker::SortedRun {
   }
 
   bool delete_after_compaction() const {
-    return file ? file->delete_after_compaction() : false;
+    return !files.empty() && std::all_of(files.begin(), files.end(), [](FileMetaData* file) {
+      return file->delete_after_compaction();
+    });
   }
 
   int level;
-  // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
-  FileMetaData* file;
+  // `files` will be empty for level > 0. For level = 0, the sorted run is for these files.
+  // There are several files only when they are outputs of the same compaction, see
+  // FileMetaData::IsSameCompactionOutput.
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1233,14 +1259,20 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
                                                 size_t out_buf_size,
                                                 bool print_path) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
+    const auto* file = files.front();
+    int written;
     if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+      written = snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
     } else {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64
-                                      "(path "
-                                      "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+      written = snprintf(out_buf, out_buf_size, "file %" PRIu64
+                                                "(path "
+                                                "%" PRIu32 ")",
+                         file->fd.GetNumber(), file->fd.GetPathId());
+    }
+    if (files.size() > 1 && written >= 0 && static_cast<size_t>(written) < out_buf_size) {
+      snprintf(out_buf + written, out_buf_size - written, " +%" ROCKSDB_PRIszt " files",
+               files.size() - 1);
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -1250,13 +1282,13 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
 void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     char* out_buf, size_t out_buf_size, size_t sorted_run_count) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
     snprintf(out_buf, out_buf_size,
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
-             "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             "of %" ROCKSDB_PRIszt " files with size %" PRIu64 " (compensated size %" PRIu64 ")",
+             files.front()->fd.GetNumber(), sorted_run_count, files.size(), size,
+             compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1266,6 +1298,26 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
   }
 }
 
+size_t UniversalCompactionPicker::NumCompactableSortedRuns(
+    const MutableCFOptions& mutable_cf_options, const VersionStorageInfo& vstorage) const {
+  size_t result = 0;
+  for (const auto& sequence : CalculateSortedRuns(
+           vstorage, ioptions_, mutable_cf_options.MaxFileSizeForCompaction())) {
+    result = std::max(result, sequence.size());
+  }
+  return result;
+}
+
+uint64_t UniversalCompactionPicker::FileTimeWindow(
+    const FileMetaData& file, uint64_t time_window_micros) {
+  if (!file.largest.user_frontier) {
+    return 0;
+  }
+  auto time = file.largest.user_frontier->PhysicalTimeMicros();
+  // Windows are numbered starting from 1, so 0 could be used for unknown window.
+  return time ? time / time_window_micros + 1 : 0;
+}
+
 std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
     UniversalCompactionPicker::CalculateSortedRuns(const VersionStorageInfo& vstorage,
                                                    const ImmutableCFOptions& ioptions,
@@ -1273,16 +1325,56 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
   std::vector<std::vector<SortedRun>> ret(1);
   MarkL0FilesForDeletion(&vstorage, &ioptions);
 
+  // Outputs of the same compaction (e.g. produced by subcompactions) are disjoint, so they form
+  // a single sorted run. When max file size for compaction is limited, files are picked
+  // individually, so they are not grouped.
+  const bool group_compaction_outputs = max_file_size == std::numeric_limits<uint64_t>::max();
+  const auto time_window_micros = ioptions.compaction_options_universal.time_window_micros;
+  // Windows older than max_time_windows newest ones are merged into the oldest of them, so the
+  // number of sorted runs that are never compacted together stays bounded.
+  uint64_t min_time_window = 0;
+  const auto max_time_windows = ioptions.compaction_options_universal.max_time_windows;
+  if (time_window_micros && max_time_windows) {
+    uint64_t max_time_window = 0;
+    for (FileMetaData* f : vstorage.LevelFiles(0)) {
+      max_time_window = std::max(max_time_window, FileTimeWindow(*f, time_window_micros));
+    }
+    if (max_time_window > max_time_windows) {
+      min_time_window = max_time_window - max_time_windows + 1;
+    }
+  }
+  // Time window of the last file added to the current sequence, 0 if not known.
+  uint64_t sequence_time_window = 0;
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
     // Any files that can be directly removed during compaction can be included, even if they
     // exceed the "max file size for compaction."
     if (f->fd.GetTotalFileSize() <= max_file_size || f->delete_after_compaction()) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
+      if (time_window_micros) {
+        // Files from different time windows are placed to different sequences, so they are never
+        // compacted together.
+        auto time_window = FileTimeWindow(*f, time_window_micros);
+        if (time_window) {
+          time_window = std::max(time_window, min_time_window);
+          if (sequence_time_window && time_window != sequence_time_window &&
+              !ret.back().empty()) {
+            ret.emplace_back();
+          }
+          sequence_time_window = time_window;
+        }
+      }
+      auto& sequence = ret.back();
+      if (group_compaction_outputs && !sequence.empty() && sequence.back().level == 0 &&
+          sequence.back().files.back()->IsSameCompactionOutput(*f, *ioptions.comparator)) {
+        sequence.back().AddFile(f);
+        continue;
+      }
+      sequence.emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
       ret.emplace_back();
+      sequence_time_window = 0;
     }
   }
 
@@ -1526,14 +1618,16 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::DoPickCompaction(
 
   size_t level_index = 0U;
   if (c->start_level() == 0) {
+    const FileMetaData* prev_file = nullptr;
     for (auto f : *c->inputs(0)) {
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
-      } else {
+      } else if (!prev_file->IsSameCompactionOutput(*f, *ioptions_.comparator)) {
         DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
       }
       prev_smallest_seqno = f->smallest.seqno;
+      prev_file = f;
     }
     level_index = 1U;
   }
@@ -1761,8 +1855,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalRe
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1814,8 +1908,7 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalDe
     const auto sr = &sorted_runs[loop];
 
     if (!sr->being_compacted && sr->delete_after_compaction()) {
-      FileMetaData* f = sr->file;
-      input_files.files.push_back(f);
+      input_files.files.insert(input_files.files.end(), sr->files.begin(), sr->files.end());
 
       char file_num_buf[kFormatFileSizeInfoBufSize];
       sr->DumpSizeInfo(file_num_buf, sizeof(file_num_buf), loop);
@@ -1952,8 +2045,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalSi
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
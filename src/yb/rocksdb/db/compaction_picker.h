@@ -85,6 +85,11 @@ class CompactionPicker {
 
   virtual bool NeedsCompaction(const VersionStorageInfo* vstorage) const = 0;
 
+  // Returns the largest number of sorted runs that could be compacted together, i.e. the part of
+  // read amplification that compactions are able to reduce.
+  virtual size_t NumCompactableSortedRuns(
+      const MutableCFOptions& mutable_cf_options, const VersionStorageInfo& vstorage) const;
+
   // Sanitize the input set of compaction input files.
   // When the input parameters do not describe a valid compaction, the
   // function will try to fix the input_files by adding necessary
@@ -257,6 +262,12 @@ class UniversalCompactionPicker : public CompactionPicker {
   virtual bool NeedsCompaction(const VersionStorageInfo* vstorage) const
       override;
 
+  // Files too large to compact and files from different time windows are never compacted
+  // together, so the largest sequence of sorted runs is used, see CalculateSortedRuns.
+  size_t NumCompactableSortedRuns(
+      const MutableCFOptions& mutable_cf_options,
+      const VersionStorageInfo& vstorage) const override;
+
  private:
   struct SortedRun;
 
@@ -292,11 +303,15 @@ class UniversalCompactionPicker : public CompactionPicker {
   // compacted.
   // One sequence is std::vector<SortedRun>.
   // Several sequences are std::vector<std::vector<SortedRun>>.
+  // When time windows are enabled, sequences are also split at time window boundaries.
   static std::vector<std::vector<SortedRun>> CalculateSortedRuns(
       const VersionStorageInfo& vstorage,
       const ImmutableCFOptions& ioptions,
       uint64_t max_file_size);
 
+  // Returns time window of the file, 0 if file does not have physical time.
+  static uint64_t FileTimeWindow(const FileMetaData& file, uint64_t time_window_micros);
+
   // Pick a path ID to place a newly generated file, with its estimated file
   // size.
   static uint32_t GetPathId(const ImmutableCFOptions& ioptions,
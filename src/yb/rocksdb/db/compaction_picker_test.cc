@@ -480,6 +480,169 @@ TEST_F(CompactionPickerTest, CompactionUniversalPickForFilesBeingCompacted) {
   ASSERT_EQ(compaction->inputs(0)->size(), 2);
 }
 
+// Tests that outputs of the same compaction (i.e. subcompactions) are treated as a single sorted
+// run, and are always picked together.
+TEST_F(CompactionPickerTest, UniversalSameCompactionOutputsFormSingleSortedRun) {
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  ioptions_.compaction_style = kCompactionStyleUniversal;
+  ioptions_.num_levels = 1;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  // Files 1, 2 and 3 are produced by the same compaction: same seqno range and disjoint keys.
+  Add(0, 4U, "100", "400", 1_MB, 0, 400, 499);
+  Add(0, 3U, "300", "399", 1_MB, 0, 100, 399);
+  Add(0, 2U, "200", "299", 1_MB, 0, 100, 399);
+  Add(0, 1U, "100", "199", 1_MB, 0, 100, 399);
+  UpdateVersionStorageInfo();
+
+  // Only 2 sorted runs, so compaction is not required.
+  ASSERT_DOUBLE_EQ(vstorage_->CompactionScore(0), 2.0 / 3);
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 6U, "100", "400", 1_MB, 0, 600, 699);
+  Add(0, 5U, "100", "400", 1_MB, 0, 500, 599);
+  Add(0, 4U, "100", "400", 1_MB, 0, 400, 499);
+  Add(0, 3U, "300", "399", 1_MB, 0, 100, 399);
+  Add(0, 2U, "200", "299", 1_MB, 0, 100, 399);
+  Add(0, 1U, "100", "199", 1_MB, 0, 100, 399);
+  UpdateVersionStorageInfo();
+
+  ASSERT_DOUBLE_EQ(vstorage_->CompactionScore(0), 4.0 / 3);
+  auto compaction = universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_);
+  ASSERT_NE(compaction, nullptr);
+  // Sorted runs 6, 5 and 4 have the total size of 3MB, so the group of files 1-3 with the same
+  // total size is included as a whole.
+  ASSERT_EQ(compaction->inputs(0)->size(), 6);
+}
+
+// Tests that files from different time windows are not compacted together.
+TEST_F(CompactionPickerTest, UniversalTimeWindows) {
+  ioptions_.compaction_style = kCompactionStyleUniversal;
+  ioptions_.num_levels = 1;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+
+  auto add_files = [this] {
+    NewVersionStorage(1, kCompactionStyleUniversal);
+    // Files 5, 4 and 3 belong to the window [1000, 2000), files 2 and 1 to [0, 1000).
+    for (uint32_t i = 5; i != 0; --i) {
+      Add(0, i, "100", "200", 1_MB, 0, i * 100, i * 100 + 99);
+      file_map_.at(i).first->largest.user_frontier =
+          test::TestUserFrontier(i * 300 + 100).Clone();
+    }
+    UpdateVersionStorageInfo();
+  };
+
+  add_files();
+  {
+    // All sorted runs have the same size, so all of them are picked without time windows.
+    UniversalCompactionPicker picker(ioptions_, icmp_.get());
+    auto compaction = picker.PickCompaction(
+        cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_);
+    ASSERT_NE(compaction, nullptr);
+    ASSERT_EQ(compaction->inputs(0)->size(), 5);
+  }
+
+  ioptions_.compaction_options_universal.time_window_micros = 1000;
+  add_files();
+  {
+    UniversalCompactionPicker picker(ioptions_, icmp_.get());
+    auto compaction = picker.PickCompaction(
+        cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_);
+    ASSERT_NE(compaction, nullptr);
+    ASSERT_EQ(compaction->inputs(0)->size(), 3);
+    for (auto* file : *compaction->inputs(0)) {
+      ASSERT_GE(file->fd.GetNumber(), 3U);
+    }
+
+    // The old window has fewer sorted runs than the trigger, so it is not compacted.
+    ASSERT_EQ(picker.PickCompaction(
+        cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_), nullptr);
+  }
+}
+
+// Tests that windows older than max_time_windows are compacted together, so the number of files
+// does not grow with the number of windows.
+TEST_F(CompactionPickerTest, UniversalMaxTimeWindows) {
+  constexpr uint32_t kNumFiles = 8;
+  ioptions_.compaction_style = kCompactionStyleUniversal;
+  ioptions_.num_levels = 1;
+  ioptions_.compaction_options_universal.time_window_micros = 1000;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+
+  auto add_files = [this] {
+    NewVersionStorage(1, kCompactionStyleUniversal);
+    // Each file belongs to its own window, so there are more windows than the trigger.
+    for (uint32_t i = kNumFiles; i != 0; --i) {
+      Add(0, i, "100", "200", 1_MB, 0, i * 100, i * 100 + 99);
+      file_map_.at(i).first->largest.user_frontier =
+          test::TestUserFrontier(i * 1000 + 500).Clone();
+    }
+    UpdateVersionStorageInfo();
+  };
+
+  add_files();
+  {
+    // Without the limit each window has a single sorted run, so nothing is compacted.
+    UniversalCompactionPicker picker(ioptions_, icmp_.get());
+    ASSERT_EQ(picker.PickCompaction(
+        cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_), nullptr);
+  }
+
+  ioptions_.compaction_options_universal.max_time_windows = 2;
+  add_files();
+  {
+    UniversalCompactionPicker picker(ioptions_, icmp_.get());
+    auto compaction = picker.PickCompaction(
+        cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_);
+    ASSERT_NE(compaction, nullptr);
+    // The newest window stays apart, all older windows are compacted together.
+    ASSERT_EQ(compaction->inputs(0)->size(), kNumFiles - 1);
+    for (auto* file : *compaction->inputs(0)) {
+      ASSERT_LT(file->fd.GetNumber(), kNumFiles);
+    }
+  }
+}
+
+// Tests that files which are never compacted together are not counted as compactable sorted runs.
+TEST_F(CompactionPickerTest, UniversalNumCompactableSortedRuns) {
+  ioptions_.compaction_style = kCompactionStyleUniversal;
+  ioptions_.num_levels = 1;
+  UniversalCompactionPicker picker(ioptions_, icmp_.get());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 7U, "100", "400", 1_MB, 0, 700, 799);
+  Add(0, 6U, "100", "400", 1_MB, 0, 600, 699);
+  Add(0, 5U, "100", "400", 100_MB, 0, 500, 599);
+  Add(0, 4U, "100", "400", 1_MB, 0, 400, 499);
+  // Files 1, 2 and 3 are produced by the same compaction.
+  Add(0, 3U, "300", "399", 1_MB, 0, 100, 399);
+  Add(0, 2U, "200", "299", 1_MB, 0, 100, 399);
+  Add(0, 1U, "100", "199", 1_MB, 0, 100, 399);
+  UpdateVersionStorageInfo();
+  ASSERT_EQ(picker.NumCompactableSortedRuns(mutable_cf_options_, *vstorage_), 5U);
+
+  // File 5 is too large to compact, so files 7 and 6 are never compacted with older files.
+  // Files are picked individually in this case, so outputs of the same compaction are not grouped.
+  mutable_cf_options_.max_file_size_for_compaction =
+      std::make_shared<std::function<uint64_t()>>([] { return 10_MB; });
+  ASSERT_EQ(picker.NumCompactableSortedRuns(mutable_cf_options_, *vstorage_), 4U);
+  mutable_cf_options_.max_file_size_for_compaction = nullptr;
+
+  // Files 5, 4 and 3 belong to the window [1000, 2000), files 2 and 1 to [0, 1000).
+  ioptions_.compaction_options_universal.time_window_micros = 1000;
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  for (uint32_t i = 5; i != 0; --i) {
+    Add(0, i, "100", "200", 1_MB, 0, i * 100, i * 100 + 99);
+    file_map_.at(i).first->largest.user_frontier =
+        test::TestUserFrontier(i * 300 + 100).Clone();
+  }
+  UpdateVersionStorageInfo();
+  ASSERT_EQ(picker.NumCompactableSortedRuns(mutable_cf_options_, *vstorage_), 3U);
+}
+
 // Tests if the files can be trivially moved in multi level
 // universal compaction when allow_trivial_move option is set
 // In this test as the input files overlaps, they cannot
@@ -177,6 +177,58 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   ANNOTATE_UNPROTECTED_WRITE(FLAGS_cache_overflow_single_touch) = true;
 }
 
+TEST_F(DBBlockCacheTest, TestPrefetchKeys) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  InitTable(options);
+  ASSERT_OK(Flush());
+
+  std::shared_ptr<Cache> cache = NewLRUCache(8 * 1024 * 1024);
+  table_options.block_cache = cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  RecordCacheCounters(options);
+
+  const std::vector<Slice> keys = {"5", "1", "3"};
+  ASSERT_OK(db_->PrefetchKeys(ReadOptions(), keys));
+  CheckCacheCounters(options, 0, 0, keys.size(), 0);
+
+  // Prefetched blocks are found in cache.
+  for (const auto& key : keys) {
+    ASSERT_EQ(std::string(kValueSize, 'a'), Get(key.ToBuffer()));
+    CheckCacheCounters(options, 0, 1, 0, 0);
+  }
+
+  // Blocks that are already in cache are not read again.
+  ASSERT_OK(db_->PrefetchKeys(ReadOptions(), {"1", "7"}));
+  CheckCacheCounters(options, 0, 0, 1, 0);
+}
+
+// Key that is a strict prefix of the smallest key of the file, should prefetch the first block of
+// the file.
+TEST_F(DBBlockCacheTest, TestPrefetchPrefixKey) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  std::string value(kValueSize, 'a');
+  for (const auto* key : {"k10", "k11", "k12"}) {
+    ASSERT_OK(Put(key, value));
+  }
+  ASSERT_OK(Flush());
+
+  std::shared_ptr<Cache> cache = NewLRUCache(8 * 1024 * 1024);
+  table_options.block_cache = cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  RecordCacheCounters(options);
+
+  // "k0" precedes the file and is not its prefix, so nothing is prefetched for it.
+  ASSERT_OK(db_->PrefetchKeys(ReadOptions(), {"k0", "k1"}));
+  CheckCacheCounters(options, 0, 0, 1, 0);
+
+  ASSERT_EQ(value, Get("k10"));
+  CheckCacheCounters(options, 0, 1, 0, 0);
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
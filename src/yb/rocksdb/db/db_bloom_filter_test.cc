@@ -38,6 +38,10 @@ class DBBloomFilterTest : public DBTestBase {
   void CheckOtherFilterPoliciesSupport(
       Options* options, const int num_unique_keys, FilterPolicyCreator write_policy_creator,
       FilterPolicyCreator new_policy_creator, bool should_be_useful);
+
+  // Checks that fixed-size bloom filter is used for point lookups, with filter index either
+  // preloaded by table reader or loaded through the block cache.
+  void TestBloomFilterIndex(bool cache_filter_index);
 };
 
 // KeyMayExist can lead to a few false positives, but not false negatives.
@@ -422,7 +426,7 @@ size_t BloomFilterUsefulLowerBound(const size_t num_unique_keys, const size_t nu
 
 } // namespace
 
-TEST_F(DBBloomFilterTest, BloomFilterIndex) {
+void DBBloomFilterTest::TestBloomFilterIndex(bool cache_filter_index) {
   do {
     Options options = CurrentOptions();
     options.statistics = rocksdb::CreateDBStatisticsForTests();
@@ -437,6 +441,7 @@ TEST_F(DBBloomFilterTest, BloomFilterIndex) {
     table_options.no_block_cache =
         table_options.filter_policy->GetFilterType() != FilterPolicy::kFixedSizeFilter;
     table_options.cache_index_and_filter_blocks = true;
+    table_options.cache_filter_index = cache_filter_index;
     options.table_factory.reset(NewBlockBasedTableFactory(table_options));
 
     CreateAndReopenWithCF({"pikachu"}, options);
@@ -483,11 +488,39 @@ TEST_F(DBBloomFilterTest, BloomFilterIndex) {
         TestGetTickerCount(options, BLOOM_FILTER_USEFUL),
         BloomFilterUsefulLowerBound(2 * (key_begin + 1)));
 
+    if (cache_filter_index && !table_options.no_block_cache) {
+      // Filter index of each SST file should be loaded once and then taken from the block cache.
+      ASSERT_GT(TestGetTickerCount(options, BLOCK_CACHE_FILTER_HIT), 0);
+
+      // Query that does not use the block cache loads filter index for each lookup, it is released
+      // by the lookup, since it is not owned by the block cache.
+      ReadOptions no_cache_options;
+      no_cache_options.query_id = kNoCacheQueryId;
+      for (int i = key_begin - 10; i < key_begin + 10; i++) {
+        std::string value;
+        auto status = db_->Get(no_cache_options, handles_[1], Key(i), &value);
+        if (i < key_begin) {
+          ASSERT_TRUE(status.IsNotFound()) << status;
+        } else {
+          ASSERT_OK(status);
+          ASSERT_EQ(Key(i), value);
+        }
+      }
+    }
+
     env_->delay_sstable_sync_.store(false, std::memory_order_release);
     Close();
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBloomFilterTest, BloomFilterIndex) {
+  TestBloomFilterIndex(/* cache_filter_index= */ false);
+}
+
+TEST_F(DBBloomFilterTest, CachedBloomFilterIndex) {
+  TestBloomFilterIndex(/* cache_filter_index= */ true);
+}
+
 TEST_F(DBBloomFilterTest, BloomFilterRate) {
   while (ChangeFilterOptions()) {
     Options options = CurrentOptions();
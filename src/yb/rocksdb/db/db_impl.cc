@@ -2059,6 +2059,13 @@ uint64_t DBImpl::GetCurrentVersionNumSSTFiles() {
   return default_cf_handle_->cfd()->current()->storage_info()->NumFiles();
 }
 
+uint64_t DBImpl::GetCurrentVersionNumCompactableSortedRuns() {
+  InstrumentedMutexLock lock(&mutex_);
+  auto* cfd = default_cf_handle_->cfd();
+  return cfd->compaction_picker()->NumCompactableSortedRuns(
+      *cfd->GetLatestMutableCFOptions(), *cfd->current()->storage_info());
+}
+
 void DBImpl::SetSSTFileTickers() {
   if (stats_) {
     auto sst_files_size = GetCurrentVersionSstFilesSize();
@@ -3969,14 +3976,39 @@ InternalIterator* DBImpl::NewInternalIterator(const ReadOptions& read_options,
   assert(arena != nullptr);
   // Need to create internal iterator from the arena.
   MergeIteratorBuilder merge_iter_builder(cfd->internal_comparator().get(), arena);
-  // Collect iterator for mutable mem
-  merge_iter_builder.AddIterator(
-      super_version->mem->NewIterator(read_options, arena));
-  // Collect all needed child iterators for immutable memtables
-  super_version->imm->AddIterators(read_options, &merge_iter_builder);
-  // Collect iterators for files in L0 - Ln
-  super_version->current->AddIterators(read_options, env_options_,
-                                       &merge_iter_builder);
+  if (read_options.isolated_file_filter) {
+    // Files could be excluded by isolated_file_filter only when their key ranges do not overlap
+    // key ranges of memtables.
+    std::vector<InternalIterator*> mem_iters;
+    mem_iters.push_back(super_version->mem->NewIterator(read_options, arena));
+    super_version->imm->AddIterators(read_options, &mem_iters, arena);
+    std::vector<UserKeyRange> memtable_ranges;
+    for (auto* mem_iter : mem_iters) {
+      const auto& first = mem_iter->SeekToFirst();
+      if (first) {
+        auto smallest = ExtractUserKey(first.key).ToBuffer();
+        const auto& last = mem_iter->SeekToLast();
+        if (last) {
+          memtable_ranges.push_back(UserKeyRange {
+            .smallest = std::move(smallest),
+            .largest = ExtractUserKey(last.key).ToBuffer(),
+          });
+        }
+      }
+      merge_iter_builder.AddIterator(mem_iter);
+    }
+    super_version->current->AddIterators(
+        read_options, env_options_, &merge_iter_builder, &memtable_ranges);
+  } else {
+    // Collect iterator for mutable mem
+    merge_iter_builder.AddIterator(
+        super_version->mem->NewIterator(read_options, arena));
+    // Collect all needed child iterators for immutable memtables
+    super_version->imm->AddIterators(read_options, &merge_iter_builder);
+    // Collect iterators for files in L0 - Ln
+    super_version->current->AddIterators(read_options, env_options_,
+                                         &merge_iter_builder);
+  }
   internal_iter = merge_iter_builder.Finish();
   IterState* cleanup = new IterState(this, &mutex_, super_version);
   internal_iter->RegisterCleanup(CleanupIteratorState, cleanup, nullptr);
@@ -3994,6 +4026,17 @@ Status DBImpl::Get(const ReadOptions& read_options,
   return GetImpl(read_options, column_family, key, value);
 }
 
+Status DBImpl::PrefetchKeys(const ReadOptions& read_options, const std::vector<Slice>& keys) {
+  if (keys.empty()) {
+    return Status::OK();
+  }
+  auto cfd = down_cast<ColumnFamilyHandleImpl*>(DefaultColumnFamily())->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  auto status = sv->current->PrefetchKeys(read_options, keys);
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  return status;
+}
+
 // JobContext gets created and destructed outside of the lock --
 // we
 // use this convinently to:
@@ -4377,12 +4420,16 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
   if (!meta.smallest.key.Valid() || !meta.largest.key.Valid()) {
     return STATUS(Corruption, "Generated table have corrupted keys");
   }
-  meta.smallest.seqno = file_info->sequence_number;
-  meta.largest.seqno = file_info->sequence_number;
-  if (meta.smallest.seqno != 0 || meta.largest.seqno != 0) {
+  if (file_info->sequence_number != 0) {
     return STATUS(InvalidArgument,
         "Non zero sequence numbers are not supported");
   }
+  meta.smallest.seqno = file_info->sequence_number;
+  meta.largest.seqno = file_info->sequence_number;
+  if (file_info->user_frontiers) {
+    meta.smallest.user_frontier = file_info->user_frontiers->Smallest().Clone();
+    meta.largest.user_frontier = file_info->user_frontiers->Largest().Clone();
+  }
 
   std::string db_base_fname;
   std::string db_data_fname;
@@ -4412,6 +4459,7 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
       return status;
     }
 
+    WriteContext context;
     {
       InstrumentedMutexLock l(&mutex_);
       const MutableCFOptions mutable_cf_options =
@@ -4419,6 +4467,7 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
 
       WriteThread::Writer w;
       write_thread_.EnterUnbatched(&w, &mutex_);
+      bool memtable_switched = false;
 
       if (!snapshots_.empty()) {
         // Check that no snapshots are being held
@@ -4452,6 +4501,28 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
         }
       }
 
+      // Level 0 files are ordered by sequence numbers, so a file with sequence number 0 would be
+      // treated as the oldest sorted run. It is fine only while nothing else was written to the
+      // DB. Otherwise the file is assigned the next sequence number, so it is ordered as the newest
+      // sorted run. Keys inside the file keep sequence number 0, it is safe because they don't
+      // overlap any keys in the DB.
+      if (status.ok() && versions_->LastSequence() != 0) {
+        // The memtable is switched, so its entries, which are older than the file, are flushed to
+        // a file with smaller sequence numbers, and the file is not placed between entries of the
+        // same memtable.
+        if (!cfd->mem()->IsEmpty()) {
+          // SwitchMemtable() will release and reacquire mutex during execution.
+          status = SwitchMemtable(cfd, &context);
+          memtable_switched = true;
+        }
+        if (status.ok()) {
+          const auto seqno = versions_->LastSequence() + 1;
+          versions_->SetLastSequence(seqno);
+          meta.smallest.seqno = seqno;
+          meta.largest.seqno = seqno;
+        }
+      }
+
       if (status.ok()) {
         // Add file to L0
         VersionEdit edit;
@@ -4463,6 +4534,12 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
       }
       write_thread_.ExitUnbatched(&w);
 
+      if (memtable_switched) {
+        cfd->imm()->FlushRequested();
+        SchedulePendingFlush(cfd);
+        MaybeScheduleFlushOrCompaction();
+      }
+
       if (status.ok()) {
         InstallSuperVersionAndScheduleWork(cfd, nullptr, mutable_cf_options);
       }
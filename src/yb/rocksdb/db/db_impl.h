@@ -111,6 +111,8 @@ class DBImpl : public DB {
       const std::vector<Slice>& keys,
       std::vector<std::string>* values) override;
 
+  Status PrefetchKeys(const ReadOptions& options, const std::vector<Slice>& keys) override;
+
   virtual Status CreateColumnFamily(const ColumnFamilyOptions& options,
                                     const std::string& column_family,
                                     ColumnFamilyHandle** handle) override;
@@ -639,6 +641,8 @@ class DBImpl : public DB {
 
   uint64_t GetCurrentVersionNumSSTFiles() override;
 
+  uint64_t GetCurrentVersionNumCompactableSortedRuns() override;
+
   int GetCfdImmNumNotFlushed() override;
 
   // Updates stats_ object with SST files size metrics.
@@ -26,6 +26,7 @@
 
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
+#include "yb/rocksdb/table/table_reader.h"
 
 
 namespace rocksdb {
@@ -225,6 +226,66 @@ TEST_F(DBTablePropertiesTest, GetPropertiesOfTablesInRange) {
     TestGetPropertiesOfTablesInRange(std::move(ranges));
   }
 }
+
+namespace {
+
+// Excludes files with the specified number of entries.
+class NumEntriesFileFilter : public TableAwareReadFileFilter {
+ public:
+  explicit NumEntriesFileFilter(uint64_t num_entries) : num_entries_(num_entries) {}
+
+  bool Filter(TableReader* reader) const override {
+    return reader->GetTableProperties()->num_entries != num_entries_;
+  }
+
+ private:
+  const uint64_t num_entries_;
+};
+
+} // namespace
+
+TEST_F(DBTablePropertiesTest, IsolatedFileFilter) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  auto write_file = [this](std::initializer_list<const char*> keys) {
+    for (const auto* key : keys) {
+      ASSERT_OK(Put(key, "value"));
+    }
+    ASSERT_OK(Flush());
+  };
+
+  // Excluded file that does not overlap other files.
+  write_file({"a1", "a2"});
+  // Excluded file that overlaps not excluded file.
+  write_file({"b1", "b3"});
+  write_file({"b2", "b4", "b5"});
+  // Excluded file that overlaps memtable.
+  write_file({"c1", "c9"});
+  // Excluded files that overlap only each other.
+  write_file({"d1", "d3"});
+  write_file({"d2", "d4"});
+  ASSERT_OK(Put("c5", "value"));
+
+  auto read_keys = [this](std::shared_ptr<TableAwareReadFileFilter> filter) {
+    ReadOptions read_options;
+    read_options.isolated_file_filter = std::move(filter);
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    std::vector<std::string> result;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      result.push_back(iter->key().ToString());
+    }
+    EXPECT_OK(iter->status());
+    return result;
+  };
+
+  ASSERT_EQ(read_keys(nullptr).size(), 14);
+  ASSERT_EQ(
+      read_keys(std::make_shared<NumEntriesFileFilter>(2)),
+      (std::vector<std::string>{"b1", "b2", "b3", "b4", "b5", "c1", "c5", "c9"}));
+}
+
 }  // namespace rocksdb
 
 
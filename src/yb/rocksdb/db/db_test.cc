@@ -7433,6 +7433,86 @@ TEST_F(DBTest, AddExternalSstFile) {
                          kSkipFIFOCompaction));
 }
 
+// Files added to a non-empty DB should be ordered as the newest sorted run of level 0, including
+// after the DB was fully compacted and its files have sequence number 0.
+TEST_F(DBTest, AddExternalSstFileSequenceNumber) {
+  std::string sst_files_folder = test::TmpDir(env_) + "/sst_files/";
+  ASSERT_OK(env_->CreateDirIfMissing(sst_files_folder));
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  const ImmutableCFOptions ioptions(options);
+  SstFileWriter sst_file_writer(EnvOptions(), ioptions, options.comparator);
+
+  auto add_file = [&](int begin, int end) -> Status {
+    std::string file = sst_files_folder + "file" + ToString(begin) + ".sst";
+    RETURN_NOT_OK(sst_file_writer.Open(file));
+    for (int k = begin; k < end; k++) {
+      RETURN_NOT_OK(sst_file_writer.Add(Key(k), Key(k) + "_val"));
+    }
+    RETURN_NOT_OK(sst_file_writer.Finish());
+    return db_->AddFile(file, /* move_file= */ true);
+  };
+  auto put = [this](int begin, int end) -> Status {
+    for (int k = begin; k < end; k++) {
+      RETURN_NOT_OK(Put(Key(k), Key(k) + "_val"));
+    }
+    return Status::OK();
+  };
+  auto check_level0 = [this](size_t expected_num_files) {
+    ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(&cf_meta);
+    const auto& files = cf_meta.levels[0].files;
+    ASSERT_EQ(files.size(), expected_num_files);
+    for (size_t i = 1; i < files.size(); i++) {
+      ASSERT_GT(files[i - 1].smallest.seqno, files[i].largest.seqno) << i;
+    }
+  };
+  auto newest_file_seqno = [this] {
+    ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(&cf_meta);
+    return cf_meta.levels[0].files.front().largest.seqno;
+  };
+
+  ASSERT_OK(put(0, 100));
+  ASSERT_OK(Flush());
+  // Memtable is not empty, so it is flushed before the file is added.
+  ASSERT_OK(put(100, 150));
+  ASSERT_OK(add_file(200, 300));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_NO_FATAL_FAILURE(check_level0(3));
+  ASSERT_EQ(newest_file_seqno(), db_->GetLatestSequenceNumber());
+
+  // Full compaction is bottommost, so its output has sequence number 0.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_NO_FATAL_FAILURE(check_level0(1));
+  ASSERT_OK(add_file(300, 400));
+  ASSERT_NO_FATAL_FAILURE(check_level0(2));
+  ASSERT_EQ(newest_file_seqno(), db_->GetLatestSequenceNumber());
+  ASSERT_OK(put(400, 450));
+  ASSERT_OK(Flush());
+  ASSERT_NO_FATAL_FAILURE(check_level0(3));
+
+  // Let the universal compaction picker process the files.
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  for (int i = 0; i < 2; i++) {
+    for (int k = 0; k < 450; k++) {
+      if (k < 150 || k >= 200) {
+        ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+      } else {
+        ASSERT_EQ(Get(Key(k)), "NOT_FOUND");
+      }
+    }
+    Reopen(options);
+  }
+}
+
 // This test reporduce a bug that can happen in some cases if the DB started
 // purging obsolete files when we are adding an external sst file.
 // This situation may result in deleting the file while it's being added.
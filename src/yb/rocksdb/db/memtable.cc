@@ -41,8 +41,10 @@
 #include "yb/rocksdb/util/statistics.h"
 #include "yb/rocksdb/util/stop_watch.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/stats/perf_step_timer.h"
+#include "yb/util/threadpool.h"
 
 using std::ostringstream;
 
@@ -65,7 +67,12 @@ MemTableOptions::MemTableOptions(
     filter_deletes(mutable_cf_options.filter_deletes),
     statistics(ioptions.statistics),
     merge_operator(ioptions.merge_operator),
-    info_log(ioptions.info_log) {
+    info_log(ioptions.info_log),
+    insert_thread_pool(
+        ioptions.memtable_factory->IsInsertConcurrentlySupported()
+            ? ioptions.memtable_insert_thread_pool : nullptr),
+    insert_min_entries_per_thread(
+        std::max<size_t>(ioptions.memtable_insert_min_entries_per_thread, 1)) {
   if (ioptions.mem_tracker) {
     mem_tracker = yb::MemTracker::FindOrCreateTracker("MemTable", ioptions.mem_tracker);
   }
@@ -479,8 +486,10 @@ KeyHandle MemTable::PrepareAdd(SequenceNumber s, ValueType type,
 void MemTable::ApplyPreparedAdd(
     const KeyHandle* handle, size_t count, const PreparedAdd& prepared_add, bool allow_concurrent) {
   if (!allow_concurrent) {
-    for (const auto* end = handle + count; handle != end; ++handle) {
-      table_->Insert(*handle);
+    if (!InsertParallel(handle, count)) {
+      for (const auto* end = handle + count; handle != end; ++handle) {
+        table_->Insert(*handle);
+      }
     }
 
     // this is a bit ugly, but is the way to avoid locked instructions
@@ -538,6 +547,64 @@ void MemTable::ApplyPreparedAdd(
   UpdateFlushState();
 }
 
+namespace {
+
+// State of the parallel insert shared between the writing thread and the pool tasks.
+// Tasks could start after the insert is completed, so the state is reference counted, and the task
+// touches entries only after it has grabbed a range.
+struct ParallelInsertState {
+  ParallelInsertState(const KeyHandle* handle_, size_t count_, size_t num_ranges_)
+      : handle(handle_), count(count_), num_ranges(num_ranges_), latch(num_ranges_) {}
+
+  // Inserts ranges until none is left, returns after processing the last grabbed range.
+  void Run(MemTableRep* table) {
+    for (;;) {
+      auto range = next_range.fetch_add(1, std::memory_order_acq_rel);
+      if (range >= num_ranges) {
+        return;
+      }
+      const auto* end = handle + count * (range + 1) / num_ranges;
+      for (const auto* it = handle + count * range / num_ranges; it != end; ++it) {
+        table->InsertConcurrently(*it);
+      }
+      latch.CountDown();
+    }
+  }
+
+  const KeyHandle* const handle;
+  const size_t count;
+  const size_t num_ranges;
+  std::atomic<size_t> next_range{0};
+  yb::CountDownLatch latch;
+};
+
+} // namespace
+
+bool MemTable::InsertParallel(const KeyHandle* handle, size_t count) {
+  auto* pool = moptions_.insert_thread_pool;
+  if (!pool) {
+    return false;
+  }
+  const size_t num_ranges = count / moptions_.insert_min_entries_per_thread;
+  if (num_ranges < 2) {
+    return false;
+  }
+
+  auto state = std::make_shared<ParallelInsertState>(handle, count, num_ranges);
+  auto* table = table_.get();
+  // The writing thread inserts one of the ranges, so at most num_ranges - 1 tasks are useful.
+  for (size_t i = 1; i != num_ranges; ++i) {
+    // Failure to submit is not an error, remaining ranges are inserted by the writing thread.
+    if (!pool->SubmitFunc([state, table] { state->Run(table); }).ok()) {
+      break;
+    }
+  }
+  state->Run(table);
+  // Wait for ranges that were grabbed by the pool threads.
+  state->latch.Wait();
+  return true;
+}
+
 // This comparator is used for deciding whether to erase a found key from a memtable instead of
 // writing a deletion mark. This is exactly what we need for erasing records in memory
 // (without writing new deletion marks). It expects a special key consisting of the user key being
@@ -46,6 +46,7 @@
 namespace yb {
 
 class MemTracker;
+class ThreadPool;
 
 }
 
@@ -78,6 +79,9 @@ struct MemTableOptions {
   MergeOperator* merge_operator;
   Logger* info_log;
   std::shared_ptr<yb::MemTracker> mem_tracker;
+  // nullptr when memtable representation does not support concurrent inserts.
+  yb::ThreadPool* insert_thread_pool;
+  size_t insert_min_entries_per_thread;
 };
 
 YB_DEFINE_ENUM(FlushState, (kNotRequested)(kRequested)(kScheduled));
@@ -199,6 +203,13 @@ class MemTable {
       SequenceNumber s, ValueType type, const SliceParts& key, const SliceParts& value,
       PreparedAdd* prepared_add);
 
+  // Inserts entries prepared by PrepareAdd into the memtable.
+  // If allow_concurrent is false and insert thread pool is configured, large number of entries is
+  // split into contiguous ranges inserted concurrently by the pool threads and the calling thread.
+  // The method returns only after all entries were inserted.
+  //
+  // REQUIRES: if allow_concurrent = false, external synchronization to prevent
+  // simultaneous operations on the same MemTable.
   void ApplyPreparedAdd(
       const KeyHandle* handle, size_t count, const PreparedAdd& prepared_add,
       bool allow_concurrent);
@@ -381,6 +392,10 @@ class MemTable {
   friend class MemTableBackwardIterator;
   friend class MemTableList;
 
+  // Tries to insert entries using insert thread pool, returns false if parallel insert is not
+  // applicable, for instance because the number of entries is too small.
+  bool InsertParallel(const KeyHandle* handle, size_t count);
+
   KeyComparator comparator_;
   const MemTableOptions moptions_;
   int refs_;
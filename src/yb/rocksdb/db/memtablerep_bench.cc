@@ -36,6 +36,7 @@ int main() {
 #include <atomic>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -76,6 +77,7 @@ DEFINE_UNKNOWN_string(memtablerep, "skiplist",
               "include/memtablerep.h for\n"
               "  more details. Options:\n"
               "\tskiplist            -- backed by a skiplist\n"
+              "\tbtree               -- backed by a B+-tree\n"
               "\tvector              -- backed by an std::vector\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n");
@@ -123,6 +125,10 @@ DEFINE_UNKNOWN_int32(num_scans, 10,
 
 DEFINE_UNKNOWN_int32(item_size, 100, "Number of bytes each item should be");
 
+DEFINE_UNKNOWN_int32(key_prefix_size, 0,
+             "Size of the prefix shared by all keys. Use values like 20 to simulate DocDB keys, "
+             "that start with cotable id and hash code.");
+
 DEFINE_UNKNOWN_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
@@ -137,6 +143,18 @@ DEFINE_UNKNOWN_int64(seed, 0,
 namespace rocksdb {
 
 namespace {
+
+// Returns user key for the specified key number.
+std::string MakeUserKey(uint64_t key) {
+  std::string result(FLAGS_key_prefix_size, 'p');
+  PutFixed64(&result, key);
+  return result;
+}
+
+size_t InternalKeySize() {
+  return FLAGS_key_prefix_size + 16;
+}
+
 struct CallbackVerifyArgs {
   bool found;
   LookupKey* key;
@@ -249,15 +267,15 @@ class FillBenchmarkThread : public BenchmarkThread {
 
   void FillOne() {
     char* buf = nullptr;
-    auto internal_key_size = 16;
+    auto internal_key_size = InternalKeySize();
     auto encoded_len =
         FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
     KeyHandle handle = table_->Allocate(encoded_len, &buf);
     assert(buf != nullptr);
-    char* p = EncodeVarint32(buf, internal_key_size);
-    auto key = key_gen_->Next();
-    EncodeFixed64(p, key);
-    p += 8;
+    char* p = EncodeVarint32(buf, static_cast<uint32_t>(internal_key_size));
+    auto user_key = MakeUserKey(key_gen_->Next());
+    memcpy(p, user_key.data(), user_key.size());
+    p += user_key.size();
     EncodeFixed64(p, ++(*sequence_));
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
@@ -322,9 +340,7 @@ class ReadBenchmarkThread : public BenchmarkThread {
   }
 
   void ReadOne() {
-    std::string user_key;
-    auto key = key_gen_->Next();
-    PutFixed64(&user_key, key);
+    auto user_key = MakeUserKey(key_gen_->Next());
     LookupKey lookup_key(user_key, *sequence_);
     InternalKeyComparator internal_key_comp(BytewiseComparator());
     CallbackVerifyArgs verify_args;
@@ -334,7 +350,7 @@ class ReadBenchmarkThread : public BenchmarkThread {
     verify_args.comparator = &internal_key_comp;
     table_->Get(lookup_key, &verify_args, callback);
     if (verify_args.found) {
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      *bytes_read_ += VarintLength(InternalKeySize()) + InternalKeySize() + FLAGS_item_size;
       ++*read_hits_;
     }
   }
@@ -358,7 +374,7 @@ class SeqReadBenchmarkThread : public BenchmarkThread {
     std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
     for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
       // pretend to read the value
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      *bytes_read_ += VarintLength(InternalKeySize()) + InternalKeySize() + FLAGS_item_size;
     }
     ++*read_hits_;
   }
@@ -434,6 +450,7 @@ class Benchmark {
     uint64_t read_hits = 0;
     StopWatchNano timer(Env::Default(), true);
     RunThreads(&threads, &bytes_written, &bytes_read, true, &read_hits);
+    bytes_written_ = bytes_written;
     auto elapsed_time = static_cast<double>(timer.ElapsedNanos() / 1000);
     std::cout << "Elapsed time: " << static_cast<int>(elapsed_time) << " us"
               << std::endl;
@@ -463,6 +480,11 @@ class Benchmark {
                           uint64_t* bytes_written, uint64_t* bytes_read,
                           bool write, uint64_t* read_hits) = 0;
 
+  // Size of entries written to the memtable by the last Run.
+  uint64_t bytes_written() const {
+    return bytes_written_;
+  }
+
  protected:
   MemTableRep* table_;
   KeyGenerator* key_gen_;
@@ -470,6 +492,7 @@ class Benchmark {
   uint64_t num_write_ops_per_thread_;
   uint64_t num_read_ops_per_thread_;
   const uint32_t num_threads_;
+  uint64_t bytes_written_ = 0;
 };
 
 class FillBenchmark : public Benchmark {
@@ -592,6 +615,8 @@ int main(int argc, char** argv) {
   std::unique_ptr<rocksdb::MemTableRepFactory> factory;
   if (FLAGS_memtablerep == "skiplist") {
     factory.reset(new rocksdb::SkipListFactory);
+  } else if (FLAGS_memtablerep == "btree") {
+    factory.reset(new rocksdb::BTreeRepFactory);
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new rocksdb::VectorRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist") {
@@ -682,7 +707,25 @@ int main(int argc, char** argv) {
       continue;
     }
     std::cout << "Running " << name.ToString() << std::endl;
+    auto memory_before = arena.ApproximateMemoryUsage();
     benchmark->Run();
+    auto memory_used = arena.ApproximateMemoryUsage() - memory_before;
+    if (memory_used) {
+      // Includes entries, so compare reps with the same key and item sizes.
+      std::cout << "Memtable memory used: " << static_cast<double>(memory_used) / (1 << 20)
+                << " MiB" << std::endl;
+    }
+    auto bytes_written = benchmark->bytes_written();
+    if (memory_used > bytes_written && bytes_written) {
+      // Memory used by the rep itself, i.e. skiplist nodes or btree nodes, per inserted entry.
+      auto entry_size =
+          rocksdb::VarintLength(rocksdb::InternalKeySize()) + rocksdb::InternalKeySize() +
+          FLAGS_item_size;
+      auto num_entries = bytes_written / entry_size;
+      std::cout << "Memtable overhead per entry: "
+                << static_cast<double>(memory_used - bytes_written) / num_entries << " bytes"
+                << std::endl;
+    }
   }
 
   return 0;
@@ -149,6 +149,16 @@ Slice FileMetaData::UserFilter() const {
   return largest.user_frontier ? largest.user_frontier->Filter() : Slice();
 }
 
+bool FileMetaData::IsSameCompactionOutput(
+    const FileMetaData& rhs, const Comparator& user_comparator) const {
+  if (imported || rhs.imported ||
+      smallest.seqno != rhs.smallest.seqno || largest.seqno != rhs.largest.seqno) {
+    return false;
+  }
+  return user_comparator.Compare(largest.key.user_key(), rhs.smallest.key.user_key()) < 0 ||
+         user_comparator.Compare(rhs.largest.key.user_key(), smallest.key.user_key()) < 0;
+}
+
 std::string FileMetaData::FrontiersToString() const {
   return yb::Format("frontiers: { smallest: $0 largest: $1 }",
       smallest.user_frontier ? smallest.user_frontier->ToString() : "none",
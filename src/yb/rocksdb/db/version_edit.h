@@ -155,6 +155,11 @@ struct FileMetaData {
 
   Slice UserFilter() const; // Extracts user filter from largest boundary value if present.
 
+  // Returns true if this and rhs files are produced by the same compaction, i.e. they share
+  // the sequence number range of the compaction inputs and have disjoint key ranges.
+  // Such files form a single sorted run, for instance outputs of subcompactions.
+  bool IsSameCompactionOutput(const FileMetaData& rhs, const Comparator& user_comparator) const;
+
   // Outputs smallest and largest user frontiers to string, if they exist.
   std::string FrontiersToString() const;
 
@@ -817,7 +817,8 @@ uint64_t VersionStorageInfo::GetEstimatedActiveKeys() const {
 
 void Version::AddIterators(const ReadOptions& read_options,
                            const EnvOptions& soptions,
-                           MergeIteratorBuilder* merge_iter_builder) {
+                           MergeIteratorBuilder* merge_iter_builder,
+                           const std::vector<UserKeyRange>* memtable_ranges) {
   assert(storage_info_.finalized_);
 
   if (storage_info_.num_non_empty_levels() == 0) {
@@ -828,27 +829,18 @@ void Version::AddIterators(const ReadOptions& read_options,
   auto* arena = merge_iter_builder->GetArena();
 
   // Merge all level zero files together since they may overlap
-  for (size_t i = 0; i < storage_info_.LevelFilesBrief(0).num_files; i++) {
-    const auto& file = storage_info_.LevelFilesBrief(0).files[i];
-    if (!read_options.file_filter || read_options.file_filter->Filter(file)) {
-      InternalIterator *file_iter;
-      TableCache::TableReaderWithHandle trwh;
-      Status s = cfd_->table_cache()->GetTableReaderForIterator(read_options, soptions,
-          cfd_->internal_comparator(), file.fd, &trwh, cfd_->internal_stats()->GetFileReadHist(0),
-          false);
-      if (s.ok()) {
-        if (!read_options.table_aware_file_filter ||
-            read_options.table_aware_file_filter->Filter(trwh.table_reader)) {
-          file_iter = cfd_->table_cache()->NewIterator(
-              read_options, &trwh, storage_info_.LevelFiles(0)[i]->UserFilter(), false, arena);
-        } else {
-          file_iter = nullptr;
-        }
-      } else {
-        file_iter = NewErrorInternalIterator(s, arena);
-      }
-      if (file_iter) {
-        merge_iter_builder->AddIterator(file_iter);
+  if (read_options.isolated_file_filter) {
+    AddLevel0IteratorsWithIsolatedFileFilter(
+        read_options, soptions, merge_iter_builder, memtable_ranges);
+  } else {
+    for (size_t i = 0; i < storage_info_.LevelFilesBrief(0).num_files; i++) {
+      const auto& file = storage_info_.LevelFilesBrief(0).files[i];
+      if (!read_options.file_filter || read_options.file_filter->Filter(file)) {
+        TableCache::TableReaderWithHandle trwh;
+        Status s = cfd_->table_cache()->GetTableReaderForIterator(read_options, soptions,
+            cfd_->internal_comparator(), file.fd, &trwh,
+            cfd_->internal_stats()->GetFileReadHist(0), false);
+        AddLevel0Iterator(read_options, i, s, &trwh, merge_iter_builder);
       }
     }
   }
@@ -874,6 +866,126 @@ void Version::AddIterators(const ReadOptions& read_options,
   }
 }
 
+void Version::AddLevel0Iterator(
+    const ReadOptions& read_options, size_t index, const Status& status,
+    TableCache::TableReaderWithHandle* trwh, MergeIteratorBuilder* merge_iter_builder) {
+  auto* arena = merge_iter_builder->GetArena();
+  InternalIterator* file_iter;
+  if (status.ok()) {
+    if (!read_options.table_aware_file_filter ||
+        read_options.table_aware_file_filter->Filter(trwh->table_reader)) {
+      file_iter = cfd_->table_cache()->NewIterator(
+          read_options, trwh, storage_info_.LevelFiles(0)[index]->UserFilter(), false, arena);
+    } else {
+      file_iter = nullptr;
+    }
+  } else {
+    file_iter = NewErrorInternalIterator(status, arena);
+  }
+  if (file_iter) {
+    merge_iter_builder->AddIterator(file_iter);
+  }
+}
+
+void Version::AddLevel0IteratorsWithIsolatedFileFilter(
+    const ReadOptions& read_options, const EnvOptions& soptions,
+    MergeIteratorBuilder* merge_iter_builder,
+    const std::vector<UserKeyRange>* memtable_ranges) {
+  struct Level0File {
+    size_t index;
+    Status status;
+    TableCache::TableReaderWithHandle trwh;
+    bool filtered_out;
+  };
+
+  const auto& level0 = storage_info_.LevelFilesBrief(0);
+  std::vector<Level0File> files;
+  files.reserve(level0.num_files);
+  bool has_filtered_out = false;
+  for (size_t i = 0; i < level0.num_files; i++) {
+    if (read_options.file_filter && !read_options.file_filter->Filter(level0.files[i])) {
+      continue;
+    }
+    TableCache::TableReaderWithHandle trwh;
+    Status s = cfd_->table_cache()->GetTableReaderForIterator(read_options, soptions,
+        cfd_->internal_comparator(), level0.files[i].fd, &trwh,
+        cfd_->internal_stats()->GetFileReadHist(0), false);
+    // File excluded by other filters does not have data for this read, so it does not participate
+    // in the overlap check.
+    if (s.ok() && read_options.table_aware_file_filter &&
+        !read_options.table_aware_file_filter->Filter(trwh.table_reader)) {
+      continue;
+    }
+    bool filtered_out = s.ok() && !read_options.isolated_file_filter->Filter(trwh.table_reader);
+    has_filtered_out = has_filtered_out || filtered_out;
+    files.push_back(Level0File {
+      .index = i,
+      .status = std::move(s),
+      .trwh = std::move(trwh),
+      .filtered_out = filtered_out,
+    });
+  }
+
+  if (has_filtered_out) {
+    // Split key ranges of all data sources into groups of transitively overlapping ranges. Level 0
+    // file is excluded only when all members of its group are level 0 files excluded by the filter.
+    struct SourceRange {
+      Slice smallest;
+      Slice largest;
+      // nullptr for memtables and files of other levels, which are never excluded.
+      Level0File* file;
+    };
+    std::vector<SourceRange> ranges;
+    for (auto& file : files) {
+      const auto& meta = level0.files[file.index];
+      ranges.push_back({meta.smallest.user_key(), meta.largest.user_key(), &file});
+    }
+    if (memtable_ranges) {
+      for (const auto& range : *memtable_ranges) {
+        ranges.push_back({range.smallest, range.largest, nullptr});
+      }
+    }
+    for (int level = 1; level < storage_info_.num_non_empty_levels(); level++) {
+      const auto& level_files = storage_info_.LevelFilesBrief(level);
+      for (size_t i = 0; i < level_files.num_files; i++) {
+        const auto& meta = level_files.files[i];
+        ranges.push_back({meta.smallest.user_key(), meta.largest.user_key(), nullptr});
+      }
+    }
+    const auto* ucmp = user_comparator();
+    std::sort(ranges.begin(), ranges.end(), [ucmp](const auto& lhs, const auto& rhs) {
+      return ucmp->Compare(lhs.smallest, rhs.smallest) < 0;
+    });
+    auto group_begin = ranges.begin();
+    while (group_begin != ranges.end()) {
+      auto group_end = group_begin;
+      auto group_largest = group_begin->largest;
+      bool all_filtered_out = true;
+      for (; group_end != ranges.end() &&
+                 ucmp->Compare(group_end->smallest, group_largest) <= 0; ++group_end) {
+        if (ucmp->Compare(group_end->largest, group_largest) > 0) {
+          group_largest = group_end->largest;
+        }
+        all_filtered_out = all_filtered_out && group_end->file && group_end->file->filtered_out;
+      }
+      if (!all_filtered_out) {
+        for (auto it = group_begin; it != group_end; ++it) {
+          if (it->file) {
+            it->file->filtered_out = false;
+          }
+        }
+      }
+      group_begin = group_end;
+    }
+  }
+
+  for (auto& file : files) {
+    if (!file.filtered_out) {
+      AddLevel0Iterator(read_options, file.index, file.status, &file.trwh, merge_iter_builder);
+    }
+  }
+}
+
 VersionStorageInfo::VersionStorageInfo(
     const InternalKeyComparatorPtr& internal_comparator,
     const Comparator* user_comparator, int levels,
@@ -1026,6 +1138,56 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+Status Version::PrefetchKeys(
+    const ReadOptions& read_options, const std::vector<Slice>& user_keys) {
+  const auto& user_cmp = *user_comparator();
+  auto less = [&user_cmp](const Slice& lhs, const Slice& rhs) {
+    return user_cmp.Compare(lhs, rhs) < 0;
+  };
+  std::vector<Slice> sorted_keys(user_keys);
+  std::sort(sorted_keys.begin(), sorted_keys.end(), less);
+  std::vector<std::string> internal_keys;
+  internal_keys.reserve(sorted_keys.size());
+  for (const auto& user_key : sorted_keys) {
+    internal_keys.push_back(InternalKey(user_key, kMaxSequenceNumber, kValueTypeForSeek).Encode());
+  }
+
+  std::vector<Slice> file_keys;
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); ++level) {
+    for (const auto* file : storage_info_.LevelFiles(level)) {
+      auto smallest = file->smallest.key.user_key();
+      auto begin = std::lower_bound(sorted_keys.begin(), sorted_keys.end(), smallest, less);
+      // Key that is a strict prefix of the smallest key of the file is ordered before it, but the
+      // file could still contain records of this key, e.g. DocDB row key and the file starting
+      // with a column of this row. All keys between such key and the smallest key start with it,
+      // so scan back while keys have common prefix with the smallest key.
+      for (auto it = begin; it != sorted_keys.begin();) {
+        --it;
+        auto common_prefix_size = it->difference_offset(smallest);
+        if (common_prefix_size == 0) {
+          break;
+        }
+        if (common_prefix_size == it->size()) {
+          begin = it;
+        }
+      }
+      auto end = std::upper_bound(begin, sorted_keys.end(), file->largest.key.user_key(), less);
+      if (begin == end) {
+        continue;
+      }
+      file_keys.assign(
+          internal_keys.begin() + (begin - sorted_keys.begin()),
+          internal_keys.begin() + (end - sorted_keys.begin()));
+      auto table_reader = VERIFY_RESULT(table_cache_->GetTableReader(
+          vset_->env_options_, internal_comparator(), file->fd, read_options.query_id,
+          /* no_io = */ false, cfd_->internal_stats()->GetFileReadHist(level),
+          IsFilterSkipped(level, file == storage_info_.LevelFiles(level).back())));
+      RETURN_NOT_OK(table_reader.table_reader->PrefetchKeys(read_options, file_keys));
+    }
+  }
+  return Status::OK();
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
@@ -1261,10 +1423,20 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      // Outputs of the same universal compaction are picked as a single sorted run, unless
+      // max file size for compaction is limited, see UniversalCompactionPicker.
+      const bool group_compaction_outputs =
+          compaction_style_ == kCompactionStyleUniversal &&
+          mutable_cf_options.MaxFileSizeForCompaction() == std::numeric_limits<uint64_t>::max();
+      const FileMetaData* prev_file = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          if (!group_compaction_outputs || !prev_file ||
+              !prev_file->IsSameCompactionOutput(*f, *user_comparator_)) {
+            num_sorted_runs++;
+          }
+          prev_file = f;
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
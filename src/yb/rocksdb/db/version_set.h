@@ -78,6 +78,12 @@ class TableCache;
 class MergeIteratorBuilder;
 class FileNumbersProvider;
 
+// Range of user keys, both bounds are inclusive.
+struct UserKeyRange {
+  std::string smallest;
+  std::string largest;
+};
+
 // Return the smallest index i such that file_level.files[i]->largest >= key.
 // Return file_level.num_files if there is no such file.
 // REQUIRES: "file_level.files" contains a sorted list of
@@ -440,8 +446,11 @@ class Version {
   // Append to *iters a sequence of iterators that will
   // yield the contents of this Version when merged together.
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
+  // memtable_ranges are key ranges of memtables that are read together with this Version, they
+  // are required when ReadOptions::isolated_file_filter is specified.
   void AddIterators(const ReadOptions&, const EnvOptions& soptions,
-                    MergeIteratorBuilder* merger_iter_builder);
+                    MergeIteratorBuilder* merger_iter_builder,
+                    const std::vector<UserKeyRange>* memtable_ranges = nullptr);
 
   // Lookup the value for key.  If found, store it in *val and
   // return OK.  Else return a non-OK status.
@@ -464,6 +473,12 @@ class Version {
            bool* value_found = nullptr, bool* key_exists = nullptr,
            SequenceNumber* seq = nullptr);
 
+  // Loads data blocks that could contain specified user keys into the block cache, reading blocks
+  // of each SST file by a single batched read. See TableReader::PrefetchKeys.
+  //
+  // REQUIRES: lock is not held
+  Status PrefetchKeys(const ReadOptions& read_options, const std::vector<Slice>& user_keys);
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -557,6 +572,16 @@ class Version {
   // that it eventually expires from the cache.
   bool IsFilterSkipped(int level, bool is_file_last_in_level = false);
 
+  // Adds iterators for level 0 files that are not excluded by ReadOptions::isolated_file_filter.
+  void AddLevel0IteratorsWithIsolatedFileFilter(
+      const ReadOptions& read_options, const EnvOptions& soptions,
+      MergeIteratorBuilder* merge_iter_builder,
+      const std::vector<UserKeyRange>* memtable_ranges);
+
+  void AddLevel0Iterator(
+      const ReadOptions& read_options, size_t index, const Status& status,
+      TableCache::TableReaderWithHandle* trwh, MergeIteratorBuilder* merge_iter_builder);
+
   // The helper function of UpdateAccumulatedStats, which may fill the missing
   // fields of file_mata from its associated TableProperties.
   // Returns true if it does initialize FileMetaData.
@@ -37,8 +37,10 @@
 #include "yb/rocksdb/utilities/write_batch_with_index.h"
 #include "yb/rocksdb/table/scoped_arena_iterator.h"
 #include "yb/rocksdb/util/logging.h"
+#include "yb/util/format.h"
 #include "yb/util/string_util.h"
 #include "yb/util/test_macros.h"
+#include "yb/util/threadpool.h"
 #include "yb/rocksdb/util/testutil.h"
 
 namespace rocksdb {
@@ -771,6 +773,57 @@ TEST_F(WriteBatchTest, SavePointTest) {
   ASSERT_EQ("", PrintContents(&batch2));
 }
 
+TEST_F(WriteBatchTest, ParallelMemTableInsert) {
+  std::unique_ptr<yb::ThreadPool> pool;
+  ASSERT_OK(yb::ThreadPoolBuilder("memtable-insert").set_max_threads(4).Build(&pool));
+
+  InternalKeyComparator cmp(BytewiseComparator());
+  Options options;
+  options.memtable_factory = std::make_shared<SkipListFactory>(
+      0 /* lookahead */, ConcurrentWrites::kTrue);
+  options.memtable_insert_thread_pool = pool.get();
+  options.memtable_insert_min_entries_per_thread = 100;
+  ImmutableCFOptions ioptions(options);
+  WriteBuffer wb(options.db_write_buffer_size);
+  MemTable* mem =
+      new MemTable(cmp, ioptions, MutableCFOptions(options, ioptions), &wb,
+                   kMaxSequenceNumber);
+  mem->Ref();
+
+  constexpr size_t kNumEntries = 1000;
+  constexpr SequenceNumber kFirstSeqNo = 100;
+  PreparedAdd prepared_add;
+  std::vector<KeyHandle> handles;
+  // Add entries in descending order, so insertion does not rely on the sorted input.
+  for (size_t i = kNumEntries; i-- > 0;) {
+    auto key = yb::Format("key$0", 10000 + i);
+    auto value = std::to_string(i);
+    Slice key_slice(key);
+    Slice value_slice(value);
+    handles.push_back(mem->PrepareAdd(
+        kFirstSeqNo + kNumEntries - 1 - i, kTypeValue, SliceParts(&key_slice, 1),
+        SliceParts(&value_slice, 1), &prepared_add));
+  }
+  mem->ApplyPreparedAdd(handles.data(), handles.size(), prepared_add, false);
+
+  ASSERT_EQ(kNumEntries, mem->num_entries());
+  ASSERT_EQ(kFirstSeqNo, mem->GetFirstSequenceNumber());
+
+  Arena arena;
+  ScopedArenaIterator iter(mem->NewIterator(ReadOptions(), &arena));
+  size_t i = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+    ParsedInternalKey ikey;
+    ASSERT_TRUE(ParseInternalKey(iter->key(), &ikey));
+    ASSERT_EQ(yb::Format("key$0", 10000 + i), ikey.user_key.ToBuffer());
+    ASSERT_EQ(std::to_string(i), iter->value().ToBuffer());
+    ASSERT_EQ(kFirstSeqNo + kNumEntries - 1 - i, ikey.sequence);
+  }
+  ASSERT_EQ(kNumEntries, i);
+
+  delete mem->Unref();
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
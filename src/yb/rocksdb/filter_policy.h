@@ -37,10 +37,24 @@
 #include <memory>
 
 #include "yb/rocksdb/env.h"
+#include "yb/util/enums.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
 
+// Format of filter blocks built by fixed-size filter policy. Format is part of the policy name, so
+// files written with one format could be read only when policy with that format is supported.
+YB_DEFINE_ENUM(FixedSizeFilterFormat,
+    // Bloom filter with all probes of the key within one cache line, using 32-bit hash.
+    (kBloom)
+    // Bloom filter with all probes of the key within one cache line, using 64-bit hash with
+    // multiplicative line and bit selection. Cheaper to probe and has less correlated bit positions
+    // than kBloom.
+    (kBlockedBloom)
+    // Standard Ribbon filter with 64-bit coefficient rows. Uses ~20% less space per key than bloom
+    // filter with the same false positive rate, so more keys fit into each filter block.
+    (kRibbon));
+
 // A class that takes a bunch of keys, then generates filter
 class FilterBitsBuilder {
  public:
@@ -209,9 +223,11 @@ extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 // error_rate: expected false positive error rate to calculate maximum number of keys to store in
 // each filter block. This is used to determine whether a filter block is full.
 //
+// format: format of filter blocks, see FixedSizeFilterFormat.
+//
 // Callers must delete the result after any database that is using the filter policy has been
 // closed.
-extern const FilterPolicy* NewFixedSizeFilterPolicy(size_t total_bits,
-                                                    double error_rate,
-                                                    Logger* logger);
+extern const FilterPolicy* NewFixedSizeFilterPolicy(
+    size_t total_bits, double error_rate, Logger* logger,
+    FixedSizeFilterFormat format = FixedSizeFilterFormat::kBloom);
 }  // namespace rocksdb
@@ -28,6 +28,7 @@
 namespace yb {
 
 class MemTracker;
+class ThreadPool;
 
 }
 
@@ -133,6 +134,10 @@ struct ImmutableCFOptions {
 
   std::shared_ptr<IteratorReplacer> iterator_replacer;
 
+  yb::ThreadPool* memtable_insert_thread_pool;
+
+  size_t memtable_insert_min_entries_per_thread;
+
   CompactionFileFilterFactory* compaction_file_filter_factory;
 
   std::shared_ptr<RocksDBPriorityThreadPoolMetrics> priority_thread_pool_metrics;
@@ -0,0 +1,542 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// B+-tree memtable representation.
+//
+// Entries are kept in the leaves as sorted arrays of pointers, so a lookup touches one contiguous
+// node per level instead of following a chain of skip list nodes scattered over the arena, and
+// the per entry overhead is a single pointer. Since DocDB applies write batches sorted by key,
+// a leaf that is split because of the insert at its end keeps all of its entries, so nodes stay
+// full for sequential inserts.
+//
+// Concurrency: a single writer and any number of lock free readers.
+// Each node has a version, that is odd while the writer modifies the node. Readers read the node
+// optimistically and validate the version afterwards, restarting from the root on mismatch.
+// When a node is split, the writer marks its parent as modified before the node, so a reader that
+// validated the parent after reading the version of the child always descends to the right child
+// (optimistic lock coupling). Nodes and entries are never freed before the whole memtable.
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/util/arena.h"
+
+#include "yb/util/logging.h"
+
+namespace rocksdb {
+namespace {
+
+// Number of entries in the leaf, and number of children in the inner node.
+constexpr size_t kBTreeNodeCapacity = 32;
+
+// Max height of the tree. Nodes are at least half full unless they were split at the end,
+// that happens only for sequential inserts and produces full nodes on the left.
+constexpr size_t kBTreeMaxHeight = 24;
+
+class BTreeNode {
+ public:
+  explicit BTreeNode(bool leaf) : leaf_(leaf) {
+    for (auto& key : keys_) {
+      key.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  bool leaf() const {
+    return leaf_;
+  }
+
+  // Returns version of the node that is not being modified.
+  uint64_t StableVersion() const {
+    for (;;) {
+      auto result = version_.load(std::memory_order_acquire);
+      if ((result & 1) == 0) {
+        return result;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  // Returns true if the node was not modified since version was obtained, so values read from the
+  // node after StableVersion are consistent.
+  bool Validate(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  void BeginWrite() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void EndWrite() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  size_t size() const {
+    // Size could be read while the node is modified, so keep it in bounds for the readers.
+    return std::min<size_t>(size_.load(std::memory_order_relaxed), kBTreeNodeCapacity);
+  }
+
+  void set_size(size_t size) {
+    size_.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+  }
+
+  // In the leaf: entry. In the inner node: the smallest entry of the child subtree.
+  // The key of the first child of the inner node is not used by the search.
+  const char* key(size_t index) const {
+    return keys_[index].load(std::memory_order_acquire);
+  }
+
+  void set_key(size_t index, const char* key) {
+    keys_[index].store(key, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<uint64_t> version_{0};
+  std::atomic<uint32_t> size_{0};
+  const bool leaf_;
+  std::atomic<const char*> keys_[kBTreeNodeCapacity];
+};
+
+class BTreeInnerNode : public BTreeNode {
+ public:
+  BTreeInnerNode() : BTreeNode(false) {
+    for (auto& child : children_) {
+      child.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  BTreeNode* child(size_t index) const {
+    return children_[index].load(std::memory_order_acquire);
+  }
+
+  void set_child(size_t index, BTreeNode* child) {
+    children_[index].store(child, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<BTreeNode*> children_[kBTreeNodeCapacity];
+};
+
+// Position of the entry in the leaf.
+struct BTreePosition {
+  const BTreeNode* leaf = nullptr;
+  uint64_t version = 0;
+  size_t index = 0;
+};
+
+// Result of the search in the tree.
+struct BTreeSearchResult {
+  BTreePosition position;
+  // Entry at position.index, or the first entry of the following leaf when position.index is
+  // equal to the leaf size. nullptr when there is no such entry.
+  const char* entry = nullptr;
+  // Entry at position.index - 1, nullptr when position.index is 0.
+  const char* prev = nullptr;
+  // True when entry is not in the leaf, i.e. position.index is equal to the leaf size.
+  bool entry_in_next_leaf = false;
+};
+
+class BTreeRep : public MemTableRep {
+ public:
+  BTreeRep(const KeyComparator& compare, MemTableAllocator* allocator)
+      : MemTableRep(allocator), compare_(compare) {
+    root_.store(NewLeaf(), std::memory_order_release);
+  }
+
+  // REQUIRES: nothing that compares equal to key is currently in the collection,
+  // and no concurrent modifications to the table in progress.
+  void Insert(KeyHandle handle) override;
+
+  bool Contains(const char* key) const override {
+    auto result = LowerBound(key, /* strict= */ false);
+    return result.entry != nullptr && compare_(result.entry, key) == 0;
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    Iterator iter(this);
+    for (auto* entry = iter.SeekMemTableKey(Slice(), k.memtable_key().cdata());
+         entry && callback_func(callback_args, entry); entry = iter.Next()) {
+    }
+  }
+
+  MemTableRep::Iterator* GetIterator(Arena* arena) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(Iterator))
+                      : operator new(sizeof(Iterator));
+    return new (mem) Iterator(this);
+  }
+
+ private:
+  class Iterator final : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const BTreeRep* rep) : rep_(rep) {}
+
+    const char* Entry() const override {
+      return entry_;
+    }
+
+    const char* Next() override {
+      DCHECK(entry_);
+      if (!Step(/* forward= */ true)) {
+        Assign(rep_->UpperBound(entry_), /* use_prev= */ false);
+      }
+      return entry_;
+    }
+
+    const char* Prev() override {
+      DCHECK(entry_);
+      if (!Step(/* forward= */ false)) {
+        Assign(rep_->LowerBound(entry_, /* strict= */ true), /* use_prev= */ true);
+      }
+      return entry_;
+    }
+
+    const char* Seek(Slice internal_key) override {
+      return SeekMemTableKey(internal_key, EncodeKey(&tmp_, internal_key));
+    }
+
+    const char* SeekMemTableKey(Slice internal_key, const char* memtable_key) override {
+      Assign(rep_->LowerBound(memtable_key, /* strict= */ false), /* use_prev= */ false);
+      return entry_;
+    }
+
+    const char* SeekToFirst() override {
+      Assign(rep_->Descend([](const BTreeNode&, size_t) -> size_t { return 0; },
+                           [](const BTreeNode&, size_t) -> size_t { return 0; }),
+             /* use_prev= */ false);
+      return entry_;
+    }
+
+    const char* SeekToLast() override {
+      Assign(rep_->Descend([](const BTreeNode&, size_t size) { return size - 1; },
+                           [](const BTreeNode&, size_t size) { return size; }),
+             /* use_prev= */ true);
+      return entry_;
+    }
+
+   private:
+    // Moves to the adjacent entry of the same leaf, if the leaf was not modified since the
+    // iterator was positioned. Returns false if the tree should be searched instead.
+    bool Step(bool forward) {
+      auto* leaf = position_.leaf;
+      if (!leaf) {
+        return false;
+      }
+      auto version = leaf->StableVersion();
+      if (version != position_.version) {
+        return false;
+      }
+      size_t index = position_.index;
+      if (forward ? index + 1 >= leaf->size() : index == 0) {
+        return false;
+      }
+      index = forward ? index + 1 : index - 1;
+      auto* entry = leaf->key(index);
+      if (!leaf->Validate(version)) {
+        return false;
+      }
+      position_.index = index;
+      entry_ = entry;
+      return true;
+    }
+
+    void Assign(const BTreeSearchResult& result, bool use_prev) {
+      position_ = result.position;
+      if (use_prev) {
+        entry_ = result.prev;
+        if (entry_) {
+          --position_.index;
+        }
+      } else {
+        entry_ = result.entry;
+      }
+      // Position of the entry from the following leaf is unknown, so the next step will search
+      // the tree.
+      if (!entry_ || (!use_prev && result.entry_in_next_leaf)) {
+        position_.leaf = nullptr;
+      }
+    }
+
+    const BTreeRep* rep_;
+    const char* entry_ = nullptr;
+    BTreePosition position_;
+    std::string tmp_; // For passing to EncodeKey
+  };
+
+  BTreeNode* NewLeaf() {
+    return new (allocator_->AllocateAligned(sizeof(BTreeNode))) BTreeNode(true);
+  }
+
+  BTreeInnerNode* NewInner() {
+    return new (allocator_->AllocateAligned(sizeof(BTreeInnerNode))) BTreeInnerNode();
+  }
+
+  // Index of the first entry of the leaf that is not less than key.
+  size_t LeafLowerBound(const BTreeNode& leaf, size_t size, const char* key) const {
+    size_t lo = 0, hi = size;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      auto* entry = leaf.key(mid);
+      // nullptr could be observed only during concurrent modification, that will be detected by
+      // the version check. Stop the search in this case.
+      if (!entry) {
+        return size;
+      }
+      if (compare_(entry, key) < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Index of the child of the inner node, that contains key.
+  // When strict is true, returns index of the child that contains the last entry less than key.
+  size_t FindChild(const BTreeNode& node, size_t size, const char* key, bool strict) const {
+    size_t lo = 1, hi = size;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      auto* separator = node.key(mid);
+      if (!separator) {
+        return 0;
+      }
+      auto cmp = compare_(separator, key);
+      if (cmp < 0 || (!strict && cmp == 0)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo - 1;
+  }
+
+  // Returns result positioned at the first entry that is not less than key.
+  // When strict is true, the search goes to the leaf that contains the last entry less than key,
+  // so result.prev is set to this entry, while result.entry could be unrelated to the key.
+  BTreeSearchResult LowerBound(const char* key, bool strict) const {
+    return Descend(
+        [this, key, strict](const BTreeNode& node, size_t size) {
+          return FindChild(node, size, key, strict);
+        },
+        [this, key](const BTreeNode& leaf, size_t size) {
+          return LeafLowerBound(leaf, size, key);
+        });
+  }
+
+  // Returns result positioned at the first entry greater than key.
+  BTreeSearchResult UpperBound(const char* key) const {
+    return Descend(
+        [this, key](const BTreeNode& node, size_t size) {
+          return FindChild(node, size, key, /* strict= */ false);
+        },
+        [this, key](const BTreeNode& leaf, size_t size) {
+          auto index = LeafLowerBound(leaf, size, key);
+          if (index < size) {
+            auto* entry = leaf.key(index);
+            if (entry && compare_(entry, key) == 0) {
+              ++index;
+            }
+          }
+          return index;
+        });
+  }
+
+  // Descends from the root to the leaf, using child_index to select child of the inner node,
+  // and leaf_index to select position in the leaf.
+  template <class ChildIndex, class LeafIndex>
+  BTreeSearchResult Descend(const ChildIndex& child_index, const LeafIndex& leaf_index) const {
+    for (;;) {
+      const BTreeNode* node = root_.load(std::memory_order_acquire);
+      auto version = node->StableVersion();
+      // Smallest entry of the subtree following the current one.
+      const char* next_subtree_entry = nullptr;
+      bool restart = false;
+      while (!node->leaf()) {
+        const auto& inner = static_cast<const BTreeInnerNode&>(*node);
+        auto size = inner.size();
+        size_t index = size ? std::min<size_t>(child_index(inner, size), size - 1) : 0;
+        auto* child = inner.child(index);
+        const char* next_entry = index + 1 < size ? inner.key(index + 1) : nullptr;
+        if (!child) {
+          restart = true;
+          break;
+        }
+        auto child_version = child->StableVersion();
+        if (!inner.Validate(version)) {
+          restart = true;
+          break;
+        }
+        if (next_entry) {
+          next_subtree_entry = next_entry;
+        }
+        node = child;
+        version = child_version;
+      }
+      if (restart) {
+        continue;
+      }
+
+      BTreeSearchResult result;
+      auto size = node->size();
+      auto index = std::min<size_t>(leaf_index(*node, size), size);
+      result.entry = index < size ? node->key(index) : next_subtree_entry;
+      result.prev = index > 0 ? node->key(index - 1) : nullptr;
+      result.entry_in_next_leaf = index == size;
+      if (!node->Validate(version)) {
+        continue;
+      }
+      result.position.leaf = node;
+      result.position.version = version;
+      result.position.index = index;
+      return result;
+    }
+  }
+
+  const KeyComparator& compare_;
+  std::atomic<BTreeNode*> root_;
+};
+
+void BTreeRep::Insert(KeyHandle handle) {
+  const char* key = static_cast<const char*>(handle);
+
+  // Only this thread modifies the tree, so it does not need to validate what it reads.
+  BTreeNode* path[kBTreeMaxHeight];
+  size_t indexes[kBTreeMaxHeight];
+  size_t depth = 0;
+  BTreeNode* node = root_.load(std::memory_order_relaxed);
+  while (!node->leaf()) {
+    auto* inner = static_cast<BTreeInnerNode*>(node);
+    auto index = FindChild(*inner, inner->size(), key, /* strict= */ false);
+    CHECK_LT(depth, kBTreeMaxHeight - 1);
+    path[depth] = node;
+    indexes[depth] = index;
+    ++depth;
+    node = inner->child(index);
+  }
+  path[depth] = node;
+  indexes[depth] = LeafLowerBound(*node, node->size(), key);
+
+  // Find the deepest node that does not have to be split, all nodes below it are full.
+  int top = static_cast<int>(depth);
+  while (top >= 0 && path[top]->size() == kBTreeNodeCapacity) {
+    --top;
+  }
+  // Parents are marked before children, see optimistic lock coupling description above.
+  for (int i = std::max(top, 0); i <= static_cast<int>(depth); ++i) {
+    path[i]->BeginWrite();
+  }
+
+  // Key and child (for inner nodes) that should be inserted into the current level.
+  const char* insert_key = key;
+  BTreeNode* insert_child = nullptr;
+  for (int level = static_cast<int>(depth); level >= 0; --level) {
+    auto* current = path[level];
+    bool leaf = current->leaf();
+    // Leaf receives key at the found position, inner node receives new child after the
+    // one the search went through.
+    size_t position = leaf ? indexes[level] : indexes[level] + 1;
+    size_t size = current->size();
+
+    if (level > top) {
+      // Node is full, distribute its entries and the new one between it and the new right node.
+      const char* keys[kBTreeNodeCapacity + 1];
+      BTreeNode* children[kBTreeNodeCapacity + 1];
+      auto* inner = leaf ? nullptr : static_cast<BTreeInnerNode*>(current);
+      for (size_t i = 0, j = 0; i != size + 1; ++i) {
+        if (i == position) {
+          keys[i] = insert_key;
+          children[i] = insert_child;
+        } else {
+          keys[i] = current->key(j);
+          children[i] = inner ? inner->child(j) : nullptr;
+          ++j;
+        }
+      }
+      // Appending to the end of the node is typical for sorted inserts. Keep the left node full
+      // in this case, so following inserts would fill the right one.
+      size_t left_size = position == size ? size : (size + 1) / 2;
+      BTreeInnerNode* right_inner = leaf ? nullptr : NewInner();
+      BTreeNode* right = leaf ? NewLeaf() : right_inner;
+      for (size_t i = left_size; i != size + 1; ++i) {
+        right->set_key(i - left_size, keys[i]);
+        if (right_inner) {
+          right_inner->set_child(i - left_size, children[i]);
+        }
+      }
+      right->set_size(size + 1 - left_size);
+      for (size_t i = 0; i != left_size; ++i) {
+        current->set_key(i, keys[i]);
+        if (inner) {
+          inner->set_child(i, children[i]);
+        }
+      }
+      current->set_size(left_size);
+
+      insert_key = keys[left_size];
+      insert_child = right;
+      continue;
+    }
+
+    // Node has space for the new key.
+    auto* inner = leaf ? nullptr : static_cast<BTreeInnerNode*>(current);
+    for (size_t i = size; i > position; --i) {
+      current->set_key(i, current->key(i - 1));
+      if (inner) {
+        inner->set_child(i, inner->child(i - 1));
+      }
+    }
+    current->set_key(position, insert_key);
+    if (inner) {
+      inner->set_child(position, insert_child);
+    }
+    current->set_size(size + 1);
+    insert_child = nullptr;
+    break;
+  }
+
+  if (insert_child) {
+    // Root was split.
+    auto* old_root = path[0];
+    auto* new_root = NewInner();
+    new_root->set_key(0, old_root->key(0));
+    new_root->set_child(0, old_root);
+    new_root->set_key(1, insert_key);
+    new_root->set_child(1, insert_child);
+    new_root->set_size(2);
+    root_.store(new_root, std::memory_order_release);
+  }
+
+  for (int i = static_cast<int>(depth); i >= std::max(top, 0); --i) {
+    path[i]->EndWrite();
+  }
+}
+
+} // namespace
+
+MemTableRep* BTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+    const SliceTransform* transform, Logger* logger) {
+  return new BTreeRep(compare, allocator);
+}
+
+} // namespace rocksdb
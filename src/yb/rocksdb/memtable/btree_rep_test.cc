@@ -0,0 +1,207 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/gutil/endian.h"
+
+#include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/db/memtable_allocator.h"
+#include "yb/rocksdb/db/writebuffer.h"
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/testharness.h"
+#include "yb/rocksdb/util/testutil.h"
+
+#include "yb/util/test_macros.h"
+
+namespace rocksdb {
+
+class BTreeRepTest : public RocksDBTest {
+ protected:
+  BTreeRepTest()
+      : internal_comparator_(BytewiseComparator()), key_comparator_(internal_comparator_),
+        write_buffer_(0), allocator_(&arena_, &write_buffer_),
+        rep_(BTreeRepFactory().CreateMemTableRep(
+            key_comparator_, &allocator_, nullptr /* transform */, nullptr /* logger */)) {
+  }
+
+  // Keys share the long prefix, like DocDB keys of the same table.
+  static std::string UserKey(uint32_t i) {
+    std::string result = "cotable_id_and_hash_prefix";
+    char buf[sizeof(uint32_t)];
+    BigEndian::Store32(buf, i);
+    result.append(buf, sizeof(buf));
+    return result;
+  }
+
+  void Insert(uint32_t i) {
+    auto user_key = UserKey(i);
+    std::string internal_key = InternalKey(user_key, i, kTypeValue).Encode().ToBuffer();
+    auto encoded_len = VarintLength(internal_key.size()) + internal_key.size();
+    char* buf = nullptr;
+    auto handle = rep_->Allocate(encoded_len, &buf);
+    char* p = EncodeVarint32(buf, static_cast<uint32_t>(internal_key.size()));
+    memcpy(p, internal_key.data(), internal_key.size());
+    rep_->Insert(handle);
+  }
+
+  static std::string EntryUserKey(const char* entry) {
+    return ExtractUserKey(GetLengthPrefixedSlice(entry)).ToBuffer();
+  }
+
+  static std::string SeekKey(uint32_t i) {
+    return InternalKey(UserKey(i), kMaxSequenceNumber, kValueTypeForSeek).Encode().ToBuffer();
+  }
+
+  // Checks that the rep contains exactly the specified keys.
+  void CheckContents(std::vector<uint32_t> keys) {
+    std::sort(keys.begin(), keys.end());
+    std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+    size_t idx = 0;
+    for (auto* entry = iter->SeekToFirst(); entry; entry = iter->Next(), ++idx) {
+      ASSERT_LT(idx, keys.size());
+      ASSERT_EQ(UserKey(keys[idx]), EntryUserKey(entry));
+    }
+    ASSERT_EQ(keys.size(), idx);
+
+    for (auto* entry = iter->SeekToLast(); entry; entry = iter->Prev()) {
+      ASSERT_GT(idx, 0U);
+      --idx;
+      ASSERT_EQ(UserKey(keys[idx]), EntryUserKey(entry));
+    }
+    ASSERT_EQ(0U, idx);
+
+    for (size_t i = 0; i != keys.size(); ++i) {
+      auto* entry = iter->Seek(SeekKey(keys[i]));
+      ASSERT_NE(entry, nullptr);
+      ASSERT_EQ(UserKey(keys[i]), EntryUserKey(entry));
+      ASSERT_TRUE(rep_->Contains(entry));
+      // Step back and forth around the found entry.
+      entry = iter->Prev();
+      if (i == 0) {
+        ASSERT_EQ(entry, nullptr);
+        continue;
+      }
+      ASSERT_NE(entry, nullptr);
+      ASSERT_EQ(UserKey(keys[i - 1]), EntryUserKey(entry));
+      entry = iter->Next();
+      ASSERT_NE(entry, nullptr);
+      ASSERT_EQ(UserKey(keys[i]), EntryUserKey(entry));
+    }
+  }
+
+  InternalKeyComparator internal_comparator_;
+  MemTable::KeyComparator key_comparator_;
+  Arena arena_;
+  WriteBuffer write_buffer_;
+  MemTableAllocator allocator_;
+  std::unique_ptr<MemTableRep> rep_;
+};
+
+TEST_F(BTreeRepTest, Empty) {
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  ASSERT_EQ(nullptr, iter->SeekToFirst());
+  ASSERT_EQ(nullptr, iter->SeekToLast());
+  ASSERT_EQ(nullptr, iter->Seek(SeekKey(0)));
+}
+
+TEST_F(BTreeRepTest, SequentialInsert) {
+  constexpr uint32_t kNumKeys = 10000;
+  std::vector<uint32_t> keys;
+  for (uint32_t i = 0; i != kNumKeys; ++i) {
+    Insert(i * 2);
+    keys.push_back(i * 2);
+  }
+  ASSERT_NO_FATALS(CheckContents(keys));
+
+  // Seek between the keys lands to the following key.
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  auto* entry = iter->Seek(SeekKey(101));
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(UserKey(102), EntryUserKey(entry));
+  ASSERT_EQ(nullptr, iter->Seek(SeekKey(kNumKeys * 2)));
+}
+
+TEST_F(BTreeRepTest, RandomInsert) {
+  constexpr uint32_t kNumKeys = 10000;
+  std::vector<uint32_t> keys;
+  for (uint32_t i = 0; i != kNumKeys; ++i) {
+    keys.push_back(i);
+  }
+  std::mt19937_64 rng(42);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    Insert(key);
+  }
+  ASSERT_NO_FATALS(CheckContents(keys));
+}
+
+TEST_F(BTreeRepTest, ConcurrentReads) {
+  constexpr uint32_t kNumKeys = 100000;
+  constexpr int kNumReaders = 4;
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> num_scans{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i != kNumReaders; ++i) {
+    readers.emplace_back([this, &stop, &num_scans] {
+      std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+      while (!stop.load(std::memory_order_acquire)) {
+        // Keys inserted concurrently could be missed, but the scan should stay sorted.
+        std::string prev;
+        for (auto* entry = iter->SeekToFirst(); entry; entry = iter->Next()) {
+          auto key = EntryUserKey(entry);
+          ASSERT_LT(prev, key);
+          prev = std::move(key);
+        }
+        num_scans.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  std::vector<uint32_t> keys;
+  std::unordered_set<uint32_t> inserted;
+  std::mt19937_64 rng(42);
+  for (uint32_t i = 0; i != kNumKeys; ++i) {
+    // Mix of sequential and random inserts.
+    auto key = i % 2 ? static_cast<uint32_t>(rng() % kNumKeys) * 2 + 1 : i;
+    if (!inserted.insert(key).second) {
+      continue;
+    }
+    Insert(key);
+    keys.push_back(key);
+  }
+  stop.store(true, std::memory_order_release);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  LOG(INFO) << "Scans: " << num_scans.load();
+  ASSERT_NO_FATALS(CheckContents(keys));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -271,6 +271,20 @@ class CDSSkipListFactory : public MemTableRepFactory {
   bool IsInsertConcurrentlySupported() const override { return true; }
 };
 
+// This uses a B+-tree to store keys. Each node keeps a sorted array of pointers to entries, so
+// lookups are more cache friendly than in the skip list, and the index overhead is about one
+// pointer per entry when keys are inserted in sorted order, as DocDB write batches are.
+// Supports a single writer with concurrent readers, and does not support in memory erase.
+class BTreeRepFactory : public MemTableRepFactory {
+ public:
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                 MemTableAllocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+
+  const char* Name() const override { return "BTreeRepFactory"; }
+};
+
 // This creates MemTableReps that are backed by an std::vector. On iteration,
 // the vector is sorted. This is useful for workloads where iteration is very
 // rare and writes are generally not issued after reads begin.
@@ -92,6 +92,10 @@ class UserFrontier {
 
   virtual void ResetFilter() = 0;
 
+  // Returns physical time of the records covered by this frontier in microseconds, or 0 if it is
+  // not known. Used by universal compaction to group files into time windows.
+  virtual uint64_t PhysicalTimeMicros() const { return 0; }
+
   // Returns true if this frontier dominates another frontier, i.e. if we update this frontier
   // with the values from the other one in the direction specified by update_type, nothing will
   // change. This is used to check invariants.
@@ -46,6 +46,7 @@ namespace yb {
 
 class MemTracker;
 class PriorityThreadPool;
+class ThreadPool;
 
 }
 
@@ -95,7 +96,9 @@ enum CompressionType : char {
   kBZip2Compression = 0x3,
   kLZ4Compression = 0x4,
   kLZ4HCCompression = 0x5,
-  // zstd format is not finalized yet so it's subject to changes.
+  kZSTD = 0x7,
+  // Legacy value used before zstd format was finalized, blocks are compressed in the same way as
+  // for kZSTD.
   kZSTDNotFinalCompression = 0x40,
 };
 
@@ -167,6 +170,14 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
+  // Maximal size of dictionary trained from data blocks of compaction output file and used to
+  // compress them, only applicable to kZSTD. Dictionary is stored in a meta block of SST file.
+  // 0 disables dictionary compression.
+  uint32_t max_dict_bytes = 0;
+  // Maximal size of data blocks that are buffered and sampled for dictionary training. Data blocks
+  // are written to the file only after dictionary is trained, so it also limits memory used by
+  // table builder. 0 means 100 * max_dict_bytes.
+  uint32_t zstd_max_train_bytes = 0;
   CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
   CompressionOptions(int wbits, int _lev, int _strategy)
       : window_bits(wbits), level(_lev), strategy(_strategy) {}
@@ -873,6 +884,17 @@ struct DBOptions {
 
   yb::PriorityThreadPool* priority_thread_pool_for_compactions_and_flushes = nullptr;
 
+  // Thread pool used to insert entries of a large write batch into the memtable concurrently.
+  // Used only when memtable_factory supports concurrent inserts. The writing thread takes part in
+  // the insertion, so the write does not wait for the pool when all of its threads are busy.
+  // Default: nullptr, i.e. entries are inserted by the writing thread only.
+  yb::ThreadPool* memtable_insert_thread_pool = nullptr;
+
+  // Min number of entries inserted into the memtable by a single thread of
+  // memtable_insert_thread_pool. A write batch is split between threads only when it has at least
+  // twice as many entries.
+  size_t memtable_insert_min_entries_per_thread = 4096;
+
   // Use to control write rate of flush and compaction. Flush has higher
   // priority than compaction. Rate limiting is disabled if nullptr.
   // If rate limiter is enabled, bytes_per_sync is set to 1MB by default.
@@ -1332,6 +1354,11 @@ struct DBOptions {
   // Supported only for level0 of universal style compactions.
   std::shared_ptr<std::function<uint64_t()>> max_file_size_for_compaction;
 
+  // Function that returns the size of the user key prefix, that should not be split between
+  // subcompactions, i.e. all keys with the same prefix are processed by the same subcompaction.
+  // When not set, any user key could be used as a subcompaction boundary.
+  std::shared_ptr<std::function<size_t(Slice)>> subcompaction_key_prefix_size;
+
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
 
@@ -1523,6 +1550,13 @@ struct ReadOptions {
 
   std::shared_ptr<ReadFileFilter> file_filter;
 
+  // Filter for pruning level 0 SST files basing on values stored in them, e.g. on ranges of column
+  // values. Excluding such file alone could expose older entries with the same keys from other
+  // sources, or leave newer partial entries without the rest of their data. So a file is excluded
+  // only when it belongs to a group of transitively overlapping key ranges of files and memtables,
+  // where every member is a level 0 file excluded by this filter.
+  std::shared_ptr<TableAwareReadFileFilter> isolated_file_filter;
+
   // Statistics object to use instead of the DB statistics object (default).
   Statistics* statistics = nullptr;
 
@@ -24,6 +24,7 @@ class CompactionFeed;
 class DB;
 class Env;
 class MemTable;
+class RateLimiter;
 class Iterator;
 class Statistics;
 class UserFrontiers;
@@ -32,6 +33,7 @@ class WriteBatch;
 struct BlockBasedTableOptions;
 struct CompactionContextOptions;
 struct CompactionInputFiles;
+struct ExternalSstFileInfo;
 struct KeyValueEntry;
 struct Options;
 struct TableBuilderOptions;
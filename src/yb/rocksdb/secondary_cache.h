@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// A SecondaryCache is the second tier of the block cache. It keeps the contents of entries evicted
+// from the primary (in memory) cache, so the following miss in the primary cache could be served
+// from the secondary cache instead of the data file.
+//
+// Unlike Cache, the secondary cache stores serialized contents instead of values, so the user is
+// responsible for restoring the value from the contents returned by Lookup.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class MemTracker;
+class MetricEntity;
+
+} // namespace yb
+
+namespace rocksdb {
+
+class Env;
+
+class SecondaryCache {
+ public:
+  virtual ~SecondaryCache() = default;
+
+  // Offers the contents of the entry evicted from the primary cache.
+  // The cache could decline the entry, for instance because of admission control or when it is
+  // already present.
+  virtual void Insert(const Slice& key, const Slice& contents) = 0;
+
+  // If the cache contains entry for key, fills contents and size and returns true.
+  // Otherwise returns false. Failures to read the entry are reported as a miss.
+  virtual bool Lookup(const Slice& key, std::unique_ptr<char[]>* contents, size_t* size) = 0;
+
+  // If the cache contains entry for key, erase it.
+  virtual void Erase(const Slice& key) = 0;
+
+  // Returns the number of bytes occupied by the cache entries on disk.
+  virtual size_t GetDiskUsage() const = 0;
+
+  // Returns the number of bytes of memory used by the cache, i.e. index and data that was not
+  // written to disk yet.
+  virtual size_t GetMemoryUsage() const = 0;
+
+  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
+
+  // Waits until all filled write buffers are written to disk and files of dropped segments are
+  // deleted.
+  virtual void TEST_WaitWritesCompleted() {}
+};
+
+struct FileSecondaryCacheOptions {
+  // Env used to access the cache files. Env::Default() is used when not specified.
+  Env* env = nullptr;
+
+  // Directory for the cache files, preferably on the fast local disk.
+  // Existing cache files in this directory are removed when the cache is created.
+  std::string dir;
+
+  // Max number of bytes stored on disk. When exceeded, the oldest segment is dropped.
+  size_t disk_capacity = 0;
+
+  // Max number of bytes of memory used by the index and the data that was not written to disk yet.
+  // When exceeded, new entries are rejected.
+  size_t memory_capacity = 64 * 1024 * 1024;
+
+  // Size of the cache file. Entries are appended to the newest segment, and are evicted a segment
+  // at a time, starting from the oldest one.
+  size_t segment_size = 64 * 1024 * 1024;
+
+  // Size of the chunk that entries are accumulated into in memory, before the background thread
+  // writes it to the file.
+  size_t write_buffer_size = 1024 * 1024;
+
+  // If specified, memory used by the index and the data that was not written to disk yet is
+  // consumed from this tracker.
+  std::shared_ptr<yb::MemTracker> mem_tracker;
+};
+
+// Creates a log structured secondary cache that appends entries to the files in options.dir.
+// The index of the cache is kept in memory, so the cache contents are not preserved on restart.
+extern yb::Result<std::shared_ptr<SecondaryCache>> NewFileSecondaryCache(
+    const FileSecondaryCacheOptions& options);
+
+}  // namespace rocksdb
@@ -28,6 +28,7 @@
 namespace rocksdb {
 
 class Comparator;
+class UserFrontiers;
 
 // Table Properties that are specific to tables created by SstFileWriter.
 struct ExternalSstFilePropertyNames {
@@ -64,6 +65,8 @@ struct ExternalSstFileInfo {
   bool is_split_sst;               // is SST split into metadata and data file(s)
   uint64_t num_entries;            // number of entries in file
   int32_t version;                 // file version
+  // Frontiers of the data in the file, not owned. Assigned to the added file when specified.
+  const UserFrontiers* user_frontiers = nullptr;
 };
 
 // SstFileWriter is used to create sst files that can be added to database later
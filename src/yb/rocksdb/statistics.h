@@ -217,6 +217,15 @@ enum Tickers : uint32_t {
   COMPACTION_FILES_FILTERED,
   COMPACTION_FILES_NOT_FILTERED,
 
+  // Packed rows rewritten by compaction from an old schema version to the latest one.
+  COMPACTION_PACKED_ROWS_REPACKED,
+
+  // Auto readahead of data blocks for sequential iteration.
+  READAHEAD_REQUESTS,
+  READAHEAD_BYTES,
+  // Number of times sequential access pattern was broken after readahead was started.
+  READAHEAD_RESETS,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -320,6 +329,11 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
 
     {COMPACTION_FILES_FILTERED, "rocksdb_compaction_files_filtered"},
     {COMPACTION_FILES_NOT_FILTERED, "rocksdb_compaction_files_not_filtered"},
+    {COMPACTION_PACKED_ROWS_REPACKED, "rocksdb_compaction_packed_rows_repacked"},
+
+    {READAHEAD_REQUESTS, "rocksdb_readahead_requests"},
+    {READAHEAD_BYTES, "rocksdb_readahead_bytes"},
+    {READAHEAD_RESETS, "rocksdb_readahead_resets"},
 };
 
 /**
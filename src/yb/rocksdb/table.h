@@ -93,6 +93,12 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // Indicating if we'd put index of fixed-size bloom filter blocks to the block cache.
+  // If not specified, each "table reader" object will pre-load filter index during table
+  // initialization, so memory used by filters of open tables grows with the data size.
+  // Has no effect when block cache is disabled.
+  bool cache_filter_index = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -163,6 +169,24 @@ struct BlockBasedTableOptions {
   KeyValueEncodingFormat data_block_key_value_encoding_format =
       KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
 
+  // If true, data blocks get hash index which maps key to the restart interval containing it, so
+  // point lookup inside data block does not need binary search over restart points.
+  // Filter key (see FilterPolicy::GetKeyTransformer) is used as hashed part of the key, or whole
+  // user key when filter policy is not specified.
+  // Blocks with more than 253 restart points are written without hash index.
+  // NOTE: SST files written with this option could not be read by older versions.
+  bool use_data_block_hash_index = false;
+
+  // Ratio of number of distinct hashed keys in data block to number of hash index buckets.
+  double data_block_hash_index_util_ratio = 0.75;
+
+  // When iterator reads data blocks of SST file sequentially, it initiates asynchronous readahead
+  // of the following part of the file. Readahead size starts from auto_readahead_initial_size and
+  // doubles on each readahead up to auto_readahead_max_size.
+  // 0 for auto_readahead_max_size disables auto readahead.
+  size_t auto_readahead_initial_size = 64 * 1024;
+  size_t auto_readahead_max_size = 0;
+
   // If non-nullptr, use the specified filter policy for new SST files to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -162,7 +162,9 @@ void BlockIter::Initialize(
     const Comparator* comparator, const char* data,
     const KeyValueEncodingFormat key_value_encoding_format,
     const uint32_t restarts, const uint32_t num_restarts,
-    const BlockHashIndex* hash_index, const BlockPrefixIndex* prefix_index) {
+    const BlockHashIndex* hash_index, const BlockPrefixIndex* prefix_index,
+    const DataBlockHashIndex* data_block_hash_index,
+    const DataBlockHashIndexKeyExtractor* hash_index_key_extractor) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -175,6 +177,10 @@ void BlockIter::Initialize(
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  if (data_block_hash_index && data_block_hash_index->valid() && hash_index_key_extractor) {
+    data_block_hash_index_ = data_block_hash_index;
+    hash_index_key_extractor_ = hash_index_key_extractor;
+  }
 }
 
 const KeyValueEntry& BlockIter::Seek(Slice target) {
@@ -186,6 +192,8 @@ const KeyValueEntry& BlockIter::Seek(Slice target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (data_block_hash_index_) {
+    ok = DataBlockHashSeek(target, &index);
   } else {
     ok = hash_index_ ? HashSeek(target, &index)
       : BinarySeek(target, 0, num_restarts_ - 1, &index);
@@ -545,9 +553,55 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   }
 }
 
+// Finds restart interval using data block hash index. The restart interval found via the index
+// is verified against the target, so hash collision with a key that is not present in the block
+// could only result in falling back to binary search.
+bool BlockIter::DataBlockHashSeek(const Slice& target, uint32_t* index) {
+  const auto hashed_key = hash_index_key_extractor_->Extract(target);
+  const uint32_t restart_index =
+      hashed_key.empty() ? kDataBlockHashIndexNoEntry : data_block_hash_index_->Lookup(hashed_key);
+  if (restart_index >= num_restarts_) {
+    // Covers kDataBlockHashIndexNoEntry and kDataBlockHashIndexCollision.
+    return BinarySeek(target, 0, num_restarts_ - 1, index);
+  }
+
+  uint32_t key_size;
+  const char* key_ptr = DecodeRestartEntry(
+      key_value_encoding_format_, data_ + GetRestartPoint(restart_index), data_ + restarts_, data_,
+      &key_size);
+  if (key_ptr == nullptr) {
+    CorruptionError("DecodeRestartEntry failed");
+    return false;
+  }
+  Slice restart_key(key_ptr, key_size);
+  // Linear search could be started from the restart interval, only when all keys before it are
+  // less than target. It is true when restart key is not greater than target, or when restart key
+  // is the first key with the same hashed part as target, since keys with the same hashed part
+  // form contiguous range.
+  if (Compare(restart_key, target) > 0 &&
+      hash_index_key_extractor_->Extract(restart_key) != hashed_key) {
+    return BinarySeek(target, 0, restart_index, index);
+  }
+
+  // Target could be located after the found restart interval, when it is not the first key with
+  // such hashed part.
+  if (restart_index + 1 < num_restarts_) {
+    const auto cmp = CompareBlockKey(restart_index + 1, target);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp <= 0) {
+      return BinarySeek(target, restart_index + 1, num_restarts_ - 1, index);
+    }
+  }
+
+  *index = restart_index;
+  return true;
+}
+
 uint32_t Block::NumRestarts() const {
   assert(size_ >= kMinBlockSize);
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return num_restarts_;
 }
 
 Block::Block(BlockContents&& contents)
@@ -556,20 +610,31 @@ Block::Block(BlockContents&& contents)
       size_(contents_.data.size()) {
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
-  } else {
-    restart_offset_ =
-        static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
-    if (restart_offset_ > size_ - sizeof(uint32_t)) {
-      // The size is too small for NumRestarts() and therefore
-      // restart_offset_ wrapped around.
+    return;
+  }
+  size_t restarts_end = size_ - sizeof(uint32_t);
+  num_restarts_ = DecodeFixed32(data_ + restarts_end);
+  if (num_restarts_ & kDataBlockHashIndexFlag) {
+    num_restarts_ &= ~kDataBlockHashIndexFlag;
+    size_t index_size = 0;
+    if (!data_block_hash_index_.Initialize(data_, restarts_end, &index_size)) {
       size_ = 0;
+      return;
     }
+    restarts_end -= index_size;
+  }
+  if (restarts_end < num_restarts_ * sizeof(uint32_t)) {
+    // The size is too small for NumRestarts().
+    size_ = 0;
+    return;
   }
+  restart_offset_ = static_cast<uint32_t>(restarts_end - num_restarts_ * sizeof(uint32_t));
 }
 
 InternalIterator* Block::NewIterator(
     const Comparator* cmp, const KeyValueEncodingFormat key_value_encoding_format, BlockIter* iter,
-    const bool total_order_seek) const {
+    const bool total_order_seek,
+    const DataBlockHashIndexKeyExtractor* hash_index_key_extractor) const {
   if (size_ < kMinBlockSize) {
     if (iter != nullptr) {
       iter->SetStatus(BadBlockContentsError());
@@ -594,10 +659,12 @@ InternalIterator* Block::NewIterator(
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, key_value_encoding_format, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, &data_block_hash_index_,
+                    hash_index_key_extractor);
     } else {
       iter = new BlockIter(cmp, data_, key_value_encoding_format, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, &data_block_hash_index_,
+                           hash_index_key_extractor);
     }
   }
 
@@ -709,4 +776,23 @@ yb::Result<std::string> Block::GetMiddleKey(
       /* restart_idx = */ 0, cmp, key_value_encoding_format, middle_entry_policy));
 }
 
+yb::Result<std::vector<std::string>> Block::GetRestartKeys(
+    const size_t max_keys, const KeyValueEncodingFormat key_value_encoding_format) const {
+  std::vector<std::string> result;
+  const auto num_restarts = NumRestarts();
+  if (max_keys == 0 || size_ == kMinBlockSize) {
+    return result;
+  }
+  const size_t num_keys = std::min<size_t>(max_keys, num_restarts);
+  result.reserve(num_keys);
+  for (size_t i = 0; i != num_keys; ++i) {
+    // Take the last restart point of each of num_keys equal parts, so the last key of the block
+    // is always included.
+    const auto restart_idx = static_cast<uint32_t>((i + 1) * num_restarts / num_keys - 1);
+    result.push_back(VERIFY_RESULT(GetRestartKey(restart_idx, key_value_encoding_format))
+        .ToBuffer());
+  }
+  return result;
+}
+
 }  // namespace rocksdb
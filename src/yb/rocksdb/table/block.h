@@ -28,12 +28,16 @@
 #include <malloc.h>
 #endif
 
+#include <string>
+#include <vector>
+
 #include "yb/rocksdb/comparator.h"
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 
@@ -90,10 +94,14 @@ class Block {
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
   // key_value_encoding_format specifies what kind of algorithm to use for decoding entries.
-  InternalIterator* NewIterator(const Comparator* comparator,
-                                KeyValueEncodingFormat key_value_encoding_format,
-                                BlockIter* iter = nullptr,
-                                bool total_order_seek = true) const;
+  //
+  // If hash_index_key_extractor is not null and data block contains hash index, the index is
+  // used to find restart interval for Seek. The extractor should be the same one that was used
+  // while building the block.
+  InternalIterator* NewIterator(
+      const Comparator* comparator, KeyValueEncodingFormat key_value_encoding_format,
+      BlockIter* iter = nullptr, bool total_order_seek = true,
+      const DataBlockHashIndexKeyExtractor* hash_index_key_extractor = nullptr) const;
 
   inline InternalIterator* NewIndexIterator(
       const Comparator* comparator, BlockIter* iter = nullptr, bool total_order_seek = true) const {
@@ -124,6 +132,12 @@ class Block {
       MiddlePointPolicy middle_entry_policy = MiddlePointPolicy::kMiddleLow
   ) const;
 
+  // Returns up to max_keys keys of restart points, evenly spread over the block and sorted in
+  // the block order. For index blocks with the restart interval of 1 it gives a sample of the
+  // keys which split SST file into the parts of roughly the same size.
+  yb::Result<std::vector<std::string>> GetRestartKeys(
+      size_t max_keys, KeyValueEncodingFormat key_value_encoding_format) const;
+
  private:
   // Returns key for corresponding restart block.
   yb::Result<Slice> GetRestartKey(
@@ -139,6 +153,8 @@ class Block {
   const char* data_;            // contents_.data.data()
   size_t size_;                 // contents_.data.size()
   uint32_t restart_offset_;     // Offset in data_ of restart array
+  uint32_t num_restarts_ = 0;
+  DataBlockHashIndex data_block_hash_index_;
   std::unique_ptr<BlockHashIndex> hash_index_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
 
@@ -163,17 +179,21 @@ class BlockIter final : public InternalIterator {
   BlockIter(
       const Comparator* comparator, const char* data,
       KeyValueEncodingFormat key_value_encoding_format, uint32_t restarts, uint32_t num_restarts,
-      const BlockHashIndex* hash_index, const BlockPrefixIndex* prefix_index)
+      const BlockHashIndex* hash_index, const BlockPrefixIndex* prefix_index,
+      const DataBlockHashIndex* data_block_hash_index,
+      const DataBlockHashIndexKeyExtractor* hash_index_key_extractor)
       : BlockIter() {
     Initialize(
         comparator, data, key_value_encoding_format, restarts, num_restarts, hash_index,
-        prefix_index);
+        prefix_index, data_block_hash_index, hash_index_key_extractor);
   }
 
   void Initialize(
       const Comparator* comparator, const char* data,
       KeyValueEncodingFormat key_value_encoding_format, uint32_t restarts, uint32_t num_restarts,
-      const BlockHashIndex* hash_index, const BlockPrefixIndex* prefix_index);
+      const BlockHashIndex* hash_index, const BlockPrefixIndex* prefix_index,
+      const DataBlockHashIndex* data_block_hash_index,
+      const DataBlockHashIndexKeyExtractor* hash_index_key_extractor);
 
   void SetStatus(Status s) {
     status_ = s;
@@ -236,6 +256,9 @@ class BlockIter final : public InternalIterator {
   Status status_;
   const BlockHashIndex* hash_index_;
   const BlockPrefixIndex* prefix_index_;
+  // Not null only when data block hash index should be used.
+  const DataBlockHashIndex* data_block_hash_index_ = nullptr;
+  const DataBlockHashIndexKeyExtractor* hash_index_key_extractor_ = nullptr;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -283,6 +306,8 @@ class BlockIter final : public InternalIterator {
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
 
+  bool DataBlockHashSeek(const Slice& target, uint32_t* index);
+
 };
 
 }  // namespace rocksdb
@@ -29,6 +29,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -49,6 +50,7 @@
 #include "yb/rocksdb/table/block_based_table_factory.h"
 #include "yb/rocksdb/table/block_based_table_internal.h"
 #include "yb/rocksdb/table/block_builder.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/filter_block.h"
 #include "yb/rocksdb/table/fixed_size_filter_block.h"
 #include "yb/rocksdb/table/format.h"
@@ -110,7 +112,8 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    std::string* compressed_output) {
+                    std::string* compressed_output,
+                    const ZSTDCompressionDict* compression_dict) {
   if (*type == kNoCompression) {
     return raw;
   }
@@ -161,9 +164,10 @@ Slice CompressBlock(const Slice& raw,
         return *compressed_output;
       }
       break;     // fall back to no compression.
+    case kZSTD:
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -282,6 +286,7 @@ struct BlockBasedTableBuilder::Rep {
 
   InternalKeySliceTransform internal_prefix_transform;
   const FilterPolicy::KeyTransformer* const filter_key_transformer;
+  std::optional<DataBlockHashIndexKeyExtractor> data_block_hash_index_key_extractor;
   std::unique_ptr<IndexBuilder> data_index_builder;
   IndexBuilder::IndexBlocks data_index_blocks;
   BlockHandle last_index_block_handle;
@@ -301,6 +306,23 @@ struct BlockBasedTableBuilder::Rep {
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
+  // Data block, that was finished but not yet written to the file, because compression dictionary
+  // is not trained yet.
+  struct BufferedDataBlock {
+    std::string contents;
+    std::string last_key;
+    std::string next_block_first_key;
+  };
+
+  // When dictionary compression is enabled, data blocks are buffered in memory until
+  // compression_dict_train_limit bytes are collected. Then dictionary is trained on buffered blocks
+  // and they are written to the file compressed with this dictionary.
+  bool data_block_buffering = false;
+  size_t compression_dict_train_limit = 0;
+  std::vector<BufferedDataBlock> buffered_data_blocks;
+  size_t buffered_data_size = 0;
+  std::unique_ptr<ZSTDCompressionDict> compression_dict;
+
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
   yb::MemTrackerPtr mem_tracker;
@@ -386,6 +408,25 @@ BlockBasedTableBuilder::Rep::Rep(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
   }
 
+  // Buffered data blocks are added to the index after dictionary is trained, so we don't support
+  // index and filter builders that depend on data block offsets while keys are added.
+  if ((compression_type == kZSTD || compression_type == kZSTDNotFinalCompression) &&
+      compression_opts.max_dict_bytes > 0 && ZSTD_Supported() &&
+      filter_type != FilterType::kBlockBasedFilter &&
+      table_options.index_type != IndexType::kHashSearch) {
+    data_block_buffering = true;
+    compression_dict_train_limit = compression_opts.zstd_max_train_bytes > 0
+        ? compression_opts.zstd_max_train_bytes
+        : 100 * static_cast<size_t>(compression_opts.max_dict_bytes);
+  }
+
+  if (table_options.use_data_block_hash_index) {
+    // Reader uses filter policy stored in table properties to restore the same key extractor.
+    data_block_hash_index_key_extractor.emplace(filter_key_transformer);
+    data_block_builder.EnableHashIndex(
+        table_options.data_block_hash_index_util_ratio, &*data_block_hash_index_key_extractor);
+  }
+
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
   if (data_file != nullptr) {
@@ -498,12 +539,34 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
-  size_t data_block_size = 0;
 
-  if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+  if (r->data_block_buffering) {
+    if (!r->data_block_builder.empty()) {
+      const auto contents = r->data_block_builder.Finish();
+      r->buffered_data_size += contents.size();
+      r->buffered_data_blocks.push_back(Rep::BufferedDataBlock {
+        .contents = contents.ToBuffer(),
+        .last_key = r->last_key,
+        .next_block_first_key = next_block_first_key.ToBuffer(),
+      });
+      r->data_block_builder.Reset();
+    }
+    if (r->buffered_data_size >= r->compression_dict_train_limit) {
+      EnterUnbufferedState();
+    }
+    return;
   }
+
+  WriteDataBlock(r->data_block_builder.Finish(), &r->last_key, next_block_first_key);
+  r->data_block_builder.Reset();
+}
+
+void BlockBasedTableBuilder::WriteDataBlock(
+    const Slice& raw_block_contents, std::string* last_key, const Slice& next_block_first_key) {
+  Rep* const r = rep_;
+  size_t data_block_size = WriteBlock(
+      raw_block_contents, &r->data_pending_handle, r->data_writer.get(),
+      r->compression_dict.get());
   if (!ok()) return;
 
   if (!r->table_options.skip_table_builder_flush) {
@@ -526,7 +589,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -545,6 +608,38 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   }
 }
 
+void BlockBasedTableBuilder::EnterUnbufferedState() {
+  Rep* const r = rep_;
+  r->data_block_buffering = false;
+
+  std::string samples;
+  std::vector<size_t> sample_lengths;
+  samples.reserve(r->buffered_data_size);
+  sample_lengths.reserve(r->buffered_data_blocks.size());
+  for (const auto& block : r->buffered_data_blocks) {
+    samples.append(block.contents);
+    sample_lengths.push_back(block.contents.size());
+  }
+  auto dict = ZSTD_TrainDictionary(samples, sample_lengths, r->compression_opts.max_dict_bytes);
+  if (!dict.empty()) {
+    r->compression_dict = std::make_unique<ZSTDCompressionDict>(
+        std::move(dict), ZSTD_CompressionLevel(r->compression_opts));
+  } else {
+    // Not enough samples, for instance small file. Blocks are compressed without dictionary.
+    RLOG(InfoLogLevel::DEBUG_LEVEL, r->ioptions.info_log,
+        "Failed to train compression dictionary on %zu data blocks",
+        sample_lengths.size());
+  }
+
+  auto buffered_data_blocks = std::move(r->buffered_data_blocks);
+  r->buffered_data_blocks.clear();
+  r->buffered_data_size = 0;
+  for (auto& block : buffered_data_blocks) {
+    WriteDataBlock(block.contents, &block.last_key, block.next_block_first_key);
+    if (!ok()) return;
+  }
+}
+
 void BlockBasedTableBuilder::FlushFilterBlock(const Slice* const next_block_first_filter_key) {
   Rep* const r = rep_;
   assert(!r->closed);
@@ -583,7 +678,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     BlockHandle* handle,
-    FileWriterWithOffsetAndCachePrefix* writer_info) {
+    FileWriterWithOffsetAndCachePrefix* writer_info,
+    const ZSTDCompressionDict* compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -596,7 +692,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, &r->compressed_output, compression_dict);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -717,6 +813,9 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (r->data_block_buffering) {
+    EnterUnbufferedState();
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(nullptr);  // no more filter block
   }
@@ -743,6 +842,14 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && r->compression_dict) {
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(
+        r->compression_dict->raw(), kNoCompression, &compression_dict_block_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(block_based_table::kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -865,8 +972,9 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::TotalFileSize() const {
-  return rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
-      rep_->metadata_writer->offset;
+  // Buffered data blocks are taken into account, so output file is cut in time during compaction.
+  return (rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
+      rep_->metadata_writer->offset) + rep_->buffered_data_size;
 }
 
 uint64_t BlockBasedTableBuilder::BaseFileSize() const {
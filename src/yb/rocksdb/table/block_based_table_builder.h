@@ -41,6 +41,7 @@ class BlockBuilder;
 class BlockHandle;
 class WritableFile;
 struct BlockBasedTableOptions;
+class ZSTDCompressionDict;
 
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const uint64_t kLegacyBlockBasedTableMagicNumber;
@@ -115,8 +116,10 @@ class BlockBasedTableBuilder : public TableBuilder {
   size_t WriteBlock(BlockBuilder* block, BlockHandle* handle,
                     FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
+  // compression_dict is only used for data blocks.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const ZSTDCompressionDict* compression_dict = nullptr);
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -134,6 +137,15 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Write data block into disk and add it to the data index. Flushes data index blocks when needed.
+  // last_key is the last key of the data block, it could be shortened by the index builder.
+  void WriteDataBlock(
+      const Slice& raw_block_contents, std::string* last_key, const Slice& next_block_first_key);
+
+  // Train compression dictionary on buffered data blocks and write them into disk. Following data
+  // blocks are written directly.
+  void EnterUnbufferedState();
+
   // Flush the current filter block into disk. next_block_first_filter_key should be nullptr if this
   // is the last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
@@ -64,6 +64,9 @@ BlockBasedTableFactory::BlockBasedTableFactory(
   if (table_options_.index_block_restart_interval < 1) {
     table_options_.index_block_restart_interval = 1;
   }
+  if (table_options_.data_block_hash_index_util_ratio <= 0) {
+    table_options_.data_block_hash_index_util_ratio = 0.75;
+  }
 }
 
 Status BlockBasedTableFactory::NewTableReader(
@@ -139,6 +142,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  cache_filter_index: %d\n",
+           table_options_.cache_filter_index);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::to_underlying(table_options_.index_type));
   ret.append(buffer);
@@ -180,6 +186,18 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  use_data_block_hash_index: %d\n",
+           table_options_.use_data_block_hash_index);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_index_util_ratio: %lf\n",
+           table_options_.data_block_hash_index_util_ratio);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  auto_readahead_initial_size: %" ROCKSDB_PRIszt "\n",
+           table_options_.auto_readahead_initial_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  auto_readahead_max_size: %" ROCKSDB_PRIszt "\n",
+           table_options_.auto_readahead_max_size);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
@@ -26,6 +26,7 @@ namespace block_based_table {
 constexpr char kFilterBlockPrefix[] = "filter.";
 constexpr char kFullFilterBlockPrefix[] = "fullfilter.";
 constexpr char kFixedSizeFilterBlockPrefix[] = "fixedsizefilter.";
+constexpr char kCompressionDictBlock[] = "rocksdb.compression_dict";
 
 // Read the block identified by "handle" from "file".
 // The only relevant option is options.verify_checksums for now.
@@ -35,10 +36,11 @@ inline Status ReadBlockFromFile(
     RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
     const BlockHandle& handle, std::unique_ptr<Block>* result, Env* env,
     const std::shared_ptr<yb::MemTracker>& mem_tracker,
-    bool do_uncompress = true) {
+    bool do_uncompress = true,
+    const ZSTDUncompressionDict* zstd_dict = nullptr) {
   BlockContents contents;
   Status s = ReadBlockContents(file, footer, options, handle, &contents, env,
-                               mem_tracker, do_uncompress);
+                               mem_tracker, do_uncompress, zstd_dict);
   if (s.ok()) {
     result->reset(new Block(std::move(contents)));
   }
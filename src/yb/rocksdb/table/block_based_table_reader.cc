@@ -23,6 +23,8 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <algorithm>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -35,6 +37,7 @@
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/secondary_cache.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/block.h"
@@ -43,6 +46,8 @@
 #include "yb/rocksdb/table/block_based_table_internal.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
+#include "yb/rocksdb/table/block_readahead.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/filter_block.h"
 #include "yb/rocksdb/table/fixed_size_filter_block.h"
 #include "yb/rocksdb/table/format.h"
@@ -55,6 +60,7 @@
 #include "yb/rocksdb/table/two_level_iterator.h"
 #include "yb/rocksdb/table_properties.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
 #include "yb/rocksdb/util/statistics.h"
@@ -62,6 +68,7 @@
 
 #include "yb/util/atomic.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/cast.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/scope_exit.h"
@@ -93,6 +100,26 @@ void DeleteCachedEntry(const Slice& key, void* value) {
   delete entry;
 }
 
+// Returns contents of the cached data block for the secondary cache.
+Slice BlockContentsForSecondaryCache(void* value) {
+  auto* block = static_cast<Block*>(value);
+  return Slice(block->data(), block->size());
+}
+
+// Inserts uncompressed block to the block cache. Data blocks could be spilled to the secondary
+// cache when evicted.
+Status InsertBlockToCache(
+    Cache* block_cache, const Slice& key, const ReadOptions& read_options, Block* block,
+    BlockType block_type, Cache::Handle** handle, Statistics* statistics) {
+  if (block_type == BlockType::kData) {
+    return block_cache->InsertSpillable(
+        key, read_options.query_id, block, block->usable_size(), &DeleteCachedEntry<Block>,
+        &BlockContentsForSecondaryCache, handle, statistics);
+  }
+  return block_cache->Insert(key, read_options.query_id, block, block->usable_size(),
+                             &DeleteCachedEntry<Block>, handle, statistics);
+}
+
 // Release the cached entry and decrement its ref count.
 void ReleaseCachedEntry(void* arg, void* h) {
   Cache* cache = reinterpret_cast<Cache*>(arg);
@@ -158,22 +185,29 @@ struct BlockBasedTable::FileReaderWithCachePrefix {
 //  field `value` is the item we want to get.
 //  field `cache_handle` is the cache handle to the block cache. If the value
 //    was not read from cache, `cache_handle` will be nullptr.
+//  field `owns_value` is set when the value was created for this entry, but was not added to the
+//    block cache, for instance for kNoCacheQueryId. Such value is deleted by Release.
 template <class TValue>
 struct BlockBasedTable::CachableEntry {
-  CachableEntry(TValue* _value, Cache::Handle* _cache_handle)
-      : value(_value), cache_handle(_cache_handle) {}
+  CachableEntry(TValue* _value, Cache::Handle* _cache_handle, bool _owns_value = false)
+      : value(_value), cache_handle(_cache_handle), owns_value(_owns_value) {}
   CachableEntry() : CachableEntry(nullptr, nullptr) {}
   void Release(Cache* cache) {
     if (cache_handle) {
       cache->Release(cache_handle);
       value = nullptr;
       cache_handle = nullptr;
+    } else if (owns_value) {
+      delete value;
+      value = nullptr;
+      owns_value = false;
     }
   }
 
   TValue* value = nullptr;
   // if the entry is from the cache, cache_handle will be populated.
   Cache::Handle* cache_handle = nullptr;
+  bool owns_value = false;
 };
 
 struct BlockBasedTable::Rep {
@@ -235,6 +269,12 @@ struct BlockBasedTable::Rep {
   bool prefix_filtering = false;
   KeyValueEncodingFormat data_block_key_value_encoding_format =
       KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+  // Used to look up data block hash index, not set when key extractor used to build the index
+  // could not be determined.
+  std::optional<DataBlockHashIndexKeyExtractor> data_block_hash_index_key_extractor;
+  // Dictionary used to uncompress data blocks, set when the file was written with ZSTD dictionary
+  // compression.
+  std::unique_ptr<ZSTDUncompressionDict> compression_dict;
   // TODO(kailiu) It is very ugly to use internal key in table, since table
   // module should not be relying on db module. However to make things easier
   // and compatible with existing code, we introduce a wrapper that allows
@@ -243,11 +283,16 @@ struct BlockBasedTable::Rep {
 
   DataIndexLoadMode data_index_load_mode = static_cast<DataIndexLoadMode>(0);
   yb::MemTrackerPtr mem_tracker;
+
+  bool cache_filter_index() const {
+    return table_options.cache_filter_index && table_options.block_cache;
+  }
 };
 
-// BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
-// to BlockBasedTable. It is used by TwoLevelIterator and MultiLevelIterator to call BlockBasedTable
-// functions in order to check if prefix may match or to create a secondary iterator.
+// BlockEntryIteratorState is mostly an adapter to BlockBasedTable. It is used by TwoLevelIterator
+// and MultiLevelIterator to call BlockBasedTable functions in order to check if prefix may match
+// or to create a secondary iterator. The only state it stores is the readahead state for data
+// blocks, which tracks sequential block reads of the iterator that owns it.
 class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
  public:
   BlockEntryIteratorState(
@@ -257,9 +302,28 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         table_(table),
         read_options_(read_options),
         skip_filters_(skip_filters),
-        block_type_(block_type) {}
+        block_type_(block_type) {
+    const auto& table_options = table->rep_->table_options;
+    if (block_type == BlockType::kData && table_options.auto_readahead_max_size > 0) {
+      readahead_.emplace(
+          table_options.auto_readahead_initial_size, table_options.auto_readahead_max_size);
+      Cache* block_cache = table_options.block_cache.get();
+      if (block_cache) {
+        auto* block_reader = table->GetBlockReader(block_type);
+        // Only offset is used in the cache key, so the size of the block is not needed.
+        is_block_cached_ = [block_cache, block_reader](uint64_t block_offset) {
+          char cache_key[block_based_table::kCacheKeyBufferSize];
+          return block_cache->Contains(GetCacheKey(
+              block_reader->cache_key_prefix, BlockHandle(block_offset, 0), cache_key));
+        };
+      }
+    }
+  }
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (readahead_) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -278,6 +342,21 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+  std::optional<BlockReadahead> readahead_;
+  BlockReadahead::IsBlockCachedFunctor is_block_cached_;
+
+  void MaybeReadahead(const Slice& index_value) {
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      // Error will be reported by NewDataBlockIterator.
+      return;
+    }
+    auto* statistics = read_options_.statistics ? read_options_.statistics
+                                                : table_->rep_->ioptions.statistics;
+    readahead_->OnBlockRead(
+        handle, table_->GetBlockReader(block_type_)->reader.get(), statistics, is_block_cached_);
+  }
 };
 
 
@@ -436,6 +515,10 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   RETURN_NOT_OK(new_table->SetupFilter(meta_iter.get()));
 
+  new_table->SetupDataBlockHashIndexKeyExtractor();
+
+  RETURN_NOT_OK(new_table->ReadCompressionDictBlock(meta_iter.get()));
+
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
     if (table_options.cache_index_and_filter_blocks) {
@@ -457,9 +540,9 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
   if (prefetch_filter == PrefetchFilter::YES) {
     // pre-fetching of blocks is turned on
     // NOTE: Table reader objects are cached in table cache (table_cache.cc).
-    if (rep->filter_policy && rep->filter_type == FilterType::kFixedSizeFilter) {
-      // TODO: may be put it in block cache instead of table reader in case
-      // table_options.cache_index_and_filter_blocks is set?
+    // When filter index is cached, it is loaded on demand through the block cache.
+    if (rep->filter_policy && rep->filter_type == FilterType::kFixedSizeFilter &&
+        !rep->cache_filter_index()) {
       RETURN_NOT_OK(new_table->CreateFilterIndexReader(&rep->filter_index_reader));
     }
 
@@ -762,7 +845,8 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const ZSTDUncompressionDict* compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -778,6 +862,25 @@ Status BlockBasedTable::GetDataBlockFromCache(
           static_cast<Block*>(block_cache->Value(block->cache_handle));
       return s;
     }
+
+    // Secondary cache keeps uncompressed data blocks evicted from the block cache.
+    auto* secondary_cache = block_cache->secondary_cache();
+    std::unique_ptr<char[]> contents;
+    size_t size;
+    if (secondary_cache != nullptr && block_type == BlockType::kData &&
+        secondary_cache->Lookup(block_cache_key, &contents, &size)) {
+      block->value = new Block(BlockContents(
+          std::move(contents), size, /* cachable = */ true, kNoCompression, mem_tracker));
+      if (read_options.fill_cache) {
+        s = InsertBlockToCache(block_cache, block_cache_key, read_options, block->value,
+                               block_type, &block->cache_handle, statistics);
+        if (!s.ok()) {
+          delete block->value;
+          block->value = nullptr;
+        }
+      }
+      return s;
+    }
   }
 
   // If not found, search from the compressed block cache.
@@ -806,7 +909,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -814,9 +917,8 @@ Status BlockBasedTable::GetDataBlockFromCache(
     assert(block->value->compression_type() == kNoCompression);
     if (block_cache != nullptr && block->value->cachable() &&
         read_options.fill_cache) {
-      s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
-                              block->value->usable_size(), &DeleteCachedEntry<Block>,
-                              &block->cache_handle, statistics);
+      s = InsertBlockToCache(block_cache, block_cache_key, read_options, block->value,
+                             block_type, &block->cache_handle, statistics);
       if (!s.ok()) {
         delete block->value;
         block->value = nullptr;
@@ -834,7 +936,8 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    BlockType block_type, const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const ZSTDUncompressionDict* compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -843,7 +946,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -876,9 +979,8 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   assert((block->value->compression_type() == kNoCompression));
   if (block_cache != nullptr && block->value->cachable()) {
-    s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
-                            block->value->usable_size(),
-                            &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
+    s = InsertBlockToCache(block_cache, block_cache_key, read_options, block->value, block_type,
+                           &block->cache_handle, statistics);
     if (!s.ok()) {
       delete block->value;
       block->value = nullptr;
@@ -888,7 +990,8 @@ Status BlockBasedTable::PutDataBlockToCache(
   return s;
 }
 
-Status BlockBasedTable::CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) {
+Status BlockBasedTable::CreateFilterIndexReader(
+    std::unique_ptr<IndexReader>* filter_index_reader) const {
   auto base_file_reader = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
   auto footer = rep_->footer;
@@ -944,12 +1047,48 @@ FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_ha
   return nullptr;
 }
 
-Status BlockBasedTable::GetFixedSizeFilterBlockHandle(const Slice& filter_key,
+yb::Result<BlockBasedTable::CachableEntry<IndexReader>> BlockBasedTable::GetFilterIndexReader(
+    QueryId query_id) const {
+  if (!rep_->cache_filter_index()) {
+    RSTATUS_DCHECK(
+        rep_->filter_index_reader, IllegalState, "Filter index has not been pre-loaded");
+    return CachableEntry<IndexReader>{rep_->filter_index_reader.get(), /* cache_handle =*/ nullptr};
+  }
+
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  char cache_key[block_based_table::kCacheKeyBufferSize];
+  auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
+      rep_->filter_handle, cache_key);
+  Statistics* statistics = rep_->ioptions.statistics;
+  auto cache_handle = GetEntryFromCache(
+      block_cache, key, BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, query_id);
+  if (cache_handle != nullptr) {
+    return CachableEntry<IndexReader>{
+        static_cast<IndexReader*>(block_cache->Value(cache_handle)), cache_handle};
+  }
+
+  // Create filter index reader and put it in the cache.
+  std::unique_ptr<IndexReader> filter_index_reader;
+  RETURN_NOT_OK(CreateFilterIndexReader(&filter_index_reader));
+  RETURN_NOT_OK(block_cache->Insert(
+      key, query_id, filter_index_reader.get(), filter_index_reader->usable_size(),
+      &DeleteCachedEntry<IndexReader>, &cache_handle, statistics));
+  // Cache does not take ownership of the reader when it was not inserted, so it is released
+  // together with the entry.
+  return CachableEntry<IndexReader>{
+      filter_index_reader.release(), cache_handle, /* owns_value =*/ cache_handle == nullptr};
+}
+
+Status BlockBasedTable::GetFixedSizeFilterBlockHandle(QueryId query_id, const Slice& filter_key,
     BlockHandle* filter_block_handle) const {
+  auto filter_index = VERIFY_RESULT(GetFilterIndexReader(query_id));
+  auto se = yb::ScopeExit([this, &filter_index] {
+    filter_index.Release(rep_->table_options.block_cache.get());
+  });
   // Determine block of fixed-size bloom filter using filter index. It is expected `NewIterator()`
   // is reusing `fiter` and not creating a new iterator (multi-level index case).
   BlockIter fiter;
-  RSTATUS_DCHECK(!rep_->filter_index_reader->NewIterator(&fiter,
+  RSTATUS_DCHECK(!filter_index.value->NewIterator(&fiter,
       // Following parameters are ignored by BinarySearchIndexReader which we use as
       // filter_index_reader.
       /* index_iterator_state = */ nullptr, /* total_order_seek = */ true),
@@ -971,6 +1110,55 @@ Slice BlockBasedTable::GetFilterKeyFromInternalKey(const Slice &internal_key) co
   return GetFilterKeyFromUserKey(ExtractUserKey(internal_key));
 }
 
+Status BlockBasedTable::ReadCompressionDictBlock(InternalIterator* meta_iter) {
+  BlockHandle handle;
+  if (!FindMetaBlock(meta_iter, block_based_table::kCompressionDictBlock, &handle).ok()) {
+    // File was written without compression dictionary.
+    return Status::OK();
+  }
+  BlockContents contents;
+  RETURN_NOT_OK(ReadBlockContents(
+      rep_->base_reader_with_cache_prefix->reader.get(), rep_->footer, ReadOptions::kDefault,
+      handle, &contents, rep_->ioptions.env, rep_->mem_tracker, /* do_uncompress = */ false));
+  if (!ZSTD_Supported()) {
+    return STATUS(NotSupported,
+                  "File is compressed with ZSTD dictionary, but ZSTD is not supported");
+  }
+  rep_->compression_dict = std::make_unique<ZSTDUncompressionDict>(contents.data.ToBuffer());
+  return Status::OK();
+}
+
+const ZSTDUncompressionDict* BlockBasedTable::GetCompressionDict(BlockType block_type) const {
+  // Only data blocks are compressed with dictionary.
+  return block_type == BlockType::kData ? rep_->compression_dict.get() : nullptr;
+}
+
+void BlockBasedTable::SetupDataBlockHashIndexKeyExtractor() {
+  // Data block hash index is built using key transformer of the filter policy the file was written
+  // with, so lookups should use the same transformer even when filters are skipped for this reader.
+  if (!rep_->table_properties) {
+    return;
+  }
+  const auto& table_filter_policy_name = rep_->table_properties->filter_policy_name;
+  if (table_filter_policy_name.empty()) {
+    rep_->data_block_hash_index_key_extractor.emplace(nullptr);
+    return;
+  }
+  const FilterPolicy* table_filter_policy = nullptr;
+  const auto& filter_policy = rep_->table_options.filter_policy;
+  if (filter_policy && filter_policy->Name() == table_filter_policy_name) {
+    table_filter_policy = filter_policy.get();
+  } else if (const auto& policies = rep_->table_options.supported_filter_policies) {
+    const auto it = policies->find(table_filter_policy_name);
+    if (it != policies->end()) {
+      table_filter_policy = it->second.get();
+    }
+  }
+  if (table_filter_policy) {
+    rep_->data_block_hash_index_key_extractor.emplace(table_filter_policy->GetKeyTransformer());
+  }
+}
+
 Slice BlockBasedTable::GetFilterKeyFromUserKey(const Slice &user_key) const {
   return rep_->filter_key_transformer ?
       rep_->filter_key_transformer->Transform(user_key) : user_key;
@@ -1012,7 +1200,8 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
   // Determine filter block handle
   BlockHandle fixed_size_filter_block_handle;
   if (is_fixed_size_filter) {
-    Status s = GetFixedSizeFilterBlockHandle(*filter_key, &fixed_size_filter_block_handle);
+    Status s = GetFixedSizeFilterBlockHandle(
+        query_id, *filter_key, &fixed_size_filter_block_handle);
     if (s.ok()) {
       if (fixed_size_filter_block_handle.IsNull()) {
         // Key is beyond filter index - return stub filter.
@@ -1203,7 +1392,8 @@ yb::Result<BlockBasedTable::CachableEntry<Block>> BlockBasedTable::RetrieveBlock
 
     Status status = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, block_type, rep_->mem_tracker,
+        GetCompressionDict(block_type));
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1211,12 +1401,14 @@ yb::Result<BlockBasedTable::CachableEntry<Block>> BlockBasedTable::RetrieveBlock
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         RETURN_NOT_OK(block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr));
+            rep_->mem_tracker, block_cache_compressed == nullptr,
+            GetCompressionDict(block_type)));
       }
 
       RETURN_NOT_OK(PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                         ro, statistics, &block, raw_block.release(),
-                                        rep_->table_options.format_version, rep_->mem_tracker));
+                                        rep_->table_options.format_version, block_type,
+                                        rep_->mem_tracker, GetCompressionDict(block_type)));
       status = Status::OK();
     }
 
@@ -1236,7 +1428,7 @@ yb::Result<BlockBasedTable::CachableEntry<Block>> BlockBasedTable::RetrieveBlock
   std::unique_ptr<Block> block_value;
   RETURN_NOT_OK(block_based_table::ReadBlockFromFile(
       reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-      rep_->mem_tracker));
+      rep_->mem_tracker, /* do_uncompress = */ true, GetCompressionDict(block_type)));
 
   block.value = block_value.release();
   RSTATUS_DCHECK(block.value, Incomplete, "No data block"); // Not expected to happen.
@@ -1257,8 +1449,12 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   auto block = RetrieveBlock(ro, index_value, block_type);
   if (block) {
+    const auto& hash_index_key_extractor = rep_->data_block_hash_index_key_extractor;
     InternalIterator* iter = block->value->NewIterator(
-        rep_->comparator.get(), GetKeyValueEncodingFormat(block_type), input_iter);
+        rep_->comparator.get(), GetKeyValueEncodingFormat(block_type), input_iter,
+        /* total_order_seek = */ true,
+        block_type == BlockType::kData && hash_index_key_extractor ? &*hash_index_key_extractor
+                                                                   : nullptr);
     if (block->cache_handle) {
       Cache* block_cache = rep_->table_options.block_cache.get();
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache, block->cache_handle);
@@ -1540,6 +1736,142 @@ Status BlockBasedTable::Prefetch(const Slice* const begin,
   return Status::OK();
 }
 
+Status BlockBasedTable::PrefetchKeys(
+    const ReadOptions& read_options, const std::vector<Slice>& internal_keys) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  Cache* block_cache_compressed = rep_->table_options.block_cache_compressed.get();
+  // Without block cache there is nowhere to keep prefetched blocks.
+  if ((block_cache == nullptr && block_cache_compressed == nullptr) || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier || internal_keys.empty()) {
+    return Status::OK();
+  }
+
+  // Find data blocks that could contain keys.
+  std::vector<BlockHandle> handles;
+  {
+    const bool check_filter =
+        rep_->filter_policy && rep_->filter_type != FilterType::kBlockBasedFilter;
+    IndexIteratorHolder iiter_holder(this, read_options);
+    InternalIterator& iiter = *iiter_holder.iter();
+    RETURN_NOT_OK(iiter.status());
+
+    for (const auto& internal_key : internal_keys) {
+      if (check_filter) {
+        auto filter_key = GetFilterKeyFromInternalKey(internal_key);
+        if (!filter_key.empty()) {
+          auto filter_entry = GetFilter(read_options.query_id, /* no_io = */ false, &filter_key);
+          const bool may_match = NonBlockBasedFilterKeyMayMatch(filter_entry.value, filter_key);
+          filter_entry.Release(block_cache);
+          if (!may_match) {
+            continue;
+          }
+        }
+      }
+      iiter.Seek(internal_key);
+      if (!iiter.Valid()) {
+        RETURN_NOT_OK(iiter.status());
+        continue;
+      }
+      BlockHandle handle;
+      Slice input = iiter.value();
+      RETURN_NOT_OK(handle.DecodeFrom(&input));
+      handles.push_back(handle);
+    }
+  }
+
+  std::sort(handles.begin(), handles.end(), [](const BlockHandle& lhs, const BlockHandle& rhs) {
+    return lhs.offset() < rhs.offset();
+  });
+  handles.erase(
+      std::unique(handles.begin(), handles.end(),
+                  [](const BlockHandle& lhs, const BlockHandle& rhs) {
+                    return lhs.offset() == rhs.offset();
+                  }),
+      handles.end());
+
+  // Skip blocks that are already present in the cache.
+  FileReaderWithCachePrefix* reader = GetBlockReader(BlockType::kData);
+  // Contains is used instead of Lookup, so the probe is not counted as cache hit or miss, and
+  // does not move the block to multi touch cache. The following read does it.
+  auto is_cached = [](
+      Cache* cache, const block_based_table::CacheKeyPrefixBuffer& prefix,
+      const BlockHandle& handle) {
+    if (cache == nullptr) {
+      return false;
+    }
+    char cache_key[block_based_table::kCacheKeyBufferSize];
+    return cache->Contains(GetCacheKey(prefix, handle, cache_key));
+  };
+  handles.erase(
+      std::remove_if(handles.begin(), handles.end(), [&](const BlockHandle& handle) {
+        return is_cached(block_cache, reader->cache_key_prefix, handle) ||
+               is_cached(block_cache_compressed, reader->compressed_cache_key_prefix, handle);
+      }),
+      handles.end());
+  if (handles.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<std::unique_ptr<char[]>> buffers;
+  std::vector<yb::ReadRequest> requests;
+  buffers.reserve(handles.size());
+  requests.reserve(handles.size());
+  for (const auto& handle : handles) {
+    const size_t size = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+    buffers.emplace_back(new char[size]);
+    requests.push_back(yb::ReadRequest {
+      .offset = handle.offset(),
+      .length = size,
+      .scratch = pointer_cast<uint8_t*>(buffers.back().get()),
+      .result = Slice(),
+    });
+  }
+
+  Statistics* statistics = rep_->ioptions.statistics;
+  {
+    StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
+    RETURN_NOT_OK(reader->reader->MultiRead(requests.data(), requests.size()));
+  }
+
+  const auto* compression_dict = GetCompressionDict(BlockType::kData);
+  for (size_t i = 0; i != handles.size(); ++i) {
+    const auto& handle = handles[i];
+    BlockContents contents;
+    auto status = BlockContentsFromReadResult(
+        reader->reader.get(), rep_->footer, read_options, handle, requests[i].result, &buffers[i],
+        &contents, rep_->mem_tracker, /* do_uncompress = */ block_cache_compressed == nullptr,
+        compression_dict);
+    if (!status.ok()) {
+      // The block will be read again by the lookup, that will also report the failure.
+      LOG(WARNING) << "Failed to prefetch block " << handle.ToDebugString() << " of "
+                   << reader->reader->file()->filename() << ": " << status;
+      continue;
+    }
+
+    char cache_key[block_based_table::kCacheKeyBufferSize];
+    char compressed_cache_key[block_based_table::kCacheKeyBufferSize];
+    Slice key, ckey;
+    if (block_cache != nullptr) {
+      key = GetCacheKey(reader->cache_key_prefix, handle, cache_key);
+    }
+    if (block_cache_compressed != nullptr) {
+      ckey = GetCacheKey(reader->compressed_cache_key_prefix, handle, compressed_cache_key);
+    }
+    CachableEntry<Block> block;
+    RETURN_NOT_OK(PutDataBlockToCache(
+        key, ckey, block_cache, block_cache_compressed, read_options, statistics, &block,
+        new Block(std::move(contents)), rep_->table_options.format_version, BlockType::kData,
+        rep_->mem_tracker, compression_dict));
+    if (block.cache_handle) {
+      block.Release(block_cache);
+    } else {
+      delete block.value;
+    }
+  }
+
+  return Status::OK();
+}
+
 bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
                                       const Slice& key) {
   std::unique_ptr<InternalIterator> iiter(NewIndexIterator(options));
@@ -1959,6 +2291,14 @@ yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
       rep_->comparator.get(), MiddlePointPolicy::kMiddleHigh);
 }
 
+yb::Result<std::vector<std::string>> BlockBasedTable::GetKeyAnchors(size_t max_anchors) {
+  auto index_reader = VERIFY_RESULT(GetIndexReader(ReadOptions::kDefault));
+  auto se = yb::ScopeExit([this, &index_reader] {
+    index_reader.Release(rep_->table_options.block_cache.get());
+  });
+  return index_reader.value->GetKeyAnchors(max_anchors);
+}
+
 yb::Result<IndexReaderCleanablePtr> BlockBasedTable::TEST_GetIndexReader() {
   auto index_reader = VERIFY_RESULT(GetIndexReader(ReadOptions::kDefault));
   auto cache = rep_->table_options.block_cache;
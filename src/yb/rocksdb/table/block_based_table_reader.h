@@ -58,6 +58,7 @@ struct ReadOptions;
 class GetContext;
 class InternalIterator;
 class IndexReader;
+class ZSTDUncompressionDict;
 
 // Index reader special unique pointer to control the instance's way of deletion. Can be removed
 // when https://github.com/yugabyte/yugabyte-db/issues/4720 is resolved.
@@ -158,6 +159,9 @@ class BlockBasedTable : public TableReader {
   // IO or iteration error.
   Status Prefetch(const Slice* begin, const Slice* end) override;
 
+  Status PrefetchKeys(
+      const ReadOptions& read_options, const std::vector<Slice>& internal_keys) override;
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file).  The returned value is in terms of file
@@ -203,6 +207,8 @@ class BlockBasedTable : public TableReader {
 
   yb::Result<std::string> GetMiddleKey() override;
 
+  yb::Result<std::vector<std::string>> GetKeyAnchors(size_t max_anchors) override;
+
   // Helper function that force reading block from a file and takes care about block cleanup.
   yb::Result<std::unique_ptr<Block>> RetrieveBlockFromFile(const ReadOptions& ro,
       const Slice& index_value, BlockType block_type);
@@ -229,9 +235,13 @@ class BlockBasedTable : public TableReader {
   class IndexIteratorHolder;
 
   // Returns filter block handle for fixed-size bloom filter using filter index and filter key.
-  Status GetFixedSizeFilterBlockHandle(const Slice& filter_key,
+  Status GetFixedSizeFilterBlockHandle(QueryId query_id, const Slice& filter_key,
       BlockHandle* filter_block_handle) const;
 
+  // Returns index of fixed-size bloom filter blocks. It is either pre-loaded during table open or
+  // loaded on demand through the block cache when table_options.cache_filter_index is set.
+  yb::Result<CachableEntry<IndexReader>> GetFilterIndexReader(QueryId query_id) const;
+
   // Returns key to be added to filter or verified against filter based on internal_key.
   Slice GetFilterKeyFromInternalKey(const Slice &internal_key) const;
 
@@ -254,8 +264,8 @@ class BlockBasedTable : public TableReader {
   // - If read_options.read_tier != kBlockCacheTier: new index reader will be created and cached.
   yb::Result<CachableEntry<IndexReader>> GetIndexReader(const ReadOptions& read_options);
 
-  // Read block cache from block caches (if set): block_cache and
-  // block_cache_compressed.
+  // Read block cache from block caches (if set): block_cache, secondary cache of block_cache for
+  // data blocks, and block_cache_compressed.
   // On success, Status::OK with be returned and @block will be populated with
   // pointer to the block as well as its block handle.
   static Status GetDataBlockFromCache(
@@ -263,7 +273,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const ZSTDUncompressionDict* compression_dict = nullptr);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -278,7 +289,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      BlockType block_type, const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const ZSTDUncompressionDict* compression_dict = nullptr);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -303,6 +315,14 @@ class BlockBasedTable : public TableReader {
 
   Status SetupFilter(InternalIterator* meta_iter);
 
+  void SetupDataBlockHashIndexKeyExtractor();
+
+  // Reads compression dictionary used for data blocks, if present in the file.
+  Status ReadCompressionDictBlock(InternalIterator* meta_iter);
+
+  // Returns compression dictionary to uncompress blocks of specified type.
+  const ZSTDUncompressionDict* GetCompressionDict(BlockType block_type) const;
+
   // Read the meta block from sst.
   static Status ReadMetaBlock(
       Rep* rep, std::unique_ptr<Block>* meta_block, std::unique_ptr<InternalIterator>* iter);
@@ -312,7 +332,7 @@ class BlockBasedTable : public TableReader {
       size_t* filter_size = nullptr);
 
   // CreateFilterIndexReader from sst
-  Status CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader);
+  Status CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) const;
 
   // Helper function to setup the cache key's prefix for block of file passed within a reader
   // instance. Used for both data and metadata files.
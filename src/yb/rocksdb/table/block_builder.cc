@@ -44,6 +44,9 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// Data block could also contain hash index between restart array and num_restarts, in this case
+// the most significant bit of num_restarts is set (see data_block_hash_index.h).
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -73,6 +76,13 @@ BlockBuilder::BlockBuilder(
   restarts_.push_back(0);       // First restart point is at offset 0
 }
 
+void BlockBuilder::EnableHashIndex(
+    double util_ratio, const DataBlockHashIndexKeyExtractor* key_extractor) {
+  DCHECK(empty());
+  hash_index_builder_.emplace(util_ratio);
+  hash_index_key_extractor_ = key_extractor;
+}
+
 void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.clear();
@@ -80,6 +90,14 @@ void BlockBuilder::Reset() {
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  if (hash_index_builder_) {
+    hash_index_builder_->Reset();
+  }
+}
+
+bool BlockBuilder::ShouldWriteHashIndex() const {
+  return hash_index_builder_ && !hash_index_builder_->empty() &&
+         restarts_.size() <= kMaxRestartsForDataBlockHashIndex;
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
@@ -88,6 +106,9 @@ size_t BlockBuilder::CurrentSizeEstimate() const {
     // Restarts haven't been flushed to buffer yet.
     size += restarts_.size() * sizeof(uint32_t) +    // Restart array.
             sizeof(uint32_t);                        // Restart array length.
+    if (ShouldWriteHashIndex()) {
+      size += hash_index_builder_->EstimateSize();
+    }
   }
   return size;
 }
@@ -335,7 +356,12 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  auto num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (ShouldWriteHashIndex()) {
+    hash_index_builder_->Finish(&buffer_);
+    num_restarts |= kDataBlockHashIndexFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
@@ -399,6 +425,13 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
     }
   }
 
+  if (hash_index_builder_ && restarts_.size() <= kMaxRestartsForDataBlockHashIndex) {
+    auto hashed_key = hash_index_key_extractor_->Extract(key);
+    if (!hashed_key.empty()) {
+      hash_index_builder_->Add(hashed_key, static_cast<uint32_t>(restarts_.size() - 1));
+    }
+  }
+
   // Update state
   last_key_.resize(shared_prefix_size);
   last_key_.append(key.cdata() + shared_prefix_size, after_shared_prefix_size);
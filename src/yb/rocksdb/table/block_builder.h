@@ -24,9 +24,12 @@
 #pragma once
 
 #include <stdint.h>
+
+#include <optional>
 #include <vector>
 
 #include "yb/rocksdb/types.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 
 #include "yb/util/slice.h"
 
@@ -41,6 +44,12 @@ class BlockBuilder {
                         KeyValueEncodingFormat key_value_encoding_format,
                         bool use_delta_encoding = true);
 
+  // Enables building of hash index for blocks that have not more than
+  // kMaxRestartsForDataBlockHashIndex restart points, see data_block_hash_index.h.
+  // Should be used only for data blocks, since keys are expected to be internal keys.
+  // key_extractor should outlive the builder.
+  void EnableHashIndex(double util_ratio, const DataBlockHashIndexKeyExtractor* key_extractor);
+
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
 
@@ -77,6 +86,11 @@ class BlockBuilder {
   int                   counter_;   // Number of entries emitted since restart
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
+
+  std::optional<DataBlockHashIndexBuilder> hash_index_builder_;
+  const DataBlockHashIndexKeyExtractor* hash_index_key_extractor_ = nullptr;
+
+  bool ShouldWriteHashIndex() const;
 };
 
 }  // namespace rocksdb
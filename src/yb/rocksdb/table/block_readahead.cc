@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/block_readahead.h"
+
+#include <algorithm>
+
+#include "yb/rocksdb/util/statistics.h"
+#include "yb/rocksdb/table/format.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
+
+#include "yb/util/status_log.h"
+
+namespace rocksdb {
+
+BlockReadahead::BlockReadahead(size_t initial_size, size_t max_size)
+    : initial_size_(std::min(initial_size, max_size)), max_size_(max_size),
+      readahead_size_(initial_size_) {}
+
+void BlockReadahead::Reset() {
+  num_sequential_reads_ = 0;
+  readahead_size_ = initial_size_;
+  readahead_start_ = 0;
+  readahead_end_ = 0;
+}
+
+bool BlockReadahead::OnBlockRead(
+    const BlockHandle& handle, uint64_t* readahead_offset, size_t* readahead_length,
+    Statistics* statistics, const IsBlockCachedFunctor& is_block_cached) {
+  if (max_size_ == 0) {
+    return false;
+  }
+
+  const auto block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+  if (handle.offset() == next_block_offset_ && num_sequential_reads_ != 0) {
+    ++num_sequential_reads_;
+  } else {
+    if (readahead_end_ != 0) {
+      RecordTick(statistics, READAHEAD_RESETS);
+    }
+    Reset();
+    num_sequential_reads_ = 1;
+  }
+  next_block_offset_ = block_end;
+
+  if (num_sequential_reads_ < kMinSequentialReads) {
+    return false;
+  }
+
+  // Issue the next request when the iterator reaches the second half of the previous one, so
+  // the data is loaded before the iterator gets there.
+  if (block_end <= readahead_start_ + (readahead_end_ - readahead_start_) / 2) {
+    return false;
+  }
+
+  const auto offset = std::max(readahead_end_, block_end);
+  readahead_start_ = offset;
+  readahead_end_ = offset + readahead_size_;
+
+  // Sequential read goes over cached blocks, so the next window is considered loaded without
+  // issuing readahead. So block cache is probed once per window instead of once per block.
+  if (is_block_cached && is_block_cached(offset)) {
+    return false;
+  }
+
+  *readahead_offset = offset;
+  *readahead_length = readahead_size_;
+  readahead_size_ = std::min(readahead_size_ * 2, max_size_);
+
+  RecordTick(statistics, READAHEAD_REQUESTS);
+  RecordTick(statistics, READAHEAD_BYTES, *readahead_length);
+  return true;
+}
+
+void BlockReadahead::OnBlockRead(
+    const BlockHandle& handle, RandomAccessFileReader* reader, Statistics* statistics,
+    const IsBlockCachedFunctor& is_block_cached) {
+  uint64_t offset;
+  size_t length;
+  if (!OnBlockRead(handle, &offset, &length, statistics, is_block_cached)) {
+    return;
+  }
+  // Readahead is just a hint, so failure does not affect the read.
+  WARN_NOT_OK(reader->file()->Readahead(offset, length), "Readahead failed");
+}
+
+} // namespace rocksdb
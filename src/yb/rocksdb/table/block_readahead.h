@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+
+namespace rocksdb {
+
+class BlockHandle;
+class RandomAccessFileReader;
+class Statistics;
+
+// Detects sequential reads of blocks by a single iterator and initiates asynchronous readahead of
+// the following part of the file, so the iterator does not wait for the disk on each block.
+//
+// Readahead is started after kMinSequentialReads sequential block reads. Each readahead request
+// covers the range after the previously requested one, and the next request is issued when
+// the iterator reaches the second half of the previous one. Readahead size starts from
+// initial_size and doubles on each request up to max_size. Non sequential read resets the state.
+// Readahead is not issued when the block it would start from is already in the block cache, since
+// the iterator would not read it from the file. Such window is skipped as if it was loaded, so
+// the block cache is probed at most once per window. Blocks of such window that are missing in the
+// block cache are read without readahead.
+//
+// Not thread safe, should be owned by the iterator.
+class BlockReadahead {
+ public:
+  static constexpr size_t kMinSequentialReads = 2;
+
+  // Returns true if the block that starts at specified offset is present in the block cache.
+  using IsBlockCachedFunctor = std::function<bool(uint64_t block_offset)>;
+
+  BlockReadahead(size_t initial_size, size_t max_size);
+
+  // Should be called before reading the block with specified handle.
+  // Returns true and fills the range if readahead should be issued.
+  // is_block_cached is invoked with the offset readahead would start from, only when readahead
+  // would be issued. Could be empty when there is no block cache.
+  bool OnBlockRead(
+      const BlockHandle& handle, uint64_t* readahead_offset, size_t* readahead_length,
+      Statistics* statistics, const IsBlockCachedFunctor& is_block_cached = {});
+
+  // Same as above, but also issues readahead of the range via the file reader.
+  void OnBlockRead(
+      const BlockHandle& handle, RandomAccessFileReader* reader, Statistics* statistics,
+      const IsBlockCachedFunctor& is_block_cached = {});
+
+  size_t readahead_size() const {
+    return readahead_size_;
+  }
+
+ private:
+  void Reset();
+
+  const size_t initial_size_;
+  const size_t max_size_;
+
+  // End of the previously read block (including trailer), i.e. offset of the next block
+  // for sequential read.
+  uint64_t next_block_offset_ = 0;
+  size_t num_sequential_reads_ = 0;
+  size_t readahead_size_;
+  // File range [readahead_start_, readahead_end_) was requested by the last readahead.
+  uint64_t readahead_start_ = 0;
+  uint64_t readahead_end_ = 0;
+};
+
+} // namespace rocksdb
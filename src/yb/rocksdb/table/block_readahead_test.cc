@@ -0,0 +1,160 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "yb/rocksdb/table/block_readahead.h"
+
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/table/format.h"
+
+#include "yb/rocksdb/util/testutil.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr size_t kBlockSize = 4096 - kBlockTrailerSize;
+constexpr size_t kInitialSize = 16 * 1024;
+constexpr size_t kMaxSize = 64 * 1024;
+
+BlockHandle BlockAt(size_t index) {
+  return BlockHandle(index * (kBlockSize + kBlockTrailerSize), kBlockSize);
+}
+
+} // namespace
+
+class BlockReadaheadTest : public RocksDBTest {
+ protected:
+  // Returns readahead length, or 0 if no readahead was requested.
+  size_t Read(size_t block_index, uint64_t* offset = nullptr) {
+    uint64_t readahead_offset = 0;
+    size_t readahead_length = 0;
+    if (!readahead_.OnBlockRead(
+            BlockAt(block_index), &readahead_offset, &readahead_length, statistics_.get(),
+            [this](uint64_t block_offset) {
+              ++num_cache_probes_;
+              return block_offset < BlockAt(num_cached_blocks_).offset();
+            })) {
+      return 0;
+    }
+    if (offset) {
+      *offset = readahead_offset;
+    }
+    return readahead_length;
+  }
+
+  uint64_t Ticker(Tickers ticker) {
+    return statistics_->getTickerCount(ticker);
+  }
+
+  std::shared_ptr<Statistics> statistics_ = CreateDBStatisticsForTests();
+  BlockReadahead readahead_{kInitialSize, kMaxSize};
+  // Blocks with lower indexes are considered present in the block cache.
+  size_t num_cached_blocks_ = 0;
+  size_t num_cache_probes_ = 0;
+};
+
+TEST_F(BlockReadaheadTest, Sequential) {
+  ASSERT_EQ(Read(0), 0U);
+  uint64_t offset = 0;
+  ASSERT_EQ(Read(1, &offset), kInitialSize);
+  ASSERT_EQ(offset, BlockAt(2).offset());
+
+  // Next readahead is issued when the iterator reaches the second half of the previous one,
+  // size grows twice on each request until the max size.
+  size_t expected_size = kInitialSize;
+  uint64_t expected_offset = offset + kInitialSize;
+  size_t num_requests = 1;
+  for (size_t block = 2; block < 64; ++block) {
+    auto length = Read(block, &offset);
+    if (length == 0) {
+      continue;
+    }
+    ++num_requests;
+    expected_size = std::min(expected_size * 2, kMaxSize);
+    ASSERT_EQ(length, expected_size);
+    ASSERT_EQ(offset, expected_offset);
+    ASSERT_LT(BlockAt(block).offset(), offset);
+    expected_offset += length;
+  }
+  ASSERT_EQ(expected_size, kMaxSize);
+  ASSERT_EQ(Ticker(READAHEAD_REQUESTS), num_requests);
+  ASSERT_EQ(Ticker(READAHEAD_BYTES), expected_offset - BlockAt(2).offset());
+  ASSERT_EQ(Ticker(READAHEAD_RESETS), 0U);
+}
+
+TEST_F(BlockReadaheadTest, Reset) {
+  ASSERT_EQ(Read(0), 0U);
+  ASSERT_EQ(Read(1), kInitialSize);
+  for (size_t block = 2; block < 8; ++block) {
+    Read(block);
+  }
+  ASSERT_GT(readahead_.readahead_size(), kInitialSize);
+
+  // Random read resets readahead.
+  ASSERT_EQ(Read(100), 0U);
+  ASSERT_EQ(readahead_.readahead_size(), kInitialSize);
+  ASSERT_EQ(Ticker(READAHEAD_RESETS), 1U);
+
+  // Readahead starts again after sequential reads.
+  uint64_t offset = 0;
+  ASSERT_EQ(Read(101, &offset), kInitialSize);
+  ASSERT_EQ(offset, BlockAt(102).offset());
+
+  // Backward reads are not considered sequential.
+  ASSERT_EQ(Read(50), 0U);
+  ASSERT_EQ(Read(49), 0U);
+  ASSERT_EQ(Ticker(READAHEAD_RESETS), 2U);
+}
+
+TEST_F(BlockReadaheadTest, CachedBlocks) {
+  constexpr size_t kBlocksPerWindow = kInitialSize / (kBlockSize + kBlockTrailerSize);
+  constexpr size_t kCachedWindows = 3;
+  // First readahead window starts after kMinSequentialReads blocks.
+  num_cached_blocks_ = BlockReadahead::kMinSequentialReads + kCachedWindows * kBlocksPerWindow;
+  size_t block = 0;
+  uint64_t offset = 0;
+  size_t length = 0;
+  while ((length = Read(block, &offset)) == 0) {
+    ++block;
+    ASSERT_LT(block, num_cached_blocks_);
+  }
+
+  // Readahead starts before the iterator reaches the first not cached block.
+  ASSERT_EQ(length, kInitialSize);
+  ASSERT_EQ(offset, BlockAt(num_cached_blocks_).offset());
+  ASSERT_EQ(Ticker(READAHEAD_REQUESTS), 1U);
+  ASSERT_EQ(Ticker(READAHEAD_RESETS), 0U);
+
+  // Cached windows are skipped, so the block cache is probed once per window.
+  ASSERT_EQ(num_cache_probes_, kCachedWindows + 1);
+}
+
+TEST_F(BlockReadaheadTest, Disabled) {
+  BlockReadahead readahead(kInitialSize, 0);
+  uint64_t offset;
+  size_t length;
+  for (size_t block = 0; block < 16; ++block) {
+    ASSERT_FALSE(readahead.OnBlockRead(BlockAt(block), &offset, &length, nullptr));
+  }
+}
+
+} // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -34,6 +34,7 @@
 #include "yb/rocksdb/table/block_builder_internal.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_internal.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testutil.h"
 
@@ -852,6 +853,118 @@ TEST_F(BlockTest, IterPerfDisabledDeltaEncoding) {
   TestBlockScanPerf(KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts, true);
 }
 
+namespace {
+
+// Uses the first kHashedPrefixSize bytes of user key as hashed part of the key.
+class FixedPrefixKeyTransformer : public FilterPolicy::KeyTransformer {
+ public:
+  static constexpr size_t kHashedPrefixSize = 6;
+
+  Slice Transform(Slice key) const override {
+    return key.size() < kHashedPrefixSize ? Slice() : key.Prefix(kHashedPrefixSize);
+  }
+};
+
+std::string MakeInternalKey(const std::string& user_key) {
+  return InternalKey(user_key, /* seq = */ 1, kTypeValue).Encode().ToBuffer();
+}
+
+// Builds block with and without hash index and checks that Seek for all targets returns the same
+// result in both cases.
+void TestDataBlockHashIndex(
+    KeyValueEncodingFormat key_value_encoding_format, int restart_interval, int num_prefixes,
+    int keys_per_prefix, const FilterPolicy::KeyTransformer* key_transformer,
+    bool expect_hash_index) {
+  InternalKeyComparator comparator(BytewiseComparator());
+  DataBlockHashIndexKeyExtractor key_extractor(key_transformer);
+
+  std::vector<std::string> targets;
+  BlockBuilder plain_builder(restart_interval, key_value_encoding_format);
+  BlockBuilder hash_builder(restart_interval, key_value_encoding_format);
+  hash_builder.EnableHashIndex(/* util_ratio = */ 0.75, &key_extractor);
+  for (int prefix = 0; prefix < num_prefixes; ++prefix) {
+    // Only even prefixes are present in block.
+    const auto prefix_str = StringPrintf("p%05d", prefix * 2);
+    targets.push_back(MakeInternalKey(prefix_str));
+    for (int i = 0; i < keys_per_prefix; ++i) {
+      const auto key = MakeInternalKey(yb::Format("$0_$1", prefix_str, 10 + i * 2));
+      const auto value = yb::Format("value_$0_$1", prefix, i);
+      plain_builder.Add(key, value);
+      hash_builder.Add(key, value);
+      targets.push_back(key);
+      targets.push_back(MakeInternalKey(yb::Format("$0_$1", prefix_str, 11 + i * 2)));
+    }
+    targets.push_back(MakeInternalKey(StringPrintf("p%05d", prefix * 2 + 1)));
+  }
+  targets.push_back(MakeInternalKey("a"));
+  targets.push_back(MakeInternalKey("z"));
+
+  auto make_block = [](BlockBuilder* builder) {
+    BlockContents contents;
+    contents.data = builder->Finish();
+    contents.cachable = false;
+    return std::make_unique<Block>(std::move(contents));
+  };
+  auto plain_block = make_block(&plain_builder);
+  auto hash_block = make_block(&hash_builder);
+  ASSERT_EQ(plain_block->NumRestarts(), hash_block->NumRestarts());
+  ASSERT_EQ(expect_hash_index, hash_block->size() > plain_block->size());
+
+  std::unique_ptr<InternalIterator> plain_iter(
+      plain_block->NewIterator(&comparator, key_value_encoding_format));
+  std::unique_ptr<InternalIterator> hash_iter(hash_block->NewIterator(
+      &comparator, key_value_encoding_format, /* iter = */ nullptr,
+      /* total_order_seek = */ true, &key_extractor));
+  for (const auto& target : targets) {
+    plain_iter->Seek(target);
+    hash_iter->Seek(target);
+    ASSERT_OK(hash_iter->status());
+    ASSERT_EQ(plain_iter->Valid(), hash_iter->Valid()) << Slice(target).ToDebugHexString();
+    if (plain_iter->Valid()) {
+      ASSERT_EQ(plain_iter->key(), hash_iter->key()) << Slice(target).ToDebugHexString();
+      ASSERT_EQ(plain_iter->value(), hash_iter->value()) << Slice(target).ToDebugHexString();
+    }
+  }
+
+  // Block with hash index should be readable without using the index.
+  std::unique_ptr<InternalIterator> iter(
+      hash_block->NewIterator(&comparator, key_value_encoding_format));
+  plain_iter->SeekToFirst();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), plain_iter->Next()) {
+    ASSERT_TRUE(plain_iter->Valid());
+    ASSERT_EQ(plain_iter->key(), iter->key());
+  }
+  ASSERT_FALSE(plain_iter->Valid());
+}
+
+} // namespace
+
+TEST_F(BlockTest, DataBlockHashIndex) {
+  FixedPrefixKeyTransformer key_transformer;
+  for (auto key_value_encoding_format : KeyValueEncodingFormatList()) {
+    for (int num_keys : {200, 400}) {
+      for (int restart_interval : {1, 4, 16}) {
+        for (int keys_per_prefix : {1, 3, 20}) {
+          SCOPED_TRACE(yb::Format(
+              "format: $0, num_keys: $1, restart_interval: $2, keys_per_prefix: $3",
+              key_value_encoding_format, num_keys, restart_interval, keys_per_prefix));
+          const int num_prefixes = num_keys / keys_per_prefix;
+          // Hash index is not written for blocks with too many restart points.
+          const bool expect_hash_index =
+              (num_prefixes * keys_per_prefix + restart_interval - 1) / restart_interval <=
+              static_cast<int>(kMaxRestartsForDataBlockHashIndex);
+          ASSERT_NO_FATALS(TestDataBlockHashIndex(
+              key_value_encoding_format, restart_interval, num_prefixes, keys_per_prefix,
+              &key_transformer, expect_hash_index));
+          ASSERT_NO_FATALS(TestDataBlockHashIndex(
+              key_value_encoding_format, restart_interval, num_prefixes, keys_per_prefix,
+              /* key_transformer = */ nullptr, expect_hash_index));
+        }
+      }
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
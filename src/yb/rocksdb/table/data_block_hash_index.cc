@@ -0,0 +1,111 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/data_block_hash_index.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr uint32_t kDataBlockHashIndexSeed = 0x5bd1e995;
+
+inline uint32_t DataBlockHash(Slice hashed_key) {
+  return Hash(hashed_key.cdata(), hashed_key.size(), kDataBlockHashIndexSeed);
+}
+
+} // namespace
+
+Slice DataBlockHashIndexKeyExtractor::Extract(Slice internal_key) const {
+  auto user_key = ExtractUserKey(internal_key);
+  return key_transformer_ ? key_transformer_->Transform(user_key) : user_key;
+}
+
+DataBlockHashIndexBuilder::DataBlockHashIndexBuilder(double util_ratio)
+    : util_ratio_(util_ratio) {
+  DCHECK_GT(util_ratio_, 0);
+}
+
+void DataBlockHashIndexBuilder::Add(Slice hashed_key, uint32_t restart_index) {
+  DCHECK_LT(restart_index, kMaxRestartsForDataBlockHashIndex);
+  // Only the first key with the same hashed part should be indexed.
+  if (!entries_.empty() && hashed_key == last_hashed_key_) {
+    return;
+  }
+  entries_.push_back(Entry {
+    .hash = DataBlockHash(hashed_key),
+    .restart_index = static_cast<uint8_t>(restart_index),
+  });
+  last_hashed_key_.assign(hashed_key.cdata(), hashed_key.size());
+}
+
+size_t DataBlockHashIndexBuilder::NumBuckets() const {
+  auto num_buckets = static_cast<size_t>(entries_.size() / util_ratio_);
+  // Odd number of buckets provides better distribution of hashes.
+  return std::min<size_t>(
+      std::max<size_t>(num_buckets, 1) | 1, std::numeric_limits<uint16_t>::max());
+}
+
+size_t DataBlockHashIndexBuilder::EstimateSize() const {
+  return NumBuckets() + sizeof(uint16_t);
+}
+
+void DataBlockHashIndexBuilder::Finish(std::string* buffer) const {
+  const auto num_buckets = NumBuckets();
+  const auto buckets_start = buffer->size();
+  buffer->append(num_buckets, static_cast<char>(kDataBlockHashIndexNoEntry));
+  auto* buckets = pointer_cast<uint8_t*>(buffer->data() + buckets_start);
+  for (const auto& entry : entries_) {
+    auto& bucket = buckets[entry.hash % num_buckets];
+    if (bucket == kDataBlockHashIndexNoEntry) {
+      bucket = entry.restart_index;
+    } else if (bucket != entry.restart_index) {
+      bucket = kDataBlockHashIndexCollision;
+    }
+  }
+  PutFixed16(buffer, static_cast<uint16_t>(num_buckets));
+}
+
+void DataBlockHashIndexBuilder::Reset() {
+  entries_.clear();
+  last_hashed_key_.clear();
+}
+
+bool DataBlockHashIndex::Initialize(const char* data, size_t size, size_t* index_size) {
+  if (size < sizeof(uint16_t)) {
+    return false;
+  }
+  const auto num_buckets = DecodeFixed16(data + size - sizeof(uint16_t));
+  *index_size = num_buckets + sizeof(uint16_t);
+  if (num_buckets == 0 || *index_size > size) {
+    return false;
+  }
+  buckets_ = pointer_cast<const uint8_t*>(data + size - *index_size);
+  num_buckets_ = num_buckets;
+  return true;
+}
+
+uint8_t DataBlockHashIndex::Lookup(Slice hashed_key) const {
+  DCHECK(valid());
+  return buckets_[DataBlockHash(hashed_key) % num_buckets_];
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,116 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/filter_policy.h"
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+// Data block hash index maps hashed part of the key to the index of the restart interval, that
+// contains the first key with such hashed part. So point lookup inside data block does not need
+// binary search over restart points.
+//
+// Hash index is appended after the restart array of data block:
+// +----------------------------------------------------------------------------+
+// | entries | restarts : uint32[num_restarts] | buckets : uint8[num_buckets]    |
+// +----------------------------------------------------------------------------+
+// | num_buckets : uint16 | num_restarts | kDataBlockHashIndexFlag : uint32      |
+// +----------------------------------------------------------------------------+
+// Each bucket contains restart index, kNoEntry when no key is mapped to the bucket or kCollision
+// when keys from different restart intervals are mapped to the bucket.
+// Since restart index is stored in single byte, hash index is not built for blocks with more than
+// kMaxRestartsForDataBlockHashIndex restart points.
+//
+// Hashed part of the key is provided by DataBlockHashIndexKeyExtractor. Keys with the same hashed
+// part should form contiguous range, so the first key with a hashed part found via the index is a
+// valid starting point for a seek to any key with the same hashed part.
+constexpr uint32_t kDataBlockHashIndexFlag = 1U << 31;
+constexpr uint8_t kDataBlockHashIndexNoEntry = 255;
+constexpr uint8_t kDataBlockHashIndexCollision = 254;
+constexpr uint32_t kMaxRestartsForDataBlockHashIndex = 253;
+
+// Extracts part of the key hashed by data block hash index. Whole user key is hashed when key
+// transformer is not specified. Keys with empty hashed part are not indexed.
+class DataBlockHashIndexKeyExtractor {
+ public:
+  explicit DataBlockHashIndexKeyExtractor(const FilterPolicy::KeyTransformer* key_transformer)
+      : key_transformer_(key_transformer) {}
+
+  Slice Extract(Slice internal_key) const;
+
+ private:
+  const FilterPolicy::KeyTransformer* const key_transformer_;
+};
+
+class DataBlockHashIndexBuilder {
+ public:
+  explicit DataBlockHashIndexBuilder(double util_ratio);
+
+  // Adds hashed part of key that belongs to the specified restart interval.
+  // Hashed parts are expected to be added in the order of keys.
+  void Add(Slice hashed_key, uint32_t restart_index);
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  // Returns estimated size of the hash index, including the num_buckets field.
+  size_t EstimateSize() const;
+
+  // Appends buckets and num_buckets to the buffer.
+  void Finish(std::string* buffer) const;
+
+  void Reset();
+
+ private:
+  size_t NumBuckets() const;
+
+  struct Entry {
+    uint32_t hash;
+    uint8_t restart_index;
+  };
+
+  const double util_ratio_;
+  std::vector<Entry> entries_;
+  std::string last_hashed_key_;
+};
+
+class DataBlockHashIndex {
+ public:
+  // Initializes index stored at the end of [data, data + size), i.e. block data without the
+  // trailing num_restarts field. Sets index_size to the number of bytes occupied by the index.
+  // Returns false when data is corrupted.
+  bool Initialize(const char* data, size_t size, size_t* index_size);
+
+  bool valid() const {
+    return num_buckets_ != 0;
+  }
+
+  // Returns restart index for the specified hashed key, kDataBlockHashIndexNoEntry or
+  // kDataBlockHashIndexCollision.
+  uint8_t Lookup(Slice hashed_key) const;
+
+ private:
+  const uint8_t* buckets_ = nullptr;
+  uint16_t num_buckets_ = 0;
+};
+
+}  // namespace rocksdb
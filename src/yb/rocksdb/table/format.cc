@@ -346,6 +346,22 @@ Status VerifyBlockChecksum(
   return Status::OK();
 }
 
+Status ValidateBlockReadResult(
+    RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
+    const BlockHandle& handle, const Slice& read_result) {
+  const size_t expected_read_size = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+  if (read_result.size() != expected_read_size) {
+    return STATUS_FORMAT(
+        Corruption, "Truncated block read in file: $0, block handle: $1, expected size: $2",
+        file->file()->filename(), handle.ToDebugString(), expected_read_size);
+  }
+
+  if (options.verify_checksums) {
+    return VerifyBlockChecksum(file, footer, handle, read_result.cdata(), handle.size());
+  }
+  return Status::OK();
+}
+
 // Read a block and check its CRC. When this function returns, *contents will contain the result of
 // reading.
 Status ReadBlock(
@@ -359,32 +375,21 @@ Status ReadBlock(
     struct BlockChecksumValidator : public yb::ReadValidator {
       BlockChecksumValidator(
           RandomAccessFileReader* file_, const Footer& footer_, const ReadOptions& options_,
-          const BlockHandle& handle_, size_t expected_read_size_)
+          const BlockHandle& handle_)
           : file(file_),
             footer(footer_),
             options(options_),
-            handle(handle_),
-            expected_read_size(expected_read_size_) {}
+            handle(handle_) {}
 
       Status Validate(const Slice& read_result) const override {
-        if (read_result.size() != expected_read_size) {
-          return STATUS_FORMAT(
-              Corruption, "Truncated block read in file: $0, block handle: $1, expected size: $2",
-              file->file()->filename(), handle.ToDebugString(), expected_read_size);
-        }
-
-        if (options.verify_checksums) {
-          return VerifyBlockChecksum(file, footer, handle, read_result.cdata(), handle.size());
-        }
-        return Status::OK();
+        return ValidateBlockReadResult(file, footer, options, handle, read_result);
       };
 
       RandomAccessFileReader* file;
       const Footer& footer;
       const ReadOptions& options;
       const BlockHandle& handle;
-      const size_t expected_read_size;
-    } validator(file, footer, options, handle, expected_read_size);
+    } validator(file, footer, options, handle);
 
     s = file->ReadAndValidate(handle.offset(), expected_read_size, contents, buf, validator);
   }
@@ -439,7 +444,8 @@ BlockContents::BlockContents(
 Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
                          const ReadOptions& options, const BlockHandle& handle,
                          BlockContents* contents, Env* env,
-                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested) {
+                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+                         const ZSTDUncompressionDict* zstd_dict) {
   Status status;
   Slice slice;
   size_t n = static_cast<size_t>(handle.size());
@@ -470,7 +476,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
   compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
 
   if (decompression_requested && compression_type != kNoCompression) {
-    return UncompressBlockContents(slice.cdata(), n, contents, footer.version(), mem_tracker);
+    return UncompressBlockContents(
+        slice.cdata(), n, contents, footer.version(), mem_tracker, zstd_dict);
   }
 
   if (slice.cdata() != used_buf) {
@@ -487,6 +494,34 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
   return status;
 }
 
+Status BlockContentsFromReadResult(
+    RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
+    const BlockHandle& handle, const Slice& read_result, std::unique_ptr<char[]>* buf,
+    BlockContents* contents, const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+    const ZSTDUncompressionDict* zstd_dict) {
+  RETURN_NOT_OK(ValidateBlockReadResult(file, footer, options, handle, read_result));
+
+  PERF_COUNTER_ADD(block_read_count, 1);
+  PERF_COUNTER_ADD(block_read_byte, read_result.size());
+  PERF_TIMER_GUARD(block_decompress_time);
+
+  const size_t n = static_cast<size_t>(handle.size());
+  const auto compression_type = static_cast<rocksdb::CompressionType>(read_result.data()[n]);
+
+  if (decompression_requested && compression_type != kNoCompression) {
+    return UncompressBlockContents(
+        read_result.cdata(), n, contents, footer.version(), mem_tracker, zstd_dict);
+  }
+
+  if (read_result.cdata() != buf->get()) {
+    *contents = BlockContents(Slice(read_result.data(), n), false, compression_type);
+    return Status::OK();
+  }
+
+  *contents = BlockContents(std::move(*buf), n, true, compression_type, mem_tracker);
+  return Status::OK();
+}
+
 //
 // The 'data' points to the raw block contents that was read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -497,7 +532,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
 Status UncompressBlockContents(const char* data, size_t n,
                                BlockContents* contents,
                                uint32_t format_version,
-                               const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+                               const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                               const ZSTDUncompressionDict* zstd_dict) {
   std::unique_ptr<char[]> ubuf;
   int decompress_size = 0;
   assert(data[n] != kNoCompression);
@@ -564,9 +600,9 @@ Status UncompressBlockContents(const char* data, size_t n,
       *contents =
           BlockContents(std::move(ubuf), decompress_size, true, kNoCompression, mem_tracker);
       break;
+    case kZSTD:
     case kZSTDNotFinalCompression:
-      ubuf =
-          std::unique_ptr<char[]>(ZSTD_Uncompress(data, n, &decompress_size));
+      ubuf = std::unique_ptr<char[]>(ZSTD_Uncompress(data, n, &decompress_size, zstd_dict));
       if (!ubuf) {
         static char zstd_corrupt_msg[] =
             "ZSTD not supported or corrupted ZSTD compressed block contents";
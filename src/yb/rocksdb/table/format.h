@@ -40,6 +40,7 @@ namespace rocksdb {
 
 class Block;
 struct ReadOptions;
+class ZSTDUncompressionDict;
 
 // the length of the magic number in bytes.
 const int kMagicNumberLengthByte = 8;
@@ -249,13 +250,30 @@ struct BlockContents {
 
 // Read the block identified by "handle" from "file".  On failure
 // return non-OK.  On success fill *result and return OK.
+// zstd_dict is used to uncompress blocks compressed with ZSTD dictionary, i.e. data blocks of SST
+// file that has compression dictionary meta block.
 extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const Footer& footer,
                                 const ReadOptions& options,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const ZSTDUncompressionDict* zstd_dict = nullptr);
+
+// Fills contents from the result of reading the block with handle (including trailer) into buf,
+// after validating it. Used when the block was read by the caller, e.g. as a part of the batch.
+// Takes ownership of buf if contents refer to it.
+extern Status BlockContentsFromReadResult(RandomAccessFileReader* file,
+                                          const Footer& footer,
+                                          const ReadOptions& options,
+                                          const BlockHandle& handle,
+                                          const Slice& read_result,
+                                          std::unique_ptr<char[]>* buf,
+                                          BlockContents* contents,
+                                          const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                          bool do_uncompress,
+                                          const ZSTDUncompressionDict* zstd_dict = nullptr);
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -267,7 +285,8 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const ZSTDUncompressionDict* zstd_dict = nullptr);
 
 // Implementation details follow.  Clients should ignore,
 
@@ -44,6 +44,10 @@ Result<std::string> BinarySearchIndexReader::GetMiddleKey() const {
   return index_block_->GetMiddleKey(kIndexBlockKeyValueEncodingFormat);
 }
 
+Result<std::vector<std::string>> BinarySearchIndexReader::GetKeyAnchors(size_t max_anchors) const {
+  return index_block_->GetRestartKeys(max_anchors, kIndexBlockKeyValueEncodingFormat);
+}
+
 Status HashIndexReader::Create(const SliceTransform* hash_key_extractor,
                        const Footer& footer, RandomAccessFileReader* file,
                        Env* env, const ComparatorPtr& comparator,
@@ -133,6 +137,10 @@ Result<std::string> HashIndexReader::GetMiddleKey() const {
   return index_block_->GetMiddleKey(kIndexBlockKeyValueEncodingFormat);
 }
 
+Result<std::vector<std::string>> HashIndexReader::GetKeyAnchors(size_t max_anchors) const {
+  return index_block_->GetRestartKeys(max_anchors, kIndexBlockKeyValueEncodingFormat);
+}
+
 class MultiLevelIterator final : public InternalIterator {
  public:
   static constexpr auto kIterChainInitialCapacity = 4;
@@ -318,4 +326,10 @@ Result<std::string> MultiLevelIndexReader::GetMiddleKey() const {
   return middle_key;
 }
 
+Result<std::vector<std::string>> MultiLevelIndexReader::GetKeyAnchors(size_t max_anchors) const {
+  // Top level index entries point to the lower level index blocks, so the anchors are coarser than
+  // for single level index, but it does not require reading the lower levels.
+  return top_level_index_block_->GetRestartKeys(max_anchors, kIndexBlockKeyValueEncodingFormat);
+}
+
 } // namespace rocksdb
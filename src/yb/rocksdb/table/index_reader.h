@@ -61,6 +61,10 @@ class IndexReader {
   // written into the index (see ShortenedIndexBuilder).
   virtual Result<std::string> GetMiddleKey() const = 0;
 
+  // Returns up to max_anchors keys from the index, evenly spread over the SST file. The same
+  // remark as for GetMiddleKey applies: keys might not match any key written to SST file.
+  virtual Result<std::vector<std::string>> GetKeyAnchors(size_t max_anchors) const = 0;
+
   // The size of the index.
   virtual size_t size() const = 0;
   // Memory usage of the index block
@@ -113,6 +117,8 @@ class BinarySearchIndexReader : public IndexReader {
 
   Result<std::string> GetMiddleKey() const override;
 
+  Result<std::vector<std::string>> GetKeyAnchors(size_t max_anchors) const override;
+
  private:
   BinarySearchIndexReader(const ComparatorPtr& comparator,
                           std::unique_ptr<Block>&& index_block)
@@ -159,6 +165,8 @@ class HashIndexReader : public IndexReader {
 
   Result<std::string> GetMiddleKey() const override;
 
+  Result<std::vector<std::string>> GetKeyAnchors(size_t max_anchors) const override;
+
  private:
   HashIndexReader(const ComparatorPtr& comparator, std::unique_ptr<Block>&& index_block)
       : IndexReader(comparator), index_block_(std::move(index_block)) {
@@ -200,6 +208,8 @@ class MultiLevelIndexReader : public IndexReader {
 
   Result<std::string> GetMiddleKey() const override;
 
+  Result<std::vector<std::string>> GetKeyAnchors(size_t max_anchors) const override;
+
   uint32_t TEST_GetNumLevels() const {
     return num_levels_;
   }
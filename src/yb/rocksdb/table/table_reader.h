@@ -24,6 +24,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "yb/rocksdb/status.h"
 
@@ -113,6 +115,15 @@ class TableReader {
     return Status::OK();
   }
 
+  // Loads data blocks that could contain specified internal keys into the block cache, so the
+  // following point lookups of these keys don't wait for IO. Blocks missing in the cache are read
+  // by a single batched read, so the reads could be performed in parallel.
+  virtual Status PrefetchKeys(const ReadOptions& read_options,
+                              const std::vector<Slice>& internal_keys) {
+    // Default implementation is NOOP.
+    return Status::OK();
+  }
+
   // convert db file to a human readable form
   virtual Status DumpTable(WritableFile* out_file) {
     return STATUS(NotSupported, "DumpTable() not supported");
@@ -123,6 +134,12 @@ class TableReader {
   virtual yb::Result<std::string> GetMiddleKey() {
     return STATUS(NotSupported, "GetMiddleKey() not supported");
   }
+
+  // Returns up to max_anchors approximate keys, sorted and evenly spread over the SST file.
+  // Used to split the key range of compaction into the parts of the similar size.
+  virtual yb::Result<std::vector<std::string>> GetKeyAnchors(size_t max_anchors) {
+    return STATUS(NotSupported, "GetKeyAnchors() not supported");
+  }
 };
 
 }  // namespace rocksdb
@@ -66,6 +66,7 @@
 #include "yb/rocksdb/util/testutil.h"
 
 #include "yb/util/enums.h"
+#include "yb/util/format.h"
 #include "yb/util/string_util.h"
 #include "yb/util/test_macros.h"
 
@@ -334,7 +335,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get());
@@ -635,6 +636,8 @@ static std::vector<TestArgs> GenerateArgList() {
   if (ZSTD_Supported()) {
     compression_types.emplace_back(kZSTDNotFinalCompression, false);
     compression_types.emplace_back(kZSTDNotFinalCompression, true);
+    compression_types.emplace_back(kZSTD, false);
+    compression_types.emplace_back(kZSTD, true);
   }
 
   for (auto test_type : test_types) {
@@ -1271,6 +1274,42 @@ TEST_F(BlockBasedTableTest, PrefetchTest) {
                 STATUS(InvalidArgument, Slice("k06 "), Slice("k07")));
 }
 
+TEST_F(BlockBasedTableTest, PrefetchKeys) {
+  Options opt;
+  auto ikc = std::make_shared<test::PlainInternalKeyComparator>(opt.comparator);
+  opt.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  c.Add("k01", "hello");
+  c.Add("k02", "hello2");
+  c.Add("k03", std::string(10000, 'x'));
+  c.Add("k04", std::string(200000, 'x'));
+  c.Add("k05", std::string(300000, 'x'));
+  c.Add("k06", "hello3");
+  c.Add("k07", std::string(100000, 'x'));
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(opt);
+  c.Finish(opt, ioptions, table_options, ikc, &keys, &kvmap);
+
+  // Same data spread as in PrefetchTest.
+  table_options.block_cache = NewLRUCache((16 * 1024 * 1024) / FLAGS_cache_single_touch_ratio);
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions2(opt);
+  ASSERT_OK(c.Reopen(ioptions2));
+
+  auto* table_reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  ASSERT_OK(table_reader->PrefetchKeys(ReadOptions(), {"k07", "k02", "k05", "k01", "zzz"}));
+  AssertKeysInCache(table_reader, {"k01", "k02", "k03", "k05", "k06", "k07"}, {"k04"});
+
+  // Blocks that are already in cache are not read again.
+  ASSERT_OK(table_reader->PrefetchKeys(ReadOptions(), {"k01", "k04"}));
+  AssertKeysInCache(table_reader, {"k01", "k02", "k03", "k04", "k05", "k06", "k07"}, {});
+}
+
 void TableTest::TestTotalOrderSeekOnHashIndex(
     const BlockBasedTableOptions& table_options, const Options& options) {
   TableConstructor c(BytewiseComparator(), true);
@@ -1696,6 +1735,60 @@ class BlockCachePropertiesSnapshot {
   int64_t block_cache_bytes_write = 0;
 };
 
+TEST_F(BlockBasedTableTest, ZSTDDictionaryCompression) {
+  if (!ZSTD_Supported()) {
+    LOG(INFO) << "Skipping test, ZSTD is not supported";
+    return;
+  }
+
+  Random rnd(301);
+  stl_wrappers::KVMap expected;
+  for (int i = 0; i < 10000; ++i) {
+    expected.emplace(
+        yb::Format("user_id=$0,table=orders", 1000000 + i),
+        yb::Format("status=shipped,amount=$0,comment=$1", rnd.Uniform(1000),
+                   RandomString(&rnd, 4)));
+  }
+
+  // Small blocks do not compress well without dictionary.
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  std::map<uint32_t, uint64_t> data_size_by_dict_bytes;
+  for (uint32_t max_dict_bytes : {0, 4096}) {
+    TableConstructor c(BytewiseComparator(), /* convert_to_internal_key = */ true);
+    for (const auto& kv : expected) {
+      c.Add(kv.first, kv.second);
+    }
+    Options options;
+    options.compression = kZSTD;
+    options.compression_opts.max_dict_bytes = max_dict_bytes;
+    // Train on part of the data, so both buffered and directly written blocks are covered.
+    options.compression_opts.zstd_max_train_bytes = 64 * 1024;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    const ImmutableCFOptions ioptions(options);
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    c.Finish(options, ioptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    std::unique_ptr<InternalIterator> iter(c.NewIterator());
+    auto expected_it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_it) {
+      ASSERT_NE(expected_it, expected.end());
+      ASSERT_EQ(expected_it->first, iter->key().ToBuffer());
+      ASSERT_EQ(expected_it->second, iter->value().ToBuffer());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected_it, expected.end());
+
+    const auto& props = *c.GetTableReader()->GetTableProperties();
+    ASSERT_GT(props.num_data_blocks, 100U);
+    data_size_by_dict_bytes[max_dict_bytes] = props.data_size;
+  }
+  LOG(INFO) << "Data size by max dictionary size: " << yb::ToString(data_size_by_dict_bytes);
+  ASSERT_LT(data_size_by_dict_bytes[4096], data_size_by_dict_bytes[0]);
+}
+
 // Make sure, by default, index/filter blocks were pre-loaded (meaning we won't
 // use block cache to store them).
 TEST_F(BlockBasedTableTest, BlockCacheDisabledTest) {
@@ -93,6 +93,19 @@ class CompactionOptionsUniversal {
   // Default: false
   bool allow_trivial_move;
 
+  // When non zero, level 0 files are grouped into time windows of the specified size, using
+  // physical time of the largest user frontier of the file. Files from different windows are never
+  // compacted together, so old windows of append-mostly data are not rewritten when new data
+  // arrives. Files without physical time join the window of the adjacent newer file.
+  // Default: 0
+  uint64_t time_window_micros = 0;
+
+  // When non zero and time windows are enabled, only the specified number of the newest time
+  // windows are kept apart. Older windows are compacted together, so the number of level 0 files
+  // does not grow with the number of windows.
+  // Default: 0
+  uint64_t max_time_windows = 0;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
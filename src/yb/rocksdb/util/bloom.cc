@@ -23,10 +23,15 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include "yb/rocksdb/filter_policy.h"
 
+#include "yb/gutil/hash/city.h"
+
 #include "yb/rocksdb/util/hash.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/ribbon.h"
 #include "yb/util/slice.h"
 #include "yb/util/math_util.h"
 
@@ -487,12 +492,134 @@ class FixedSizeFilterBitsReader : public FullFilterBitsReader {
       : FullFilterBitsReader(contents, logger) {}
 };
 
+// Line size of blocked bloom filter is fixed, so filter could be read on machine with another
+// cache line size.
+constexpr size_t kBlockedBloomLineSize = 64;
+constexpr size_t kBlockedBloomLineBits = kBlockedBloomLineSize * 8;
+
+// Line is selected by lower 32 bits of the hash, bits within line are selected by upper 9 bits of
+// upper half of the hash, multiplied by golden ratio constant before each next probe.
+template <class Op>
+inline bool BlockedBloomProbe(uint64_t hash, size_t num_lines, size_t num_probes, const Op& op) {
+  const auto line = ((hash & 0xffffffff) * num_lines) >> 32;
+  const size_t line_start = line * kBlockedBloomLineBits;
+  auto h = static_cast<uint32_t>(hash >> 32);
+  for (size_t i = 0; i != num_probes; ++i, h *= 0x9e3779b9) {
+    if (!op(line_start + (h >> (32 - 9)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline uint64_t BlockedBloomHash(const Slice& key) {
+  return util_hash::CityHash64(key.cdata(), key.size());
+}
+
+// Cache-line blocked bloom filter of fixed size. Number of probes and maximal number of keys are
+// calculated the same way as for FixedSizeFilterBitsBuilder, encoding of metadata is also the same.
+class FixedSizeBlockedBloomBitsBuilder : public FilterBitsBuilder {
+ public:
+  FixedSizeBlockedBloomBitsBuilder(const FixedSizeBlockedBloomBitsBuilder&) = delete;
+  void operator=(const FixedSizeBlockedBloomBitsBuilder&) = delete;
+
+  FixedSizeBlockedBloomBitsBuilder(size_t total_bits, double error_rate) {
+    DCHECK_GT(error_rate, 0);
+    DCHECK_GT(total_bits, 0);
+    num_lines_ = std::max<size_t>(total_bits / kBlockedBloomLineBits, 1);
+    total_bits_ = num_lines_ * kBlockedBloomLineBits;
+
+    const double minus_log_error_rate = -log(error_rate);
+    num_probes_ = std::clamp<size_t>(static_cast<size_t>(minus_log_error_rate / LOG2), 1, 255);
+    max_keys_ = static_cast<size_t>(total_bits_ * LOG2 * LOG2 / minus_log_error_rate);
+
+    data_.reset(new char[FilterSize()]);
+    memset(data_.get(), 0, FilterSize());
+  }
+
+  void AddKey(const Slice& key) override {
+    ++keys_added_;
+    auto* data = data_.get();
+    BlockedBloomProbe(
+        BlockedBloomHash(key), num_lines_, num_probes_, [data](size_t bitpos) {
+      data[bitpos / 8] |= (1 << (bitpos % 8));
+      return true;
+    });
+  }
+
+  bool IsFull() const override { return keys_added_ >= max_keys_; }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    data_[total_bits_ / 8] = static_cast<char>(num_probes_);
+    EncodeFixed32(data_.get() + total_bits_ / 8 + 1, static_cast<uint32_t>(num_lines_));
+    buf->reset(data_.release());
+    return Slice(buf->get(), FilterSize());
+  }
+
+  static constexpr size_t kMetaDataSize = FullFilterBitsBuilder::kMetaDataSize;
+
+ private:
+  size_t FilterSize() const { return total_bits_ / 8 + kMetaDataSize; }
+
+  std::unique_ptr<char[]> data_;
+  size_t max_keys_;
+  size_t keys_added_ = 0;
+  size_t total_bits_;
+  size_t num_lines_;
+  size_t num_probes_;
+};
+
+class FixedSizeBlockedBloomBitsReader : public FilterBitsReader {
+ public:
+  FixedSizeBlockedBloomBitsReader(const FixedSizeBlockedBloomBitsReader&) = delete;
+  void operator=(const FixedSizeBlockedBloomBitsReader&) = delete;
+
+  FixedSizeBlockedBloomBitsReader(const Slice& contents, Logger* logger)
+      : data_(contents.cdata()), data_len_(contents.size()) {
+    constexpr auto kMetaDataSize = FixedSizeBlockedBloomBitsBuilder::kMetaDataSize;
+    if (data_len_ <= kMetaDataSize) {
+      return;
+    }
+    num_probes_ = static_cast<uint8_t>(data_[data_len_ - kMetaDataSize]);
+    num_lines_ = DecodeFixed32(data_ + data_len_ - 4);
+    if (data_len_ != num_lines_ * kBlockedBloomLineSize + kMetaDataSize) {
+      RLOG(InfoLogLevel::ERROR_LEVEL, logger, "Bloom filter data is broken, won't be used.");
+      FAIL_IF_NOT_PRODUCTION();
+      num_lines_ = 0;
+      num_probes_ = 0;
+    }
+  }
+
+  bool MayMatch(const Slice& entry) override {
+    if (data_len_ <= FixedSizeBlockedBloomBitsBuilder::kMetaDataSize) {
+      return false;
+    }
+    // Broken filter is regarded as match.
+    if (num_probes_ == 0 || num_lines_ == 0) {
+      return true;
+    }
+    const auto* data = data_;
+    return BlockedBloomProbe(
+        BlockedBloomHash(entry), num_lines_, num_probes_, [data](size_t bitpos) {
+      return (data[bitpos / 8] & (1 << (bitpos % 8))) != 0;
+    });
+  }
+
+ private:
+  const char* data_;
+  size_t data_len_;
+  size_t num_probes_ = 0;
+  size_t num_lines_ = 0;
+};
+
 class FixedSizeFilterPolicy : public FilterPolicy {
  public:
-  explicit FixedSizeFilterPolicy(size_t total_bits, double error_rate, Logger* logger)
+  explicit FixedSizeFilterPolicy(
+      size_t total_bits, double error_rate, Logger* logger, FixedSizeFilterFormat format)
       : total_bits_(total_bits),
         error_rate_(error_rate),
-        logger_(logger) {
+        logger_(logger),
+        format_(format) {
     DCHECK_GT(error_rate, 0);
     // Make sure num_probes > 0.
     DCHECK_GT(static_cast<int64_t> (-log(error_rate) / LOG2), 0);
@@ -501,7 +628,15 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   virtual FilterType GetFilterType() const override { return FilterType::kFixedSizeFilter; }
 
   virtual const char* Name() const override {
-    return "rocksdb.FixedSizeBloomFilter";
+    switch (format_) {
+      case FixedSizeFilterFormat::kBloom:
+        return "rocksdb.FixedSizeBloomFilter";
+      case FixedSizeFilterFormat::kBlockedBloom:
+        return "rocksdb.FixedSizeBlockedBloomFilter";
+      case FixedSizeFilterFormat::kRibbon:
+        return "rocksdb.FixedSizeRibbonFilter";
+    }
+    FATAL_INVALID_ENUM_VALUE(FixedSizeFilterFormat, format_);
   }
 
   // Not used in FixedSizeFilter. GetFilterBitsBuilder/Reader interface should be used.
@@ -516,11 +651,27 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   }
 
   virtual FilterBitsBuilder* GetFilterBitsBuilder() const override {
-    return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_);
+    switch (format_) {
+      case FixedSizeFilterFormat::kBloom:
+        return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_);
+      case FixedSizeFilterFormat::kBlockedBloom:
+        return new FixedSizeBlockedBloomBitsBuilder(total_bits_, error_rate_);
+      case FixedSizeFilterFormat::kRibbon:
+        return NewFixedSizeRibbonBitsBuilder(total_bits_, error_rate_);
+    }
+    FATAL_INVALID_ENUM_VALUE(FixedSizeFilterFormat, format_);
   }
 
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
-    return new FixedSizeFilterBitsReader(contents, logger_);
+    switch (format_) {
+      case FixedSizeFilterFormat::kBloom:
+        return new FixedSizeFilterBitsReader(contents, logger_);
+      case FixedSizeFilterFormat::kBlockedBloom:
+        return new FixedSizeBlockedBloomBitsReader(contents, logger_);
+      case FixedSizeFilterFormat::kRibbon:
+        return NewFixedSizeRibbonBitsReader(contents, logger_);
+    }
+    FATAL_INVALID_ENUM_VALUE(FixedSizeFilterFormat, format_);
   }
 
 
@@ -528,6 +679,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   size_t total_bits_;
   double error_rate_;
   Logger* logger_;
+  FixedSizeFilterFormat format_;
 };
 
 }  // namespace
@@ -538,10 +690,9 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
   // TODO - replace by NewFixedSizeFilterPolicy and check tests.
 }
 
-const FilterPolicy* NewFixedSizeFilterPolicy(size_t total_bits,
-                                             double error_rate,
-                                             Logger* logger) {
-  return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
+const FilterPolicy* NewFixedSizeFilterPolicy(
+    size_t total_bits, double error_rate, Logger* logger, FixedSizeFilterFormat format) {
+  return new FixedSizeFilterPolicy(total_bits, error_rate, logger, format);
 }
 
 }  // namespace rocksdb
@@ -219,6 +219,11 @@ class FullFilterBloomTestContext : public BloomTestContext {
 
 class FixedSizeFilterBloomTestContext : public BloomTestContext {
  public:
+  explicit FixedSizeFilterBloomTestContext(FixedSizeFilterFormat format)
+      : filter_policy_(NewFixedSizeFilterPolicy(
+            FilterPolicy::kDefaultFixedSizeFilterBits,
+            FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr, format)) {}
+
   const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
 
   // For fixed-size filter we limit maximum number of keys depending on total bits in test itself
@@ -230,13 +235,11 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
   }
 
  private:
-  std::unique_ptr<const FilterPolicy> filter_policy_{
-      NewFixedSizeFilterPolicy(
-          FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
-          nullptr)};
+  std::unique_ptr<const FilterPolicy> filter_policy_;
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+YB_DEFINE_ENUM(BuilderReaderBloomTestType,
+    (kFullFilter)(kFixedSizeFilter)(kFixedSizeBlockedBloomFilter)(kFixedSizeRibbonFilter));
 
 namespace {
 
@@ -245,7 +248,12 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
     case BuilderReaderBloomTestType::kFullFilter:
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
-      return std::make_unique<FixedSizeFilterBloomTestContext>();
+      return std::make_unique<FixedSizeFilterBloomTestContext>(FixedSizeFilterFormat::kBloom);
+    case BuilderReaderBloomTestType::kFixedSizeBlockedBloomFilter:
+      return std::make_unique<FixedSizeFilterBloomTestContext>(
+          FixedSizeFilterFormat::kBlockedBloom);
+    case BuilderReaderBloomTestType::kFixedSizeRibbonFilter:
+      return std::make_unique<FixedSizeFilterBloomTestContext>(FixedSizeFilterFormat::kRibbon);
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -374,7 +382,34 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
 
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kFixedSizeBlockedBloomFilter,
+    BuilderReaderBloomTestType::kFixedSizeRibbonFilter));
+
+namespace {
+
+size_t FixedSizeFilterMaxKeys(FixedSizeFilterFormat format) {
+  std::unique_ptr<const FilterPolicy> policy(NewFixedSizeFilterPolicy(
+      FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+      nullptr, format));
+  std::unique_ptr<FilterBitsBuilder> builder(policy->GetFilterBitsBuilder());
+  char buffer[sizeof(size_t)];
+  size_t num_keys = 0;
+  while (!builder->IsFull()) {
+    builder->AddKey(Key(num_keys++, buffer));
+  }
+  return num_keys;
+}
+
+} // namespace
+
+TEST_F(BloomTest, FixedSizeRibbonFilterCapacity) {
+  // Ribbon filter block of the same size should fit noticeably more keys than bloom filter block.
+  const auto bloom_keys = FixedSizeFilterMaxKeys(FixedSizeFilterFormat::kBloom);
+  const auto ribbon_keys = FixedSizeFilterMaxKeys(FixedSizeFilterFormat::kRibbon);
+  LOG(INFO) << "Max keys per filter block, bloom: " << bloom_keys << ", ribbon: " << ribbon_keys;
+  ASSERT_GE(ribbon_keys, bloom_keys * 6 / 5);
+}
 
 }  // namespace rocksdb
 
@@ -26,6 +26,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/secondary_cache.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/util/autovector.h"
 #include "yb/rocksdb/util/hash.h"
@@ -101,6 +102,8 @@ struct LRUHandle {
   bool in_cache;      // true, if this entry is referenced by the hash table
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   QueryId query_id;  // Query id that added the value to the cache.
+  // Returns contents of the value for the secondary cache, nullptr if entry should not be spilled.
+  Cache::ContentsFunction contents_function;
   char key_data[1];   // Beginning of key
 
   Slice key() const {
@@ -351,12 +354,23 @@ void LRUSubCache::LRU_Append(LRUHandle *e) {
 
 class LRUHandleDeleter {
  public:
-  explicit LRUHandleDeleter(yb::CacheMetrics* metrics) : metrics_(metrics) {}
+  LRUHandleDeleter(yb::CacheMetrics* metrics, SecondaryCache* secondary_cache)
+      : metrics_(metrics), secondary_cache_(secondary_cache) {}
 
   void Add(LRUHandle* handle) {
     handles_.push_back(handle);
   }
 
+  // Adds the handle evicted from the cache. Spillable multi touch handles are offered to the
+  // secondary cache before being freed.
+  void AddEvicted(LRUHandle* handle) {
+    if (secondary_cache_ != nullptr && handle->contents_function != nullptr &&
+        handle->GetSubCacheType() == MULTI_TOUCH) {
+      spilled_handles_.push_back(handle);
+    }
+    handles_.push_back(handle);
+  }
+
   size_t TotalCharge() const {
     size_t result = 0;
     for (LRUHandle* handle : handles_) {
@@ -366,6 +380,9 @@ class LRUHandleDeleter {
   }
 
   ~LRUHandleDeleter() {
+    for (LRUHandle* handle : spilled_handles_) {
+      secondary_cache_->Insert(handle->key(), handle->contents_function(handle->value));
+    }
     for (LRUHandle* handle : handles_) {
       handle->Free(metrics_);
     }
@@ -373,7 +390,9 @@ class LRUHandleDeleter {
 
  private:
   yb::CacheMetrics* metrics_;
+  SecondaryCache* secondary_cache_;
   autovector<LRUHandle*> handles_;
+  autovector<LRUHandle*> spilled_handles_;
 };
 
 // A single shard of sharded cache.
@@ -392,15 +411,21 @@ class LRUCache {
     table_.SetMetrics(metrics);
   }
 
+  void SetSecondaryCache(SecondaryCache* secondary_cache) {
+    secondary_cache_ = secondary_cache;
+  }
+
   // Set the flag to reject insertion if cache if full.
   void SetStrictCapacityLimit(bool strict_capacity_limit);
 
   // Like Cache methods, but with an extra "hash" parameter.
   Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                 void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::ContentsFunction contents_function,
                 Cache::Handle** handle, Statistics* statistics);
   Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
                         Statistics* statistics = nullptr);
+  bool Contains(const Slice& key, uint32_t hash);
   void Release(Cache::Handle* handle);
   void Erase(const Slice& key, uint32_t hash);
   size_t Evict(size_t required);
@@ -474,6 +499,9 @@ class LRUCache {
   HandleTable table_;
 
   shared_ptr<yb::CacheMetrics> metrics_;
+
+  // Receives spillable entries evicted from the multi touch cache, owned by ShardedLRUCache.
+  SecondaryCache* secondary_cache_ = nullptr;
 };
 
 LRUCache::LRUCache() {}
@@ -551,12 +579,12 @@ void LRUCache::EvictFromLRU(const size_t charge,
     old->in_cache = false;
     Unref(old);
     sub_cache->DecrementUsage(old->charge);
-    deleted->Add(old);
+    deleted->AddEvicted(old);
   }
 }
 
 void LRUCache::SetCapacity(size_t capacity) {
-  LRUHandleDeleter last_reference_list(metrics_.get());
+  LRUHandleDeleter last_reference_list(metrics_.get(), secondary_cache_);
 
   {
     MutexLock l(&mutex_);
@@ -579,6 +607,8 @@ void LRUCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
 
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
                                 Statistics* statistics)  {
+  // Declared before the lock, so evicted entries are freed and spilled outside of the mutex.
+  LRUHandleDeleter multi_touch_eviction_list(metrics_.get(), secondary_cache_);
   MutexLock l(&mutex_);
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
@@ -593,10 +623,7 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
     // Now the handle will be added to the multi touch pool only if it exists.
     if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
         e->query_id != query_id) {
-      {
-        LRUHandleDeleter multi_touch_eviction_list(metrics_.get());
-        EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
-      }
+      EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
       // Cannot have any single touch elements in this case.
       assert(FLAGS_cache_single_touch_ratio != 0);
       if (!strict_capacity_limit_ ||
@@ -642,6 +669,11 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+bool LRUCache::Contains(const Slice& key, uint32_t hash) {
+  MutexLock l(&mutex_);
+  return table_.Lookup(key, hash) != nullptr;
+}
+
 bool LRUCache::HasFreeSpace(const SubCacheType subcache_type) {
   switch(subcache_type) {
     case SINGLE_TOUCH :
@@ -692,7 +724,7 @@ void LRUCache::Release(Cache::Handle* handle) {
 }
 
 size_t LRUCache::Evict(size_t required) {
-  LRUHandleDeleter evicted(metrics_.get());
+  LRUHandleDeleter evicted(metrics_.get(), secondary_cache_);
   {
     MutexLock l(&mutex_);
     EvictFromLRU(required, &evicted, SINGLE_TOUCH);
@@ -705,6 +737,7 @@ size_t LRUCache::Evict(size_t required) {
 
 Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                         void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                        Cache::ContentsFunction contents_function,
                         Cache::Handle** handle, Statistics* statistics) {
   // Don't use the cache if disabled by the caller using the special query id.
   if (query_id == kNoCacheQueryId) {
@@ -716,7 +749,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   LRUHandle* e = reinterpret_cast<LRUHandle*>(
                     new char[sizeof(LRUHandle) - 1 + key.size()]);
   Status s;
-  LRUHandleDeleter last_reference_list(metrics_.get());
+  LRUHandleDeleter last_reference_list(metrics_.get(), secondary_cache_);
 
   e->value = value;
   e->deleter = deleter;
@@ -730,6 +763,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   e->in_cache = true;
   // Adding query id to the handle.
   e->query_id = query_id;
+  e->contents_function = contents_function;
   memcpy(e->key_data, key.data(), key.size());
 
   {
@@ -851,6 +885,7 @@ class ShardedLRUCache : public Cache {
   size_t capacity_;
   bool strict_capacity_limit_;
   shared_ptr<yb::CacheMetrics> metrics_;
+  shared_ptr<SecondaryCache> secondary_cache_;
 
   static inline uint32_t HashSlice(const Slice& s) {
     return Hash(s.data(), s.size(), 0);
@@ -867,17 +902,20 @@ class ShardedLRUCache : public Cache {
 
  public:
   ShardedLRUCache(size_t capacity, int num_shard_bits,
-                  bool strict_capacity_limit)
+                  bool strict_capacity_limit,
+                  shared_ptr<SecondaryCache> secondary_cache)
       : last_id_(0),
         num_shard_bits_(num_shard_bits),
         capacity_(capacity),
         strict_capacity_limit_(strict_capacity_limit),
-        metrics_(nullptr) {
+        metrics_(nullptr),
+        secondary_cache_(std::move(secondary_cache)) {
     int num_shards = 1 << num_shard_bits_;
     shards_ = new LRUCache[num_shards];
     const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
     for (int s = 0; s < num_shards; s++) {
       shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+      shards_[s].SetSecondaryCache(secondary_cache_.get());
       shards_[s].SetCapacity(per_shard);
     }
   }
@@ -899,6 +937,14 @@ class ShardedLRUCache : public Cache {
   virtual Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
                         void (*deleter)(const Slice& key, void* value),
                         Handle** handle, Statistics* statistics) override {
+    return InsertSpillable(key, query_id, value, charge, deleter, /* contents_function= */ nullptr,
+                           handle, statistics);
+  }
+
+  Status InsertSpillable(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                         void (*deleter)(const Slice& key, void* value),
+                         ContentsFunction contents_function,
+                         Handle** handle, Statistics* statistics) override {
     DCHECK(IsValidQueryId(query_id));
     // Queries with no cache query ids are not cached.
     if (query_id == kNoCacheQueryId) {
@@ -906,7 +952,11 @@ class ShardedLRUCache : public Cache {
     }
     const uint32_t hash = HashSlice(key);
     return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
-                                       handle, statistics);
+                                       contents_function, handle, statistics);
+  }
+
+  SecondaryCache* secondary_cache() const override {
+    return secondary_cache_.get();
   }
 
   size_t Evict(size_t bytes_to_evict) override {
@@ -930,6 +980,11 @@ class ShardedLRUCache : public Cache {
     return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
   }
 
+  bool Contains(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Contains(key, hash);
+  }
+
   void Release(Handle* handle) override {
     LRUHandle* h = reinterpret_cast<LRUHandle*>(handle);
     shards_[Shard(h->hash)].Release(handle);
@@ -1002,6 +1057,9 @@ class ShardedLRUCache : public Cache {
     for (int s = 0; s < num_shards; s++) {
       shards_[s].SetMetrics(metrics_);
     }
+    if (secondary_cache_) {
+      secondary_cache_->SetMetrics(entity);
+    }
   }
 
   virtual std::vector<std::pair<size_t, size_t>> TEST_GetIndividualUsages() override {
@@ -1027,11 +1085,17 @@ shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits) {
 
 shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                               bool strict_capacity_limit) {
+  return NewLRUCache(capacity, num_shard_bits, strict_capacity_limit, nullptr);
+}
+
+shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
+                              bool strict_capacity_limit,
+                              shared_ptr<SecondaryCache> secondary_cache) {
   if (num_shard_bits > kSharedLRUCacheMaxNumShardBits) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
   return std::make_shared<ShardedLRUCache>(capacity, num_shard_bits,
-                                           strict_capacity_limit);
+                                           strict_capacity_limit, std::move(secondary_cache));
 }
 
 }  // namespace rocksdb
@@ -32,6 +32,12 @@ int main() {
 #include <inttypes.h>
 #include <sys/types.h>
 #include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include <boost/algorithm/string/predicate.hpp>
+
 #include "yb/util/flags.h"
 
 #include "yb/rocksdb/db.h"
@@ -41,19 +47,29 @@ int main() {
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/random.h"
 
+#include "yb/util/status_log.h"
+
 using GFLAGS::ParseCommandLineFlags;
 
 static const uint32_t KB = 1024;
 
 DEFINE_UNKNOWN_int32(threads, 16, "Number of concurrent threads to run.");
-DEFINE_UNKNOWN_int64(cache_size, 8 * KB * KB,
+DEFINE_UNKNOWN_int64(cache_size, 256 * KB * KB,
              "Number of bytes to use as a cache of uncompressed data.");
 DEFINE_UNKNOWN_int32(num_shard_bits, 4, "shard_bits.");
+DEFINE_UNKNOWN_string(cache_type, "both",
+                      "Cache implementation to benchmark: lru, clock or both.");
+DEFINE_UNKNOWN_int64(value_charge, 8 * KB,
+                     "Charge of each cache entry, i.e. size of the cached block.");
 
-DEFINE_UNKNOWN_int64(max_key, 1 * KB * KB * KB, "Max number of key to place in cache");
+DEFINE_UNKNOWN_int64(max_key, 64 * KB, "Max number of key to place in cache");
 DEFINE_UNKNOWN_uint64(ops_per_thread, 1200000, "Number of operations per thread.");
+DEFINE_UNKNOWN_int32(num_query_ids, 4,
+                     "Number of distinct query ids used by the workload. Lookup with query id "
+                     "different from the one used to insert the entry moves it to the "
+                     "multi touch part of the cache.");
 
-DEFINE_UNKNOWN_bool(populate_cache, false, "Populate cache before operations");
+DEFINE_UNKNOWN_bool(populate_cache, true, "Populate cache before operations");
 DEFINE_UNKNOWN_int32(insert_percent, 40,
              "Ratio of insert to total workload (expressed as a percentage)");
 DEFINE_UNKNOWN_int32(lookup_percent, 50,
@@ -66,7 +82,7 @@ namespace rocksdb {
 class CacheBench;
 namespace {
 void deleter(const Slice& key, void* value) {
-    delete reinterpret_cast<char *>(value);
+    delete[] reinterpret_cast<char *>(value);
 }
 
 // State shared by all concurrent executions of the same benchmark.
@@ -144,27 +160,29 @@ struct ThreadState {
 
 class CacheBench {
  public:
-  CacheBench() :
-      cache_(NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits)),
-      num_threads_(FLAGS_threads) {}
+  CacheBench(std::string name, std::shared_ptr<Cache> cache)
+      : name_(std::move(name)),
+        cache_(std::move(cache)),
+        num_threads_(FLAGS_threads) {}
 
   ~CacheBench() {}
 
   void PopulateCache() {
     Random rnd(1);
-    for (int64_t i = 0; i < FLAGS_cache_size; i++) {
+    for (int64_t i = 0; i < FLAGS_cache_size / FLAGS_value_charge; i++) {
       uint64_t rand_key = rnd.Next() % FLAGS_max_key;
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
       // do insert
-      cache_->Insert(key, new char[10], 1, &deleter);
+      WARN_NOT_OK(
+          cache_->Insert(key, kDefaultQueryId, new char[10], FLAGS_value_charge, &deleter),
+          "Insert failed");
     }
   }
 
   bool Run() {
     rocksdb::Env* env = rocksdb::Env::Default();
 
-    PrintEnv();
     SharedState shared(this);
     std::vector<ThreadState*> threads(num_threads_);
     for (uint32_t i = 0; i < num_threads_; i++) {
@@ -193,14 +211,20 @@ class CacheBench {
       double elapsed = static_cast<double>(end_time - start_time) * 1e-6;
       uint32_t qps = static_cast<uint32_t>(
           static_cast<double>(FLAGS_threads * FLAGS_ops_per_thread) / elapsed);
-      fprintf(stdout, "Complete in %.3f s; QPS = %u\n", elapsed, qps);
+      const auto lookups = lookups_.load();
+      fprintf(stdout, "%s: complete in %.3f s; QPS = %u; lookup hit ratio = %.3f; usage = %zu\n",
+              name_.c_str(), elapsed, qps, lookups ? hits_.load() * 1.0 / lookups : 0.0,
+              cache_->GetUsage());
     }
     return true;
   }
 
  private:
+  const std::string name_;
   std::shared_ptr<Cache> cache_;
   uint32_t num_threads_;
+  std::atomic<uint64_t> lookups_{0};
+  std::atomic<uint64_t> hits_{0};
 
   static void ThreadBody(void* v) {
     ThreadState* thread = reinterpret_cast<ThreadState*>(v);
@@ -228,42 +252,67 @@ class CacheBench {
   }
 
   void OperateCache(ThreadState* thread) {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
     for (uint64_t i = 0; i < FLAGS_ops_per_thread; i++) {
       uint64_t rand_key = thread->rnd.Next() % FLAGS_max_key;
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
+      QueryId query_id = thread->rnd.Uniform(std::max(FLAGS_num_query_ids, 1));
       int32_t prob_op = thread->rnd.Uniform(100);
-      if (prob_op >= 0 && prob_op < FLAGS_insert_percent) {
+      if (prob_op < FLAGS_insert_percent) {
         // do insert
-        cache_->Insert(key, new char[10], 1, &deleter);
-      } else if (prob_op -= FLAGS_insert_percent &&
-                 prob_op < FLAGS_lookup_percent) {
+        WARN_NOT_OK(
+            cache_->Insert(key, query_id, new char[10], FLAGS_value_charge, &deleter),
+            "Insert failed");
+        continue;
+      }
+      prob_op -= FLAGS_insert_percent;
+      if (prob_op < FLAGS_lookup_percent) {
         // do lookup
-        auto handle = cache_->Lookup(key);
+        ++lookups;
+        auto handle = cache_->Lookup(key, query_id);
         if (handle) {
+          ++hits;
           cache_->Release(handle);
         }
-      } else if (prob_op -= FLAGS_lookup_percent &&
-                 prob_op < FLAGS_erase_percent) {
+        continue;
+      }
+      prob_op -= FLAGS_lookup_percent;
+      if (prob_op < FLAGS_erase_percent) {
         // do erase
         cache_->Erase(key);
       }
     }
+    lookups_ += lookups;
+    hits_ += hits;
   }
+};
 
-  void PrintEnv() const {
-    printf("Number of threads   : %d\n", FLAGS_threads);
-    printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
-    printf("Cache size          : %" PRIu64 "\n", FLAGS_cache_size);
-    printf("Num shard bits      : %d\n", FLAGS_num_shard_bits);
-    printf("Max key             : %" PRIu64 "\n", FLAGS_max_key);
-    printf("Populate cache      : %d\n", FLAGS_populate_cache);
-    printf("Insert percentage   : %d%%\n", FLAGS_insert_percent);
-    printf("Lookup percentage   : %d%%\n", FLAGS_lookup_percent);
-    printf("Erase percentage    : %d%%\n", FLAGS_erase_percent);
-    printf("----------------------------\n");
+void PrintEnv() {
+  printf("Number of threads   : %d\n", FLAGS_threads);
+  printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
+  printf("Cache type          : %s\n", FLAGS_cache_type.c_str());
+  printf("Cache size          : %" PRId64 "\n", FLAGS_cache_size);
+  printf("Num shard bits      : %d\n", FLAGS_num_shard_bits);
+  printf("Value charge        : %" PRId64 "\n", FLAGS_value_charge);
+  printf("Max key             : %" PRId64 "\n", FLAGS_max_key);
+  printf("Num query ids       : %d\n", FLAGS_num_query_ids);
+  printf("Populate cache      : %d\n", FLAGS_populate_cache);
+  printf("Insert percentage   : %d%%\n", FLAGS_insert_percent);
+  printf("Lookup percentage   : %d%%\n", FLAGS_lookup_percent);
+  printf("Erase percentage    : %d%%\n", FLAGS_erase_percent);
+  printf("----------------------------\n");
+}
+
+bool RunBench(const std::string& name, std::shared_ptr<Cache> cache) {
+  CacheBench bench(name, std::move(cache));
+  if (FLAGS_populate_cache) {
+    bench.PopulateCache();
   }
-};
+  return bench.Run();
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -274,15 +323,28 @@ int main(int argc, char** argv) {
     exit(1);
   }
 
-  rocksdb::CacheBench bench;
-  if (FLAGS_populate_cache) {
-    bench.PopulateCache();
+  const bool run_lru = boost::iequals(FLAGS_cache_type, "lru") ||
+                       boost::iequals(FLAGS_cache_type, "both");
+  const bool run_clock = boost::iequals(FLAGS_cache_type, "clock") ||
+                         boost::iequals(FLAGS_cache_type, "both");
+  if (!run_lru && !run_clock) {
+    fprintf(stderr, "Unknown cache type: %s\n", FLAGS_cache_type.c_str());
+    exit(1);
+  }
+
+  rocksdb::PrintEnv();
+  bool ok = true;
+  if (run_lru) {
+    ok = rocksdb::RunBench(
+        "lru", rocksdb::NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits)) && ok;
   }
-  if (bench.Run()) {
-    return 0;
-  } else {
-    return 1;
+  if (run_clock) {
+    ok = rocksdb::RunBench(
+        "clock", rocksdb::NewClockCache(
+            FLAGS_cache_size, FLAGS_num_shard_bits, /* strict_capacity_limit= */ false,
+            FLAGS_value_charge)) && ok;
   }
+  return ok ? 0 : 1;
 }
 
 #endif  // GFLAGS
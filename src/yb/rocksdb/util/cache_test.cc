@@ -21,14 +21,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <atomic>
 #include <forward_list>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/secondary_cache.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/random.h"
 
 #include "yb/util/string_util.h"
 #include "yb/util/test_macros.h"
@@ -745,6 +749,308 @@ TEST_F(CacheTest, OverFlowTest) {
   cache->Release(h);
 }
 
+namespace {
+
+// Secondary cache that just records offered entries.
+class RecordingSecondaryCache : public SecondaryCache {
+ public:
+  void Insert(const Slice& key, const Slice& contents) override {
+    inserted_keys.push_back(DecodeKey(key));
+    ASSERT_EQ(contents, Slice("contents"));
+  }
+
+  bool Lookup(const Slice& key, std::unique_ptr<char[]>* contents, size_t* size) override {
+    return false;
+  }
+
+  void Erase(const Slice& key) override {}
+
+  size_t GetDiskUsage() const override { return 0; }
+
+  size_t GetMemoryUsage() const override { return 0; }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {}
+
+  std::vector<int> inserted_keys;
+};
+
+Slice TestContents(void* value) {
+  return Slice("contents");
+}
+
+} // namespace
+
+TEST_F(CacheTest, SpillToSecondaryCache) {
+  auto secondary_cache = std::make_shared<RecordingSecondaryCache>();
+  auto cache = NewLRUCache(kCacheSize2, 0 /* num_shard_bits */, false, secondary_cache);
+  auto insert_spillable = [&cache](int key) {
+    return cache->InsertSpillable(EncodeKey(key), kTestQueryId, EncodeValue(key), 1,
+                                  &CacheTest::Deleter, &TestContents);
+  };
+
+  // Spillable multi touch entry.
+  ASSERT_OK(insert_spillable(1));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 1, 1, kTestQueryId + 1));
+  // Spillable single touch entry.
+  ASSERT_OK(insert_spillable(2));
+  // Regular multi touch entry.
+  ASSERT_OK(Insert(cache, 3, 3));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 3, 3, kTestQueryId + 1));
+  // Erased entry is not spilled.
+  ASSERT_OK(insert_spillable(4));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 4, 4, kTestQueryId + 1));
+  cache->Erase(EncodeKey(4));
+
+  ASSERT_TRUE(secondary_cache->inserted_keys.empty());
+  cache->SetCapacity(0);
+  ASSERT_EQ(std::vector<int>{1}, secondary_cache->inserted_keys);
+  ASSERT_EQ(4U, deleted_keys_.size());
+}
+
+TEST_F(CacheTest, ClockCacheBasic) {
+  cache_ = NewClockCache(kCacheSize, kNumShardBits, false, 1);
+
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(-1, Lookup(200));
+
+  ASSERT_OK(Insert(200, 201));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+
+  // Replace entry while it is pinned.
+  Cache::Handle* h1 = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_OK(Insert(100, 102));
+  ASSERT_EQ(102, Lookup(100));
+  ASSERT_EQ(101, DecodeValue(cache_->Value(h1)));
+  ASSERT_EQ(0U, deleted_keys_.size());
+  ASSERT_EQ(3U, cache_->GetUsage());
+  ASSERT_EQ(1U, cache_->GetPinnedUsage());
+
+  cache_->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+  ASSERT_EQ(2U, cache_->GetUsage());
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+
+  Erase(200);
+  ASSERT_EQ(-1, Lookup(200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(200, deleted_keys_[1]);
+  ASSERT_EQ(201, deleted_values_[1]);
+  ASSERT_EQ(1U, cache_->GetUsage());
+}
+
+TEST_F(CacheTest, ClockCacheEviction) {
+  const size_t kCapacity = 100;
+  auto cache = NewClockCache(kCapacity, 0, false, 1);
+
+  for (size_t i = 0; i < 10 * kCapacity; ++i) {
+    ASSERT_OK(Insert(cache, static_cast<int>(i), static_cast<int>(i + 1)));
+    ASSERT_GE(kCapacity, cache->GetUsage());
+  }
+  ASSERT_EQ(kCapacity, cache->GetUsage());
+  ASSERT_EQ(9 * kCapacity, deleted_keys_.size());
+
+  // Pinned entries are not evicted, so cache grows over capacity.
+  std::vector<Cache::Handle*> handles;
+  for (size_t i = 0; i <= kCapacity; ++i) {
+    Cache::Handle* handle;
+    ASSERT_OK(cache->Insert(
+        EncodeKey(10000 + i), kTestQueryId, EncodeValue(i), 1, &CacheTest::Deleter, &handle));
+    handles.push_back(handle);
+  }
+  ASSERT_EQ(kCapacity + 1, cache->GetUsage());
+  ASSERT_EQ(kCapacity + 1, cache->GetPinnedUsage());
+  for (auto* handle : handles) {
+    cache->Release(handle);
+  }
+  ASSERT_EQ(kCapacity, cache->GetUsage());
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+}
+
+TEST_F(CacheTest, ClockCacheMultiTouch) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_cache_single_touch_ratio) = 0.2;
+  const size_t kCapacity = 10;
+  auto cache = NewClockCache(kCapacity, 0, false, 1);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Insert(cache, i, i));
+  }
+  AssertCacheSizes(cache.get(), 10, 0);
+
+  // Lookup with the same query id does not promote entries.
+  for (int i = 0; i < 10; i++) {
+    ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, i, i));
+  }
+  AssertCacheSizes(cache.get(), 10, 0);
+
+  // Lookup with another query id moves entries to multi touch cache, until its capacity is
+  // reached.
+  for (int i = 0; i < 8; i++) {
+    ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, i, i, kTestQueryId + 1));
+  }
+  AssertCacheSizes(cache.get(), 2, 8);
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 8, 8, kTestQueryId + 1));
+  AssertCacheSizes(cache.get(), 1, 8);
+
+  // Single touch entries do not evict multi touch entries.
+  for (int i = 100; i < 200; i++) {
+    ASSERT_OK(Insert(cache, i, i));
+  }
+  AssertCacheSizes(cache.get(), 2, 8);
+
+  // Insert with another query id goes directly to multi touch cache.
+  ASSERT_OK(Insert(cache, 199, 199, 1, kTestQueryId + 1));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 199, 199));
+  AssertCacheSizes(cache.get(), 1, 8);
+}
+
+TEST_F(CacheTest, ContainsDoesNotPromote) {
+  const size_t kCapacity = 10;
+  for (auto cache : {NewLRUCache(kCapacity, 0), NewClockCache(kCapacity, 0, false, 1)}) {
+    ASSERT_OK(Insert(cache, 1, 1));
+    ASSERT_TRUE(cache->Contains(EncodeKey(1)));
+    ASSERT_FALSE(cache->Contains(EncodeKey(2)));
+    AssertCacheSizes(cache.get(), 1, 0);
+
+    // Lookup with another query id moves the entry to multi touch cache, while Contains does not.
+    ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 1, 1, kTestQueryId + 1));
+    AssertCacheSizes(cache.get(), 0, 1);
+
+    Erase(cache, 1);
+    ASSERT_FALSE(cache->Contains(EncodeKey(1)));
+  }
+}
+
+TEST_F(CacheTest, ClockCacheStrictCapacityLimit) {
+  google::FlagSaver flag_saver;
+  // Use multi touch cache only, so whole capacity is available for inserted entries.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_cache_single_touch_ratio) = 0;
+  auto cache = NewClockCache(10, 0, true, 1);
+  std::vector<Cache::Handle*> handles(10);
+  for (size_t i = 0; i != handles.size(); ++i) {
+    ASSERT_OK(cache->Insert(
+        EncodeKey(i), kInMultiTouchId, EncodeValue(i), 1, &CacheTest::Deleter, &handles[i]));
+  }
+  Cache::Handle* handle;
+  auto s = cache->Insert(
+      EncodeKey(100), kInMultiTouchId, EncodeValue(100), 1, &CacheTest::Deleter, &handle);
+  ASSERT_TRUE(s.IsIncomplete()) << s;
+  ASSERT_EQ(nullptr, handle);
+  ASSERT_EQ(0U, deleted_keys_.size());
+
+  s = cache->Insert(EncodeKey(100), kInMultiTouchId, EncodeValue(100), 1, &CacheTest::Deleter);
+  ASSERT_TRUE(s.IsIncomplete()) << s;
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+
+  for (auto* h : handles) {
+    cache->Release(h);
+  }
+}
+
+TEST_F(CacheTest, ClockCacheTableFull) {
+  // Large estimated entry charge gives the smallest table, so it is filled by pinned entries.
+  const size_t kCapacity = 1000;
+  auto cache = NewClockCache(kCapacity, 0, false, kCapacity);
+  std::vector<Cache::Handle*> handles;
+  for (;;) {
+    Cache::Handle* handle;
+    const auto key = static_cast<int>(handles.size());
+    ASSERT_OK(cache->Insert(
+        EncodeKey(key), kTestQueryId, EncodeValue(key), 1, &CacheTest::Deleter, &handle));
+    ASSERT_NE(nullptr, handle);
+    handles.push_back(handle);
+    if (Lookup(cache, key) == -1) {
+      // Table is full, so the entry was not added to it, but the handle is still usable.
+      ASSERT_EQ(key, DecodeValue(cache->Value(handle)));
+      break;
+    }
+    ASSERT_LE(handles.size(), kCapacity);
+  }
+  ASSERT_EQ(0U, deleted_keys_.size());
+
+  // Entry inserted without handle is just not cached.
+  ASSERT_OK(Insert(cache, 10000, 10000));
+  ASSERT_EQ(-1, Lookup(cache, 10000));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(10000, deleted_keys_.back());
+
+  const auto last_key = static_cast<int>(handles.size() - 1);
+  cache->Release(handles.back());
+  handles.pop_back();
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(last_key, deleted_keys_.back());
+  ASSERT_EQ(handles.size(), cache->GetUsage());
+
+  for (auto* h : handles) {
+    cache->Release(h);
+  }
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+}
+
+TEST_F(CacheTest, ClockCacheConcurrent) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeys = 1000;
+  constexpr int kOpsPerThread = 100000;
+  auto cache = NewClockCache(kNumKeys / 4, 2, false, 1);
+
+  std::atomic<int> alive{0};
+  struct TestValue {
+    int key;
+    std::atomic<int>* alive;
+  };
+  auto value_deleter = [](const Slice& key, void* value) {
+    auto* test_value = static_cast<TestValue*>(value);
+    ASSERT_EQ(DecodeKey(key), test_value->key);
+    test_value->alive->fetch_sub(1);
+    delete test_value;
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([&cache, &alive, value_deleter, t] {
+      Random rnd(t + 1);
+      for (int i = 0; i != kOpsPerThread; ++i) {
+        auto key = static_cast<int>(rnd.Uniform(kNumKeys));
+        QueryId query_id = rnd.Uniform(3);
+        auto op = rnd.Uniform(10);
+        if (op < 4) {
+          alive.fetch_add(1);
+          auto* value = new TestValue {
+            .key = key,
+            .alive = &alive,
+          };
+          ASSERT_OK(cache->Insert(EncodeKey(key), query_id, value, 1, value_deleter));
+        } else if (op < 9) {
+          auto* handle = cache->Lookup(EncodeKey(key), query_id);
+          if (handle) {
+            ASSERT_EQ(key, static_cast<TestValue*>(cache->Value(handle))->key);
+            cache->Release(handle);
+          }
+        } else {
+          cache->Erase(EncodeKey(key));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+  ASSERT_EQ(cache->GetUsage(), static_cast<size_t>(alive.load()));
+  // Concurrent inserts could temporarily exceed capacity, so evict extra entries.
+  cache->SetCapacity(kNumKeys / 4);
+  ASSERT_GE(kNumKeys / 4 + 4, cache->GetUsage());
+  ASSERT_EQ(cache->GetUsage(), static_cast<size_t>(alive.load()));
+  cache.reset();
+  ASSERT_EQ(0, alive.load());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,903 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string.h>
+
+#include <atomic>
+#include <cmath>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/enums.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
+
+using std::shared_ptr;
+
+DECLARE_double(cache_single_touch_ratio);
+DECLARE_bool(cache_overflow_single_touch);
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation.
+//
+// Each shard keeps entries in a fixed size open addressing hash table with double hashing.
+// There are no LRU lists, all eviction decisions are made by the clock hand sweeping the table.
+// Lookup and Release only use atomic operations on the slot, so readers do not contend on a shard
+// mutex.
+//
+// Slot state and reference counter are packed into a single 64 bit meta word:
+// - Empty: slot is free.
+// - Construction: slot is exclusively owned by a single thread, that either fills it on insert or
+//   frees it on eviction/erase. No other thread could acquire a reference in this state.
+// - Visible: entry is in cache and could be found by Lookup.
+// - Invisible: entry was erased or replaced, but still referenced by some handles. It is freed
+//   when the last reference is released.
+//
+// Reference is acquired optimistically by incrementing meta and then checking the state.
+// When state is not shareable (Empty or Construction), such increment is simply ignored, since the
+// owning thread overwrites whole meta word when it finishes.
+//
+// Each slot also tracks the number of entries whose probe sequence passes through the slot
+// (displacements). Lookup stops probing at the first slot with zero displacements.
+constexpr uint64_t kOccupiedBit = 1ULL << 63;
+constexpr uint64_t kShareableBit = 1ULL << 62;
+constexpr uint64_t kVisibleBit = 1ULL << 61;
+constexpr uint64_t kStateMask = kOccupiedBit | kShareableBit | kVisibleBit;
+constexpr uint64_t kRefsMask = (1ULL << 32) - 1;
+
+constexpr uint64_t kStateEmpty = 0;
+constexpr uint64_t kStateConstruction = kOccupiedBit;
+constexpr uint64_t kStateInvisible = kOccupiedBit | kShareableBit;
+constexpr uint64_t kStateVisible = kOccupiedBit | kShareableBit | kVisibleBit;
+
+// Keys of this size or shorter are stored inside the slot, so typical block cache key does not
+// require separate allocation.
+constexpr size_t kInlineKeySize = 48;
+
+// Max fraction of occupied slots. Entries are evicted regardless of usage, after this limit is
+// reached, to keep probe sequences short.
+constexpr double kMaxLoadFactor = 0.85;
+// Load factor of the table, when all entries have estimated charge and cache is full.
+constexpr double kTargetLoadFactor = 0.7;
+constexpr size_t kMinTableSize = 16;
+
+inline uint64_t GetState(uint64_t meta) {
+  return meta & kStateMask;
+}
+
+inline uint64_t GetRefs(uint64_t meta) {
+  return meta & kRefsMask;
+}
+
+struct ClockHandle {
+  std::atomic<uint64_t> meta{kStateEmpty};
+  std::atomic<uint32_t> displacements{0};
+  std::atomic<uint32_t> hash{0};
+  // Set on access and cleared by the clock hand. Entry is evicted by the clock hand only when this
+  // flag is already cleared, i.e. the entry was not accessed during the whole clock round.
+  std::atomic<bool> accessed{false};
+  // kInMultiTouchId for entries in the multi touch sub cache. Could be changed by promotion while
+  // other threads hold references to the entry.
+  std::atomic<QueryId> query_id{kDefaultQueryId};
+
+  // Following fields are written only by the thread that owns the slot exclusively, i.e. in the
+  // Construction state. And could be read by threads that hold reference to the entry.
+  void* value = nullptr;
+  void (*deleter)(const Slice&, void* value) = nullptr;
+  size_t charge = 0;
+  size_t key_length = 0;
+  std::unique_ptr<char[]> heap_key;
+  char inline_key[kInlineKeySize];
+
+  Slice key() const {
+    return Slice(heap_key ? heap_key.get() : inline_key, key_length);
+  }
+
+  void SetKey(const Slice& key) {
+    key_length = key.size();
+    char* dest = inline_key;
+    if (key_length > kInlineKeySize) {
+      heap_key.reset(new char[key_length]);
+      dest = heap_key.get();
+    }
+    memcpy(dest, key.data(), key_length);
+  }
+
+  SubCacheType GetSubCacheType() const {
+    return query_id.load(std::memory_order_relaxed) == kInMultiTouchId ? MULTI_TOUCH
+                                                                       : SINGLE_TOUCH;
+  }
+};
+
+// A single shard of sharded cache.
+class ClockCache {
+ public:
+  ClockCache() = default;
+  ~ClockCache();
+
+  // Separate from constructor so caller can easily make an array of ClockCache.
+  void Init(size_t capacity, size_t estimated_entry_charge, bool strict_capacity_limit);
+
+  void SetCapacity(size_t capacity);
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = std::move(metrics);
+  }
+
+  Status Insert(const Slice& key, uint32_t hash, QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+                Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, QueryId query_id,
+                        Statistics* statistics);
+  bool Contains(const Slice& key, uint32_t hash);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+  size_t Evict(size_t required);
+
+  size_t GetUsage() const {
+    return usage_[SINGLE_TOUCH].load(std::memory_order_relaxed) +
+           usage_[MULTI_TOUCH].load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const {
+    return pinned_usage_.load(std::memory_order_relaxed);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t));
+
+  std::pair<size_t, size_t> TEST_GetIndividualUsages() const {
+    return std::make_pair(usage_[SINGLE_TOUCH].load(), usage_[MULTI_TOUCH].load());
+  }
+
+ private:
+  size_t ProbeStart(uint32_t hash) const {
+    return hash & table_mask_;
+  }
+
+  // Odd increment visits all slots of power of 2 sized table.
+  size_t ProbeIncrement(uint32_t hash) const {
+    return ((hash * 0x9e3779b1U) >> 7 | 1) & table_mask_;
+  }
+
+  SubCacheType EffectiveSubCacheType(SubCacheType subcache_type) const;
+  size_t GetSubCacheCapacity(SubCacheType subcache_type) const;
+  bool HasFreeSpace(SubCacheType subcache_type) const;
+
+  // Tries to acquire a reference to the entry in the specified slot. Returns true only if the slot
+  // contains a visible entry.
+  bool Ref(ClockHandle* h);
+
+  // Releases a reference acquired by Ref, Lookup or Insert. Frees the entry when the last
+  // reference to the invisible entry is released. Also frees the visible entry in the same case,
+  // when free_if_no_space is true and its sub cache is over capacity.
+  void Unref(ClockHandle* h, bool free_if_no_space);
+
+  // Marks entry as invisible. REQUIRES: caller holds reference to the entry.
+  void MarkInvisible(ClockHandle* h);
+
+  // Invokes f for all visible entries with specified key, while holding reference to them.
+  template <class F>
+  void ForEachMatch(const Slice& key, uint32_t hash, const F& f);
+
+  // Finds a free slot for the entry with specified hash and takes exclusive ownership of it.
+  // Returns nullptr when the table is full.
+  ClockHandle* ClaimSlot(uint32_t hash);
+
+  // Calls deleter, updates usage and releases the slot. REQUIRES: slot is in Construction state.
+  void FreeSlot(ClockHandle* h);
+
+  // Returns true when the handle is a slot of the table, i.e. it is not a detached handle that
+  // was returned by Insert when the table was full.
+  bool InTable(const ClockHandle* h) const {
+    return h >= table_.get() && h <= table_.get() + table_mask_;
+  }
+
+  // Tries to evict entry of the specified sub cache at the slot. Clears access flag if it is set.
+  // Returns charge of the evicted entry, or 0 if the entry was not evicted.
+  size_t TryEvict(ClockHandle* h, SubCacheType subcache_type);
+
+  // Moves the clock hand evicting unreferenced entries of the specified sub cache, while
+  // need_more(evicted_so_far) returns true. Stops after two full rounds, so all access flags are
+  // cleared and all unreferenced entries are visited. Returns total charge of evicted entries.
+  template <class NeedMore>
+  size_t EvictFromClock(SubCacheType subcache_type, const NeedMore& need_more);
+
+  // Evicts entries of the specified sub cache, until there is room for the given charge.
+  size_t EvictForCharge(size_t charge, SubCacheType subcache_type);
+
+  void DecrementMetrics(SubCacheType subcache_type, size_t charge);
+
+  std::unique_ptr<ClockHandle[]> table_;
+  size_t table_mask_ = 0;
+  size_t max_occupancy_ = 0;
+  bool strict_capacity_limit_ = false;
+
+  std::atomic<size_t> total_capacity_{0};
+  std::atomic<size_t> multi_touch_capacity_{0};
+  std::atomic<size_t> occupancy_{0};
+  std::atomic<size_t> clock_hand_{0};
+  std::atomic<size_t> usage_[2] = {{0}, {0}};
+  std::atomic<size_t> pinned_usage_{0};
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+void ClockCache::Init(
+    size_t capacity, size_t estimated_entry_charge, bool strict_capacity_limit) {
+  strict_capacity_limit_ = strict_capacity_limit;
+  const auto estimated_entries = static_cast<size_t>(std::ceil(
+      capacity / kTargetLoadFactor / std::max<size_t>(estimated_entry_charge, 1)));
+  size_t table_size = kMinTableSize;
+  while (table_size < estimated_entries) {
+    table_size <<= 1;
+  }
+  table_.reset(new ClockHandle[table_size]);
+  table_mask_ = table_size - 1;
+  max_occupancy_ = static_cast<size_t>(table_size * kMaxLoadFactor);
+  SetCapacity(capacity);
+}
+
+ClockCache::~ClockCache() {
+  if (!table_) {
+    return;
+  }
+  for (size_t i = 0; i <= table_mask_; ++i) {
+    auto& h = table_[i];
+    auto meta = h.meta.load(std::memory_order_acquire);
+    // Referenced entries are not freed, the same as in LRU cache.
+    if ((meta & kShareableBit) && GetRefs(meta) == 0) {
+      h.meta.store(kStateConstruction, std::memory_order_relaxed);
+      FreeSlot(&h);
+    }
+  }
+}
+
+SubCacheType ClockCache::EffectiveSubCacheType(SubCacheType subcache_type) const {
+  if (FLAGS_cache_single_touch_ratio == 0) {
+    return MULTI_TOUCH;
+  } else if (FLAGS_cache_single_touch_ratio == 1) {
+    return SINGLE_TOUCH;
+  }
+  return subcache_type;
+}
+
+size_t ClockCache::GetSubCacheCapacity(SubCacheType subcache_type) const {
+  const auto total_capacity = total_capacity_.load(std::memory_order_relaxed);
+  const auto multi_touch_capacity = multi_touch_capacity_.load(std::memory_order_relaxed);
+  switch (subcache_type) {
+    case SINGLE_TOUCH: {
+      if (strict_capacity_limit_ || !FLAGS_cache_overflow_single_touch) {
+        return total_capacity - multi_touch_capacity;
+      }
+      auto multi_touch_usage = usage_[MULTI_TOUCH].load(std::memory_order_relaxed);
+      return total_capacity > multi_touch_usage ? total_capacity - multi_touch_usage : 0;
+    }
+    case MULTI_TOUCH:
+      return multi_touch_capacity;
+  }
+  FATAL_INVALID_ENUM_VALUE(SubCacheType, subcache_type);
+}
+
+bool ClockCache::HasFreeSpace(SubCacheType subcache_type) const {
+  switch (subcache_type) {
+    case SINGLE_TOUCH:
+      if (strict_capacity_limit_ || !FLAGS_cache_overflow_single_touch) {
+        return usage_[SINGLE_TOUCH].load(std::memory_order_relaxed) <=
+               total_capacity_.load(std::memory_order_relaxed) -
+                   multi_touch_capacity_.load(std::memory_order_relaxed);
+      }
+      return GetUsage() <= total_capacity_.load(std::memory_order_relaxed);
+    case MULTI_TOUCH:
+      return usage_[MULTI_TOUCH].load(std::memory_order_relaxed) <=
+             multi_touch_capacity_.load(std::memory_order_relaxed);
+  }
+  FATAL_INVALID_ENUM_VALUE(SubCacheType, subcache_type);
+}
+
+void ClockCache::SetCapacity(size_t capacity) {
+  multi_touch_capacity_.store(
+      static_cast<size_t>(std::round((1 - FLAGS_cache_single_touch_ratio) * capacity)),
+      std::memory_order_relaxed);
+  total_capacity_.store(capacity, std::memory_order_relaxed);
+  EvictForCharge(0, EffectiveSubCacheType(MULTI_TOUCH));
+  EvictForCharge(0, EffectiveSubCacheType(SINGLE_TOUCH));
+}
+
+bool ClockCache::Ref(ClockHandle* h) {
+  auto old_meta = h->meta.fetch_add(1, std::memory_order_acq_rel);
+  if (!(old_meta & kShareableBit)) {
+    // Slot is owned by another thread, that will overwrite meta.
+    return false;
+  }
+  if (GetRefs(old_meta) == 0) {
+    pinned_usage_.fetch_add(h->charge, std::memory_order_relaxed);
+  }
+  if (GetState(old_meta) == kStateVisible) {
+    return true;
+  }
+  Unref(h, /* free_if_no_space= */ false);
+  return false;
+}
+
+void ClockCache::Unref(ClockHandle* h, bool free_if_no_space) {
+  // Read entry fields before releasing our reference, since after that the slot could be reused.
+  const auto charge = h->charge;
+  const auto subcache_type = EffectiveSubCacheType(h->GetSubCacheType());
+  auto old_meta = h->meta.fetch_sub(1, std::memory_order_acq_rel);
+  DCHECK(old_meta & kShareableBit);
+  DCHECK_GT(GetRefs(old_meta), 0);
+  if (GetRefs(old_meta) != 1) {
+    return;
+  }
+  pinned_usage_.fetch_sub(charge, std::memory_order_relaxed);
+  uint64_t expected = GetState(old_meta);
+  DCHECK(expected == kStateVisible || expected == kStateInvisible);
+  if (expected == kStateVisible && (!free_if_no_space || HasFreeSpace(subcache_type))) {
+    return;
+  }
+  // Could fail when somebody acquired a reference concurrently, in this case the entry will be
+  // freed by that thread.
+  if (h->meta.compare_exchange_strong(
+          expected, kStateConstruction, std::memory_order_acq_rel)) {
+    FreeSlot(h);
+  }
+}
+
+void ClockCache::MarkInvisible(ClockHandle* h) {
+  auto meta = h->meta.load(std::memory_order_relaxed);
+  while (GetState(meta) == kStateVisible &&
+         !h->meta.compare_exchange_weak(
+             meta, meta & ~kVisibleBit, std::memory_order_acq_rel)) {
+  }
+}
+
+template <class F>
+void ClockCache::ForEachMatch(const Slice& key, uint32_t hash, const F& f) {
+  const auto increment = ProbeIncrement(hash);
+  auto index = ProbeStart(hash);
+  for (size_t i = 0; i <= table_mask_; ++i) {
+    auto* h = &table_[index];
+    if (GetState(h->meta.load(std::memory_order_acquire)) == kStateVisible &&
+        h->hash.load(std::memory_order_relaxed) == hash && Ref(h)) {
+      if (h->hash.load(std::memory_order_relaxed) == hash && h->key() == key) {
+        f(h);
+      }
+      Unref(h, /* free_if_no_space= */ false);
+    }
+    if (h->displacements.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+    index = (index + increment) & table_mask_;
+  }
+}
+
+ClockHandle* ClockCache::ClaimSlot(uint32_t hash) {
+  const auto increment = ProbeIncrement(hash);
+  const auto start = ProbeStart(hash);
+  auto index = start;
+  for (size_t i = 0; i <= table_mask_; ++i) {
+    auto* h = &table_[index];
+    auto old_meta = h->meta.fetch_or(kOccupiedBit, std::memory_order_acq_rel);
+    if (!(old_meta & kOccupiedBit)) {
+      occupancy_.fetch_add(1, std::memory_order_relaxed);
+      return h;
+    }
+    h->displacements.fetch_add(1, std::memory_order_release);
+    index = (index + increment) & table_mask_;
+  }
+  // Table is full, rollback displacements.
+  index = start;
+  for (size_t i = 0; i <= table_mask_; ++i) {
+    table_[index].displacements.fetch_sub(1, std::memory_order_relaxed);
+    index = (index + increment) & table_mask_;
+  }
+  return nullptr;
+}
+
+void ClockCache::FreeSlot(ClockHandle* h) {
+  const auto charge = h->charge;
+  const auto subcache_type = EffectiveSubCacheType(h->GetSubCacheType());
+  (*h->deleter)(h->key(), h->value);
+  h->heap_key.reset();
+  h->value = nullptr;
+  usage_[subcache_type].fetch_sub(charge, std::memory_order_relaxed);
+  DecrementMetrics(subcache_type, charge);
+  if (!InTable(h)) {
+    delete h;
+    return;
+  }
+
+  const auto hash = h->hash.load(std::memory_order_relaxed);
+  const auto increment = ProbeIncrement(hash);
+  for (auto index = ProbeStart(hash); &table_[index] != h;
+       index = (index + increment) & table_mask_) {
+    table_[index].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  occupancy_.fetch_sub(1, std::memory_order_relaxed);
+  h->meta.store(kStateEmpty, std::memory_order_release);
+}
+
+void ClockCache::DecrementMetrics(SubCacheType subcache_type, size_t charge) {
+  if (!metrics_) {
+    return;
+  }
+  if (subcache_type == MULTI_TOUCH) {
+    metrics_->multi_touch_cache_usage->DecrementBy(charge);
+  } else {
+    metrics_->single_touch_cache_usage->DecrementBy(charge);
+  }
+  metrics_->cache_usage->DecrementBy(charge);
+}
+
+size_t ClockCache::TryEvict(ClockHandle* h, SubCacheType subcache_type) {
+  auto meta = h->meta.load(std::memory_order_acquire);
+  if (GetState(meta) != kStateVisible || GetRefs(meta) != 0 ||
+      EffectiveSubCacheType(h->GetSubCacheType()) != subcache_type) {
+    return 0;
+  }
+  if (h->accessed.load(std::memory_order_relaxed)) {
+    h->accessed.store(false, std::memory_order_relaxed);
+    return 0;
+  }
+  if (!h->meta.compare_exchange_strong(meta, kStateConstruction, std::memory_order_acq_rel)) {
+    return 0;
+  }
+  const auto charge = h->charge;
+  FreeSlot(h);
+  return charge;
+}
+
+template <class NeedMore>
+size_t ClockCache::EvictFromClock(SubCacheType subcache_type, const NeedMore& need_more) {
+  size_t evicted = 0;
+  for (size_t step = 0; step <= 2 * table_mask_ + 1 && need_more(evicted); ++step) {
+    auto index = clock_hand_.fetch_add(1, std::memory_order_relaxed) & table_mask_;
+    evicted += TryEvict(&table_[index], subcache_type);
+  }
+  return evicted;
+}
+
+size_t ClockCache::EvictForCharge(size_t charge, SubCacheType subcache_type) {
+  return EvictFromClock(subcache_type, [this, charge, subcache_type](size_t) {
+    return usage_[subcache_type].load(std::memory_order_relaxed) + charge >
+           GetSubCacheCapacity(subcache_type);
+  });
+}
+
+size_t ClockCache::Evict(size_t required) {
+  auto evicted = EvictFromClock(
+      EffectiveSubCacheType(SINGLE_TOUCH), [required](size_t evicted) {
+    return evicted < required;
+  });
+  return evicted + EvictFromClock(
+      EffectiveSubCacheType(MULTI_TOUCH), [required, evicted](size_t multi_touch_evicted) {
+    return evicted + multi_touch_evicted < required;
+  });
+}
+
+void ClockCache::ApplyToAllCacheEntries(void (*callback)(void*, size_t)) {
+  for (size_t i = 0; i <= table_mask_; ++i) {
+    auto* h = &table_[i];
+    if (GetState(h->meta.load(std::memory_order_acquire)) == kStateVisible && Ref(h)) {
+      callback(h->value, h->charge);
+      Unref(h, /* free_if_no_space= */ false);
+    }
+  }
+}
+
+Cache::Handle* ClockCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                  Statistics* statistics) {
+  ClockHandle* e = nullptr;
+  const auto increment = ProbeIncrement(hash);
+  auto index = ProbeStart(hash);
+  for (size_t i = 0; i <= table_mask_; ++i) {
+    auto* h = &table_[index];
+    if (GetState(h->meta.load(std::memory_order_acquire)) == kStateVisible &&
+        h->hash.load(std::memory_order_relaxed) == hash && Ref(h)) {
+      if (h->hash.load(std::memory_order_relaxed) == hash && h->key() == key) {
+        e = h;
+        break;
+      }
+      Unref(h, /* free_if_no_space= */ false);
+    }
+    if (h->displacements.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+    index = (index + increment) & table_mask_;
+  }
+
+  if (e != nullptr) {
+    // Avoid writing to the shared cache line when flag is already set.
+    if (!e->accessed.load(std::memory_order_relaxed)) {
+      e->accessed.store(true, std::memory_order_relaxed);
+    }
+
+    // Now the handle will be added to the multi touch pool only if it exists.
+    auto entry_query_id = e->query_id.load(std::memory_order_relaxed);
+    if (FLAGS_cache_single_touch_ratio < 1 && entry_query_id != kInMultiTouchId &&
+        entry_query_id != query_id) {
+      EvictForCharge(e->charge, MULTI_TOUCH);
+      if ((!strict_capacity_limit_ ||
+           usage_[MULTI_TOUCH].load(std::memory_order_relaxed) + e->charge <=
+               multi_touch_capacity_.load(std::memory_order_relaxed)) &&
+          e->query_id.compare_exchange_strong(entry_query_id, kInMultiTouchId)) {
+        usage_[SINGLE_TOUCH].fetch_sub(e->charge, std::memory_order_relaxed);
+        usage_[MULTI_TOUCH].fetch_add(e->charge, std::memory_order_relaxed);
+        if (metrics_) {
+          metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
+          metrics_->single_touch_cache_usage->DecrementBy(e->charge);
+        }
+      }
+    }
+    if (statistics != nullptr) {
+      // overall cache hit
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      // total bytes read from cache
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+      if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      }
+    }
+  } else if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_MISS);
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+bool ClockCache::Contains(const Slice& key, uint32_t hash) {
+  bool found = false;
+  ForEachMatch(key, hash, [&found](ClockHandle*) {
+    found = true;
+  });
+  return found;
+}
+
+void ClockCache::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  Unref(reinterpret_cast<ClockHandle*>(handle), /* free_if_no_space= */ true);
+}
+
+void ClockCache::Erase(const Slice& key, uint32_t hash) {
+  ForEachMatch(key, hash, [this](ClockHandle* h) {
+    MarkInvisible(h);
+  });
+}
+
+Status ClockCache::Insert(const Slice& key, uint32_t hash, QueryId query_id, void* value,
+                          size_t charge, void (*deleter)(const Slice& key, void* value),
+                          Cache::Handle** handle, Statistics* statistics) {
+  // Replace existing entries with the same key. Entry goes directly to the multi touch cache when
+  // it replaces multi touch entry or entry added by another query.
+  SubCacheType subcache_type = query_id == kInMultiTouchId ? MULTI_TOUCH : SINGLE_TOUCH;
+  ForEachMatch(key, hash, [this, query_id, &subcache_type](ClockHandle* h) {
+    auto old_query_id = h->query_id.load(std::memory_order_relaxed);
+    if (old_query_id == kInMultiTouchId || old_query_id != query_id) {
+      subcache_type = MULTI_TOUCH;
+    }
+    MarkInvisible(h);
+  });
+  if (FLAGS_cache_single_touch_ratio == 0) {
+    query_id = kInMultiTouchId;
+    subcache_type = MULTI_TOUCH;
+  } else if (FLAGS_cache_single_touch_ratio == 1) {
+    // If there is no multi touch cache, default to single cache.
+    subcache_type = SINGLE_TOUCH;
+  } else if (subcache_type == MULTI_TOUCH) {
+    query_id = kInMultiTouchId;
+  }
+
+  EvictForCharge(charge, subcache_type);
+  if (occupancy_.load(std::memory_order_relaxed) >= max_occupancy_) {
+    auto need_more = [this](size_t) {
+      return occupancy_.load(std::memory_order_relaxed) >= max_occupancy_;
+    };
+    EvictFromClock(EffectiveSubCacheType(SINGLE_TOUCH), need_more);
+    EvictFromClock(EffectiveSubCacheType(MULTI_TOUCH), need_more);
+  }
+
+  Status s;
+  ClockHandle* e = nullptr;
+  bool detached = false;
+  if (strict_capacity_limit_ &&
+      usage_[subcache_type].load(std::memory_order_relaxed) + charge >
+          GetSubCacheCapacity(subcache_type)) {
+    s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+  } else {
+    e = ClaimSlot(hash);
+    if (e == nullptr) {
+      if (strict_capacity_limit_) {
+        s = STATUS(Incomplete, "Insert failed due to CLOCK cache table being full.");
+      } else if (handle != nullptr) {
+        // All slots are referenced. LRU cache goes over capacity in this case, so the caller
+        // still gets the handle. Here the entry is allocated outside of the table, it is not
+        // visible to lookups and is freed when the handle is released.
+        e = new ClockHandle();
+        detached = true;
+      }
+    }
+  }
+
+  if (e == nullptr) {
+    if (handle == nullptr) {
+      (*deleter)(key, value);
+    } else {
+      *handle = nullptr;
+    }
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+    return s;
+  }
+
+  e->hash.store(hash, std::memory_order_relaxed);
+  e->query_id.store(query_id, std::memory_order_relaxed);
+  e->accessed.store(true, std::memory_order_relaxed);
+  e->value = value;
+  e->deleter = deleter;
+  e->charge = charge;
+  e->SetKey(key);
+  usage_[subcache_type].fetch_add(charge, std::memory_order_relaxed);
+  if (handle != nullptr) {
+    pinned_usage_.fetch_add(charge, std::memory_order_relaxed);
+  }
+  // Publish the entry.
+  e->meta.store(
+      (detached ? kStateInvisible : kStateVisible) | (handle != nullptr ? 1 : 0),
+      std::memory_order_release);
+  if (handle != nullptr) {
+    *handle = reinterpret_cast<Cache::Handle*>(e);
+  }
+
+  if (subcache_type == MULTI_TOUCH && FLAGS_cache_single_touch_ratio != 0) {
+    // Evict entries from single touch cache if the total size increases. This can happen if
+    // single touch entries has overflown and we insert entries directly into the multi touch
+    // cache without it going through the single touch cache.
+    EvictForCharge(0, SINGLE_TOUCH);
+  }
+
+  if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_ADD);
+    RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+    if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+      RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+      RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+    }
+  }
+  if (metrics_ != nullptr) {
+    if (subcache_type == MULTI_TOUCH) {
+      metrics_->multi_touch_cache_usage->IncrementBy(charge);
+    } else {
+      metrics_->single_touch_cache_usage->IncrementBy(charge);
+    }
+    metrics_->cache_usage->IncrementBy(charge);
+  }
+  return Status::OK();
+}
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                    size_t estimated_entry_charge)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit) {
+    const int num_shards = 1 << num_shard_bits_;
+    shards_ = new ClockCache[num_shards];
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].Init(per_shard, estimated_entry_charge, strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  // Size of the shard hash tables is not changed, so significant increase of capacity could lead
+  // to eviction because of full tables.
+  void SetCapacity(size_t capacity) override {
+    const int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    MutexLock l(&capacity_mutex_);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  size_t Evict(size_t bytes_to_evict) override {
+    auto num_shards = 1ULL << num_shard_bits_;
+    size_t total_evicted = 0;
+    // Start at random shard.
+    auto index = Shard(yb::RandomUniformInt<uint32_t>());
+    for (size_t i = 0; bytes_to_evict > total_evicted && i != num_shards; ++i) {
+      total_evicted += shards_[index].Evict(bytes_to_evict - total_evicted);
+      index = (index + 1) & (num_shards - 1);
+    }
+    return total_evicted;
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  bool Contains(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Contains(key, hash);
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    auto* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash.load(std::memory_order_relaxed))].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return reinterpret_cast<ClockHandle*>(e)->GetSubCacheType();
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  // Entries are visited without any locks, so thread_safe does not matter.
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    int num_shards = 1 << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> TEST_GetIndividualUsages() override {
+    std::vector<std::pair<size_t, size_t>> cache_sizes;
+    cache_sizes.reserve(1 << num_shard_bits_);
+
+    for (int i = 0; i < 1 << num_shard_bits_; ++i) {
+      cache_sizes.emplace_back(shards_[i].TEST_GetIndividualUsages());
+    }
+    return cache_sizes;
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  static bool IsValidQueryId(const QueryId query_id) {
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+  }
+
+  ClockCache* shards_;
+  port::Mutex capacity_mutex_;
+  std::atomic<uint64_t> last_id_{0};
+  const size_t num_shard_bits_;
+  size_t capacity_;
+  const bool strict_capacity_limit_;
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                                size_t estimated_entry_charge) {
+  if (num_shard_bits > kSharedLRUCacheMaxNumShardBits) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(
+      capacity, num_shard_bits, strict_capacity_limit, estimated_entry_charge);
+}
+
+}  // namespace rocksdb
@@ -25,7 +25,11 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "yb/gutil/macros.h"
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
@@ -48,6 +52,7 @@
 #endif
 
 #if defined(ZSTD)
+#include <zdict.h>
 #include <zstd.h>
 #endif
 
@@ -102,6 +107,7 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
       return LZ4_Supported();
     case kLZ4HCCompression:
       return LZ4_Supported();
+    case kZSTD:
     case kZSTDNotFinalCompression:
       return ZSTD_Supported();
     default:
@@ -124,8 +130,10 @@ inline std::string CompressionTypeToString(CompressionType compression_type) {
       return "LZ4";
     case kLZ4HCCompression:
       return "LZ4HC";
-    case kZSTDNotFinalCompression:
+    case kZSTD:
       return "ZSTD";
+    case kZSTDNotFinalCompression:
+      return "ZSTDNotFinal";
     default:
       assert(false);
       return "";
@@ -620,8 +628,116 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+// Compression level of ZSTD dictionary, when level is not specified in CompressionOptions.
+// Compression without dictionary passes CompressionOptions::level to ZSTD as is, as it always did.
+constexpr int kZSTDDefaultCompressionLevel = 3;
+
+inline int ZSTD_CompressionLevel(const CompressionOptions& opts) {
+  return opts.level == CompressionOptions().level ? kZSTDDefaultCompressionLevel : opts.level;
+}
+
+// Dictionary used to compress data blocks of SST file with ZSTD.
+// Holds compression context, so should be used by single thread only.
+class ZSTDCompressionDict {
+ public:
+  ZSTDCompressionDict(std::string dict, int level) : dict_(std::move(dict)) {
+#ifdef ZSTD
+    cdict_ = ZSTD_createCDict(dict_.data(), dict_.size(), level);
+    context_ = ZSTD_createCCtx();
+#endif
+  }
+
+  ~ZSTDCompressionDict() {
+#ifdef ZSTD
+    ZSTD_freeCCtx(context_);
+    ZSTD_freeCDict(cdict_);
+#endif
+  }
+
+  const std::string& raw() const {
+    return dict_;
+  }
+
+#ifdef ZSTD
+  ZSTD_CDict* cdict() const {
+    return cdict_;
+  }
+
+  ZSTD_CCtx* context() const {
+    return context_;
+  }
+#endif
+
+ private:
+  std::string dict_;
+#ifdef ZSTD
+  ZSTD_CDict* cdict_ = nullptr;
+  ZSTD_CCtx* context_ = nullptr;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(ZSTDCompressionDict);
+};
+
+// Dictionary used to uncompress data blocks of SST file with ZSTD. Thread safe.
+class ZSTDUncompressionDict {
+ public:
+  explicit ZSTDUncompressionDict(std::string dict) : dict_(std::move(dict)) {
+#ifdef ZSTD
+    ddict_ = ZSTD_createDDict(dict_.data(), dict_.size());
+#endif
+  }
+
+  ~ZSTDUncompressionDict() {
+#ifdef ZSTD
+    ZSTD_freeDDict(ddict_);
+#endif
+  }
+
+  const std::string& raw() const {
+    return dict_;
+  }
+
+#ifdef ZSTD
+  ZSTD_DDict* ddict() const {
+    return ddict_;
+  }
+#endif
+
+ private:
+  std::string dict_;
+#ifdef ZSTD
+  ZSTD_DDict* ddict_ = nullptr;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(ZSTDUncompressionDict);
+};
+
+// Trains ZSTD dictionary of at most max_dict_bytes from samples concatenated in a single buffer.
+// Returns empty string when dictionary could not be trained, for instance because there are not
+// enough samples.
+inline std::string ZSTD_TrainDictionary(
+    const std::string& samples, const std::vector<size_t>& sample_lengths,
+    size_t max_dict_bytes) {
+#ifdef ZSTD
+  if (sample_lengths.empty() || max_dict_bytes == 0) {
+    return std::string();
+  }
+  std::string dict(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict[0], max_dict_bytes, samples.data(), sample_lengths.data(),
+      static_cast<unsigned>(sample_lengths.size()));
+  if (ZDICT_isError(dict_len)) {
+    return std::string();
+  }
+  dict.resize(dict_len);
+  return dict;
+#endif
+  return std::string();
+}
+
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const ZSTDCompressionDict* dict = nullptr) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +749,16 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen;
+  if (dict != nullptr && dict->cdict() != nullptr) {
+    outlen = ZSTD_compress_usingCDict(
+        dict->context(), &(*output)[output_header_len], compressBound, input, length,
+        dict->cdict());
+  } else {
+    outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
+                           input, length, opts.level);
+  }
+  if (ZSTD_isError(outlen) || outlen == 0) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -644,8 +767,17 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
   return false;
 }
 
+#ifdef ZSTD
+inline ZSTD_DCtx* ZSTD_ThreadLocalDecompressionContext() {
+  static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(
+      ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  return context.get();
+}
+#endif
+
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const ZSTDUncompressionDict* dict = nullptr) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -653,12 +785,20 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
-  char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+  std::unique_ptr<char[]> output(new char[output_len]);
+  size_t actual_output_length;
+  if (dict != nullptr && dict->ddict() != nullptr) {
+    actual_output_length = ZSTD_decompress_usingDDict(
+        ZSTD_ThreadLocalDecompressionContext(), output.get(), output_len, input_data,
+        input_length, dict->ddict());
+  } else {
+    actual_output_length = ZSTD_decompress(output.get(), output_len, input_data, input_length);
+  }
+  if (ZSTD_isError(actual_output_length) || actual_output_length != output_len) {
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
-  return output;
+  return output.release();
 #endif
   return nullptr;
 }
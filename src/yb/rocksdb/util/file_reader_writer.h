@@ -116,6 +116,7 @@ class RandomAccessFileReader {
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
   Status ReadAndValidate(
       uint64_t offset, size_t n, Slice* result, char* scratch, const yb::ReadValidator& validator);
+  Status MultiRead(yb::ReadRequest* requests, size_t num_requests) const;
 
   RandomAccessFile* file() { return file_.get(); }
 };
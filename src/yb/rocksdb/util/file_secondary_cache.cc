@@ -0,0 +1,523 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/gutil/strings/util.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/secondary_cache.h"
+#include "yb/rocksdb/util/crc32c.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/cast.h"
+#include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/status_format.h"
+#include "yb/util/status_log.h"
+#include "yb/util/thread.h"
+
+namespace rocksdb {
+
+namespace {
+
+const std::string kSegmentFileSuffix = ".sbc";
+
+// Approximate memory used by the index entry, in addition to the key itself.
+constexpr size_t kIndexEntryOverhead = 64;
+
+// Log structured secondary cache.
+//
+// Entries are appended to the newest segment file. Insert is called on the block cache eviction
+// path, so it only copies the data to in-memory buffers of write_buffer_size. The copy is made
+// before taking the lock, so the lock is held only to update the index. Filled buffers are written
+// to the file by the background writer thread, and lookups of entries that are not written yet are
+// served from memory.
+// When disk usage exceeds disk_capacity, the oldest segment is dropped with all its entries, its
+// file is deleted by the writer thread.
+//
+// Admission control: an entry is rejected when it is already present, when it does not fit into
+// the segment, or when the memory limit is reached, i.e. when writes do not keep up with evictions.
+class FileSecondaryCache : public SecondaryCache {
+ public:
+  explicit FileSecondaryCache(const FileSecondaryCacheOptions& options)
+      : options_(options), env_(options.env ? options.env : Env::Default()) {
+    if (options.mem_tracker) {
+      memory_consumption_ = yb::ScopedTrackedConsumption(options.mem_tracker, 0);
+    }
+  }
+
+  ~FileSecondaryCache() {
+    {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+    }
+    writer_cond_.notify_all();
+    if (writer_thread_) {
+      writer_thread_->Join();
+    }
+    if (writer_) {
+      WARN_NOT_OK(writer_->Close(), "Failed to close secondary cache file");
+    }
+    for (const auto& id_and_segment : segments_) {
+      WARN_NOT_OK(env_->DeleteFile(id_and_segment.second.path),
+                  "Failed to delete secondary cache file");
+    }
+    DeleteFiles(dropped_files_);
+  }
+
+  Status Init() {
+    RETURN_NOT_OK(env_->CreateDirIfMissing(options_.dir));
+    // The index is not persistent, so files left from the previous run are useless.
+    std::vector<std::string> children;
+    RETURN_NOT_OK(env_->GetChildren(options_.dir, &children));
+    for (const auto& child : children) {
+      if (HasSuffixString(child, kSegmentFileSuffix)) {
+        RETURN_NOT_OK(env_->DeleteFile(SegmentPath(child)));
+      }
+    }
+    return yb::Thread::Create(
+        "rocksdb", "secondary_cache_writer", &FileSecondaryCache::WriterLoop, this,
+        &writer_thread_);
+  }
+
+  void Insert(const Slice& key, const Slice& contents) override {
+    if (contents.size() > options_.segment_size) {
+      IncrementCounter(&yb::SecondaryCacheMetrics::admission_rejects);
+      return;
+    }
+    std::string key_str = key.ToBuffer();
+    std::string data = contents.ToBuffer();
+    bool notify_writer;
+    {
+      std::lock_guard lock(mutex_);
+      if (index_.count(key_str)) {
+        return;
+      }
+      const size_t entry_memory = key.size() + kIndexEntryOverhead;
+      if (memory_usage_ + entry_memory + data.size() > options_.memory_capacity) {
+        IncrementCounter(&yb::SecondaryCacheMetrics::admission_rejects);
+        return;
+      }
+
+      auto* segment = active_segment_id_ ? &segments_[active_segment_id_] : nullptr;
+      if (!segment || segment->size + data.size() > options_.segment_size) {
+        SealActiveBuffer();
+        active_segment_id_ = ++last_segment_id_;
+        segment = &segments_[active_segment_id_];
+        segment->path = SegmentPath(std::to_string(active_segment_id_) + kSegmentFileSuffix);
+      }
+      if (!active_buffer_) {
+        active_buffer_ = std::make_shared<Buffer>();
+        active_buffer_->segment_id = active_segment_id_;
+        active_buffer_->offset = segment->size;
+        active_buffer_->first_key_idx = segment->keys.size();
+      }
+
+      // Checksum is calculated by the writer thread.
+      index_.emplace(key_str, Location {
+        .segment_id = active_segment_id_,
+        .offset = segment->size,
+        .size = static_cast<uint32_t>(data.size()),
+        .crc = 0,
+      });
+      segment->keys.push_back(std::move(key_str));
+      disk_usage_ += data.size();
+      memory_usage_ += entry_memory + data.size();
+      active_buffer_->entry_offsets.push_back(segment->size);
+      active_buffer_->size += data.size();
+      segment->size += data.size();
+      active_buffer_->entries.push_back(std::move(data));
+
+      if (active_buffer_->size >= options_.write_buffer_size) {
+        SealActiveBuffer();
+      }
+      DropSegmentsIfNecessary();
+      notify_writer = !sealed_buffers_.empty() || !dropped_files_.empty();
+      UpdateUsage();
+    }
+    IncrementCounter(&yb::SecondaryCacheMetrics::inserts);
+
+    if (notify_writer) {
+      writer_cond_.notify_one();
+    }
+  }
+
+  bool Lookup(const Slice& key, std::unique_ptr<char[]>* contents, size_t* size) override {
+    IncrementCounter(&yb::SecondaryCacheMetrics::lookups);
+    const auto key_str = key.ToBuffer();
+    Location location;
+    std::shared_ptr<RandomAccessFile> reader;
+    // Buffer that contains the entry, when it is not written to the file yet. Buffer is kept alive
+    // by the pointer, and its existing entries are not modified, so the entry is copied after the
+    // lock is released.
+    std::shared_ptr<const Buffer> memory_buffer;
+    const std::string* entry = nullptr;
+    {
+      std::lock_guard lock(mutex_);
+      auto it = index_.find(key_str);
+      if (it == index_.end()) {
+        return false;
+      }
+      location = it->second;
+      const auto& segment = segments_[location.segment_id];
+      if (location.offset + location.size <= segment.written_size) {
+        reader = segment.reader;
+      } else {
+        memory_buffer = FindBuffer(location);
+        if (!memory_buffer) {
+          return false;
+        }
+        entry = memory_buffer->FindEntry(location.offset);
+        if (!entry) {
+          return false;
+        }
+      }
+    }
+
+    if (entry) {
+      contents->reset(new char[entry->size()]);
+      memcpy(contents->get(), entry->data(), entry->size());
+      *size = entry->size();
+      IncrementCounter(&yb::SecondaryCacheMetrics::cache_hits);
+      return true;
+    }
+
+    std::unique_ptr<char[]> buffer(new char[location.size]);
+    Slice result;
+    auto status = reader
+        ? reader->Read(location.offset, location.size, &result,
+                       pointer_cast<uint8_t*>(buffer.get()))
+        : STATUS(IllegalState, "Secondary cache file is not available");
+    if (status.ok() && result.size() != location.size) {
+      status = STATUS_FORMAT(
+          Corruption, "Read $0 bytes instead of $1", result.size(), location.size);
+    }
+    if (status.ok() && crc32c::Value(result.cdata(), result.size()) != location.crc) {
+      status = STATUS(Corruption, "Secondary cache entry checksum mismatch");
+    }
+    if (!status.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 10)
+          << "Failed to read secondary cache entry from segment " << location.segment_id << ": "
+          << status;
+      IncrementCounter(&yb::SecondaryCacheMetrics::read_errors);
+      EraseLocation(key, location.segment_id);
+      return false;
+    }
+    if (result.data() != pointer_cast<const uint8_t*>(buffer.get())) {
+      memcpy(buffer.get(), result.data(), result.size());
+    }
+    *contents = std::move(buffer);
+    *size = location.size;
+    IncrementCounter(&yb::SecondaryCacheMetrics::cache_hits);
+    return true;
+  }
+
+  void Erase(const Slice& key) override {
+    const auto key_str = key.ToBuffer();
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(key_str);
+    if (it != index_.end()) {
+      EraseIndexEntry(it);
+    }
+  }
+
+  size_t GetDiskUsage() const override {
+    std::lock_guard lock(mutex_);
+    return disk_usage_;
+  }
+
+  size_t GetMemoryUsage() const override {
+    std::lock_guard lock(mutex_);
+    return memory_usage_;
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    metrics_ = std::make_shared<yb::SecondaryCacheMetrics>(entity);
+  }
+
+  void TEST_WaitWritesCompleted() override {
+    std::unique_lock lock(mutex_);
+    writes_completed_cond_.wait(lock, [this]() REQUIRES(mutex_) {
+      return sealed_buffers_.empty() && dropped_files_.empty() && !writer_busy_;
+    });
+  }
+
+ private:
+  struct Location {
+    uint64_t segment_id;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t crc;
+  };
+
+  struct Segment {
+    std::string path;
+    // Number of bytes appended to the segment, including bytes that are not written yet.
+    uint64_t size = 0;
+    // Number of bytes written to the file.
+    uint64_t written_size = 0;
+    // Keys of entries appended to the segment, used to clean up the index when segment is dropped.
+    std::vector<std::string> keys;
+    std::shared_ptr<RandomAccessFile> reader;
+  };
+
+  // Data appended to the segment, that is not written to the file yet.
+  struct Buffer {
+    uint64_t segment_id;
+    uint64_t offset;
+    // Total size of the entries.
+    uint64_t size = 0;
+    // Index of the first entry of the buffer in Segment::keys.
+    size_t first_key_idx;
+    // Entries in the order they were appended. Appending to deque does not move existing entries,
+    // so they could be read without the lock.
+    std::deque<std::string> entries;
+    // Segment offsets of the entries.
+    std::vector<uint64_t> entry_offsets;
+
+    const std::string* FindEntry(uint64_t entry_offset) const {
+      auto it = std::lower_bound(entry_offsets.begin(), entry_offsets.end(), entry_offset);
+      if (it == entry_offsets.end() || *it != entry_offset) {
+        return nullptr;
+      }
+      return &entries[it - entry_offsets.begin()];
+    }
+  };
+
+  using Index = std::unordered_map<std::string, Location>;
+
+  std::string SegmentPath(const std::string& name) const {
+    return options_.dir + "/" + name;
+  }
+
+  void IncrementCounter(scoped_refptr<yb::Counter> yb::SecondaryCacheMetrics::*counter) {
+    if (metrics_) {
+      ((*metrics_).*counter)->Increment();
+    }
+  }
+
+  void UpdateUsage() REQUIRES(mutex_) {
+    if (memory_consumption_) {
+      memory_consumption_.Reset(memory_usage_);
+    }
+    if (metrics_) {
+      metrics_->disk_usage->set_value(disk_usage_);
+      metrics_->memory_usage->set_value(memory_usage_);
+    }
+  }
+
+  void SealActiveBuffer() REQUIRES(mutex_) {
+    if (active_buffer_) {
+      sealed_buffers_.push_back(std::move(active_buffer_));
+      active_buffer_.reset();
+    }
+  }
+
+  std::shared_ptr<const Buffer> FindBuffer(const Location& location) const REQUIRES(mutex_) {
+    auto contains = [&location](const Buffer& buffer) {
+      return buffer.segment_id == location.segment_id && buffer.offset <= location.offset &&
+             location.offset + location.size <= buffer.offset + buffer.size;
+    };
+    if (active_buffer_ && contains(*active_buffer_)) {
+      return active_buffer_;
+    }
+    for (const auto& buffer : sealed_buffers_) {
+      if (contains(*buffer)) {
+        return buffer;
+      }
+    }
+    return nullptr;
+  }
+
+  void EraseIndexEntry(Index::iterator it) REQUIRES(mutex_) {
+    memory_usage_ -= it->first.size() + kIndexEntryOverhead;
+    index_.erase(it);
+    UpdateUsage();
+  }
+
+  void EraseLocation(const Slice& key, uint64_t segment_id) {
+    const auto key_str = key.ToBuffer();
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(key_str);
+    if (it != index_.end() && it->second.segment_id == segment_id) {
+      EraseIndexEntry(it);
+    }
+  }
+
+  // Drops the oldest segments until disk usage fits into the disk capacity. Only fully written
+  // segments could be dropped. Files of dropped segments are deleted by the writer thread.
+  void DropSegmentsIfNecessary() REQUIRES(mutex_) {
+    while (disk_usage_ > options_.disk_capacity && segments_.size() > 1) {
+      auto it = segments_.begin();
+      auto& segment = it->second;
+      if (it->first == active_segment_id_ || segment.written_size != segment.size) {
+        break;
+      }
+      for (const auto& key : segment.keys) {
+        auto index_it = index_.find(key);
+        if (index_it != index_.end() && index_it->second.segment_id == it->first) {
+          EraseIndexEntry(index_it);
+        }
+      }
+      disk_usage_ -= segment.size;
+      dropped_files_.push_back(std::move(segment.path));
+      segments_.erase(it);
+      IncrementCounter(&yb::SecondaryCacheMetrics::dropped_segments);
+    }
+  }
+
+  void DeleteFiles(const std::vector<std::string>& files) {
+    for (const auto& file : files) {
+      WARN_NOT_OK(env_->DeleteFile(file), "Failed to delete secondary cache file");
+    }
+  }
+
+  // Body of the writer thread. Writes sealed buffers to segment files, in the order they were
+  // sealed, and deletes files of dropped segments.
+  void WriterLoop() {
+    std::unique_lock lock(mutex_);
+    for (;;) {
+      writer_cond_.wait(lock, [this]() REQUIRES(mutex_) {
+        return stop_ || !sealed_buffers_.empty() || !dropped_files_.empty();
+      });
+      if (stop_) {
+        break;
+      }
+      writer_busy_ = true;
+      auto dropped_files = std::move(dropped_files_);
+      dropped_files_.clear();
+      std::shared_ptr<Buffer> buffer;
+      std::string path;
+      if (!sealed_buffers_.empty()) {
+        buffer = sealed_buffers_.front();
+        path = segments_[buffer->segment_id].path;
+      }
+      lock.unlock();
+
+      DeleteFiles(dropped_files);
+      std::shared_ptr<RandomAccessFile> new_reader;
+      std::vector<uint32_t> crcs;
+      if (buffer) {
+        crcs.reserve(buffer->entries.size());
+        for (const auto& entry : buffer->entries) {
+          crcs.push_back(crc32c::Value(entry.data(), entry.size()));
+        }
+        auto status = WriteBuffer(*buffer, path, &new_reader);
+        if (!status.ok()) {
+          // Entries of the buffer are reported as read errors and removed from the index on
+          // lookup.
+          YB_LOG_EVERY_N_SECS(WARNING, 10)
+              << "Failed to write secondary cache file " << path << ": " << status;
+          IncrementCounter(&yb::SecondaryCacheMetrics::write_errors);
+        }
+      }
+
+      lock.lock();
+      writer_busy_ = false;
+      if (buffer) {
+        sealed_buffers_.pop_front();
+        auto& segment = segments_[buffer->segment_id];
+        for (size_t i = 0; i != crcs.size(); ++i) {
+          auto it = index_.find(segment.keys[buffer->first_key_idx + i]);
+          // Entry could be erased, and then inserted again at the other location.
+          if (it != index_.end() && it->second.segment_id == buffer->segment_id &&
+              it->second.offset == buffer->entry_offsets[i]) {
+            it->second.crc = crcs[i];
+          }
+        }
+        segment.written_size = buffer->offset + buffer->size;
+        if (new_reader) {
+          segment.reader = std::move(new_reader);
+        }
+        memory_usage_ -= buffer->size;
+        DropSegmentsIfNecessary();
+        UpdateUsage();
+      }
+      writes_completed_cond_.notify_all();
+    }
+  }
+
+  Status WriteBuffer(
+      const Buffer& buffer, const std::string& path,
+      std::shared_ptr<RandomAccessFile>* new_reader) {
+    if (!writer_ || writer_segment_id_ != buffer.segment_id) {
+      if (writer_) {
+        WARN_NOT_OK(writer_->Close(), "Failed to close secondary cache file");
+        writer_.reset();
+      }
+      EnvOptions env_options;
+      RETURN_NOT_OK(env_->NewWritableFile(path, &writer_, env_options));
+      writer_segment_id_ = buffer.segment_id;
+      std::unique_ptr<RandomAccessFile> reader;
+      RETURN_NOT_OK(env_->NewRandomAccessFile(path, &reader, env_options));
+      *new_reader = std::move(reader);
+    }
+    std::string data;
+    data.reserve(buffer.size);
+    for (const auto& entry : buffer.entries) {
+      data.append(entry);
+    }
+    RETURN_NOT_OK(writer_->Append(data));
+    return writer_->Flush();
+  }
+
+  const FileSecondaryCacheOptions options_;
+  Env* const env_;
+  std::shared_ptr<yb::SecondaryCacheMetrics> metrics_;
+
+  mutable std::mutex mutex_;
+  Index index_ GUARDED_BY(mutex_);
+  // Segments ordered from the oldest to the newest.
+  std::map<uint64_t, Segment> segments_ GUARDED_BY(mutex_);
+  uint64_t last_segment_id_ GUARDED_BY(mutex_) = 0;
+  uint64_t active_segment_id_ GUARDED_BY(mutex_) = 0;
+  std::shared_ptr<Buffer> active_buffer_ GUARDED_BY(mutex_);
+  std::deque<std::shared_ptr<Buffer>> sealed_buffers_ GUARDED_BY(mutex_);
+  // Files of dropped segments, that should be deleted by the writer thread.
+  std::vector<std::string> dropped_files_ GUARDED_BY(mutex_);
+  size_t disk_usage_ GUARDED_BY(mutex_) = 0;
+  size_t memory_usage_ GUARDED_BY(mutex_) = 0;
+  yb::ScopedTrackedConsumption memory_consumption_ GUARDED_BY(mutex_);
+  bool stop_ GUARDED_BY(mutex_) = false;
+  // Whether the writer thread is processing data taken from sealed_buffers_ or dropped_files_.
+  bool writer_busy_ GUARDED_BY(mutex_) = false;
+  std::condition_variable writer_cond_;
+  std::condition_variable writes_completed_cond_;
+
+  // Accessed only by the writer thread, and by destructor after the writer thread is joined.
+  std::unique_ptr<WritableFile> writer_;
+  uint64_t writer_segment_id_ = 0;
+  scoped_refptr<yb::Thread> writer_thread_;
+};
+
+} // namespace
+
+yb::Result<std::shared_ptr<SecondaryCache>> NewFileSecondaryCache(
+    const FileSecondaryCacheOptions& options) {
+  SCHECK(!options.dir.empty(), InvalidArgument, "Secondary cache directory is not specified");
+  SCHECK_GT(options.disk_capacity, 0U, InvalidArgument, "Secondary cache disk capacity is zero");
+  auto result = std::make_shared<FileSecondaryCache>(options);
+  RETURN_NOT_OK(result->Init());
+  return std::shared_ptr<SecondaryCache>(std::move(result));
+}
+
+}  // namespace rocksdb
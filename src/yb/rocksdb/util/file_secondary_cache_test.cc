@@ -0,0 +1,198 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/secondary_cache.h"
+#include "yb/rocksdb/util/testharness.h"
+#include "yb/rocksdb/util/testutil.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/test_macros.h"
+
+namespace rocksdb {
+
+class FileSecondaryCacheTest : public RocksDBTest {
+ protected:
+  void SetUp() override {
+    RocksDBTest::SetUp();
+    options_.dir = test::TmpDir(Env::Default()) + "/secondary_cache";
+    options_.disk_capacity = 64 * 1024;
+    options_.segment_size = 16 * 1024;
+    options_.write_buffer_size = 4 * 1024;
+  }
+
+  void CreateCache() {
+    cache_ = ASSERT_RESULT(NewFileSecondaryCache(options_));
+  }
+
+  static std::string Key(int i) {
+    return "key" + std::to_string(i);
+  }
+
+  static std::string Value(int i, size_t size) {
+    return std::string(size, static_cast<char>('a' + i % 26));
+  }
+
+  // Returns contents for key, or empty string if cache does not contain it.
+  std::string Lookup(const std::string& key) {
+    std::unique_ptr<char[]> contents;
+    size_t size = 0;
+    if (!cache_->Lookup(key, &contents, &size)) {
+      return std::string();
+    }
+    return std::string(contents.get(), size);
+  }
+
+  size_t NumSegmentFiles() {
+    std::vector<std::string> children;
+    EXPECT_OK(Env::Default()->GetChildren(options_.dir, &children));
+    size_t result = 0;
+    for (const auto& child : children) {
+      if (child != "." && child != "..") {
+        ++result;
+      }
+    }
+    return result;
+  }
+
+  FileSecondaryCacheOptions options_;
+  std::shared_ptr<SecondaryCache> cache_;
+};
+
+TEST_F(FileSecondaryCacheTest, InsertLookup) {
+  CreateCache();
+  constexpr int kNumEntries = 20;
+  constexpr size_t kValueSize = 1000;
+  for (int i = 0; i != kNumEntries; ++i) {
+    cache_->Insert(Key(i), Value(i, kValueSize));
+  }
+  ASSERT_EQ(kNumEntries * kValueSize, cache_->GetDiskUsage());
+  // Part of the entries is written to the file, the rest is still in memory.
+  cache_->TEST_WaitWritesCompleted();
+  ASSERT_GT(NumSegmentFiles(), 0U);
+  for (int i = 0; i != kNumEntries; ++i) {
+    ASSERT_EQ(Value(i, kValueSize), Lookup(Key(i)));
+  }
+  ASSERT_EQ("", Lookup(Key(kNumEntries)));
+
+  // Entry that is already present is not overwritten.
+  cache_->Insert(Key(0), Value(1, kValueSize));
+  ASSERT_EQ(Value(0, kValueSize), Lookup(Key(0)));
+  ASSERT_EQ(kNumEntries * kValueSize, cache_->GetDiskUsage());
+
+  cache_->Erase(Key(0));
+  ASSERT_EQ("", Lookup(Key(0)));
+}
+
+TEST_F(FileSecondaryCacheTest, DropOldestSegment) {
+  CreateCache();
+  constexpr int kNumEntries = 200;
+  constexpr size_t kValueSize = 1000;
+  for (int i = 0; i != kNumEntries; ++i) {
+    cache_->Insert(Key(i), Value(i, kValueSize));
+    // Segments are dropped only after they are written.
+    cache_->TEST_WaitWritesCompleted();
+    ASSERT_LE(cache_->GetDiskUsage(), options_.disk_capacity + options_.segment_size);
+  }
+  // The oldest entries are dropped together with their segments, the newest ones are kept.
+  ASSERT_EQ("", Lookup(Key(0)));
+  ASSERT_EQ(Value(kNumEntries - 1, kValueSize), Lookup(Key(kNumEntries - 1)));
+  ASSERT_LE(NumSegmentFiles(), (options_.disk_capacity / options_.segment_size) + 2);
+}
+
+TEST_F(FileSecondaryCacheTest, Admission) {
+  options_.memory_capacity = 8 * 1024;
+  options_.write_buffer_size = 64 * 1024;
+  CreateCache();
+  // Entry larger than the segment is rejected.
+  cache_->Insert(Key(0), Value(0, options_.segment_size + 1));
+  ASSERT_EQ("", Lookup(Key(0)));
+
+  // Data is not written while write buffer is not full, so memory limit rejects new entries.
+  constexpr size_t kValueSize = 1000;
+  for (int i = 1; i != 20; ++i) {
+    cache_->Insert(Key(i), Value(i, kValueSize));
+  }
+  ASSERT_LE(cache_->GetMemoryUsage(), options_.memory_capacity);
+  ASSERT_EQ(Value(1, kValueSize), Lookup(Key(1)));
+  ASSERT_EQ("", Lookup(Key(19)));
+}
+
+TEST_F(FileSecondaryCacheTest, MemTracker) {
+  options_.mem_tracker = yb::MemTracker::CreateTracker("secondary_cache");
+  CreateCache();
+  auto memory_usage = [this] {
+    return static_cast<int64_t>(cache_->GetMemoryUsage());
+  };
+  for (int i = 0; i != 20; ++i) {
+    cache_->Insert(Key(i), Value(i, 1000));
+    // Wait for the writer thread, so memory usage is not changed concurrently.
+    cache_->TEST_WaitWritesCompleted();
+    ASSERT_EQ(options_.mem_tracker->consumption(), memory_usage());
+    ASSERT_GT(memory_usage(), 0);
+  }
+  cache_->Erase(Key(0));
+  ASSERT_EQ(options_.mem_tracker->consumption(), memory_usage());
+  cache_.reset();
+  ASSERT_EQ(options_.mem_tracker->consumption(), 0);
+}
+
+// Entries are copied out of the lock, so concurrent inserts and lookups should see complete data.
+TEST_F(FileSecondaryCacheTest, Concurrent) {
+  options_.disk_capacity = 1024 * 1024;
+  options_.memory_capacity = 16 * 1024 * 1024;
+  CreateCache();
+  constexpr int kNumThreads = 4;
+  constexpr int kNumEntriesPerThread = 200;
+  constexpr size_t kValueSize = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = t * kNumEntriesPerThread; i != (t + 1) * kNumEntriesPerThread; ++i) {
+        cache_->Insert(Key(i), Value(i, kValueSize));
+        ASSERT_EQ(Value(i, kValueSize), Lookup(Key(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(kNumThreads * kNumEntriesPerThread * kValueSize, cache_->GetDiskUsage());
+}
+
+TEST_F(FileSecondaryCacheTest, RemoveFilesOnStart) {
+  CreateCache();
+  for (int i = 0; i != 20; ++i) {
+    cache_->Insert(Key(i), Value(i, 1000));
+  }
+  cache_->TEST_WaitWritesCompleted();
+  ASSERT_GT(NumSegmentFiles(), 0U);
+  // Keep the old cache alive, so its files are not removed by the cache itself, as after crash.
+  auto old_cache = std::move(cache_);
+  CreateCache();
+  ASSERT_EQ(0U, NumSegmentFiles());
+  ASSERT_EQ("", Lookup(Key(0)));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef GFLAGS
+#include <cstdio>
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <algorithm>
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yb/util/flags.h"
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/util/random.h"
+
+using GFLAGS::ParseCommandLineFlags;
+using GFLAGS::SetUsageMessage;
+
+DEFINE_UNKNOWN_int64(num_keys, 1000000, "Number of keys added to filter blocks.");
+DEFINE_UNKNOWN_int64(num_queries, 1000000,
+                     "Number of queries for existing and for non-existing keys each.");
+DEFINE_UNKNOWN_int64(filter_block_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits,
+                     "Size of each filter block in bits.");
+DEFINE_UNKNOWN_double(error_rate, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+                      "Expected false positive rate of each filter block.");
+
+namespace rocksdb {
+
+namespace {
+
+// Even numbers are used for keys added to filter, odd numbers for keys that are not in filter,
+// so both kinds of keys are spread over all filter blocks.
+std::string MakeKey(int64_t i) {
+  char buf[100];
+  snprintf(buf, sizeof(buf), "%04d__key___%016" PRId64, static_cast<int>(i % 1000), i);
+  return std::string(buf);
+}
+
+struct FilterBlock {
+  // Index of the first key in this block.
+  int64_t first_key;
+  std::unique_ptr<const char[]> buf;
+  std::unique_ptr<FilterBitsReader> reader;
+};
+
+// Builds fixed-size filter blocks of specified format the same way BlockBasedTableBuilder does,
+// then probes them with existing and non-existing keys in random order.
+// Prints average time of single probe, observed false positive rate and size of filter per key.
+void FilterBenchmark(FixedSizeFilterFormat format) {
+  std::unique_ptr<const FilterPolicy> policy(NewFixedSizeFilterPolicy(
+      FLAGS_filter_block_bits, FLAGS_error_rate, /* logger = */ nullptr, format));
+  std::vector<FilterBlock> blocks;
+  size_t filter_size = 0;
+
+  std::unique_ptr<FilterBitsBuilder> builder;
+  int64_t first_key = 0;
+  auto finish_block = [&](int64_t next_key) {
+    FilterBlock block {
+      .first_key = first_key,
+    };
+    auto filter = builder->Finish(&block.buf);
+    filter_size += filter.size();
+    block.reader.reset(policy->GetFilterBitsReader(filter));
+    blocks.push_back(std::move(block));
+    builder.reset();
+    first_key = next_key;
+  };
+  for (int64_t i = 0; i != FLAGS_num_keys; ++i) {
+    if (!builder) {
+      builder.reset(policy->GetFilterBitsBuilder());
+    }
+    builder->AddKey(MakeKey(i * 2));
+    if (builder->IsFull()) {
+      finish_block(i + 1);
+    }
+  }
+  if (builder) {
+    finish_block(FLAGS_num_keys);
+  }
+
+  Random64 rnd(301);
+  std::vector<std::string> existing_keys;
+  std::vector<std::string> missing_keys;
+  existing_keys.reserve(FLAGS_num_queries);
+  missing_keys.reserve(FLAGS_num_queries);
+  std::vector<FilterBitsReader*> existing_readers;
+  std::vector<FilterBitsReader*> missing_readers;
+  auto reader_for_key = [&blocks](int64_t key_idx) {
+    auto it = std::upper_bound(
+        blocks.begin(), blocks.end(), key_idx, [](int64_t idx, const FilterBlock& block) {
+      return idx < block.first_key;
+    });
+    return std::prev(it)->reader.get();
+  };
+  for (int64_t i = 0; i != FLAGS_num_queries; ++i) {
+    auto key_idx = static_cast<int64_t>(rnd.Uniform(FLAGS_num_keys));
+    existing_keys.push_back(MakeKey(key_idx * 2));
+    existing_readers.push_back(reader_for_key(key_idx));
+    missing_keys.push_back(MakeKey(key_idx * 2 + 1));
+    missing_readers.push_back(reader_for_key(key_idx));
+  }
+
+  auto* env = Env::Default();
+  auto probe = [env](
+      const std::vector<std::string>& keys, const std::vector<FilterBitsReader*>& readers,
+      size_t* matches) {
+    auto start = env->NowNanos();
+    for (size_t i = 0; i != keys.size(); ++i) {
+      *matches += readers[i]->MayMatch(keys[i]);
+    }
+    return static_cast<double>(env->NowNanos() - start) / std::max<size_t>(keys.size(), 1);
+  };
+
+  size_t existing_matches = 0;
+  size_t false_positives = 0;
+  auto existing_ns = probe(existing_keys, existing_readers, &existing_matches);
+  auto missing_ns = probe(missing_keys, missing_readers, &false_positives);
+  if (existing_matches != existing_keys.size()) {
+    fprintf(stderr, "False negatives: %zu\n", existing_keys.size() - existing_matches);
+    abort();
+  }
+
+  fprintf(
+      stderr,
+      "%-40s blocks: %6zu  bits/key: %6.3f  fp rate: %7.4f%%  "
+      "existing key probe: %7.1f ns  missing key probe: %7.1f ns\n",
+      policy->Name(), blocks.size(), filter_size * 8.0 / FLAGS_num_keys,
+      false_positives * 100.0 / std::max<size_t>(missing_keys.size(), 1), existing_ns, missing_ns);
+}
+
+}  // namespace
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  SetUsageMessage(std::string("\nUSAGE:\n") + std::string(argv[0]) + " [OPTIONS]...");
+  ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_num_keys <= 0 || FLAGS_num_queries < 0) {
+    fprintf(stderr, "num_keys should be positive and num_queries should not be negative\n");
+    return 1;
+  }
+
+  for (auto format : rocksdb::FixedSizeFilterFormatList()) {
+    rocksdb::FilterBenchmark(format);
+  }
+
+  return 0;
+}
+
+#endif  // GFLAGS
@@ -94,6 +94,8 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       mem_tracker(options.mem_tracker),
       block_based_table_mem_tracker(options.block_based_table_mem_tracker),
       iterator_replacer(options.iterator_replacer),
+      memtable_insert_thread_pool(options.memtable_insert_thread_pool),
+      memtable_insert_min_entries_per_thread(options.memtable_insert_min_entries_per_thread),
       compaction_file_filter_factory(options.compaction_file_filter_factory.get()),
       priority_thread_pool_metrics(options.priority_thread_pool_metrics) {}
 
@@ -455,6 +457,10 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "  Options.compression_opts.zstd_max_train_bytes: %" PRIu32,
+      compression_opts.zstd_max_train_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -1912,6 +1912,7 @@ TEST_F(OptionsParserTest, DBOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(DBOptions, boundary_extractor),
       BLACKLIST_ENTRY(DBOptions, compaction_context_factory),
       BLACKLIST_ENTRY(DBOptions, max_file_size_for_compaction),
+      BLACKLIST_ENTRY(DBOptions, subcompaction_key_prefix_size),
       BLACKLIST_ENTRY(DBOptions, mem_table_flush_filter_factory),
       BLACKLIST_ENTRY(DBOptions, log_prefix),
       BLACKLIST_ENTRY(DBOptions, mem_tracker),
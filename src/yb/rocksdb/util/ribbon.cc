@@ -0,0 +1,283 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/util/ribbon.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "yb/gutil/hash/city.h"
+
+#include "yb/rocksdb/util/coding.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Number of slots covered by coefficient row of each key.
+constexpr size_t kCoeffBits = 64;
+constexpr size_t kBlockBits = kCoeffBits;
+constexpr size_t kMaxResultBits = 8;
+// Maximal ratio of keys to slots. Probability that keys could not be placed into filter with
+// given seed is below 1% for this ratio and filter block of default size.
+constexpr double kMaxLoadFactor = 0.92;
+// Number of seeds to try before building filter that matches everything.
+constexpr size_t kMaxSeeds = 32;
+// num_result_bits : 1 byte, seed : 1 byte, num_blocks : 4 bytes.
+constexpr size_t kMetaDataSize = 6;
+
+inline uint64_t Mix64(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+inline uint64_t RibbonKeyHash(const Slice& key) {
+  return util_hash::CityHash64(key.cdata(), key.size());
+}
+
+struct RibbonHash {
+  size_t start;
+  uint64_t coeff;
+  uint8_t result;
+};
+
+inline RibbonHash GetRibbonHash(
+    uint64_t key_hash, size_t seed, size_t num_starts, size_t num_result_bits) {
+  const uint64_t hash = Mix64(key_hash + seed * 0x9e3779b97f4a7c15ULL);
+  return RibbonHash {
+    .start = static_cast<size_t>(((hash >> 32) * num_starts) >> 32),
+    // First bit of coefficient row is always set, so each key is "pivoted" on the slot it adds.
+    .coeff = Mix64(hash) | 1,
+    .result = static_cast<uint8_t>(hash & ((1U << num_result_bits) - 1)),
+  };
+}
+
+inline size_t NumStarts(size_t num_blocks) {
+  return num_blocks * kBlockBits - kCoeffBits + 1;
+}
+
+inline uint64_t Parity(uint64_t value) {
+  return __builtin_parityll(value);
+}
+
+class FixedSizeRibbonBitsBuilder : public FilterBitsBuilder {
+ public:
+  FixedSizeRibbonBitsBuilder(const FixedSizeRibbonBitsBuilder&) = delete;
+  void operator=(const FixedSizeRibbonBitsBuilder&) = delete;
+
+  FixedSizeRibbonBitsBuilder(size_t total_bits, double error_rate) {
+    DCHECK_GT(error_rate, 0);
+    DCHECK_GT(total_bits, 0);
+    num_result_bits_ = std::clamp<size_t>(
+        static_cast<size_t>(ceil(-log2(error_rate))), 1, kMaxResultBits);
+    num_blocks_ = std::max<size_t>(total_bits / (kBlockBits * num_result_bits_), 1);
+    const auto num_slots = num_blocks_ * kBlockBits;
+    max_keys_ = static_cast<size_t>(num_slots * kMaxLoadFactor);
+    coeffs_.resize(num_slots);
+    results_.resize(num_slots);
+    hashes_.reserve(max_keys_);
+  }
+
+  void AddKey(const Slice& key) override {
+    const auto hash = RibbonKeyHash(key);
+    // Keys are sorted, so duplicates are adjacent.
+    if (!hashes_.empty() && hashes_.back() == hash) {
+      return;
+    }
+    hashes_.push_back(hash);
+    if (banded_) {
+      banded_ = AddToBanding(hash);
+    }
+  }
+
+  bool IsFull() const override { return hashes_.size() >= max_keys_; }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    if (hashes_.empty()) {
+      return FinishWithoutData(/* num_result_bits= */ num_result_bits_, /* num_blocks= */ 0, buf);
+    }
+    while (!banded_ && ++seed_ < kMaxSeeds) {
+      std::fill(coeffs_.begin(), coeffs_.end(), 0);
+      std::fill(results_.begin(), results_.end(), 0);
+      banded_ = true;
+      for (auto hash : hashes_) {
+        if (!AddToBanding(hash)) {
+          banded_ = false;
+          break;
+        }
+      }
+    }
+    if (!banded_) {
+      return FinishWithoutData(/* num_result_bits= */ 0, /* num_blocks= */ 1, buf);
+    }
+
+    const size_t data_size = num_blocks_ * num_result_bits_ * sizeof(uint64_t);
+    std::unique_ptr<char[]> data(new char[data_size + kMetaDataSize]);
+    BackSubstitute(data.get());
+    EncodeMetaData(num_result_bits_, num_blocks_, data.get() + data_size);
+    buf->reset(data.release());
+    return Slice(buf->get(), data_size + kMetaDataSize);
+  }
+
+ private:
+  // Adds key to the linear system in echelon form, returns false when key contradicts keys that
+  // were added before.
+  bool AddToBanding(uint64_t key_hash) {
+    auto hash = GetRibbonHash(key_hash, seed_, NumStarts(num_blocks_), num_result_bits_);
+    auto slot = hash.start;
+    auto coeff = hash.coeff;
+    auto result = hash.result;
+    for (;;) {
+      if (coeffs_[slot] == 0) {
+        coeffs_[slot] = coeff;
+        results_[slot] = result;
+        return true;
+      }
+      coeff ^= coeffs_[slot];
+      result ^= results_[slot];
+      if (coeff == 0) {
+        // Row is a linear combination of already added rows, consistent only if results match.
+        return result == 0;
+      }
+      const auto shift = __builtin_ctzll(coeff);
+      slot += shift;
+      coeff >>= shift;
+    }
+  }
+
+  // Solves the banded system from the last slot to the first one, writing columns of solution
+  // block by block.
+  void BackSubstitute(char* out) const {
+    // Bit i of state[j] is bit of column j in slot (current slot + i).
+    std::array<uint64_t, kMaxResultBits> state = {};
+    for (size_t block = num_blocks_; block-- > 0;) {
+      std::array<uint64_t, kMaxResultBits> words = {};
+      for (size_t bit = kBlockBits; bit-- > 0;) {
+        const auto slot = block * kBlockBits + bit;
+        const auto coeff = coeffs_[slot];
+        // Bits of free slots could be arbitrary, use pseudo random ones to avoid correlation of
+        // false positives between columns.
+        const auto result = coeff ? results_[slot] : Mix64(slot + seed_);
+        for (size_t j = 0; j != num_result_bits_; ++j) {
+          state[j] <<= 1;
+          const uint64_t value = ((result >> j) ^ Parity(coeff & state[j])) & 1;
+          state[j] |= value;
+          words[j] |= value << bit;
+        }
+      }
+      for (size_t j = 0; j != num_result_bits_; ++j) {
+        EncodeFixed64(out + (block * num_result_bits_ + j) * sizeof(uint64_t), words[j]);
+      }
+    }
+  }
+
+  void EncodeMetaData(size_t num_result_bits, size_t num_blocks, char* out) const {
+    out[0] = static_cast<char>(num_result_bits);
+    out[1] = static_cast<char>(seed_);
+    EncodeFixed32(out + 2, static_cast<uint32_t>(num_blocks));
+  }
+
+  Slice FinishWithoutData(
+      size_t num_result_bits, size_t num_blocks, std::unique_ptr<const char[]>* buf) const {
+    std::unique_ptr<char[]> data(new char[kMetaDataSize]);
+    EncodeMetaData(num_result_bits, num_blocks, data.get());
+    buf->reset(data.release());
+    return Slice(buf->get(), kMetaDataSize);
+  }
+
+  size_t num_result_bits_;
+  size_t num_blocks_;
+  size_t max_keys_;
+  size_t seed_ = 0;
+  bool banded_ = true;
+  // Hashes of added keys, used to rebuild banding with another seed.
+  std::vector<uint64_t> hashes_;
+  std::vector<uint64_t> coeffs_;
+  std::vector<uint8_t> results_;
+};
+
+class FixedSizeRibbonBitsReader : public FilterBitsReader {
+ public:
+  FixedSizeRibbonBitsReader(const FixedSizeRibbonBitsReader&) = delete;
+  void operator=(const FixedSizeRibbonBitsReader&) = delete;
+
+  FixedSizeRibbonBitsReader(const Slice& contents, Logger* logger) : data_(contents.cdata()) {
+    if (contents.size() < kMetaDataSize) {
+      BrokenFilter(logger);
+      return;
+    }
+    const auto* meta = data_ + contents.size() - kMetaDataSize;
+    num_result_bits_ = static_cast<uint8_t>(meta[0]);
+    seed_ = static_cast<uint8_t>(meta[1]);
+    num_blocks_ = DecodeFixed32(meta + 2);
+    if (num_result_bits_ > kMaxResultBits ||
+        contents.size() != num_blocks_ * num_result_bits_ * sizeof(uint64_t) + kMetaDataSize) {
+      BrokenFilter(logger);
+    }
+  }
+
+  bool MayMatch(const Slice& entry) override {
+    if (num_blocks_ == 0) {
+      return false;
+    }
+    auto hash = GetRibbonHash(
+        RibbonKeyHash(entry), seed_, NumStarts(num_blocks_), num_result_bits_);
+    const auto shift = hash.start % kBlockBits;
+    const auto* block = data_ + hash.start / kBlockBits * num_result_bits_ * sizeof(uint64_t);
+    for (size_t j = 0; j != num_result_bits_; ++j) {
+      auto window = DecodeFixed64(block + j * sizeof(uint64_t)) >> shift;
+      if (shift) {
+        // Start is never greater than num_slots - kCoeffBits, so the next block is present.
+        window |= DecodeFixed64(block + (num_result_bits_ + j) * sizeof(uint64_t)) <<
+                  (kBlockBits - shift);
+      }
+      if (Parity(window & hash.coeff) != ((hash.result >> j) & 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  // Broken filter is regarded as matching everything.
+  void BrokenFilter(Logger* logger) {
+    RLOG(InfoLogLevel::ERROR_LEVEL, logger, "Ribbon filter data is broken, won't be used.");
+    FAIL_IF_NOT_PRODUCTION();
+    num_result_bits_ = 0;
+    num_blocks_ = 1;
+  }
+
+  const char* data_;
+  size_t num_result_bits_ = 0;
+  size_t seed_ = 0;
+  size_t num_blocks_ = 1;
+};
+
+} // namespace
+
+FilterBitsBuilder* NewFixedSizeRibbonBitsBuilder(size_t total_bits, double error_rate) {
+  return new FixedSizeRibbonBitsBuilder(total_bits, error_rate);
+}
+
+FilterBitsReader* NewFixedSizeRibbonBitsReader(const Slice& contents, Logger* logger) {
+  return new FixedSizeRibbonBitsReader(contents, logger);
+}
+
+}  // namespace rocksdb
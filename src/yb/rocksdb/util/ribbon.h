@@ -0,0 +1,45 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include "yb/rocksdb/filter_policy.h"
+
+namespace rocksdb {
+
+// Standard Ribbon filter (see "Ribbon filter: practically smaller than Bloom and Xor",
+// Dillinger & Walzer) with 64-bit coefficient rows.
+//
+// Each key is mapped to a start slot s, 64-bit coefficient row c and r-bit result. Filter stores r
+// columns of slot bits, such that for each added key and each column j, parity of bits of column j
+// in slots [s, s + 64) selected by c equals bit j of the result. So a key not in the set matches
+// with probability 2^-r.
+//
+// Filter block has the following encoding:
+// +----------------------------------------------------------------------------+
+// | block 0: column 0 : 8 bytes | ... | column r - 1 : 8 bytes                   |
+// | ...                                                                        |
+// | block num_blocks - 1                                                       |
+// +----------------------------------------------------------------------------+
+// | num_result_bits (r) : 1 byte | seed : 1 byte | num_blocks : 4 bytes         |
+// +----------------------------------------------------------------------------+
+// Where block i keeps bits of slots [64 * i, 64 * (i + 1)).
+//
+// Filter with num_blocks equal to 0 does not contain any keys and does not match anything.
+// Filter with num_result_bits equal to 0 matches everything, it is built when keys could not be
+// placed into filter with any seed.
+FilterBitsBuilder* NewFixedSizeRibbonBitsBuilder(size_t total_bits, double error_rate);
+
+FilterBitsReader* NewFixedSizeRibbonBitsReader(const Slice& contents, Logger* logger);
+
+}  // namespace rocksdb
@@ -730,6 +730,10 @@ class TestUserFrontier : public UserFrontier {
     return value_;
   }
 
+  uint64_t PhysicalTimeMicros() const override {
+    return value_;
+  }
+
   std::string ToString() const override;
 
   void ToPB(google::protobuf::Any* pb) const override {
@@ -145,6 +145,9 @@ Status RestorePatch::ProcessExistingOnlyEntry(
       char type = subkey.consume_byte();
       if (dockv::IsColumnId(static_cast<dockv::KeyEntryType>(type))) {
         Slice packed_value = last_packed_row_restoring_state_.value.AsSlice();
+        auto packed_row_version = dockv::ConsumePackedRowVersion(&packed_value);
+        SCHECK(packed_row_version, Corruption, "Packed row expected: $0",
+               last_packed_row_restoring_state_.value.AsSlice().ToDebugHexString());
         const dockv::SchemaPacking& packing = VERIFY_RESULT(
             table_info_->doc_read_context->schema_packing_storage.GetPacking(&packed_value));
         int64_t column_id_as_int64 = VERIFY_RESULT(util::FastDecodeSignedVarIntUnsafe(&subkey));
@@ -152,7 +155,7 @@ Status RestorePatch::ProcessExistingOnlyEntry(
         SCHECK_EQ(subkey.empty(), true, Corruption, "Only one subkey expected");
         ColumnId column_id;
         RETURN_NOT_OK(ColumnId::FromInt64(column_id_as_int64, &column_id));
-        auto value = packing.GetValue(column_id, packed_value);
+        auto value = packing.GetValue(*packed_row_version, column_id, packed_value);
         // Insert this column's packed row value.
         if (value) {
           VLOG_WITH_FUNC(1) << "Inserting key: " << existing_key.ToDebugHexString()
@@ -228,7 +231,7 @@ Status RestorePatch::TryUpdateLastPackedRow(const Slice& key, const Slice& value
                     << ", value: " << value.ToDebugHexString();
   auto value_slice = value;
   RETURN_NOT_OK(dockv::ValueControlFields::Decode(&value_slice));
-  if (value_slice.TryConsumeByte(dockv::ValueEntryTypeAsChar::kPackedRow)) {
+  if (dockv::GetPackedRowVersion(dockv::DecodeValueEntryType(value_slice))) {
     VLOG_WITH_FUNC(2) << "Packed row encountered in the restoring state. Key: "
                       << key.ToDebugHexString() << ", value: " << value.ToDebugHexString();
     last_packed_row_restoring_state_.key = key;
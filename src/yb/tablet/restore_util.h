@@ -20,6 +20,7 @@
 #include "yb/docdb/doc_write_batch.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/rocksdb_writer.h"
+#include "yb/dockv/schema_packing.h"
 #include "yb/dockv/value.h"
 #include "yb/dockv/value_type.h"
 
@@ -152,7 +153,7 @@ class RestorePatch {
     ValueBuffer value;
   };
   // Key-Value pair corresponding to the most recent packed row encountered in
-  // the restoring state.
+  // the restoring state. Value starts with the packed row value type.
   KeyValuePair last_packed_row_restoring_state_;
 
   virtual Result<bool> ShouldSkipEntry(const Slice& key, const Slice& value) = 0;
@@ -174,12 +175,13 @@ Result<std::optional<ValueType>> GetColumnValuePacked(
     tablet::TableInfo* table_info, const Slice& packed_value, const std::string& column_name) {
   auto value_slice = packed_value;
   RETURN_NOT_OK(dockv::ValueControlFields::Decode(&value_slice));
-  SCHECK(value_slice.TryConsumeByte(dockv::ValueEntryTypeAsChar::kPackedRow),
-          Corruption, "Packed row expected: $0", packed_value.ToDebugHexString());
+  auto packed_row_version = dockv::ConsumePackedRowVersion(&value_slice);
+  SCHECK(packed_row_version, Corruption, "Packed row expected: $0",
+         packed_value.ToDebugHexString());
   const dockv::SchemaPacking& packing = VERIFY_RESULT(
       table_info->doc_read_context->schema_packing_storage.GetPacking(&value_slice));
   auto column_id = VERIFY_RESULT(table_info->schema().ColumnIdByName(column_name));
-  auto value = packing.GetValue(column_id, value_slice);
+  auto value = packing.GetValue(*packed_row_version, column_id, value_slice);
   if (value) {
     dockv::Value column_value;
     RETURN_NOT_OK(column_value.Decode(*value));
@@ -18,6 +18,7 @@
 #include "yb/common/hybrid_time.h"
 #include "yb/common/pgsql_error.h"
 
+#include "yb/tablet/shared_transaction_status_cache.h"
 #include "yb/tablet/transaction_participant_context.h"
 
 #include "yb/tserver/tserver_service.pb.h"
@@ -108,6 +109,26 @@ void RunningTransaction::RequestStatusAt(const StatusRequest& request,
     *request.status_tablet_id = status_tablet();
   }
 
+  if (context_.shared_status_cache_ && !external_transaction() &&
+      last_known_status_ != TransactionStatus::COMMITTED &&
+      last_known_status_ != TransactionStatus::ABORTED) {
+    auto cached = context_.shared_status_cache_->Get(id());
+    if (cached) {
+      VLOG_WITH_PREFIX(4) << "Cached status: " << cached->ToString();
+      if (cached->status == TransactionStatus::ABORTED) {
+        // Don't remember abort learned by other tablet, so removal of intents is still decided
+        // by the status received for this transaction participant.
+        lock->unlock();
+        request.callback(TransactionStatusResult{TransactionStatus::ABORTED, cached->status_ht});
+        return;
+      }
+      // Committed status is final, so could be used as known status of this transaction.
+      auto did_abort_txn = UpdateStatus(
+          cached->status, cached->status_ht, HybridTime(), cached->aborted_subtxn_set);
+      DCHECK(!did_abort_txn);
+    }
+  }
+
   if (last_known_status_hybrid_time_ > HybridTime::kMin) {
     auto transaction_status =
         GetStatusAt(request.global_limit_ht, last_known_status_hybrid_time_, last_known_status_,
@@ -364,6 +385,14 @@ void RunningTransaction::DoStatusReceived(const Status& status,
         << response.ShortDebugString();
     auto coordinator_safe_time = response.coordinator_safe_time().size() == 1
         ? HybridTime::FromPB(response.coordinator_safe_time(0)) : HybridTime();
+    if (context_.shared_status_cache_ && !external_transaction()) {
+      if (transaction_status == TransactionStatus::COMMITTED) {
+        context_.shared_status_cache_->Committed(id(), time_of_status, aborted_subtxn_set);
+      } else if (transaction_status == TransactionStatus::ABORTED) {
+        context_.shared_status_cache_->Aborted(
+            id(), coordinator_safe_time ? coordinator_safe_time : time_of_status);
+      }
+    }
     auto did_abort_txn = UpdateStatus(
         transaction_status, time_of_status, coordinator_safe_time, aborted_subtxn_set);
     if (did_abort_txn) {
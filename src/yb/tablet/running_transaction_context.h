@@ -96,6 +96,8 @@ class RunningTransactionContext {
   rpc::Rpcs rpcs_;
   TransactionParticipantContext& participant_context_;
   TransactionIntentApplier& applier_;
+  // Tablet server wide cache of transaction statuses, could be null.
+  SharedTransactionStatusCache* shared_status_cache_ = nullptr;
   int64_t request_serial_ = 0;
   std::mutex mutex_;
 
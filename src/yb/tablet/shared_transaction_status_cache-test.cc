@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include "yb/tablet/shared_transaction_status_cache.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int32(transaction_status_cache_ttl_ms);
+DECLARE_uint64(transaction_status_cache_max_entries);
+
+namespace yb {
+namespace tablet {
+
+class SharedTransactionStatusCacheTest : public YBTest {
+ protected:
+  SharedTransactionStatusCache cache_{nullptr};
+};
+
+TEST_F(SharedTransactionStatusCacheTest, CommittedAndAborted) {
+  auto committed_id = TransactionId::GenerateRandom();
+  auto aborted_id = TransactionId::GenerateRandom();
+  SubtxnSet aborted_subtxn_set;
+  ASSERT_OK(aborted_subtxn_set.SetRange(2, 3));
+
+  ASSERT_FALSE(cache_.Get(committed_id));
+
+  cache_.Committed(committed_id, HybridTime(1000), aborted_subtxn_set);
+  cache_.Aborted(aborted_id, HybridTime(2000));
+
+  auto committed = cache_.Get(committed_id);
+  ASSERT_TRUE(committed);
+  ASSERT_EQ(committed->status, TransactionStatus::COMMITTED);
+  ASSERT_EQ(committed->status_ht, HybridTime(1000));
+  ASSERT_EQ(committed->aborted_subtxn_set.ToString(), aborted_subtxn_set.ToString());
+
+  auto aborted = cache_.Get(aborted_id);
+  ASSERT_TRUE(aborted);
+  ASSERT_EQ(aborted->status, TransactionStatus::ABORTED);
+  ASSERT_EQ(aborted->status_ht, HybridTime(2000));
+
+  // Final status is not overwritten.
+  cache_.Committed(committed_id, HybridTime(3000), SubtxnSet());
+  ASSERT_EQ(cache_.Get(committed_id)->status_ht, HybridTime(1000));
+}
+
+TEST_F(SharedTransactionStatusCacheTest, Expiration) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_status_cache_ttl_ms) = 100;
+  auto id = TransactionId::GenerateRandom();
+  cache_.Committed(id, HybridTime(1000), SubtxnSet());
+  ASSERT_TRUE(cache_.Get(id));
+  std::this_thread::sleep_for(200ms);
+  ASSERT_FALSE(cache_.Get(id));
+
+  // Expired entry is removed by the following insert.
+  cache_.Committed(TransactionId::GenerateRandom(), HybridTime(1000), SubtxnSet());
+  ASSERT_EQ(cache_.TEST_size(), 1U);
+
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_status_cache_ttl_ms) = 0;
+  cache_.Committed(id, HybridTime(1000), SubtxnSet());
+  ASSERT_FALSE(cache_.Get(id));
+}
+
+TEST_F(SharedTransactionStatusCacheTest, MaxEntries) {
+  constexpr size_t kMaxEntries = 10;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_status_cache_max_entries) = kMaxEntries;
+  std::vector<TransactionId> ids;
+  for (size_t i = 0; i != kMaxEntries * 2; ++i) {
+    ids.push_back(TransactionId::GenerateRandom());
+    cache_.Committed(ids.back(), HybridTime(1000 + i), SubtxnSet());
+  }
+  ASSERT_EQ(cache_.TEST_size(), kMaxEntries);
+  // The oldest entries are evicted first.
+  for (size_t i = 0; i != ids.size(); ++i) {
+    ASSERT_EQ(cache_.Get(ids[i]).has_value(), i >= kMaxEntries) << i;
+  }
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,131 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/shared_transaction_status_cache.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/format.h"
+#include "yb/util/metrics.h"
+
+using namespace std::literals;
+
+DEFINE_RUNTIME_int32(transaction_status_cache_ttl_ms, 30000,
+    "Time to keep final status of transaction in the tablet server wide transaction status "
+    "cache. 0 disables the cache. New value applies to newly cached statuses. After the value "
+    "is lowered, memory of already cached statuses could be released later than their expiration, "
+    "but not later than with the old value.");
+
+DEFINE_RUNTIME_uint64(transaction_status_cache_max_entries, 100000,
+    "Max number of transactions in the tablet server wide transaction status cache.");
+
+METRIC_DEFINE_counter(server, transaction_status_cache_hits,
+                      "Transaction Status Cache Hits",
+                      yb::MetricUnit::kCacheHits,
+                      "Total number of hits in tablet server wide transaction status cache");
+METRIC_DEFINE_counter(server, transaction_status_cache_queries,
+                      "Transaction Status Cache Queries",
+                      yb::MetricUnit::kCacheQueries,
+                      "Total number of queries to tablet server wide transaction status cache");
+
+namespace yb {
+namespace tablet {
+
+std::string CachedTransactionStatus::ToString() const {
+  return YB_STRUCT_TO_STRING(status, status_ht, aborted_subtxn_set);
+}
+
+SharedTransactionStatusCache::SharedTransactionStatusCache(
+    const scoped_refptr<MetricEntity>& metric_entity) {
+  if (metric_entity) {
+    hits_ = METRIC_transaction_status_cache_hits.Instantiate(metric_entity);
+    queries_ = METRIC_transaction_status_cache_queries.Instantiate(metric_entity);
+  }
+}
+
+SharedTransactionStatusCache::~SharedTransactionStatusCache() = default;
+
+void SharedTransactionStatusCache::Committed(
+    const TransactionId& id, HybridTime commit_ht, const SubtxnSet& aborted_subtxn_set) {
+  Insert(id, CachedTransactionStatus {
+    .status = TransactionStatus::COMMITTED,
+    .status_ht = commit_ht,
+    .aborted_subtxn_set = aborted_subtxn_set,
+  });
+}
+
+void SharedTransactionStatusCache::Aborted(const TransactionId& id, HybridTime status_ht) {
+  Insert(id, CachedTransactionStatus {
+    .status = TransactionStatus::ABORTED,
+    .status_ht = status_ht,
+    .aborted_subtxn_set = {},
+  });
+}
+
+void SharedTransactionStatusCache::Insert(
+    const TransactionId& id, CachedTransactionStatus&& status) {
+  auto ttl_ms = FLAGS_transaction_status_cache_ttl_ms;
+  if (ttl_ms <= 0) {
+    return;
+  }
+  auto now = CoarseMonoClock::now();
+  auto expiration = now + ttl_ms * 1ms;
+  std::lock_guard lock(mutex_);
+  CleanupUnlocked(now);
+  auto it = entries_.find(id);
+  if (it != entries_.end()) {
+    // Final status does not change, so just keep the existing entry.
+    return;
+  }
+  entries_.emplace(id, Entry {
+    .status = std::move(status),
+    .expiration = expiration,
+  });
+  expiration_queue_.push_back(QueueEntry {
+    .id = id,
+    .expiration = expiration,
+  });
+}
+
+std::optional<CachedTransactionStatus> SharedTransactionStatusCache::Get(
+    const TransactionId& id) {
+  if (queries_) {
+    queries_->Increment();
+  }
+  auto now = CoarseMonoClock::now();
+  std::lock_guard lock(mutex_);
+  auto it = entries_.find(id);
+  if (it == entries_.end() || it->second.expiration <= now) {
+    return std::nullopt;
+  }
+  if (hits_) {
+    hits_->Increment();
+  }
+  return it->second.status;
+}
+
+void SharedTransactionStatusCache::CleanupUnlocked(CoarseTimePoint now) {
+  const auto max_entries = FLAGS_transaction_status_cache_max_entries;
+  while (!expiration_queue_.empty() &&
+         (expiration_queue_.front().expiration <= now || entries_.size() >= max_entries)) {
+    entries_.erase(expiration_queue_.front().id);
+    expiration_queue_.pop_front();
+  }
+}
+
+size_t SharedTransactionStatusCache::TEST_size() {
+  std::lock_guard lock(mutex_);
+  return entries_.size();
+}
+
+} // namespace tablet
+} // namespace yb
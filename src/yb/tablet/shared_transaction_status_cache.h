@@ -0,0 +1,89 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/metrics_fwd.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tablet {
+
+struct CachedTransactionStatus {
+  // COMMITTED or ABORTED.
+  TransactionStatus status;
+  // Commit hybrid time for committed transaction, time when coordinator reported abort for
+  // aborted transaction.
+  HybridTime status_ht;
+  SubtxnSet aborted_subtxn_set;
+
+  std::string ToString() const;
+};
+
+// Final statuses of transactions, shared by transaction participants of all tablets of the tablet
+// server. So status learned by one tablet, from coordinator response or from apply, could be used
+// by other tablets touched by the same transaction without asking the coordinator again.
+// Entries expire after transaction_status_cache_ttl_ms. Thread safe.
+class SharedTransactionStatusCache {
+ public:
+  explicit SharedTransactionStatusCache(const scoped_refptr<MetricEntity>& metric_entity);
+  ~SharedTransactionStatusCache();
+
+  void Committed(
+      const TransactionId& id, HybridTime commit_ht, const SubtxnSet& aborted_subtxn_set);
+
+  // status_ht is the time when coordinator reported transaction as aborted.
+  void Aborted(const TransactionId& id, HybridTime status_ht);
+
+  std::optional<CachedTransactionStatus> Get(const TransactionId& id);
+
+  size_t TEST_size();
+
+ private:
+  void Insert(const TransactionId& id, CachedTransactionStatus&& status);
+  void CleanupUnlocked(CoarseTimePoint now) REQUIRES(mutex_);
+
+  struct Entry {
+    CachedTransactionStatus status;
+    CoarseTimePoint expiration;
+  };
+
+  struct QueueEntry {
+    TransactionId id;
+    CoarseTimePoint expiration;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<TransactionId, Entry, TransactionIdHash> entries_ GUARDED_BY(mutex_);
+  // Entries in order of insertion. It is the order of expiration while TTL does not change.
+  // After TTL is lowered, entries that expire earlier could be queued behind older entries, so they
+  // are removed only when those entries expire, or when the cache is full. Get checks expiration of
+  // the entry itself, so expired entry is never returned.
+  std::deque<QueueEntry> expiration_queue_ GUARDED_BY(mutex_);
+
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> queries_;
+};
+
+} // namespace tablet
+} // namespace yb
@@ -64,6 +64,7 @@
 #include "yb/docdb/doc_read_context.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/doc_write_batch.h"
+#include "yb/docdb/doc_zone_map.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_compaction_filter_intents.h"
 #include "yb/docdb/docdb_debug.h"
@@ -112,6 +113,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pg_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status_format.h"
@@ -210,6 +212,29 @@ DEFINE_UNKNOWN_bool(tablet_enable_ttl_file_filter, false,
             "Enables compaction to directly delete files that have expired based on TTL, "
             "rather than removing them via the normal compaction process.");
 
+DEFINE_NON_RUNTIME_uint64(tablet_compaction_time_window_secs, 0,
+            "When non zero, regular RocksDB files are grouped into time windows of the specified "
+            "size using hybrid time of their records, and files from different windows are never "
+            "compacted together. Reduces write amplification for append-mostly time series "
+            "tables. 0 to disable.");
+
+DEFINE_NON_RUNTIME_uint64(tablet_compaction_max_time_windows, 4,
+            "Max number of the newest time windows, whose regular RocksDB files are not compacted "
+            "with other windows, when tablet_compaction_time_window_secs is set. Files of older "
+            "windows are compacted together, so the number of files of a tablet stays below "
+            "sst_files_soft_limit. 0 to not limit, this should be used only when old windows are "
+            "removed by tablet_enable_ttl_file_filter.");
+
+DEFINE_RUNTIME_int32(txn_apply_sst_ingestion_min_records, 0,
+            "When a transaction applies at least the specified number of records to a tablet, "
+            "its records are written to a sorted SST file that is added to the regular RocksDB "
+            "directly, bypassing the memtable. Applied only when the key range of the records "
+            "does not overlap keys already present in the tablet. Adding the file seeks the "
+            "tablet for overlapping keys and writes the MANIFEST while holding the RocksDB write "
+            "thread, i.e. other writes to the tablet are blocked for the duration. Also the "
+            "memtable is switched and flushed to a separate SST file when it is not empty, so "
+            "the value should be large enough to amortize it. 0 to disable.");
+
 DEFINE_UNKNOWN_bool(enable_schema_packing_gc, true, "Whether schema packing GC is enabled.");
 
 DEFINE_RUNTIME_bool(batch_tablet_metrics_update, true,
@@ -516,6 +541,7 @@ Tablet::Tablet(const TabletInitData& data)
     transaction_participant_ = std::make_unique<TransactionParticipant>(
         data.transaction_participant_context, this, DCHECK_NOTNULL(tablet_metrics_entity_),
         data.parent_mem_tracker);
+    transaction_participant_->SetSharedTransactionStatusCache(data.shared_txn_status_cache);
     if (data.waiting_txn_registry) {
       transaction_participant_->SetWaitQueue(std::make_unique<docdb::WaitQueue>(
         transaction_participant_.get(), metadata_->fs_manager()->uuid(), data.waiting_txn_registry,
@@ -697,6 +723,12 @@ std::string Tablet::LogPrefix() const {
 
 namespace {
 
+// SST files with records of applied transactions are written to this subdirectory of the regular
+// DB directory before they are added to the DB. Files left after a crash are removed at startup.
+std::string ApplyTempDir(const std::string& db_dir) {
+  return JoinPathSegments(db_dir, "apply.tmp");
+}
+
 std::string LogDbTypePrefix(docdb::StorageDbType db_type) {
   switch (db_type) {
     case docdb::StorageDbType::kRegular:
@@ -787,9 +819,25 @@ Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options regular_rocksdb_options(rocksdb_options);
   regular_rocksdb_options.listeners.push_back(
       std::make_shared<RegularRocksDbListener>(this, regular_rocksdb_options.log_prefix));
+  if (table_type_ == TableType::PGSQL_TABLE_TYPE) {
+    regular_rocksdb_options.table_properties_collector_factories.push_back(
+        docdb::CreateZoneMapCollectorFactory(metadata_.get()));
+  }
+  docdb::SetRegularDBMemTableOptions(
+      &regular_rocksdb_options, tablet_options_.memtable_insert_thread_pool);
+  regular_rocksdb_options.compaction_options_universal.time_window_micros =
+      FLAGS_tablet_compaction_time_window_secs * MonoTime::kMicrosecondsPerSecond;
+  regular_rocksdb_options.compaction_options_universal.max_time_windows =
+      FLAGS_tablet_compaction_max_time_windows;
 
   const string db_dir = metadata()->rocksdb_dir();
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
+  const auto apply_temp_dir = ApplyTempDir(db_dir);
+  if (metadata()->fs_manager()->env()->FileExists(apply_temp_dir)) {
+    RETURN_NOT_OK_PREPEND(
+        metadata()->fs_manager()->env()->DeleteRecursively(apply_temp_dir),
+        Format("Failed to cleanup $0", apply_temp_dir));
+  }
 
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
@@ -809,6 +857,10 @@ Status Tablet::OpenKeyValueTablet() {
     LOG_WITH_PREFIX(INFO) << "Opening intents DB at: " << db_dir + kIntentsDBSuffix;
     rocksdb::Options intents_rocksdb_options(rocksdb_options);
     intents_rocksdb_options.compaction_context_factory = {};
+    // Intents DB keys are not document keys, and intents DB compactions are small, so
+    // subcompactions are not used for it.
+    intents_rocksdb_options.max_subcompactions = 1;
+    intents_rocksdb_options.subcompaction_key_prefix_size = nullptr;
     docdb::SetLogPrefix(&intents_rocksdb_options, LogPrefix(docdb::StorageDbType::kIntents));
 
     intents_rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
@@ -1937,12 +1989,40 @@ Result<docdb::ApplyTransactionState> Tablet::ApplyIntents(const TransactionApply
   docdb::IntentsWriter intents_writer(
       data.apply_state ? data.apply_state->key : Slice(), intents_db_.get(), &context);
   rocksdb::WriteBatch regular_write_batch;
-  regular_write_batch.SetDirectWriter(&intents_writer);
   // data.hybrid_time contains transaction commit time.
   // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
   auto frontiers_ptr = data.op_id.empty() ? nullptr : InitFrontiers(data, &frontiers);
   context.SetFrontiers(frontiers_ptr);
+  const auto sst_ingestion_min_records = FLAGS_txn_apply_sst_ingestion_min_records;
+  if (sst_ingestion_min_records > 0) {
+    docdb::BufferedApplyWriteHandler handler;
+    RETURN_NOT_OK(intents_writer.Apply(&handler));
+    bool ingested = false;
+    // The ingested file must carry frontiers, otherwise schema packing GC, history cutoff and
+    // flushed op id tracking would not take its records into account.
+    if (frontiers_ptr &&
+        handler.num_records() >= static_cast<size_t>(sst_ingestion_min_records)) {
+      // Records should be ingested before apply state is written, otherwise they could be lost
+      // after restart.
+      auto result = handler.IngestRecords(
+          regular_db_.get(), ApplyTempDir(regular_db_->GetName()),
+          Format("$0.sst", data.transaction_id), *frontiers_ptr);
+      if (result.ok()) {
+        ingested = *result;
+      } else {
+        LOG_WITH_PREFIX(WARNING)
+            << "Failed to ingest apply records of " << data.transaction_id << ": "
+            << result.status();
+      }
+      VLOG_WITH_PREFIX(2)
+          << "Apply " << data.transaction_id << ", records: " << handler.num_records()
+          << ", ingested: " << ingested;
+    }
+    handler.AppendToWriteBatch(!ingested, &regular_write_batch);
+  } else {
+    regular_write_batch.SetDirectWriter(&intents_writer);
+  }
   WriteToRocksDB(frontiers_ptr, &regular_write_batch, StorageDbType::kRegular);
   return context.apply_state();
 }
@@ -3534,6 +3614,12 @@ uint64_t Tablet::GetCurrentVersionNumSSTFiles() const {
   }, 0);
 }
 
+uint64_t Tablet::GetCurrentVersionNumCompactableSortedRuns() const {
+  return GetRegularDbStat([this] {
+    return regular_db_->GetCurrentVersionNumCompactableSortedRuns();
+  }, 0);
+}
+
 std::pair<int, int> Tablet::GetNumMemtables() const {
   int intents_num_memtables = 0;
   int regular_num_memtables = 0;
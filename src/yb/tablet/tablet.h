@@ -633,6 +633,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetCurrentVersionSstFilesUncompressedSize() const;
   std::pair<uint64_t, uint64_t> GetCurrentVersionSstFilesAllSizes() const;
   uint64_t GetCurrentVersionNumSSTFiles() const;
+  uint64_t GetCurrentVersionNumCompactableSortedRuns() const;
 
   void ListenNumSSTFilesChanged(std::function<void()> listener);
 
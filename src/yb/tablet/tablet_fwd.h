@@ -47,6 +47,7 @@ typedef std::weak_ptr<TabletPeer> TabletPeerWeakPtr;
 class ChangeMetadataOperation;
 class Operation;
 class OperationFilter;
+class SharedTransactionStatusCache;
 class SnapshotCoordinator;
 class SnapshotOperation;
 class SplitOperation;
@@ -60,6 +60,8 @@ struct TabletOptions {
   rocksdb::Env* rocksdb_env = rocksdb::Env::Default();
   std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
   std::shared_ptr<rocksdb::RocksDBPriorityThreadPoolMetrics> priority_thread_pool_metrics;
+  // Thread pool used to insert large write batches into the memtable of regular RocksDB.
+  ThreadPool* memtable_insert_thread_pool = nullptr;
 };
 
 using TransactionManagerProvider = std::function<client::TransactionManager&()>;
@@ -90,6 +92,7 @@ struct TabletInitData {
   ThreadPool* admin_triggered_compaction_pool;
   scoped_refptr<yb::AtomicGauge<uint64_t>> post_split_compaction_added;
   client::YBMetaDataCache* metadata_cache;
+  SharedTransactionStatusCache* shared_txn_status_cache = nullptr;
 };
 
 } // namespace tablet
@@ -42,6 +42,7 @@
 #include "yb/tablet/remove_intents_task.h"
 #include "yb/tablet/running_transaction.h"
 #include "yb/tablet/running_transaction_context.h"
+#include "yb/tablet/shared_transaction_status_cache.h"
 #include "yb/tablet/transaction_loader.h"
 #include "yb/tablet/transaction_participant_context.h"
 #include "yb/tablet/transaction_status_resolver.h"
@@ -181,6 +182,10 @@ class TransactionParticipant::Impl
     return wait_queue_.get();
   }
 
+  void SetSharedTransactionStatusCache(SharedTransactionStatusCache* cache) {
+    shared_status_cache_ = cache;
+  }
+
   bool StartShutdown() {
     bool expected = false;
     if (!closing_.compare_exchange_strong(expected, true)) {
@@ -758,6 +763,9 @@ class TransactionParticipant::Impl
     }
 
     if (!was_previously_committed) {
+      if (shared_status_cache_) {
+        shared_status_cache_->Committed(data.transaction_id, data.commit_ht, data.aborted);
+      }
       if (wait_queue_) {
         // We signal this commit to the wait queue if it is newly committed. It's important to do so
         // *after* the local running transaction's metadata is updated to indicate that this was
@@ -1603,6 +1611,35 @@ class TransactionParticipant::Impl
     min_running_notifier->Satisfied();
   }
 
+  void AddToSharedStatusCache(const TransactionStatusInfo& info) {
+    if (info.status == TransactionStatus::COMMITTED) {
+      shared_status_cache_->Committed(
+          info.transaction_id, info.status_ht, info.aborted_subtxn_set);
+    } else if (info.status == TransactionStatus::ABORTED) {
+      shared_status_cache_->Aborted(
+          info.transaction_id,
+          info.coordinator_safe_time ? info.coordinator_safe_time : info.status_ht);
+    }
+  }
+
+  // Uses commit status cached by other tablets instead of requesting it from the coordinator.
+  // Cached abort is not used, so removal of intents is decided by the status received for this
+  // participant. Returns true if transaction was found committed in the cache.
+  bool CheckCommittedInSharedCacheUnlocked(RunningTransaction* txn) REQUIRES(mutex_) {
+    if (!shared_status_cache_) {
+      return false;
+    }
+    auto cached = shared_status_cache_->Get(txn->id());
+    if (!cached || cached->status != TransactionStatus::COMMITTED) {
+      return false;
+    }
+    VLOG_WITH_PREFIX(4) << "Cached status of " << txn->id() << ": " << cached->ToString();
+    auto did_abort_txn = txn->UpdateStatus(
+        cached->status, cached->status_ht, HybridTime(), cached->aborted_subtxn_set);
+    DCHECK(!did_abort_txn);
+    return true;
+  }
+
   void TransactionsStatus(
       const std::vector<TransactionStatusInfo>& status_infos) {
     MinRunningNotifier min_running_notifier(&applier_);
@@ -1613,6 +1650,9 @@ class TransactionParticipant::Impl
       if (it == transactions_.end()) {
         continue;
       }
+      if (shared_status_cache_ && !(**it).external_transaction()) {
+        AddToSharedStatusCache(info);
+      }
       if ((**it).UpdateStatus(
           info.status, info.status_ht, info.coordinator_safe_time, info.aborted_subtxn_set)) {
         NotifyAbortedTransactionIncrement(info.transaction_id);
@@ -1760,6 +1800,12 @@ class TransactionParticipant::Impl
         if (txn.abort_check_ht() > now) {
           break;
         }
+        if (CheckCommittedInSharedCacheUnlocked(&txn)) {
+          CHECK(index.modify(index.begin(), [now](const auto& txn) {
+            txn->UpdateAbortCheckHT(now, UpdateAbortCheckHTMode::kStatusResponseReceived);
+          }));
+          continue;
+        }
         if (!resolver) {
           resolver = &AddStatusResolver();
         }
@@ -2060,6 +2106,10 @@ docdb::WaitQueue* TransactionParticipant::wait_queue() const {
   return impl_->wait_queue();
 }
 
+void TransactionParticipant::SetSharedTransactionStatusCache(SharedTransactionStatusCache* cache) {
+  impl_->SetSharedTransactionStatusCache(cache);
+}
+
 void TransactionParticipant::StartShutdown() {
   impl_->StartShutdown();
 }
@@ -119,6 +119,9 @@ class TransactionParticipant : public TransactionStatusManager {
 
   docdb::WaitQueue* wait_queue() const;
 
+  // Sets tablet server wide cache of transaction statuses. Should be called before Start.
+  void SetSharedTransactionStatusCache(SharedTransactionStatusCache* cache);
+
   // Notify participant that this context is ready and it could start performing its requests.
   void Start();
 
@@ -0,0 +1,135 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/tserver/compaction_rate_tuner.h"
+
+#include <algorithm>
+
+#include "yb/rocksdb/rate_limiter.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/ts_tablet_manager.h"
+
+#include "yb/util/background_task.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+
+DEFINE_RUNTIME_int64(rocksdb_compact_flush_rate_limit_max_bytes_per_sec, 0,
+    "Max rate of flushes and compactions, when rate is tuned adaptively using read "
+    "amplification of tablets. Rate is never lowered below "
+    "rocksdb_compact_flush_rate_limit_bytes_per_sec. Only applicable when rate limiter is shared "
+    "by the whole tserver. 0 or value not greater than "
+    "rocksdb_compact_flush_rate_limit_bytes_per_sec disables adaptive tuning.");
+
+DEFINE_RUNTIME_uint64(compaction_rate_tuner_high_num_sorted_runs, 20,
+    "Compaction rate limit is raised while some tablet has at least this number of sorted runs, "
+    "that could be compacted together, and lowered when all tablets have less than half of it.");
+
+DEFINE_NON_RUNTIME_int32(compaction_rate_tuner_interval_ms, 5000,
+    "Interval at which compaction rate limit is adjusted. 0 disables the tuner.");
+
+DECLARE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec);
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+// Rate is multiplied or divided by this factor on each adjustment.
+constexpr double kRateStep = 1.5;
+
+} // namespace
+
+CompactionRateTuner::CompactionRateTuner(
+    TSTabletManager* ts_tablet_manager, rocksdb::RateLimiter* rate_limiter)
+    : ts_tablet_manager_(ts_tablet_manager), rate_limiter_(rate_limiter) {
+}
+
+CompactionRateTuner::~CompactionRateTuner() = default;
+
+Status CompactionRateTuner::Init() {
+  if (!rate_limiter_ || FLAGS_compaction_rate_tuner_interval_ms <= 0) {
+    return Status::OK();
+  }
+  bg_task_ = std::make_unique<BackgroundTask>(
+      std::function<void()>([this]() { Tune(); }),
+      "compaction rate tuner", "compaction rate tuner bgtask",
+      std::chrono::milliseconds(FLAGS_compaction_rate_tuner_interval_ms));
+  return bg_task_->Init();
+}
+
+void CompactionRateTuner::Shutdown() {
+  if (bg_task_) {
+    bg_task_->Shutdown();
+  }
+}
+
+int64_t CompactionRateTuner::CalculateRate(int64_t current_rate, uint64_t max_num_sorted_runs) {
+  const auto min_rate = FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec;
+  const auto max_rate = FLAGS_rocksdb_compact_flush_rate_limit_max_bytes_per_sec;
+  if (max_rate <= min_rate) {
+    return min_rate;
+  }
+  current_rate = std::clamp(current_rate, min_rate, max_rate);
+  const auto high_num_sorted_runs = FLAGS_compaction_rate_tuner_high_num_sorted_runs;
+  if (max_num_sorted_runs >= high_num_sorted_runs) {
+    return std::min<int64_t>(current_rate * kRateStep, max_rate);
+  }
+  if (max_num_sorted_runs * 2 < high_num_sorted_runs) {
+    return std::max<int64_t>(current_rate / kRateStep, min_rate);
+  }
+  return current_rate;
+}
+
+void CompactionRateTuner::Tune() {
+  const auto base_rate = FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec;
+  if (base_rate <= 0) {
+    return;
+  }
+  if (FLAGS_rocksdb_compact_flush_rate_limit_max_bytes_per_sec <= 0) {
+    // Restore the configured rate if tuning was disabled after the rate was changed.
+    if (current_rate_ && current_rate_ != base_rate) {
+      rate_limiter_->SetBytesPerSecond(base_rate);
+    }
+    current_rate_ = 0;
+    return;
+  }
+
+  uint64_t max_num_sorted_runs = 0;
+  for (const auto& peer : ts_tablet_manager_->GetTabletPeers()) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    max_num_sorted_runs = std::max(
+        max_num_sorted_runs, tablet->GetCurrentVersionNumCompactableSortedRuns());
+  }
+
+  auto current_rate = current_rate_ ? current_rate_ : base_rate;
+  auto new_rate = CalculateRate(current_rate, max_num_sorted_runs);
+  if (new_rate != current_rate || !current_rate_) {
+    YB_LOG_EVERY_N_SECS(INFO, 60)
+        << "Compaction rate limit: " << new_rate
+        << ", max number of compactable sorted runs in a tablet: " << max_num_sorted_runs;
+    rate_limiter_->SetBytesPerSecond(new_rate);
+  }
+  current_rate_ = new_rate;
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,67 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#pragma once
+
+#include <memory>
+
+#include "yb/rocksdb/rocksdb_fwd.h"
+
+#include "yb/tserver/tserver_fwd.h"
+
+#include "yb/util/status_fwd.h"
+
+namespace yb {
+
+class BackgroundTask;
+
+namespace tserver {
+
+// Adjusts the tserver wide compaction and flush rate limit using read amplification of tablets,
+// i.e. number of sorted runs in their regular RocksDB that could be compacted together.
+// Files that are never compacted together, such as files too large to compact or files from
+// different time windows, are not counted, since a higher rate would not reduce their number.
+// While some tablet has too many sorted runs, compactions are falling behind, so the rate is raised
+// up to rocksdb_compact_flush_rate_limit_max_bytes_per_sec. When there is no backlog, the rate is
+// gradually lowered back to rocksdb_compact_flush_rate_limit_bytes_per_sec, so compactions do not
+// compete with foreground I/O.
+class CompactionRateTuner {
+ public:
+  CompactionRateTuner(TSTabletManager* ts_tablet_manager, rocksdb::RateLimiter* rate_limiter);
+  ~CompactionRateTuner();
+
+  Status Init();
+
+  void Shutdown();
+
+  // Returns rate limit that should be used, given the current one and max number of compactable
+  // sorted runs among tablets.
+  static int64_t CalculateRate(int64_t current_rate, uint64_t max_num_sorted_runs);
+
+  // Adjusts the rate limit once, invoked periodically by the background task.
+  void Tune();
+
+ private:
+  TSTabletManager* const ts_tablet_manager_;
+  rocksdb::RateLimiter* const rate_limiter_;
+
+  // Rate limit set by this tuner, 0 if it was not changed yet.
+  int64_t current_rate_ = 0;
+
+  std::unique_ptr<BackgroundTask> bg_task_;
+};
+
+} // namespace tserver
+} // namespace yb
@@ -13,6 +13,8 @@
 
 #include "yb/tserver/tablet_memory_manager.h"
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include "yb/consensus/log_cache.h"
 #include "yb/consensus/raft_consensus.h"
 
@@ -23,6 +25,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/secondary_cache.h"
 
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_options.h"
@@ -32,6 +35,7 @@
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/status_log.h"
 
 using namespace std::literals;
@@ -81,6 +85,42 @@ DEFINE_RUNTIME_int32(db_block_cache_num_shard_bits, -1,
              "The maximum permissible value is 19.");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_NON_RUNTIME_string(db_block_cache_type, "LRU",
+             "Type of RocksDB block cache: LRU or CLOCK. CLOCK cache does not take shard mutex on "
+             "lookup, so it scales better when many threads read the same blocks.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+namespace {
+
+bool BlockCacheTypeValidator(const char* flag_name, const std::string& flag_value) {
+  if (boost::iequals(flag_value, "LRU") || boost::iequals(flag_value, "CLOCK")) {
+    return true;
+  }
+  LOG(ERROR) << flag_name << ": unknown block cache type " << flag_value;
+  return false;
+}
+
+} // namespace
+
+DEFINE_validator(db_block_cache_type, &BlockCacheTypeValidator);
+
+DEFINE_NON_RUNTIME_string(db_block_cache_secondary_dir, "",
+             "Directory on a fast local disk for the secondary block cache, that keeps data blocks "
+             "evicted from the multi touch part of the LRU block cache. Empty value disables the "
+             "secondary block cache. Secondary block cache files in this directory are removed on "
+             "start.");
+TAG_FLAG(db_block_cache_secondary_dir, advanced);
+
+DEFINE_NON_RUNTIME_uint64(db_block_cache_secondary_disk_size_bytes, 16_GB,
+             "Max disk space used by the secondary block cache.");
+TAG_FLAG(db_block_cache_secondary_disk_size_bytes, advanced);
+
+DEFINE_NON_RUNTIME_uint64(db_block_cache_secondary_memory_size_bytes, 128_MB,
+             "Max memory used by the secondary block cache index and the blocks that were not "
+             "written to disk yet. Evicted blocks are not admitted to the secondary block cache "
+             "while this limit is reached.");
+TAG_FLAG(db_block_cache_secondary_memory_size_bytes, advanced);
+
 DEFINE_test_flag(bool, pretend_memory_exceeded_enforce_flush, false,
                   "Always pretend memory has been exceeded to enforce background flush.");
 
@@ -188,6 +228,34 @@ std::shared_ptr<MemTracker> TabletMemoryManager::block_based_table_mem_tracker()
   return block_based_table_mem_tracker_;
 }
 
+namespace {
+
+// Memory of the secondary block cache is consumed from the child of block_cache_mem_tracker, so it
+// is accounted as a part of the block cache.
+std::shared_ptr<rocksdb::SecondaryCache> CreateSecondaryBlockCache(
+    const std::shared_ptr<MemTracker>& block_cache_mem_tracker) {
+  if (FLAGS_db_block_cache_secondary_dir.empty()) {
+    return nullptr;
+  }
+  rocksdb::FileSecondaryCacheOptions secondary_cache_options;
+  secondary_cache_options.dir = FLAGS_db_block_cache_secondary_dir;
+  secondary_cache_options.disk_capacity = FLAGS_db_block_cache_secondary_disk_size_bytes;
+  secondary_cache_options.memory_capacity = FLAGS_db_block_cache_secondary_memory_size_bytes;
+  secondary_cache_options.mem_tracker = MemTracker::FindOrCreateTracker(
+      "SecondaryBlockCache", block_cache_mem_tracker);
+  auto secondary_cache = rocksdb::NewFileSecondaryCache(secondary_cache_options);
+  if (!secondary_cache.ok()) {
+    LOG(WARNING) << "Failed to create secondary block cache in " << secondary_cache_options.dir
+                 << ": " << secondary_cache.status();
+    return nullptr;
+  }
+  LOG(INFO) << "Created secondary block cache in " << secondary_cache_options.dir
+            << ", disk capacity: " << secondary_cache_options.disk_capacity;
+  return *secondary_cache;
+}
+
+} // namespace
+
 void TabletMemoryManager::InitBlockCache(
     const scoped_refptr<MetricEntity>& metrics,
     const int32_t default_block_cache_size_percentage,
@@ -200,8 +268,18 @@ void TabletMemoryManager::InitBlockCache(
       server_mem_tracker_);
 
   if (block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    options->block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                GetDbBlockCacheNumShardBits());
+    if (boost::iequals(FLAGS_db_block_cache_type, "CLOCK")) {
+      LOG_IF(WARNING, !FLAGS_db_block_cache_secondary_dir.empty())
+          << "Secondary block cache is not supported by CLOCK block cache";
+      options->block_cache = rocksdb::NewClockCache(block_cache_size_bytes,
+                                                    GetDbBlockCacheNumShardBits());
+    } else {
+      options->block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
+                                                  GetDbBlockCacheNumShardBits(),
+                                                  /* strict_capacity_limit = */ false,
+                                                  CreateSecondaryBlockCache(
+                                                      block_based_table_mem_tracker_));
+    }
     options->block_cache->SetMetrics(metrics);
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(options->block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
@@ -47,6 +47,7 @@
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/raft_consensus.h"
 
+#include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 
 #include "yb/fs/fs_manager.h"
@@ -59,12 +60,14 @@
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/rate_limiter.h"
+#include "yb/rocksdb/write_batch.h"
 
 #include "yb/tablet/tablet-harness.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
 
+#include "yb/tserver/compaction_rate_tuner.h"
 #include "yb/tserver/full_compaction_manager.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_memory_manager.h"
@@ -86,6 +89,8 @@ using std::string;
 DECLARE_bool(TEST_pretend_memory_exceeded_enforce_flush);
 DECLARE_bool(TEST_tserver_disable_heartbeat);
 DECLARE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec);
+DECLARE_int64(rocksdb_compact_flush_rate_limit_max_bytes_per_sec);
+DECLARE_uint64(compaction_rate_tuner_high_num_sorted_runs);
 DECLARE_string(rocksdb_compact_flush_rate_limit_sharing_mode);
 DECLARE_bool(disable_auto_flags_management);
 DECLARE_int32(scheduled_full_compaction_frequency_hours);
@@ -764,6 +769,103 @@ TEST_F(TsTabletManagerTest, RateLimiterSharing) {
   peers_num = peers.size();
 }
 
+TEST_F(TsTabletManagerTest, CompactionRateTuner) {
+  constexpr int64_t kMinRate = 100_MB;
+  constexpr int64_t kMaxRate = 400_MB;
+  constexpr uint64_t kHighNumFiles = 20;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec) = kMinRate;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_compaction_rate_tuner_high_num_sorted_runs) = kHighNumFiles;
+
+  // Tuning is disabled, so the configured rate is used.
+  ASSERT_EQ(CompactionRateTuner::CalculateRate(kMinRate, kHighNumFiles), kMinRate);
+
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_compact_flush_rate_limit_max_bytes_per_sec) = kMaxRate;
+  // Rate is raised while there are too many files, but not above max rate.
+  auto rate = kMinRate;
+  for (int i = 0; i != 10; ++i) {
+    auto new_rate = CompactionRateTuner::CalculateRate(rate, kHighNumFiles);
+    ASSERT_GE(new_rate, rate);
+    rate = new_rate;
+  }
+  ASSERT_EQ(rate, kMaxRate);
+
+  // Rate is kept in the hysteresis range.
+  ASSERT_EQ(CompactionRateTuner::CalculateRate(rate, kHighNumFiles / 2), rate);
+
+  // Rate is lowered back, but not below min rate.
+  for (int i = 0; i != 10; ++i) {
+    auto new_rate = CompactionRateTuner::CalculateRate(rate, kHighNumFiles / 2 - 1);
+    ASSERT_LE(new_rate, rate);
+    rate = new_rate;
+  }
+  ASSERT_EQ(rate, kMinRate);
+
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_compact_flush_rate_limit_max_bytes_per_sec) = 0;
+}
+
+TEST_F(TsTabletManagerTest, CompactionRateTunerTune) {
+  constexpr int64_t kMinRate = 100_MB;
+  constexpr int64_t kMaxRate = 400_MB;
+  constexpr uint64_t kNumSortedRuns = 3;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec) = kMinRate;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_compact_flush_rate_limit_max_bytes_per_sec) = kMaxRate;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_compaction_rate_tuner_high_num_sorted_runs) = kNumSortedRuns;
+
+  std::shared_ptr<TabletPeer> peer;
+  ASSERT_OK(CreateNewTablet(kTableId, kTabletId, schema_, &peer));
+  auto tablet = peer->shared_tablet();
+
+  // Refill period of one second, so single burst is equal to the rate.
+  std::unique_ptr<rocksdb::RateLimiter> rate_limiter(
+      rocksdb::NewGenericRateLimiter(kMinRate, 1000000 /* refill_period_us */));
+  CompactionRateTuner tuner(tablet_manager_, rate_limiter.get());
+  auto tune = [&tuner, &rate_limiter] {
+    tuner.Tune();
+    return rate_limiter->GetSingleBurstBytes();
+  };
+
+  ASSERT_EQ(tune(), kMinRate);
+
+  // Each flush adds a sorted run. Number of sorted runs is below the compaction trigger, so they
+  // are not compacted.
+  for (uint64_t i = 0; i != kNumSortedRuns; ++i) {
+    docdb::ConsensusFrontiers frontiers;
+    set_op_id(OpId(1, 1), &frontiers);
+    set_hybrid_time(peer->clock().Now(), &frontiers);
+    rocksdb::WriteBatch batch;
+    batch.SetFrontiers(&frontiers);
+    batch.Put(Format("key-$0", i), "value");
+    ASSERT_OK(tablet->TEST_db()->Write(rocksdb::WriteOptions(), &batch));
+    ASSERT_OK(tablet->TEST_db()->Flush(rocksdb::FlushOptions()));
+  }
+  ASSERT_EQ(tablet->GetCurrentVersionNumCompactableSortedRuns(), kNumSortedRuns);
+
+  // Rate is raised while some tablet has too many sorted runs.
+  int64_t rate = kMinRate;
+  for (int i = 0; i != 10; ++i) {
+    auto new_rate = tune();
+    ASSERT_GE(new_rate, rate);
+    rate = new_rate;
+  }
+  ASSERT_EQ(rate, kMaxRate);
+
+  // With the higher threshold there is no backlog, so rate is lowered back.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_compaction_rate_tuner_high_num_sorted_runs) =
+      kNumSortedRuns * 2 + 1;
+  for (int i = 0; i != 10; ++i) {
+    auto new_rate = tune();
+    ASSERT_LE(new_rate, rate);
+    rate = new_rate;
+  }
+  ASSERT_EQ(rate, kMinRate);
+
+  // Configured rate is restored when tuning is disabled.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_compaction_rate_tuner_high_num_sorted_runs) = kNumSortedRuns;
+  ASSERT_GT(tune(), kMinRate);
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_compact_flush_rate_limit_max_bytes_per_sec) = 0;
+  ASSERT_EQ(tune(), kMinRate);
+}
+
 TEST_F(TsTabletManagerTest, DataAndWalFilesLocations) {
   std::string wal;
   std::string data;
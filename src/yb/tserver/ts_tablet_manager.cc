@@ -82,6 +82,7 @@
 
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/operations/split_operation.h"
+#include "yb/tablet/shared_transaction_status_cache.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
@@ -89,6 +90,7 @@
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/tablet_peer.h"
 
+#include "yb/tserver/compaction_rate_tuner.h"
 #include "yb/tserver/full_compaction_manager.h"
 #include "yb/tserver/heartbeater.h"
 #include "yb/tserver/remote_bootstrap_client.h"
@@ -240,6 +242,11 @@ DEFINE_NON_RUNTIME_int32(full_compaction_pool_max_queue_size, 500,
              "on a scheduled basis or after they have been split and still contain irrelevant data "
              "from the tablet they were sourced from.");
 
+DEFINE_NON_RUNTIME_int32(memtable_insert_pool_max_threads, 0,
+             "The maximum number of threads used to insert large write batches into the memtable "
+             "of regular RocksDB concurrently with the applying thread. This raises the write "
+             "throughput of a single hot tablet. 0 to insert using the applying thread only.");
+
 DEFINE_NON_RUNTIME_int32(scheduled_full_compaction_check_interval_min, 15,
              "DEPRECATED. Use auto_compact_check_interval_sec.");
 
@@ -481,6 +488,11 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
               .set_metrics(THREAD_POOL_METRICS_INSTANCE(
                   server_->metric_entity(), waiting_txn_pool))
               .Build(&waiting_txn_pool_));
+  if (FLAGS_memtable_insert_pool_max_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("memtable-insert")
+                .set_max_threads(FLAGS_memtable_insert_pool_max_threads)
+                .Build(&memtable_insert_pool_));
+  }
   ts_split_op_apply_ = METRIC_ts_split_op_apply.Instantiate(server_->metric_entity(), 0);
   ts_post_split_compaction_added_ =
       METRIC_ts_post_split_compaction_added.Instantiate(server_->metric_entity(), 0);
@@ -497,6 +509,7 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   tablet_options_.priority_thread_pool_metrics =
       std::make_shared<rocksdb::RocksDBPriorityThreadPoolMetrics>(
           ROCKSDB_PRIORITY_THREAD_POOL_METRICS_INSTANCE(server_->metric_entity()));
+  tablet_options_.memtable_insert_thread_pool = memtable_insert_pool_.get();
 }
 
 TSTabletManager::~TSTabletManager() {
@@ -511,6 +524,8 @@ Status TSTabletManager::Init() {
   if (docdb::GetRocksDBRateLimiterSharingMode() == docdb::RateLimiterSharingMode::TSERVER) {
     tablet_options_.rate_limiter = docdb::CreateRocksDBRateLimiter();
   }
+  compaction_rate_tuner_ = std::make_unique<CompactionRateTuner>(
+      this, tablet_options_.rate_limiter.get());
 
   // Start the threadpool we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
@@ -553,6 +568,9 @@ Status TSTabletManager::Init() {
         waiting_txn_pool());
   }
 
+  shared_txn_status_cache_ = std::make_unique<tablet::SharedTransactionStatusCache>(
+      server_->metric_entity());
+
   deque<RaftGroupMetadataPtr> metas;
 
   // First, load all of the tablet metadata. We do this before we start
@@ -616,6 +634,8 @@ Status TSTabletManager::Init() {
 
   RETURN_NOT_OK(full_compaction_manager_->Init());
 
+  RETURN_NOT_OK(compaction_rate_tuner_->Init());
+
   tablets_cleaner_ = std::make_unique<rpc::Poller>(
       LogPrefix(), std::bind(&TSTabletManager::CleanupSplitTablets, this));
 
@@ -1617,7 +1637,8 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
         .full_compaction_pool = full_compaction_pool(),
         .admin_triggered_compaction_pool = admin_triggered_compaction_pool(),
         .post_split_compaction_added = ts_post_split_compaction_added_,
-        .metadata_cache = metadata_cache};
+        .metadata_cache = metadata_cache,
+        .shared_txn_status_cache = shared_txn_status_cache_.get()};
     tablet::BootstrapTabletData data = {
       .tablet_init_data = tablet_init_data,
       .listener = tablet_peer->status_listener(),
@@ -1772,6 +1793,10 @@ void TSTabletManager::StartShutdown() {
 
   full_compaction_manager_->Shutdown();
 
+  if (compaction_rate_tuner_) {
+    compaction_rate_tuner_->Shutdown();
+  }
+
   // Wait for all RBS operations to finish.
   const MonoDelta kSingleWait = 10ms;
   const MonoDelta kReportInterval = 5s;
@@ -1859,6 +1884,9 @@ void TSTabletManager::CompleteShutdown() {
   if (waiting_txn_pool_) {
     waiting_txn_pool_->Shutdown();
   }
+  if (memtable_insert_pool_) {
+    memtable_insert_pool_->Shutdown();
+  }
 
   {
     std::lock_guard l(mutex_);
@@ -96,6 +96,7 @@ class RaftConfigPB;
 
 namespace tserver {
 class TabletServer;
+class CompactionRateTuner;
 class FullCompactionManager;
 
 using rocksdb::MemoryMonitor;
@@ -642,6 +643,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::unique_ptr<ThreadPool> waiting_txn_pool_;
 
+  // Thread pool for inserting large write batches into the memtables of regular RocksDB.
+  std::unique_ptr<ThreadPool> memtable_insert_pool_;
+
   std::unique_ptr<rpc::Poller> tablets_cleaner_;
 
   // Used for verifying tablet data integrity.
@@ -654,6 +658,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::unique_ptr<rpc::Poller> waiting_txn_registry_poller_;
 
+  // Statuses of transactions shared by transaction participants of all tablets.
+  std::unique_ptr<tablet::SharedTransactionStatusCache> shared_txn_status_cache_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -689,6 +696,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::unique_ptr<FullCompactionManager> full_compaction_manager_;
 
+  std::unique_ptr<CompactionRateTuner> compaction_rate_tuner_;
+
   std::shared_mutex service_registration_mutex_;
   std::unordered_map<StatefulServiceKind, ConsensusChangeCallback> service_consensus_change_cb_;
 
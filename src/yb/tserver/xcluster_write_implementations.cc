@@ -22,6 +22,7 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/dockv/key_bytes.h"
 #include "yb/dockv/packed_row.h"
+#include "yb/dockv/schema_packing.h"
 #include "yb/docdb/rocksdb_writer.h"
 
 #include "yb/tserver/xcluster_write_interface.h"
@@ -72,8 +73,8 @@ Status UpdatePackedRow(const Slice& key,
   // Don't perform any changes to the value for the following cases:
   // 1. Non-packed rows
   // 2. We don't have a schema version map of producer to consumer schema versions
-  if (!value_slice.TryConsumeByte(dockv::ValueEntryTypeAsChar::kPackedRow) ||
-      schema_versions_map.empty()) {
+  auto packed_row_version = dockv::ConsumePackedRowVersion(&value_slice);
+  if (!packed_row_version || schema_versions_map.empty()) {
     // Return the whole value without changes
     out->Truncate(0);
     out->Reserve(value.size());
@@ -88,7 +89,8 @@ Status UpdatePackedRow(const Slice& key,
     }
     return it->second;
   };
-  auto status = ReplaceSchemaVersionInPackedValue(value_slice, control_fields, mapper, out);
+  auto status = ReplaceSchemaVersionInPackedValue(
+      value_slice, *packed_row_version, control_fields, mapper, out);
 
   if (status.ok()) {
     VLOG(3) << Format("Updated kv with producer schema version $0=$1",
@@ -71,6 +71,42 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+
+METRIC_DEFINE_counter(server, block_cache_secondary_inserts,
+                      "Secondary Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks evicted from the block cache and stored in the secondary "
+                      "block cache");
+METRIC_DEFINE_counter(server, block_cache_secondary_admission_rejects,
+                      "Secondary Block Cache Admission Rejects", yb::MetricUnit::kBlocks,
+                      "Number of blocks evicted from the block cache that were not admitted to the "
+                      "secondary block cache");
+METRIC_DEFINE_counter(server, block_cache_secondary_lookups,
+                      "Secondary Block Cache Lookups", yb::MetricUnit::kBlocks,
+                      "Number of blocks looked up from the secondary block cache");
+METRIC_DEFINE_counter(server, block_cache_secondary_hits,
+                      "Secondary Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups that found a block in the secondary block cache");
+METRIC_DEFINE_counter(server, block_cache_secondary_read_errors,
+                      "Secondary Block Cache Read Errors", yb::MetricUnit::kBlocks,
+                      "Number of secondary block cache lookups that failed to read a block");
+METRIC_DEFINE_counter(server, block_cache_secondary_write_errors,
+                      "Secondary Block Cache Write Errors", yb::MetricUnit::kRequests,
+                      "Number of failed writes to the secondary block cache files");
+METRIC_DEFINE_counter(server, block_cache_secondary_dropped_segments,
+                      "Secondary Block Cache Dropped Segments", yb::MetricUnit::kUnits,
+                      "Number of secondary block cache segments dropped to stay within the disk "
+                      "limit");
+
+METRIC_DEFINE_gauge_uint64(server, block_cache_secondary_disk_usage,
+                           "Secondary Block Cache Disk Usage",
+                           yb::MetricUnit::kBytes,
+                           "Disk space consumed by the secondary block cache");
+METRIC_DEFINE_gauge_uint64(server, block_cache_secondary_memory_usage,
+                           "Secondary Block Cache Memory Usage",
+                           yb::MetricUnit::kBytes,
+                           "Memory consumed by the secondary block cache index and the blocks "
+                           "that are not written to disk yet");
+
 namespace yb {
 
 #define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
@@ -87,6 +123,18 @@ CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
     GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
     GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
 }
+
+SecondaryCacheMetrics::SecondaryCacheMetrics(const scoped_refptr<MetricEntity>& entity)
+  : MINIT(inserts, block_cache_secondary_inserts),
+    MINIT(admission_rejects, block_cache_secondary_admission_rejects),
+    MINIT(lookups, block_cache_secondary_lookups),
+    MINIT(cache_hits, block_cache_secondary_hits),
+    MINIT(read_errors, block_cache_secondary_read_errors),
+    MINIT(write_errors, block_cache_secondary_write_errors),
+    MINIT(dropped_segments, block_cache_secondary_dropped_segments),
+    GINIT(disk_usage, block_cache_secondary_disk_usage),
+    GINIT(memory_usage, block_cache_secondary_memory_usage) {
+}
 #undef MINIT
 #undef GINIT
 
@@ -59,4 +59,19 @@ struct CacheMetrics {
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
 };
 
+struct SecondaryCacheMetrics {
+  explicit SecondaryCacheMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+
+  scoped_refptr<Counter> inserts;
+  scoped_refptr<Counter> admission_rejects;
+  scoped_refptr<Counter> lookups;
+  scoped_refptr<Counter> cache_hits;
+  scoped_refptr<Counter> read_errors;
+  scoped_refptr<Counter> write_errors;
+  scoped_refptr<Counter> dropped_segments;
+
+  scoped_refptr<AtomicGauge<uint64_t> > disk_usage;
+  scoped_refptr<AtomicGauge<uint64_t> > memory_usage;
+};
+
 } // namespace yb
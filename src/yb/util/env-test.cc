@@ -35,6 +35,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -60,6 +61,7 @@
 
 DECLARE_int32(o_direct_block_size_bytes);
 DECLARE_bool(TEST_simulate_fs_without_fallocate);
+DECLARE_bool(use_io_uring_for_multi_read);
 
 #if !defined(__APPLE__)
 #include <linux/falloc.h>
@@ -623,6 +625,40 @@ TEST_F(TestEnv, TestOpenEmptyRandomAccessFile) {
   ASSERT_EQ(0, size);
 }
 
+TEST_F(TestEnv, TestMultiRead) {
+  Env* env = Env::Default();
+  const string test_file = JoinPathSegments(GetTestDataDirectory(), "test_file");
+  constexpr size_t kFileSize = 256 * 1024;
+  constexpr size_t kNumRequests = 200;
+  ASSERT_NO_FATALS(WriteTestFile(env, test_file, kFileSize));
+  std::unique_ptr<RandomAccessFile> readable_file;
+  ASSERT_OK(env->NewRandomAccessFile(test_file, &readable_file));
+
+  for (bool use_io_uring : {false, true}) {
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_use_io_uring_for_multi_read) = use_io_uring;
+    std::vector<std::unique_ptr<uint8_t[]>> buffers;
+    std::vector<ReadRequest> requests;
+    for (size_t i = 0; i != kNumRequests; ++i) {
+      // The last request crosses the end of file.
+      size_t offset = i + 1 == kNumRequests ? kFileSize - 100 : RandomUniformInt<size_t>(
+          0, kFileSize - 4096);
+      size_t length = i + 1 == kNumRequests ? 200 : RandomUniformInt<size_t>(1, 4096);
+      buffers.emplace_back(new uint8_t[length]);
+      requests.push_back(ReadRequest {
+        .offset = offset,
+        .length = length,
+        .scratch = buffers.back().get(),
+        .result = Slice(),
+      });
+    }
+    ASSERT_OK(readable_file->MultiRead(requests.data(), requests.size()));
+    for (const auto& request : requests) {
+      ASSERT_EQ(request.result.size(), std::min(request.length, kFileSize - request.offset));
+      ASSERT_NO_FATALS(VerifyTestData(request.result, request.offset));
+    }
+  }
+}
+
 TEST_F(TestEnv, TestOverwrite) {
   string test_path = GetTestPath("test_env_wf");
 
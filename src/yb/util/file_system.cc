@@ -33,10 +33,21 @@ Status RandomAccessFile::Read(uint64_t offset, size_t n, Slice* result, char* sc
   return Read(offset, n, result, reinterpret_cast<uint8_t*>(scratch));
 }
 
+Status RandomAccessFile::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  for (auto* request = requests; request != requests + num_requests; ++request) {
+    RETURN_NOT_OK(Read(request->offset, request->length, &request->result, request->scratch));
+  }
+  return Status::OK();
+}
+
 Status RandomAccessFile::InvalidateCache(size_t offset, size_t length) {
   return STATUS(NotSupported, "InvalidateCache not supported.");
 }
 
+Status RandomAccessFile::Readahead(uint64_t offset, size_t length) {
+  return Status::OK();
+}
+
 Status SequentialFileWrapper::InvalidateCache(size_t offset, size_t length) {
   return target_->InvalidateCache(offset, length);
 }
@@ -52,6 +63,10 @@ Status RandomAccessFileWrapper::Read(
   return target_->Read(offset, n, result, scratch);
 }
 
+Status RandomAccessFileWrapper::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  return target_->MultiRead(requests, num_requests);
+}
+
 Result<uint64_t> RandomAccessFileWrapper::Size() const { return target_->Size(); }
 
 Result<uint64_t> RandomAccessFileWrapper::INode() const { return target_->INode(); }
@@ -60,6 +75,10 @@ Status RandomAccessFileWrapper::InvalidateCache(size_t offset, size_t length) {
   return target_->InvalidateCache(offset, length);
 }
 
+Status RandomAccessFileWrapper::Readahead(uint64_t offset, size_t length) {
+  return target_->Readahead(offset, length);
+}
+
 } // namespace yb
 
 namespace rocksdb {
@@ -118,6 +118,15 @@ class ReadValidator {
   virtual ~ReadValidator() = default;
 };
 
+// Single read of RandomAccessFile::MultiRead.
+struct ReadRequest {
+  uint64_t offset = 0;
+  size_t length = 0;
+  uint8_t* scratch = nullptr;
+  // Filled by MultiRead. Follows the same rules as result of RandomAccessFile::Read.
+  Slice result;
+};
+
 // A file abstraction for randomly reading the contents of a file.
 class RandomAccessFile : public FileWithUniqueId {
  public:
@@ -142,6 +151,13 @@ class RandomAccessFile : public FileWithUniqueId {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch);
 
+  // Performs all specified reads, possibly in parallel. Returns the first encountered error,
+  // results of the requests are unspecified in this case.
+  // Default implementation performs reads one by one.
+  //
+  // Safe for concurrent use by multiple threads.
+  virtual Status MultiRead(ReadRequest* requests, size_t num_requests) const;
+
   // Returns the size of the file
   virtual Result<uint64_t> Size() const = 0;
 
@@ -180,6 +196,11 @@ class RandomAccessFile : public FileWithUniqueId {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Initiates asynchronous load of the specified range of the file into the OS page cache, so
+  // subsequent reads from this range do not wait for the disk. It is just a hint, so the default
+  // implementation does nothing.
+  virtual Status Readahead(uint64_t offset, size_t length);
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -364,6 +385,8 @@ class RandomAccessFileWrapper : public RandomAccessFile {
 
   Status Read(uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const override;
 
+  Status MultiRead(ReadRequest* requests, size_t num_requests) const override;
+
   Result<uint64_t> Size() const override;
 
   Result<uint64_t> INode() const override;
@@ -388,6 +411,8 @@ class RandomAccessFileWrapper : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { return target_->Hint(pattern); }
 
+  Status Readahead(uint64_t offset, size_t length) override;
+
   Status InvalidateCache(size_t offset, size_t length) override;
 
  private:
@@ -28,6 +28,8 @@
 #include "yb/util/coding.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/errno.h"
+#include "yb/util/flags.h"
+#include "yb/util/io_uring.h"
 #include "yb/util/malloc.h"
 #include "yb/util/result.h"
 #include "yb/util/stats/iostats_context_imp.h"
@@ -62,6 +64,10 @@
 
 DECLARE_bool(never_fsync);
 
+DEFINE_RUNTIME_bool(use_io_uring_for_multi_read, false,
+    "Use io_uring to perform batched reads from files in parallel. Falls back to synchronous "
+    "reads if io_uring is not available.");
+
 namespace {
 
 // A wrapper for fadvise, if the platform doesn't support fadvise, it will simply return
@@ -204,6 +210,16 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+Status PosixRandomAccessFile::MultiRead(ReadRequest* requests, size_t num_requests) const {
+  if (num_requests > 1 && FLAGS_use_io_uring_for_multi_read && use_os_buffer_) {
+    auto* reader = IoUringReader::ForCurrentThread();
+    if (reader) {
+      return reader->Read(fd_, filename_, requests, num_requests);
+    }
+  }
+  return RandomAccessFile::MultiRead(requests, num_requests);
+}
+
 Result<uint64_t> PosixRandomAccessFile::Size() const {
   TRACE_EVENT1("io", __PRETTY_FUNCTION__, "path", filename_);
   ThreadRestrictions::AssertIOAllowed();
@@ -257,6 +273,23 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+Status PosixRandomAccessFile::Readahead(uint64_t offset, size_t length) {
+#ifndef __linux__
+  return Status::OK();
+#else
+  if (!use_os_buffer_) {
+    // Pages are dropped from the OS cache after each read, so readahead would be wasted.
+    return Status::OK();
+  }
+  // POSIX_FADV_WILLNEED initiates a non-blocking read of the range into the page cache.
+  int ret = Fadvise(fd_, static_cast<off_t>(offset), length, POSIX_FADV_WILLNEED);
+  if (ret == 0) {
+    return Status::OK();
+  }
+  return STATUS_IO_ERROR(filename_, ret);
+#endif
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef __linux__
   return Status::OK();
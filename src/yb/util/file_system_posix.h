@@ -49,6 +49,8 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       uint8_t* scratch) const override;
 
+  Status MultiRead(ReadRequest* requests, size_t num_requests) const override;
+
   Result<uint64_t> Size() const override;
 
   Result<uint64_t> INode() const override;
@@ -61,6 +63,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  Status Readahead(uint64_t offset, size_t length) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 
  private:
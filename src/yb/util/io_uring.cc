@@ -0,0 +1,358 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/io_uring.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define YB_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "yb/util/errno.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+#include "yb/util/thread_restrictions.h"
+
+namespace yb {
+
+#ifdef YB_HAS_IO_URING
+
+namespace {
+
+// Set when io_uring could not be initialized because of missing kernel support, so other threads
+// don't retry.
+std::atomic<bool> io_uring_unavailable{false};
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+template <class T>
+T LoadAcquire(const T* ptr) {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template <class T>
+void StoreRelease(T* ptr, T value) {
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+template <class T>
+T* RingField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+// Reads the rest of the request with pread, after io_uring returned less than requested.
+Status CompleteRead(int fd, const std::string& filename, ReadRequest* request, size_t done) {
+  while (done < request->length) {
+    auto r = pread(
+        fd, request->scratch + done, request->length - done,
+        static_cast<off_t>(request->offset + done));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      request->result = Slice(request->scratch, done);
+      return STATUS_FROM_ERRNO_SPECIAL_EIO_HANDLING(filename, errno);
+    }
+    if (r == 0) {
+      break;
+    }
+    done += r;
+  }
+  request->result = Slice(request->scratch, done);
+  return Status::OK();
+}
+
+} // namespace
+
+class IoUringReader::Impl {
+ public:
+  ~Impl() {
+    if (sqes_) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  Status Init() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = IoUringSetup(kQueueDepth, &params);
+    if (ring_fd_ < 0) {
+      return STATUS_FROM_ERRNO("io_uring_setup", errno);
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      single_mmap = true;
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+#endif
+
+    sq_ring_ = VERIFY_RESULT(Map(sq_ring_size_, IORING_OFF_SQ_RING));
+    if (single_mmap) {
+      cq_ring_ = sq_ring_;
+    } else {
+      cq_ring_ = VERIFY_RESULT(Map(cq_ring_size_, IORING_OFF_CQ_RING));
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(VERIFY_RESULT(Map(sqes_size_, IORING_OFF_SQES)));
+
+    sq_entries_ = params.sq_entries;
+    sq_tail_ = RingField<uint32_t>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = *RingField<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = RingField<uint32_t>(sq_ring_, params.sq_off.array);
+    cq_head_ = RingField<uint32_t>(cq_ring_, params.cq_off.head);
+    cq_tail_ = RingField<uint32_t>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *RingField<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    iovecs_.resize(sq_entries_);
+    completed_flags_.resize(sq_entries_);
+    return Status::OK();
+  }
+
+  Status Read(int fd, const std::string& filename, ReadRequest* requests, size_t num_requests) {
+    Status result;
+    for (size_t start = 0; start < num_requests;) {
+      const auto batch = std::min<size_t>(num_requests - start, sq_entries_);
+      auto status = ReadBatch(fd, filename, requests + start, batch);
+      if (result.ok()) {
+        result = std::move(status);
+      }
+      start += batch;
+    }
+    return result;
+  }
+
+ private:
+  Result<void*> Map(size_t size, off_t offset) {
+    auto* result = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    if (result == MAP_FAILED) {
+      return STATUS_FROM_ERRNO("mmap io_uring", errno);
+    }
+    return result;
+  }
+
+  // Submits all requests, that should fit into submission queue, and waits for their completion.
+  Status ReadBatch(int fd, const std::string& filename, ReadRequest* requests, size_t count) {
+    if (failed_) {
+      return ReadWithPread(fd, filename, requests, count);
+    }
+    auto tail = *sq_tail_;
+    for (size_t i = 0; i != count; ++i) {
+      auto& request = requests[i];
+      iovecs_[i].iov_base = request.scratch;
+      iovecs_[i].iov_len = request.length;
+      auto index = tail & sq_mask_;
+      auto& sqe = sqes_[index];
+      memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = IORING_OP_READV;
+      sqe.fd = fd;
+      sqe.off = request.offset;
+      sqe.addr = reinterpret_cast<uint64_t>(&iovecs_[i]);
+      sqe.len = 1;
+      sqe.user_data = i;
+      sq_array_[index] = index;
+      completed_flags_[i] = false;
+      ++tail;
+    }
+    StoreRelease(sq_tail_, tail);
+
+    Status result;
+    size_t to_submit = count;
+    size_t completed = 0;
+    while (completed < count) {
+      auto ret = IoUringEnter(
+          ring_fd_, static_cast<unsigned>(to_submit), 1, IORING_ENTER_GETEVENTS);
+      if (ret < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+          continue;
+        }
+        return HandleEnterFailure(
+            fd, filename, requests, count, tail, to_submit, completed, errno, std::move(result));
+      }
+      to_submit -= std::min<size_t>(ret, to_submit);
+      completed += ReapCompletions(fd, filename, requests, &result);
+    }
+    return result;
+  }
+
+  // Handles unexpected failure of io_uring_enter. Submitted reads still write into the caller
+  // buffers, so waits for their completion by polling completion queue, that is updated by the
+  // kernel w/o io_uring_enter. Then switches to pread, for the rest of this batch and for all
+  // following reads, since the ring state is unknown at this point.
+  Status HandleEnterFailure(
+      int fd, const std::string& filename, ReadRequest* requests, size_t count, uint32_t tail,
+      size_t not_submitted, size_t completed, int err, Status result) {
+    LOG(WARNING) << "io_uring_enter failed, falling back to synchronous reads: "
+                 << ErrnoToString(err);
+    failed_ = true;
+    // Kernel did not consume these entries, so they could be removed from the submission queue.
+    StoreRelease(sq_tail_, static_cast<uint32_t>(tail - not_submitted));
+    while (completed < count - not_submitted) {
+      auto reaped = ReapCompletions(fd, filename, requests, &result);
+      if (reaped == 0) {
+        SleepFor(MonoDelta::FromMilliseconds(1));
+      }
+      completed += reaped;
+    }
+    for (size_t i = 0; i != count; ++i) {
+      if (!completed_flags_[i]) {
+        auto status = CompleteRead(fd, filename, &requests[i], 0);
+        if (result.ok()) {
+          result = std::move(status);
+        }
+      }
+    }
+    return result;
+  }
+
+  // Processes all available entries of completion queue. Returns number of processed entries.
+  size_t ReapCompletions(
+      int fd, const std::string& filename, ReadRequest* requests, Status* result) {
+    size_t reaped = 0;
+    auto head = *cq_head_;
+    const auto cq_tail = LoadAcquire(cq_tail_);
+    for (; head != cq_tail; ++head) {
+      const auto& cqe = cqes_[head & cq_mask_];
+      auto& request = requests[cqe.user_data];
+      Status status;
+      if (cqe.res >= 0) {
+        status = CompleteRead(fd, filename, &request, cqe.res);
+      } else if (cqe.res == -EAGAIN || cqe.res == -EINTR) {
+        status = CompleteRead(fd, filename, &request, 0);
+      } else {
+        request.result = Slice(request.scratch, 0);
+        status = STATUS_FROM_ERRNO_SPECIAL_EIO_HANDLING(filename, -cqe.res);
+      }
+      if (result->ok()) {
+        *result = std::move(status);
+      }
+      completed_flags_[cqe.user_data] = true;
+      ++reaped;
+    }
+    StoreRelease(cq_head_, head);
+    return reaped;
+  }
+
+  static Status ReadWithPread(
+      int fd, const std::string& filename, ReadRequest* requests, size_t count) {
+    Status result;
+    for (size_t i = 0; i != count; ++i) {
+      auto status = CompleteRead(fd, filename, &requests[i], 0);
+      if (result.ok()) {
+        result = std::move(status);
+      }
+    }
+    return result;
+  }
+
+  int ring_fd_ = -1;
+  void* sq_ring_ = nullptr;
+  void* cq_ring_ = nullptr;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  size_t sqes_size_ = 0;
+
+  uint32_t sq_entries_ = 0;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  std::vector<iovec> iovecs_;
+  // Whether request with the specified index in the current batch was completed.
+  std::vector<bool> completed_flags_;
+  // Set after unexpected io_uring failure, in this case reads are performed with pread.
+  bool failed_ = false;
+};
+
+IoUringReader* IoUringReader::ForCurrentThread() {
+  static thread_local std::unique_ptr<IoUringReader> reader;
+  static thread_local bool initialized = false;
+  if (!initialized) {
+    initialized = true;
+    if (io_uring_unavailable.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    auto impl = std::make_unique<Impl>();
+    auto status = impl->Init();
+    if (status.ok()) {
+      reader.reset(new IoUringReader(std::move(impl)));
+    } else if (!io_uring_unavailable.exchange(true, std::memory_order_acq_rel)) {
+      LOG(WARNING) << "io_uring is not available, falling back to synchronous reads: " << status;
+    }
+  }
+  return reader.get();
+}
+
+Status IoUringReader::Read(
+    int fd, const std::string& filename, ReadRequest* requests, size_t num_requests) {
+  ThreadRestrictions::AssertIOAllowed();
+  return impl_->Read(fd, filename, requests, num_requests);
+}
+
+#else
+
+class IoUringReader::Impl {
+};
+
+IoUringReader* IoUringReader::ForCurrentThread() {
+  return nullptr;
+}
+
+Status IoUringReader::Read(
+    int fd, const std::string& filename, ReadRequest* requests, size_t num_requests) {
+  return STATUS(NotSupported, "io_uring is not supported");
+}
+
+#endif // YB_HAS_IO_URING
+
+IoUringReader::IoUringReader(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+IoUringReader::~IoUringReader() = default;
+
+} // namespace yb
@@ -0,0 +1,55 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include "yb/util/file_system.h"
+#include "yb/util/status_fwd.h"
+
+namespace yb {
+
+// Minimal io_uring based reader, used to perform a batch of reads from a file in parallel.
+// Implemented directly on top of io_uring system calls, so does not require liburing.
+//
+// Each thread uses its own ring, so an instance is not shared between threads.
+class IoUringReader {
+ public:
+  // Max number of reads submitted to the kernel at once.
+  static constexpr size_t kQueueDepth = 64;
+
+  // Returns reader for the current thread, or nullptr if io_uring is not available in the system,
+  // e.g. because of old kernel or seccomp policy.
+  static IoUringReader* ForCurrentThread();
+
+  ~IoUringReader();
+
+  // Performs all reads from the file with specified descriptor in parallel. Short reads are
+  // completed with pread, so the result size is less than requested only at the end of the file.
+  // After unexpected io_uring failure, remaining and all following reads of this reader are
+  // performed with pread.
+  Status Read(int fd, const std::string& filename, ReadRequest* requests, size_t num_requests);
+
+ private:
+  class Impl;
+
+  explicit IoUringReader(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace yb
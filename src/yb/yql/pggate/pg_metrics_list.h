@@ -103,6 +103,9 @@ typedef enum PgAnalyzeMetrics {
     YB_ANALYZE_METRIC_ROCKSDB_BLOCK_CACHE_MULTI_TOUCH_ADD,
     YB_ANALYZE_METRIC_ROCKSDB_BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
     YB_ANALYZE_METRIC_ROCKSDB_BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
+    YB_ANALYZE_METRIC_ROCKSDB_READAHEAD_REQUESTS,
+    YB_ANALYZE_METRIC_ROCKSDB_READAHEAD_BYTES,
+    YB_ANALYZE_METRIC_ROCKSDB_READAHEAD_RESETS,
 
     YB_ANALYZE_METRIC_COUNT,
 } YbPgAnalyzeMetrics;
@@ -223,6 +223,10 @@ class PgOperationBuffer::Impl {
     return keys_.size() + InFlightOpsCount();
   }
 
+  size_t PendingTransactionalOpsCount() const {
+    return txn_ops_.size();
+  }
+
   void Clear() {
     VLOG_IF(1, !keys_.empty()) << "Dropping " << keys_.size() << " pending operations";
     ops_.Clear();
@@ -435,6 +439,10 @@ size_t PgOperationBuffer::Size() const {
     return impl_->Size();
 }
 
+size_t PgOperationBuffer::PendingTransactionalOpsCount() const {
+    return impl_->PendingTransactionalOpsCount();
+}
+
 void PgOperationBuffer::Clear() {
     impl_->Clear();
 }
@@ -61,6 +61,8 @@ class PgOperationBuffer {
   Result<BufferableOperations> FlushTake(
       const PgTableDesc& table, const PgsqlOp& op, bool transactional);
   size_t Size() const;
+  // Number of not yet flushed transactional operations.
+  size_t PendingTransactionalOpsCount() const;
   void Clear();
 
  private:
@@ -43,6 +43,7 @@
 #include "yb/util/format.h"
 #include "yb/util/logging.h"
 #include "yb/util/result.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/status_format.h"
 #include "yb/util/string_util.h"
 
@@ -536,6 +537,12 @@ Result<client::TableSizeInfo> PgSession::GetTableDiskSize(const PgObjectId& tabl
 
 Status PgSession::StartOperationsBuffering() {
   SCHECK(!buffering_enabled_, IllegalState, "Buffering has been already started");
+  if (flush_deferred_till_commit_) {
+    // Previous statement was not the last one in the transaction, so its operations should be
+    // flushed now.
+    flush_deferred_till_commit_ = false;
+    RETURN_NOT_OK(FlushBufferedOperations());
+  }
   if (PREDICT_FALSE(!Empty(buffer_))) {
     LOG(DFATAL) << "Buffering hasn't been started yet but "
                 << buffer_.Size()
@@ -546,9 +553,19 @@ Status PgSession::StartOperationsBuffering() {
   return Status::OK();
 }
 
-Status PgSession::StopOperationsBuffering() {
+Status PgSession::StopOperationsBuffering(bool is_implicit_txn) {
   SCHECK(buffering_enabled_, IllegalState, "Buffering hasn't been started");
   buffering_enabled_ = false;
+  // Single buffered transactional operation could be the only operation of the transaction. Keep
+  // it till commit, so it could be sent without distributed transaction. Flush is not deferred when
+  // more operations are buffered or the operation is already non transactional, since deferring
+  // would only move their errors to commit.
+  if (is_implicit_txn && FLAGS_ysql_enable_single_shard_txn_fast_path && buffer_.Size() == 1 &&
+      buffer_.PendingTransactionalOpsCount() == 1 && !pg_txn_manager_->IsDdlMode() &&
+      NoOperationsPerformedInTxn()) {
+    flush_deferred_till_commit_ = true;
+    return Status::OK();
+  }
   return FlushBufferedOperations();
 }
 
@@ -561,7 +578,17 @@ Status PgSession::FlushBufferedOperations() {
   return buffer_.Flush();
 }
 
+Status PgSession::FlushBufferedOperationsOnCommit() {
+  flush_deferred_till_commit_ = false;
+  flushing_on_commit_ = true;
+  auto se = ScopeExit([this] {
+    flushing_on_commit_ = false;
+  });
+  return FlushBufferedOperations();
+}
+
 void PgSession::DropBufferedOperations() {
+  flush_deferred_till_commit_ = false;
   buffer_.Clear();
 }
 
@@ -585,6 +612,11 @@ Result<PerformFuture> PgSession::FlushOperations(BufferableOperations ops, bool
               << " session (num ops: " << ops.size() << ")";
   }
 
+  if (transactional && VERIFY_RESULT(CanFlushAsSingleShardTxn(ops))) {
+    VLOG(1) << "Flushing " << ops.size() << " operations of transaction as single shard write";
+    transactional = false;
+  }
+
   if (transactional) {
     auto txn_priority_requirement = kLowerPriorityRange;
     if (GetIsolationLevel() == PgIsolationLevel::READ_COMMITTED) {
@@ -673,6 +705,34 @@ Result<PerformFuture> PgSession::Perform(BufferableOperations&& ops, PerformOpti
   return PerformFuture(promise->get_future(), this, std::move(ops.relations));
 }
 
+bool PgSession::NoOperationsPerformedInTxn() const {
+  return std::get<0>(last_perform_on_txn_serial_no_).txn_serial_no !=
+         pg_txn_manager_->GetTxnSerialNo();
+}
+
+// Single row writes, which are known to be safe without distributed transaction from the plan, are
+// already sent as non transactional by postgres (see yb_es_is_single_row_modify_txn), they are not
+// buffered. This check is made at run time, when the whole statement is executed, so it also covers
+// statements rejected by the plan based check, as long as they produced a single write and nothing
+// else was sent: values computed by non immutable functions, tables with triggers, which don't
+// access other tables, and plans other than plain Result, such as INSERT ... SELECT of one row.
+Result<bool> PgSession::CanFlushAsSingleShardTxn(const BufferableOperations& ops) {
+  if (!flushing_on_commit_ || !FLAGS_ysql_enable_single_shard_txn_fast_path ||
+      pg_txn_manager_->IsDdlMode() ||
+      pg_txn_manager_->GetIsolationLevel() != IsolationLevel::NON_TRANSACTIONAL ||
+      !NoOperationsPerformedInTxn()) {
+    return false;
+  }
+  // Tablet applies operations of non transactional write independently, i.e. failure of one
+  // operation (for example because of duplicate key) does not prevent others from being written.
+  // So only single operation is atomic without distributed transaction.
+  if (ops.size() != 1) {
+    return false;
+  }
+  auto table = VERIFY_RESULT(LoadTable(ops.relations.front()));
+  return !table->schema().table_properties().is_ysql_catalog_table();
+}
+
 void PgSession::ProcessPerformOnTxnSerialNo(
     uint64_t txn_serial_no,
     EnsureReadTimeIsSet ensure_read_time_set_for_current_txn_serial_no,
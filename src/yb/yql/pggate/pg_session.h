@@ -214,12 +214,19 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   Status StartOperationsBuffering();
   // Flush all pending buffered operation and stop further buffering.
   // Buffering must be in progress.
-  Status StopOperationsBuffering();
+  // When is_implicit_txn is true, i.e. statement runs in a transaction started implicitly for it,
+  // flush could be deferred till commit (see FlushBufferedOperationsOnCommit). In this case errors
+  // of buffered operations are returned by the commit.
+  Status StopOperationsBuffering(bool is_implicit_txn = false);
   // Drop all pending buffered operations and stop further buffering. Buffering may be in any state.
   void ResetOperationsBuffering();
 
   // Flush all pending buffered operations. Buffering mode remain unchanged.
   Status FlushBufferedOperations();
+  // Flush all pending buffered operations right before transaction commit. If these are all the
+  // operations of the transaction and there is only one write, it is sent without distributed
+  // transaction.
+  Status FlushBufferedOperationsOnCommit();
   // Drop all pending buffered operations. Buffering mode remain unchanged.
   void DropBufferedOperations();
 
@@ -368,6 +375,13 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   Result<PerformFuture> Perform(BufferableOperations&& ops, PerformOptions&& options);
 
+  // Whether nothing was performed in context of the current transaction yet.
+  bool NoOperationsPerformedInTxn() const;
+
+  // Whether transactional buffered operations could be sent as a single shard write, i.e.
+  // without distributed transaction.
+  Result<bool> CanFlushAsSingleShardTxn(const BufferableOperations& ops);
+
   void ProcessPerformOnTxnSerialNo(
       uint64_t txn_serial_no,
       EnsureReadTimeIsSet force_set_read_time_for_current_txn_serial_no,
@@ -416,6 +430,10 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   // Should write operations be buffered?
   bool buffering_enabled_ = false;
+  // Whether flush of buffered operations was deferred till commit by StopOperationsBuffering.
+  bool flush_deferred_till_commit_ = false;
+  // Whether buffered operations are flushed right before transaction commit.
+  bool flushing_on_commit_ = false;
   BufferingSettings buffering_settings_;
   PgOperationBuffer buffer_;
 
@@ -74,6 +74,7 @@ class PgTxnManager : public RefCountedThreadSafe<PgTxnManager> {
   IsolationLevel GetIsolationLevel() const { return isolation_level_; }
   bool IsDdlMode() const { return ddl_type_ != DdlType::NonDdl; }
   bool ShouldEnableTracing() const { return enable_tracing_; }
+  uint64_t GetTxnSerialNo() const { return txn_serial_no_; }
 
   uint64_t SetupPerformOptions(tserver::PgPerformOptionsPB* options);
 
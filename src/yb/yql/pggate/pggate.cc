@@ -1302,8 +1302,8 @@ Status PgApiImpl::StartOperationsBuffering() {
   return pg_session_->StartOperationsBuffering();
 }
 
-Status PgApiImpl::StopOperationsBuffering() {
-  return pg_session_->StopOperationsBuffering();
+Status PgApiImpl::StopOperationsBuffering(bool is_implicit_txn) {
+  return pg_session_->StopOperationsBuffering(is_implicit_txn);
 }
 
 void PgApiImpl::ResetOperationsBuffering() {
@@ -1779,7 +1779,7 @@ Status PgApiImpl::RestartReadPoint() {
 
 Status PgApiImpl::CommitTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
-  RETURN_NOT_OK(pg_session_->FlushBufferedOperations());
+  RETURN_NOT_OK(pg_session_->FlushBufferedOperationsOnCommit());
   return pg_txn_manager_->CommitTransaction();
 }
 
@@ -475,7 +475,7 @@ class PgApiImpl {
 
   // Buffer write operations.
   Status StartOperationsBuffering();
-  Status StopOperationsBuffering();
+  Status StopOperationsBuffering(bool is_implicit_txn);
   void ResetOperationsBuffering();
   Status FlushBufferedOperations();
 
@@ -54,6 +54,15 @@ DEFINE_UNKNOWN_uint64(ysql_session_max_batch_size, 3072,
 DEFINE_UNKNOWN_bool(ysql_non_txn_copy, false,
             "Execute COPY inserts non-transactionally.");
 
+DEFINE_RUNTIME_bool(ysql_enable_single_shard_txn_fast_path, false,
+            "In a transaction started implicitly for a single statement, keep buffered writes "
+            "until commit. If by then nothing else was sent in the transaction and there is "
+            "only one write, it is sent as non-transactional write, avoiding intents write, "
+            "apply and cleanup. Since the write is sent at commit, its errors, such as duplicate "
+            "key, are reported by the commit rather than by the statement execution. Complements "
+            "the plan based single row modify path, covering statements it does not, such as "
+            "values from volatile functions, tables with local triggers and INSERT ... SELECT.");
+
 DEFINE_UNKNOWN_int32(ysql_max_read_restart_attempts, 20,
              "How many read restarts can we try transparently before giving up");
 
@@ -936,8 +936,8 @@ YBCStatus YBCPgStartOperationsBuffering() {
   return ToYBCStatus(pgapi->StartOperationsBuffering());
 }
 
-YBCStatus YBCPgStopOperationsBuffering() {
-  return ToYBCStatus(pgapi->StopOperationsBuffering());
+YBCStatus YBCPgStopOperationsBuffering(bool is_implicit_txn) {
+  return ToYBCStatus(pgapi->StopOperationsBuffering(is_implicit_txn));
 }
 
 void YBCPgResetOperationsBuffering() {
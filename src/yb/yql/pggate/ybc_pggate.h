@@ -450,7 +450,7 @@ YBCStatus YBCPgBuildYBTupleId(const YBCPgYBTupleIdDescriptor* data, uint64_t *yb
 
 // Buffer write operations.
 YBCStatus YBCPgStartOperationsBuffering();
-YBCStatus YBCPgStopOperationsBuffering();
+YBCStatus YBCPgStopOperationsBuffering(bool is_implicit_txn);
 void YBCPgResetOperationsBuffering();
 YBCStatus YBCPgFlushBufferedOperations();
 
@@ -53,6 +53,7 @@
 #include "yb/util/random_util.h"
 #include "yb/util/range.h"
 #include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status_log.h"
 #include "yb/util/test_macros.h"
@@ -66,6 +67,8 @@ using std::string;
 
 using namespace std::literals;
 
+DECLARE_bool(TEST_disable_apply_committed_transactions);
+DECLARE_bool(TEST_disable_proactive_txn_cleanup_on_abort);
 DECLARE_bool(TEST_force_master_leader_resolution);
 DECLARE_bool(enable_automatic_tablet_splitting);
 DECLARE_bool(enable_pg_savepoints);
@@ -81,7 +84,9 @@ DECLARE_int32(heartbeat_interval_ms);
 DECLARE_int32(history_cutoff_propagation_interval_ms);
 DECLARE_int32(timestamp_history_retention_interval_sec);
 DECLARE_int32(timestamp_syscatalog_history_retention_interval_sec);
+DECLARE_int32(transaction_status_cache_ttl_ms);
 DECLARE_int32(tserver_heartbeat_metrics_interval_ms);
+DECLARE_int32(txn_apply_sst_ingestion_min_records);
 DECLARE_int32(txn_max_apply_batch_records);
 DECLARE_int32(yb_num_shards_per_tserver);
 
@@ -96,6 +101,7 @@ DECLARE_int64(tablet_split_high_phase_shard_count_per_node);
 DECLARE_int64(tablet_split_high_phase_size_threshold_bytes);
 DECLARE_int64(tablet_split_low_phase_shard_count_per_node);
 DECLARE_int64(tablet_split_low_phase_size_threshold_bytes);
+DECLARE_int64(transaction_abort_check_interval_ms);
 
 DECLARE_uint64(max_clock_skew_usec);
 
@@ -107,6 +113,8 @@ DECLARE_uint64(pg_client_heartbeat_interval_ms);
 
 METRIC_DECLARE_entity(tablet);
 METRIC_DECLARE_gauge_uint64(aborted_transactions_pending_cleanup);
+METRIC_DECLARE_counter(transaction_status_cache_hits);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_GetTransactionStatus);
 
 namespace yb::pgwrapper {
 namespace {
@@ -177,6 +185,14 @@ class PgMiniTestFailOnConflict : public PgMiniTest {
   }
 };
 
+class PgMiniSingleShardTxnFastPathTest : public PgMiniTestSingleNode {
+ protected:
+  void SetUp() override {
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_ysql_enable_single_shard_txn_fast_path) = true;
+    PgMiniTestSingleNode::SetUp();
+  }
+};
+
 class PgMiniPgClientServiceCleanupTest : public PgMiniTestSingleNode {
  public:
   void SetUp() override {
@@ -1152,6 +1168,154 @@ TEST_F(PgMiniTest, BigInsertWithRestart) {
   TestBigInsert(/* restart= */ true);
 }
 
+// Large transaction with ascending keys should be applied by ingesting SST files, since applied
+// chunks do not overlap each other.
+TEST_F(PgMiniTest, BigInsertWithSstIngestion) {
+  constexpr int64_t kNumRows = RegularBuildVsSanitizers(100000, 10000);
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_txn_max_apply_batch_records) = kNumRows / 10;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_txn_apply_sst_ingestion_min_records) = kNumRows / 20;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (a int, PRIMARY KEY (a ASC))"));
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (0)"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT generate_series(1, $0)", kNumRows));
+
+  ASSERT_OK(WaitFor([this] {
+    return CountIntents(cluster_.get()) == 0;
+  }, 60s * kTimeMultiplier, "Intents cleanup", 200ms));
+
+  auto res = ASSERT_RESULT(conn.FetchValue<PGUint64>("SELECT SUM(a) FROM t"));
+  ASSERT_EQ(res, kNumRows * (kNumRows + 1) / 2);
+
+  // Tablets were not flushed explicitly, so SST files could appear only because of ingestion.
+  size_t num_checked_peers = 0;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet || tablet->metadata()->table_name() != "t") {
+      continue;
+    }
+    ASSERT_GT(tablet->GetCurrentVersionNumSSTFiles(), 0U) << peer->LogPrefix();
+    // Temporary files are moved to the DB when they are ingested.
+    auto apply_temp_dir = JoinPathSegments(tablet->metadata()->rocksdb_dir(), "apply.tmp");
+    auto temp_files = ASSERT_RESULT(
+        Env::Default()->GetChildren(apply_temp_dir, ExcludeDots::kTrue));
+    ASSERT_TRUE(temp_files.empty()) << peer->LogPrefix() << ": " << AsString(temp_files);
+    ++num_checked_peers;
+  }
+  ASSERT_GT(num_checked_peers, 0U);
+
+  // Ingested files should be ordered as the newest data, also after the full compaction.
+  ASSERT_OK(conn.ExecuteFormat("INSERT INTO t VALUES ($0)", kNumRows + 1));
+  ASSERT_OK(cluster_->FlushTablets());
+  ASSERT_OK(cluster_->CompactTablets());
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT generate_series($0, $1)", kNumRows + 2, kNumRows * 2));
+  ASSERT_OK(WaitFor([this] {
+    return CountIntents(cluster_.get()) == 0;
+  }, 60s * kTimeMultiplier, "Intents cleanup", 200ms));
+  ASSERT_OK(cluster_->CompactTablets());
+
+  res = ASSERT_RESULT(conn.FetchValue<PGUint64>("SELECT SUM(a) FROM t"));
+  ASSERT_EQ(res, kNumRows * (2 * kNumRows + 1));
+}
+
+// Single row writes outside of transaction block, that are not handled by the single row modify
+// path of postgres (yb_es_is_single_row_modify_txn), should not write intents. That path is decided
+// by the plan, so it does not handle values computed by non immutable functions, tables with
+// triggers and plans other than plain Result. Multi row statements and transaction blocks should
+// still be atomic. Errors of deferred writes are reported at commit.
+TEST_F_EX(PgMiniTest, SingleShardTxnFastPath, PgMiniSingleShardTxnFastPathTest) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (k INT PRIMARY KEY, v INT) SPLIT INTO 1 TABLETS"));
+  ASSERT_OK(conn.Execute("CREATE TABLE t2 (k INT PRIMARY KEY, v INT) SPLIT INTO 1 TABLETS"));
+  // Volatile function, that does not access tables. Plpgsql functions are not inlined.
+  ASSERT_OK(conn.Execute(
+      "CREATE FUNCTION twice(x INT) RETURNS INT AS $$ BEGIN RETURN x * 2; END $$ "
+      "LANGUAGE plpgsql"));
+  ASSERT_OK(conn.Execute(
+      "CREATE FUNCTION negate_v() RETURNS TRIGGER AS $$ BEGIN NEW.v := -NEW.v; RETURN NEW; END $$ "
+      "LANGUAGE plpgsql"));
+  ASSERT_OK(conn.Execute(
+      "CREATE TRIGGER t2_negate_v BEFORE INSERT OR UPDATE ON t2 FOR EACH ROW "
+      "EXECUTE PROCEDURE negate_v()"));
+
+  rocksdb::DB* intents_db = nullptr;
+  std::vector<rocksdb::DB*> intents_dbs;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    const auto& table_name = tablet->metadata()->table_name();
+    if (table_name == "t") {
+      intents_db = tablet->TEST_intents_db();
+    }
+    if (table_name == "t" || table_name == "t2") {
+      intents_dbs.push_back(tablet->TEST_intents_db());
+    }
+  }
+  ASSERT_NE(intents_db, nullptr);
+  ASSERT_EQ(intents_dbs.size(), 2U);
+  auto intents_written = [&intents_dbs] {
+    rocksdb::SequenceNumber result = 0;
+    for (auto* db : intents_dbs) {
+      result += db->GetLatestSequenceNumber();
+    }
+    return result;
+  };
+
+  constexpr int kNumRows = 10;
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(conn.ExecuteFormat("INSERT INTO t VALUES ($0, twice($0))", i));
+    ASSERT_OK(conn.ExecuteFormat("INSERT INTO t2 VALUES ($0, $0)", i));
+    ASSERT_EQ(intents_written(), 0U) << i;
+  }
+  ASSERT_OK(conn.Execute("INSERT INTO t SELECT k, k FROM generate_series(100, 100) AS k"));
+  // Writes handled by the single row modify path of postgres.
+  ASSERT_OK(conn.Execute("UPDATE t SET v = -1 WHERE k = 0"));
+  ASSERT_OK(conn.Execute("DELETE FROM t WHERE k = 1"));
+  ASSERT_EQ(intents_written(), 0U);
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int32_t>("SELECT v FROM t WHERE k = 2")), 4);
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int32_t>("SELECT v FROM t WHERE k = 100")), 100);
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int32_t>("SELECT v FROM t2 WHERE k = 2")), -2);
+  ASSERT_OK(conn.Execute("DELETE FROM t WHERE k = 100"));
+
+  // Write is sent at commit, so duplicate key is reported by commit of the statement transaction.
+  auto status = conn.Execute("INSERT INTO t VALUES (2, twice(2))");
+  ASSERT_NOK(status);
+  ASSERT_STR_CONTAINS(status.ToString(), "duplicate key value violates unique constraint");
+  status = conn.Execute("INSERT INTO t2 VALUES (2, 2)");
+  ASSERT_NOK(status);
+  ASSERT_STR_CONTAINS(status.ToString(), "duplicate key value violates unique constraint");
+  // Failed commit should not affect following statements.
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (1, twice(1))"));
+  ASSERT_EQ(intents_written(), 0U);
+
+  // Multiple writes to the same tablet are not handled by the fast path, so should go through
+  // the distributed transaction.
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (200, 200), (201, 201)"));
+  auto intents_seq_no = intents_db->GetLatestSequenceNumber();
+  ASSERT_GT(intents_seq_no, 0U);
+  // Same for statement that reads before writing.
+  ASSERT_OK(conn.Execute(
+      "INSERT INTO t VALUES (200, 200) ON CONFLICT (k) DO UPDATE SET v = EXCLUDED.v + 1"));
+  ASSERT_GT(intents_db->GetLatestSequenceNumber(), intents_seq_no);
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int32_t>("SELECT v FROM t WHERE k = 200")), 201);
+  ASSERT_OK(conn.Execute("DELETE FROM t WHERE k >= 200"));
+
+  // Duplicate key in the multi row insert should prevent other rows from being written.
+  ASSERT_NOK(conn.Execute("INSERT INTO t VALUES (100, 100), (3, 3)"));
+  ASSERT_OK(conn.Execute("BEGIN"));
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (101, 101)"));
+  ASSERT_OK(conn.Execute("ROLLBACK"));
+
+  auto count = ASSERT_RESULT(conn.FetchValue<PGUint64>("SELECT COUNT(*) FROM t"));
+  ASSERT_EQ(count, kNumRows);
+  auto value = ASSERT_RESULT(conn.FetchValue<int32_t>("SELECT v FROM t WHERE k = 0"));
+  ASSERT_EQ(value, -1);
+}
+
 TEST_F(PgMiniTest, BigInsertWithDropTable) {
   constexpr int kNumRows = 10000;
   ANNOTATE_UNPROTECTED_WRITE(FLAGS_txn_max_apply_batch_records) = kNumRows / 10;
@@ -1923,4 +2087,117 @@ TEST_F_EX(
   ASSERT_OK(aux_conn.Fetch("SELECT 1"));
 }
 
+// Transaction writes to all tablets of the single tablet server. The first tablet, that reads its
+// intents, requests the transaction status from the coordinator, and the rest of them should get
+// it from the tablet server wide transaction status cache.
+TEST_F_EX(PgMiniTest, SharedTransactionStatusCache, PgMiniTestSingleNode) {
+  constexpr size_t kNumTablets = 4;
+  constexpr int kNumRows = 40;
+  // Keep intents of committed transactions, so readers have to resolve transaction status.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_TEST_disable_apply_committed_transactions) = true;
+  // Avoid status requests from the periodic abort check of running transactions.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_abort_check_interval_ms) = 600000;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.ExecuteFormat(
+      "CREATE TABLE t (k INT PRIMARY KEY, v INT) SPLIT INTO $0 TABLETS", kNumTablets));
+
+  const auto& server = *cluster_->mini_tablet_server(0)->server();
+  MetricWatcher status_rpcs_watcher(
+      server, METRIC_handler_latency_yb_tserver_TabletServerService_GetTransactionStatus);
+  MetricWatcher cache_hits_watcher(server, METRIC_transaction_status_cache_hits);
+
+  // Commits transaction that writes rows to all tablets, and reads them one by one. Returns the
+  // number of transaction status requests sent while reading.
+  int first_key = 0;
+  auto write_and_read = [&conn, &status_rpcs_watcher, &first_key]() -> Result<size_t> {
+    const auto begin = first_key;
+    const auto end = begin + kNumRows;
+    first_key = end;
+    RETURN_NOT_OK(conn.Execute("BEGIN"));
+    RETURN_NOT_OK(conn.ExecuteFormat(
+        "INSERT INTO t SELECT k, k FROM generate_series($0, $1) AS k", begin, end - 1));
+    RETURN_NOT_OK(conn.Execute("COMMIT"));
+    return status_rpcs_watcher.Delta([&conn, begin, end]() -> Status {
+      for (auto k = begin; k != end; ++k) {
+        auto v = VERIFY_RESULT(conn.FetchValue<int32_t>(Format("SELECT v FROM t WHERE k = $0", k)));
+        SCHECK_EQ(v, k, IllegalState, "Wrong value");
+      }
+      return Status::OK();
+    });
+  };
+
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_status_cache_ttl_ms) = 0;
+  const auto rpcs_without_cache = ASSERT_RESULT(write_and_read());
+
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_status_cache_ttl_ms) = 30000;
+  size_t rpcs_with_cache = 0;
+  const auto cache_hits = ASSERT_RESULT(cache_hits_watcher.Delta(
+      [&write_and_read, &rpcs_with_cache]() -> Status {
+    rpcs_with_cache = VERIFY_RESULT(write_and_read());
+    return Status::OK();
+  }));
+  LOG(INFO) << "Status RPCs without cache: " << rpcs_without_cache << ", with cache: "
+            << rpcs_with_cache << ", cache hits: " << cache_hits;
+  ASSERT_GE(rpcs_without_cache, kNumTablets);
+  ASSERT_LT(rpcs_with_cache, rpcs_without_cache);
+  ASSERT_GE(cache_hits, kNumTablets - 1);
+}
+
+// Cached abort of the transaction is used by readers of other tablets, but it does not remove
+// the transaction from their participants. Its intents are cleaned up only after participants
+// learn about the abort from the coordinator themselves.
+TEST_F_EX(PgMiniTest, SharedTransactionStatusCacheAbort, PgMiniTestSingleNode) {
+  constexpr size_t kNumTablets = 4;
+  constexpr int kNumRows = 40;
+  // Leave cleanup of aborted transaction to participants.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_TEST_disable_proactive_txn_cleanup_on_abort) = true;
+  // Abort check should not happen while rows are read.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_abort_check_interval_ms) = 10000 * kTimeMultiplier;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.ExecuteFormat(
+      "CREATE TABLE t (k INT PRIMARY KEY, v INT) SPLIT INTO $0 TABLETS", kNumTablets));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT k, 0 FROM generate_series(0, $0) AS k", kNumRows - 1));
+
+  std::vector<tablet::TransactionParticipant*> participants;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+    auto tablet = peer->shared_tablet();
+    if (tablet && tablet->metadata()->table_name() == "t") {
+      participants.push_back(tablet->transaction_participant());
+    }
+  }
+  ASSERT_EQ(participants.size(), kNumTablets);
+  auto num_running_transactions = [&participants] {
+    size_t result = 0;
+    for (auto* participant : participants) {
+      result += participant->TEST_GetNumRunningTransactions();
+    }
+    return result;
+  };
+
+  ASSERT_OK(conn.Execute("BEGIN"));
+  ASSERT_OK(conn.Execute("UPDATE t SET v = 1"));
+  ASSERT_OK(conn.Execute("ROLLBACK"));
+  ASSERT_EQ(num_running_transactions(), kNumTablets);
+
+  MetricWatcher cache_hits_watcher(
+      *cluster_->mini_tablet_server(0)->server(), METRIC_transaction_status_cache_hits);
+  const auto cache_hits = ASSERT_RESULT(cache_hits_watcher.Delta([&conn]() -> Status {
+    for (int k = 0; k != kNumRows; ++k) {
+      auto v = VERIFY_RESULT(conn.FetchValue<int32_t>(Format("SELECT v FROM t WHERE k = $0", k)));
+      SCHECK_EQ(v, 0, IllegalState, "Value of aborted transaction is visible");
+    }
+    return Status::OK();
+  }));
+  ASSERT_GE(cache_hits, kNumTablets - 1);
+  // Only the tablet that received the status from the coordinator could remove the transaction.
+  ASSERT_GE(num_running_transactions(), kNumTablets - 1);
+
+  ASSERT_OK(WaitFor([&num_running_transactions] {
+    return num_running_transactions() == 0;
+  }, 60s * kTimeMultiplier, "Aborted transaction cleanup", 200ms));
+}
+
 } // namespace yb::pgwrapper
@@ -20,6 +20,7 @@
 
 #include "yb/rocksdb/db/db_impl.h"
 #include "yb/rocksdb/sst_dump_tool.h"
+#include "yb/rocksdb/statistics.h"
 
 #include "yb/tablet/kv_formatter.h"
 #include "yb/tablet/tablet.h"
@@ -41,6 +42,7 @@ DECLARE_bool(ysql_enable_packed_row);
 DECLARE_int32(history_cutoff_propagation_interval_ms);
 DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
 DECLARE_int32(timestamp_history_retention_interval_sec);
+DECLARE_int32(txn_apply_sst_ingestion_min_records);
 DECLARE_uint64(rocksdb_universal_compaction_always_include_size_threshold);
 DECLARE_uint64(ysql_packed_row_size_limit);
 DECLARE_bool(ysql_enable_packed_row_for_colocated_table);
@@ -315,6 +317,36 @@ TEST_F(PgPackedRowTest, SchemaChange) {
   ASSERT_EQ(value, "");
 }
 
+// Check that compaction repacks rows with old schema version to the latest one.
+TEST_F(PgPackedRowTest, RepackToLatestSchema) {
+  constexpr int kKeys = 100;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute(
+      "CREATE TABLE t (key INT PRIMARY KEY, v1 INT, v2 TEXT) SPLIT INTO 1 TABLETS"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, i, 'value' || i FROM generate_series(1, $0) AS i", kKeys));
+  ASSERT_OK(cluster_->FlushTablets(tablet::FlushMode::kSync));
+
+  ASSERT_OK(conn.Execute("ALTER TABLE t DROP COLUMN v2"));
+  ASSERT_OK(conn.Execute("ALTER TABLE t ADD COLUMN v3 INT"));
+  ASSERT_OK(cluster_->CompactTablets());
+
+  uint64_t repacked_rows = 0;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet || !tablet->regulardb_statistics()) {
+      continue;
+    }
+    repacked_rows += tablet->regulardb_statistics()->getTickerCount(
+        rocksdb::COMPACTION_PACKED_ROWS_REPACKED);
+  }
+  ASSERT_EQ(repacked_rows, kKeys);
+
+  auto sum = ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT SUM(v1) FROM t"));
+  ASSERT_EQ(sum, kKeys * (kKeys + 1) / 2);
+}
+
 // Check that we GC old schemas. I.e. when there are no more packed rows with this schema version.
 TEST_F(PgPackedRowTest, SchemaGC) {
   constexpr int kModifications = 1200;
@@ -780,6 +812,57 @@ TEST_F(PgPackedRowTest, AppliedSchemaVersionWithColocation) {
   TestAppliedSchemaVersion(true);
 }
 
+// Rows of a transaction applied by SST ingestion use the packing of the schema version they were
+// written with, so this packing should survive schema packing GC after ALTER TABLE, while the
+// ingested file is not compacted.
+TEST_F(PgPackedRowTest, SchemaGCAfterSstIngestion) {
+  constexpr int kNumRows = 10000;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_timestamp_history_retention_interval_sec) = 0;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rocksdb_level0_file_num_compaction_trigger) = 2;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_txn_apply_sst_ingestion_min_records) = kNumRows / 2;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT, value INT, PRIMARY KEY (key ASC))"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, -i FROM generate_series(1, $0) AS i", kNumRows));
+
+  ASSERT_OK(WaitFor([this] {
+    return CountIntents(cluster_.get()) == 0;
+  }, 60s * kTimeMultiplier, "Intents cleanup"));
+
+  tablet::TabletPtr tablet;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+    auto peer_tablet = peer->shared_tablet();
+    if (peer_tablet && peer_tablet->metadata()->table_name() == "t") {
+      tablet = peer_tablet;
+    }
+  }
+  ASSERT_NE(tablet, nullptr);
+  // Tablet was not flushed, so SST file could appear only because of ingestion.
+  ASSERT_EQ(tablet->GetCurrentVersionNumSSTFiles(), 1U);
+  for (const auto& file : tablet->TEST_db()->GetLiveFilesMetaData()) {
+    ASSERT_NE(file.smallest.user_frontier, nullptr) << file.name;
+    ASSERT_NE(file.largest.user_frontier, nullptr) << file.name;
+  }
+
+  ASSERT_OK(conn.Execute("ALTER TABLE t ADD COLUMN extra INT"));
+
+  // Flushed files written with the new schema version are small, so they are compacted without
+  // the ingested file, and schema packing GC runs after each compaction.
+  for (int i = 1; i <= FLAGS_rocksdb_level0_file_num_compaction_trigger * 2; ++i) {
+    ASSERT_OK(conn.ExecuteFormat("INSERT INTO t VALUES ($0, $1, $0)", kNumRows + i, -kNumRows - i));
+    ASSERT_OK(cluster_->FlushTablets());
+  }
+  ASSERT_OK(WaitFor([tablet] {
+    return tablet->GetCurrentVersionNumSSTFiles() <= 2U;
+  }, 30s * kTimeMultiplier, "Compact flushed files"));
+
+  auto sum = ASSERT_RESULT(conn.FetchRowAsString("SELECT SUM(key), SUM(value) FROM t"));
+  auto total_rows = kNumRows + FLAGS_rocksdb_level0_file_num_compaction_trigger * 2;
+  auto expected_sum = static_cast<int64_t>(total_rows) * (total_rows + 1) / 2;
+  ASSERT_EQ(sum, Format("$0, $1", expected_sum, -expected_sum));
+}
+
 TEST_F(PgPackedRowTest, UpdateToNull) {
   ANNOTATE_UNPROTECTED_WRITE(FLAGS_timestamp_history_retention_interval_sec) = 0;
 
@@ -19,11 +19,14 @@
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/fs/fs_manager.h"
+#include "yb/gutil/casts.h"
+#include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 
 #include "yb/tserver/mini_tablet_server.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_thread_holder.h"
@@ -56,6 +59,11 @@ DECLARE_uint64(refresh_waiter_timeout_ms);
 DECLARE_bool(ysql_enable_packed_row);
 DECLARE_bool(ysql_enable_pack_full_row_update);
 DECLARE_bool(TEST_drop_participant_signal);
+DECLARE_bool(enable_local_deadlock_cycle_detection);
+DECLARE_int32(transaction_table_num_tablets);
+
+METRIC_DECLARE_counter(deadlock_probes_sent);
+METRIC_DECLARE_histogram(deadlock_local_detection_latency);
 
 using namespace std::literals;
 
@@ -94,6 +102,30 @@ class PgWaitQueuesTest : public PgMiniTestBase {
   }
 
   void TestDeadlockWithWrites() const;
+
+  // Returns sum of the counter or histogram count over all tablets of the cluster.
+  size_t SumTabletMetric(const MetricPrototype& prototype) const {
+    size_t result = 0;
+    for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      for (const auto& peer : cluster_->GetTabletPeers(i)) {
+        auto tablet = peer->shared_tablet();
+        if (!tablet) {
+          continue;
+        }
+        const auto& metric_map = tablet->GetTabletMetricsEntity()->UnsafeMetricsMapForTests();
+        auto it = metric_map.find(&prototype);
+        if (it == metric_map.end()) {
+          continue;
+        }
+        if (prototype.type() == MetricType::kCounter) {
+          result += down_cast<const Counter&>(*it->second).value();
+        } else {
+          result += down_cast<const Histogram&>(*it->second).TotalCount();
+        }
+      }
+    }
+    return result;
+  }
 };
 
 auto GetBlockerIdx(auto idx, auto cycle_length) {
@@ -247,6 +279,35 @@ TEST_F(PgWaitQueuesDropParticipantSignal, YB_DISABLE_TEST_IN_TSAN(FindAbortStatu
   TestDeadlockWithWrites();
 }
 
+// All transactions share the status tablet, so deadlocks are found by local cycle detection of its
+// deadlock detector, without probes.
+class PgWaitQueuesSingleStatusTabletTest : public PgWaitQueuesTest {
+ protected:
+  void SetUp() override {
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_transaction_table_num_tablets) = 1;
+    PgWaitQueuesTest::SetUp();
+  }
+};
+
+TEST_F(PgWaitQueuesSingleStatusTabletTest, YB_DISABLE_TEST_IN_TSAN(TestDeadlockWithWrites)) {
+  TestDeadlockWithWrites();
+  ASSERT_GT(SumTabletMetric(METRIC_deadlock_local_detection_latency), 0);
+}
+
+class PgWaitQueuesProbesOnlyTest : public PgWaitQueuesTest {
+ protected:
+  void SetUp() override {
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_enable_local_deadlock_cycle_detection) = false;
+    PgWaitQueuesTest::SetUp();
+  }
+};
+
+TEST_F(PgWaitQueuesProbesOnlyTest, YB_DISABLE_TEST_IN_TSAN(TestDeadlockWithWrites)) {
+  TestDeadlockWithWrites();
+  ASSERT_GT(SumTabletMetric(METRIC_deadlock_probes_sent), 0);
+  ASSERT_EQ(SumTabletMetric(METRIC_deadlock_local_detection_latency), 0);
+}
+
 // TODO(wait-queues): Once we have active unblocking of deadlocked waiters, re-enable this test.
 // Note: the following test fails due to a delay in the time it takes for an aborted transaction to
 // signal to the client. This requires more investigation into how pg_client handles heartbeat